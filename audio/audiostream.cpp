@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/mutex.h"
@@ -34,6 +35,7 @@
 #include "audio/decoders/vorbis.h"
 #include "audio/decoders/wave.h"
 #include "audio/mixer.h"
+#include "audio/prefetchstream.h"
 
 
 namespace Audio {
@@ -84,6 +86,8 @@ SeekableAudioStream *SeekableAudioStream::openStreamFile(const Common::String &b
 
 	if (stream == nullptr)
 		debug(1, "SeekableAudioStream::openStreamFile: Could not open compressed AudioFile %s", basename.c_str());
+	else if (ConfMan.hasKey("audio_prefetch", Common::ConfigManager::kApplicationDomain) && ConfMan.getBool("audio_prefetch", Common::ConfigManager::kApplicationDomain))
+		stream = makePrefetchingAudioStream(stream);
 
 	return stream;
 }
@@ -186,6 +186,9 @@ public:
 	 * In case of an error, the file handle will be closed, but deleting
 	 * it is still the responsibility of the caller.
 	 *
+	 * If the audio_prefetch config key is set, the stream is wrapped in a
+	 * PrefetchingAudioStream.
+	 *
 	 * @param basename  File name without an extension.
 	 *
 	 * @return  A SeekableAudioStream ready to use in case of success.
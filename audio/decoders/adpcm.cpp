@@ -47,14 +47,50 @@ ADPCMStream::ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Fl
 		_endpos(_startpos + size),
 		_channels(channels),
 		_blockAlign(blockAlign),
-		_rate(rate) {
+		_rate(rate),
+		_blockData(nullptr),
+		_blockSamples(nullptr) {
 
 	reset();
 }
 
+ADPCMStream::~ADPCMStream() {
+	delete[] _blockData;
+	delete[] _blockSamples;
+}
+
 void ADPCMStream::reset() {
 	memset(&_status, 0, sizeof(_status));
 	_blockPos[0] = _blockPos[1] = _blockAlign; // To make sure first header is read
+	_blockSampleCount = 0;
+	_blockSampleIndex = 0;
+}
+
+void ADPCMStream::allocBlockBuffers(uint32 dataSize, uint32 sampleCount) {
+	delete[] _blockData;
+	delete[] _blockSamples;
+	_blockData = new byte[dataSize];
+	_blockSamples = new int16[sampleCount];
+}
+
+int ADPCMStream::readBlockBuffer(int16 *buffer, const int numSamples) {
+	int samples = 0;
+
+	while (samples < numSamples) {
+		if (_blockSampleCount == 0) {
+			_blockSampleIndex = 0;
+			if (!decodeBlock())
+				break;
+		}
+
+		const uint32 count = MIN<uint32>(numSamples - samples, _blockSampleCount);
+		memcpy(buffer + samples, _blockSamples + _blockSampleIndex, count * sizeof(int16));
+		_blockSampleIndex += count;
+		_blockSampleCount -= count;
+		samples += count;
+	}
+
+	return samples;
 }
 
 bool ADPCMStream::rewind() {
@@ -68,26 +104,6 @@ bool ADPCMStream::rewind() {
 #pragma mark -
 
 
-int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
-		}
-
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
-	}
-
-	return samples;
-}
-
 static const int16 okiStepSize[49] = {
 	   16,   17,   19,   21,   23,   25,   28,   31,
 	   34,   37,   41,   45,   50,   55,   60,   66,
@@ -116,6 +132,68 @@ int16 Oki_ADPCMStream::decodeOKI(byte code) {
 	return samp * 16;
 }
 
+namespace {
+
+/**
+ * Precomputed OKI decoding steps: for every step index and nibble, the
+ * difference to add to the last sample and the next step index. This
+ * gives the same results as decodeOKI(), without any branches.
+ */
+struct OKIDecodeTable {
+	int16 diff[ARRAYSIZE(okiStepSize)][16];
+	byte nextIndex[ARRAYSIZE(okiStepSize)][16];
+
+	OKIDecodeTable() {
+		for (int index = 0; index < ARRAYSIZE(okiStepSize); index++) {
+			for (int code = 0; code < 16; code++) {
+				const int16 E = (2 * (code & 0x7) + 1) * okiStepSize[index] / 8;
+				diff[index][code] = (code & 0x08) ? -E : E;
+				nextIndex[index][code] = CLIP<int>(index + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(okiStepSize) - 1);
+			}
+		}
+	}
+};
+
+const OKIDecodeTable &getOKIDecodeTable() {
+	static const OKIDecodeTable table;
+	return table;
+}
+
+} // End of anonymous namespace
+
+bool Oki_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
+
+	const uint32 size = _stream->read(_blockData, MIN<uint32>(kChunkSize, _endpos - _stream->pos()));
+	if (size == 0)
+		return false;
+
+	const OKIDecodeTable &table = getOKIDecodeTable();
+	int32 last = _status.ima_ch[0].last;
+	int32 index = CLIP<int32>(_status.ima_ch[0].stepIndex, 0, ARRAYSIZE(okiStepSize) - 1);
+	int16 *dst = _blockSamples;
+
+	for (uint32 i = 0; i < size; i++) {
+		const byte data = _blockData[i];
+
+		// Clip the values to +/- 2^11 (supposed to be 12 bits), and * 16
+		// to convert the 12-bit values to 16-bit output
+		last = CLIP<int32>(last + table.diff[index][data >> 4], -2048, 2047);
+		index = table.nextIndex[index][data >> 4];
+		*dst++ = last * 16;
+
+		last = CLIP<int32>(last + table.diff[index][data & 0x0f], -2048, 2047);
+		index = table.nextIndex[index][data & 0x0f];
+		*dst++ = last * 16;
+	}
+
+	_status.ima_ch[0].last = last;
+	_status.ima_ch[0].stepIndex = index;
+	_blockSampleCount = size * 2;
+	return true;
+}
+
 
 #pragma mark -
 
@@ -220,24 +298,80 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 #pragma mark -
 
 
-int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+namespace {
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
+/**
+ * Precomputed IMA decoding steps: for every step index and nibble, the
+ * difference to add to the last sample and the next step index. This
+ * gives the same results as Ima_ADPCMStream::decodeIMA(), without any
+ * branches.
+ */
+struct IMADecodeTable {
+	int32 diff[ARRAYSIZE(Ima_ADPCMStream::_imaTable)][16];
+	byte nextIndex[ARRAYSIZE(Ima_ADPCMStream::_imaTable)][16];
+
+	IMADecodeTable() {
+		for (int index = 0; index < ARRAYSIZE(Ima_ADPCMStream::_imaTable); index++) {
+			for (int code = 0; code < 16; code++) {
+				const int32 E = (2 * (code & 0x7) + 1) * Ima_ADPCMStream::_imaTable[index] / 8;
+				diff[index][code] = (code & 0x08) ? -E : E;
+				nextIndex[index][code] = CLIP<int>(index + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(Ima_ADPCMStream::_imaTable) - 1);
+			}
 		}
+	}
+};
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+const IMADecodeTable &getIMADecodeTable() {
+	static const IMADecodeTable table;
+	return table;
+}
+
+/**
+ * Decoding state of a single IMA channel, kept in locals while decoding
+ * a block.
+ */
+struct IMAChannelState {
+	int32 last;
+	int32 index;
+
+	inline int16 decode(const IMADecodeTable &table, byte code) {
+		last = CLIP<int32>(last + table.diff[index][code], -32768, 32767);
+		index = table.nextIndex[index][code];
+		return last;
 	}
+};
 
-	return samples;
+} // End of anonymous namespace
+
+bool DVI_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
+
+	const uint32 size = _stream->read(_blockData, MIN<uint32>(kChunkSize, _endpos - _stream->pos()));
+	if (size == 0)
+		return false;
+
+	const IMADecodeTable &table = getIMADecodeTable();
+	const int right = (_channels == 2) ? 1 : 0;
+	IMAChannelState state[2];
+	for (int i = 0; i <= right; i++) {
+		state[i].last = _status.ima_ch[i].last;
+		state[i].index = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, ARRAYSIZE(_imaTable) - 1);
+	}
+
+	int16 *dst = _blockSamples;
+	for (uint32 i = 0; i < size; i++) {
+		const byte data = _blockData[i];
+		*dst++ = state[0].decode(table, data >> 4);
+		*dst++ = state[right].decode(table, data & 0x0f);
+	}
+
+	for (int i = 0; i <= right; i++) {
+		_status.ima_ch[i].last = state[i].last;
+		_status.ima_ch[i].stepIndex = state[i].index;
+	}
+	_blockSampleCount = size * 2;
+	return true;
 }
 
 #pragma mark -
@@ -310,46 +444,50 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 #pragma mark -
 
 
-int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	// Need to write at least one sample per channel
-	assert((numSamples % _channels) == 0);
+bool MSIma_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
 
-	int samples = 0;
+	// Each chunk holds four bytes per channel, and so does the header
+	const uint32 chunkSize = _channels * 4;
+	const uint32 size = _stream->read(_blockData, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	if (size < chunkSize)
+		return false;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
+	const IMADecodeTable &table = getIMADecodeTable();
+	const byte *src = _blockData;
+	IMAChannelState state[2];
+	for (int i = 0; i < _channels; i++) {
+		state[i].last = (int16)READ_LE_UINT16(src);
+		state[i].index = CLIP<int32>((int16)READ_LE_UINT16(src + 2), 0, ARRAYSIZE(_imaTable) - 1);
+		src += 4;
+	}
 
-			_blockPos[0] = _channels * 4;
-		}
+	// A truncated last block still decodes whole chunks only
+	const uint32 chunks = (size - chunkSize) / chunkSize;
+	int16 *dst = _blockSamples;
 
-		// Decode a set of samples
+	for (uint32 chunk = 0; chunk < chunks; chunk++) {
+		// The stream encodes four bytes (eight samples) per channel at a
+		// time, we want the samples interleaved
 		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
+			int16 *out = dst + i;
 			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
-			}
-		}
-
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
+				const byte data = *src++;
+				out[0] = state[i].decode(table, data & 0x0f);
+				out[_channels] = state[i].decode(table, data >> 4);
+				out += _channels * 2;
 			}
-
-			samples += _channels;
 		}
+		dst += _channels * 8;
 	}
 
-	return samples;
+	for (int i = 0; i < _channels; i++) {
+		_status.ima_ch[i].last = state[i].last;
+		_status.ima_ch[i].stepIndex = state[i].index;
+	}
+	_blockSampleCount = chunks * _channels * 8;
+	return true;
 }
 
 
@@ -369,67 +507,69 @@ static const int MSADPCMAdaptationTable[] = {
 	768, 614, 512, 409, 307, 230, 230, 230
 };
 
+// Sign extension of the 4-bit codes
+static const int8 MSADPCMSignedNibble[] = {
+	0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1
+};
+
 int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 	int32 predictor;
 
 	predictor = (((c->sample1) * (c->coeff1)) + ((c->sample2) * (c->coeff2))) / 256;
-	predictor += (signed)((code & 0x08) ? (code - 0x10) : (code)) * c->delta;
+	predictor += MSADPCMSignedNibble[code] * c->delta;
 
 	predictor = CLIP<int32>(predictor, -32768, 32767);
 
 	c->sample2 = c->sample1;
 	c->sample1 = predictor;
-	c->delta = (MSADPCMAdaptationTable[(int)code] * c->delta) >> 8;
-
-	if (c->delta < 16)
-		c->delta = 16;
+	c->delta = MAX<int16>((MSADPCMAdaptationTable[code] * c->delta) >> 8, 16);
 
 	return (int16)predictor;
 }
 
-int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-	int i;
+bool MS_ADPCMStream::decodeBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
-				// read block header
-				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-				}
+	const uint32 headerSize = _channels * 7;
+	const uint32 size = _stream->read(_blockData, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	if (size < headerSize)
+		return false;
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
+	// read block header
+	const byte *src = _blockData;
+	int i;
+	for (i = 0; i < _channels; i++) {
+		_status.ch[i].predictor = CLIP(*src++, (byte)0, (byte)6);
+		_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+		_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+	}
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].delta = (int16)READ_LE_UINT16(src);
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].sample1 = (int16)READ_LE_UINT16(src);
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].sample2 = (int16)READ_LE_UINT16(src);
 
-				_blockPos[0] = _channels * 7;
-			} else {
-				data = _stream->readByte();
-				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-			}
-			_decodedSampleIndex = 0;
-		}
+	// The header samples come first, oldest first
+	int16 *dst = _blockSamples;
+	for (i = 0; i < _channels; i++)
+		*dst++ = _status.ch[i].sample2;
+	for (i = 0; i < _channels; i++)
+		*dst++ = _status.ch[i].sample1;
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+	ADPCMChannelStatus *left = &_status.ch[0];
+	ADPCMChannelStatus *right = &_status.ch[_channels - 1];
+	for (const byte *end = _blockData + size; src < end; src++) {
+		*dst++ = decodeMS(left, *src >> 4);
+		*dst++ = decodeMS(right, *src & 0x0f);
 	}
 
-	return samples;
+	_blockSampleCount = dst - _blockSamples;
+	return true;
 }
 
 
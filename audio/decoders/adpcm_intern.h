@@ -59,8 +59,44 @@ protected:
 
 	virtual void reset();
 
+	/**
+	 * @name Block decoding
+	 *
+	 * Decoders which decode a whole block (or chunk) of input at once keep
+	 * the raw input and the decoded samples here. The input is fetched with
+	 * a single read() call per block, which is considerably faster than
+	 * reading it a byte at a time.
+	 * @{
+	 */
+	byte *_blockData;
+	int16 *_blockSamples;
+	uint32 _blockSampleCount;
+	uint32 _blockSampleIndex;
+
+	/**
+	 * Allocate the block buffers.
+	 *
+	 * @param dataSize    maximum size of a block of input, in bytes
+	 * @param sampleCount maximum number of samples decoded from a block
+	 */
+	void allocBlockBuffers(uint32 dataSize, uint32 sampleCount);
+
+	/**
+	 * Decode the next block into _blockSamples and set _blockSampleCount.
+	 *
+	 * @return false if there is no more input
+	 */
+	virtual bool decodeBlock() { return false; }
+
+	/**
+	 * readBuffer() implementation for decoders using decodeBlock().
+	 */
+	int readBlockBuffer(int16 *buffer, const int numSamples);
+	/** @} */
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
+	virtual ~ADPCMStream();
 
 	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
 	virtual bool isStereo() const { return _channels == 2; }
@@ -83,18 +119,19 @@ public:
 class Oki_ADPCMStream : public ADPCMStream {
 public:
 	Oki_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { allocBlockBuffers(kChunkSize, kChunkSize * 2); }
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_blockSampleCount == 0); }
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBlockBuffer(buffer, numSamples); }
 
 protected:
-	int16 decodeOKI(byte);
+	enum {
+		kChunkSize = 256 ///< Number of bytes decoded at once
+	};
 
-private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
+	int16 decodeOKI(byte);
+	virtual bool decodeBlock();
 };
 
 class XA_ADPCMStream : public ADPCMStream {
@@ -132,15 +169,18 @@ public:
 class DVI_ADPCMStream : public Ima_ADPCMStream {
 public:
 	DVI_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { allocBlockBuffers(kChunkSize, kChunkSize * 2); }
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_blockSampleCount == 0); }
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBlockBuffer(buffer, numSamples); }
 
-private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
+protected:
+	enum {
+		kChunkSize = 256 ///< Number of bytes decoded at once
+	};
+
+	virtual bool decodeBlock();
 };
 
 class Apple_ADPCMStream : public Ima_ADPCMStream {
@@ -182,21 +222,16 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		// The header holds four bytes per channel, every other byte two samples
+		allocBlockBuffers(blockAlign, (blockAlign - _channels * 4) * 2);
 	}
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_blockSampleCount == 0); }
 
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
-	}
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBlockBuffer(buffer, numSamples); }
 
-private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+protected:
+	virtual bool decodeBlock();
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -226,21 +261,18 @@ public:
 		if (blockAlign == 0)
 			error("MS_ADPCMStream(): blockAlign isn't specified for MS ADPCM");
 		memset(&_status, 0, sizeof(_status));
-		_decodedSampleCount = 0;
-		_decodedSampleIndex = 0;
+
+		// The header holds two samples per channel, every other byte two samples
+		allocBlockBuffers(blockAlign, _channels * 4 + blockAlign * 2);
 	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_blockSampleCount == 0); }
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBlockBuffer(buffer, numSamples); }
 
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
-
-private:
-	uint8 _decodedSampleCount;
-	uint8 _decodedSampleIndex;
-	int16 _decodedSamples[4];
+	virtual bool decodeBlock();
 };
 
 // Duck DK3 IMA ADPCM Decoder
@@ -305,7 +305,12 @@ EmulatedOPL::EmulatedOPL() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) {
+	_handle(new Audio::SoundHandle()),
+	_queueLength(0),
+	_queueWrites(false),
+	_callbackFrame(0),
+	_buffer(nullptr),
+	_generatedFrames(0) {
 }
 
 EmulatedOPL::~EmulatedOPL() {
@@ -318,29 +323,114 @@ EmulatedOPL::~EmulatedOPL() {
 	delete _handle;
 }
 
+void EmulatedOPL::write(int a, int v) {
+	Common::StackLock lock(_queueMutex);
+
+	if (_queueWrites)
+		queueWrite(a, v, false);
+	else
+		writePort(a, v);
+}
+
+byte EmulatedOPL::read(int a) {
+	Common::StackLock lock(_queueMutex);
+
+	// Make sure the chip state is up to date first
+	if (_queueWrites)
+		flushWrites(_callbackFrame);
+
+	return readPort(a);
+}
+
+void EmulatedOPL::writeReg(int r, int v) {
+	Common::StackLock lock(_queueMutex);
+
+	if (_queueWrites)
+		queueWrite(r, v, true);
+	else
+		writeRegister(r, v);
+}
+
+void EmulatedOPL::queueWrite(int index, int value, bool isRegister) {
+	if (_queueLength == kMaxQueuedWrites)
+		flushWrites(_callbackFrame);
+
+	QueuedWrite &entry = _queue[_queueLength++];
+	entry.frame = _callbackFrame;
+	entry.index = index;
+	entry.value = value;
+	entry.isRegister = isRegister;
+}
+
+void EmulatedOPL::flushWrites(int frame) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	for (uint i = 0; i < _queueLength; ++i) {
+		const QueuedWrite &entry = _queue[i];
+
+		if (entry.frame > _generatedFrames) {
+			generateSamples(_buffer + _generatedFrames * stereoFactor, (entry.frame - _generatedFrames) * stereoFactor);
+			_generatedFrames = entry.frame;
+		}
+
+		if (entry.isRegister)
+			writeRegister(entry.index, entry.value);
+		else
+			writePort(entry.index, entry.value);
+	}
+	_queueLength = 0;
+
+	if (frame > _generatedFrames) {
+		generateSamples(_buffer + _generatedFrames * stereoFactor, (frame - _generatedFrames) * stereoFactor);
+		_generatedFrames = frame;
+	}
+}
+
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
-	int len = numSamples / stereoFactor;
+	const int len = numSamples / stereoFactor;
+	int pos = 0;
 	int step;
 
+	// Run all timer callbacks for this buffer first. The register writes
+	// they make are queued along with the sample frame they were made at,
+	// and the whole buffer is then rendered with as few generateSamples()
+	// calls as possible, while still applying every write at the exact
+	// sample it would have been applied at otherwise. The lock is not held
+	// while the callback runs, as it may wait for the engine thread, which
+	// in turn may be writing to the chip.
+	_queueMutex.lock();
+	_buffer = buffer;
+	_generatedFrames = 0;
+	_callbackFrame = 0;
+	_queueWrites = true;
+	_queueMutex.unlock();
+
 	do {
-		step = len;
+		step = len - pos;
 		if (step > (_nextTick >> FIXP_SHIFT))
 			step = (_nextTick >> FIXP_SHIFT);
 
-		generateSamples(buffer, step * stereoFactor);
-
 		_nextTick -= step << FIXP_SHIFT;
+		pos += step;
+
 		if (!(_nextTick >> FIXP_SHIFT)) {
-			if (_callback && _callback->isValid())
+			if (_callback && _callback->isValid()) {
+				_queueMutex.lock();
+				_callbackFrame = pos;
+				_queueMutex.unlock();
+
 				(*_callback)();
+			}
 
 			_nextTick += _samplesPerTick;
 		}
+	} while (pos < len);
 
-		buffer += step * stereoFactor;
-		len -= step;
-	} while (len);
+	Common::StackLock lock(_queueMutex);
+	flushWrites(len);
+	_queueWrites = false;
+	_buffer = nullptr;
 
 	return numSamples;
 }
@@ -25,6 +25,7 @@
 #include "audio/audiostream.h"
 
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -250,6 +251,9 @@ public:
 	virtual ~EmulatedOPL();
 
 	// OPL API
+	void write(int a, int v);
+	byte read(int a);
+	void writeReg(int r, int v);
 	void setCallbackFrequency(int timerFrequency);
 
 	// AudioStream API
@@ -274,6 +278,25 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Write a byte to the given I/O port of the emulated chip.
+	 *
+	 * Unlike write(), this is always applied immediately.
+	 */
+	virtual void writePort(int a, int v) = 0;
+
+	/**
+	 * Read a byte from the given I/O port of the emulated chip.
+	 */
+	virtual byte readPort(int a) = 0;
+
+	/**
+	 * Write to a register of the emulated chip.
+	 *
+	 * Unlike writeReg(), this is always applied immediately.
+	 */
+	virtual void writeRegister(int r, int v) = 0;
+
 private:
 	int _baseFreq;
 
@@ -285,6 +308,48 @@ private:
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+
+	/**
+	 * A port or register write made from the timer callback, which has
+	 * to be applied at the given sample frame of the current buffer.
+	 */
+	struct QueuedWrite {
+		int frame;
+		int index;
+		int value;
+		bool isRegister;
+	};
+
+	enum {
+		kMaxQueuedWrites = 256
+	};
+
+	/**
+	 * Protects the queue and the emulated chip. The mixer thread renders
+	 * samples while the engine thread may write to the chip outside of the
+	 * timer callback.
+	 */
+	Common::Mutex _queueMutex;
+
+	QueuedWrite _queue[kMaxQueuedWrites];
+	uint _queueLength;
+
+	/**
+	 * Whether writes are queued instead of applied immediately. This is the
+	 * case while readBuffer() renders a buffer, so writes from another
+	 * thread are applied in order with the ones from the timer callback.
+	 */
+	bool _queueWrites;
+	/** The sample frame the timer callback currently runs at. */
+	int _callbackFrame;
+
+	int16 *_buffer;
+	int _generatedFrames;
+
+	/** Queue a write. Must be called with _queueMutex locked. */
+	void queueWrite(int index, int value, bool isRegister);
+	/** Apply the queued writes. Must be called with _queueMutex locked. */
+	void flushWrites(int frame);
 };
 /** @} */
 } // End of namespace OPL
@@ -42,7 +42,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -56,10 +56,21 @@ public:
 	 */
 	int mix(int16 *data, uint len);
 
+	/**
+	 * Mixes the channel's samples into the given 32-bit accumulation buffer.
+	 *
+	 * @param accum      buffer where to mix the data
+	 * @param scratch    temporary buffer of at least len sample pairs
+	 * @param len        number of sample *pairs*
+	 * @param accumulate kernel used to scale and add the samples
+	 * @return number of sample pairs processed (which can still be silence!)
+	 */
+	int mixAccumulated(int32 *accum, st_sample_t *scratch, uint len, MixAccumulateFunc accumulate);
+
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	bool isFinished() const { return _stream->endOfStream() && !_draining; }
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -158,6 +169,7 @@ private:
 	int8 _balance;
 
 	void updateChannelVolumes();
+	int flow(st_sample_t *data, uint len, st_volume_t volL, st_volume_t volR);
 	st_volume_t _volL, _volR;
 
 	Mixer *_mixer;
@@ -168,6 +180,9 @@ private:
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	/** The stream ended while the rate converter still had output left */
+	bool _draining;
+
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
 };
@@ -177,17 +192,23 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _rateConverterQuality(kRateConverterDefault), _accumulateMode(false), _accumBuf(nullptr), _channelBuf(nullptr), _mixBufSize(0) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = nullptr;
+
+	getMixerKernels(_mixAccumulate, _mixSaturate);
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	free(_accumBuf);
+	free(_channelBuf);
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -196,6 +217,18 @@ void MixerImpl::setReady(bool ready) {
 	_mixerReady = ready;
 }
 
+void MixerImpl::setAccumulateMode(bool enable) {
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	// The accumulation buffer is signed, so only the default mode is
+	// available for unsigned output.
+	enable = false;
+#endif
+
+	Common::StackLock lock(_mutex);
+
+	_accumulateMode = enable;
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
@@ -268,12 +301,18 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
 }
 
+void MixerImpl::setRateConverterQuality(RateConverterQuality quality) {
+	Common::StackLock lock(_mutex);
+
+	_rateConverterQuality = quality;
+}
+
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
@@ -287,6 +326,13 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	if (_accumulateMode)
+		return mixChannelsAccumulated(buf, len);
+	else
+		return mixChannels(buf, len);
+}
+
+int MixerImpl::mixChannels(int16 *buf, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -308,6 +354,41 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	return res;
 }
 
+int MixerImpl::mixChannelsAccumulated(int16 *buf, uint len) {
+	// Reallocate the work buffers, if necessary
+	if (len > _mixBufSize) {
+		free(_accumBuf);
+		free(_channelBuf);
+		_accumBuf = (int32 *)malloc(2 * len * sizeof(int32));
+		_channelBuf = (st_sample_t *)malloc(2 * len * sizeof(st_sample_t));
+		_mixBufSize = len;
+
+		if (!_accumBuf || !_channelBuf)
+			error("[MixerImpl::mixChannelsAccumulated] Cannot allocate memory for mixing buffers");
+	}
+
+	memset(_accumBuf, 0, 2 * len * sizeof(int32));
+
+	// mix all channels
+	int res = 0, tmp;
+	for (int i = 0; i != NUM_CHANNELS; i++)
+		if (_channels[i]) {
+			if (_channels[i]->isFinished()) {
+				delete _channels[i];
+				_channels[i] = nullptr;
+			} else if (!_channels[i]->isPaused()) {
+				tmp = _channels[i]->mixAccumulated(_accumBuf, _channelBuf, len, _mixAccumulate);
+
+				if (tmp > res)
+					res = tmp;
+			}
+		}
+
+	_mixSaturate(buf, _accumBuf, len);
+
+	return res;
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -515,16 +596,16 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
+	  _pauseStartTime(0), _pauseTime(0), _draining(false), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -635,18 +716,42 @@ void Channel::loop() {
 }
 
 int Channel::mix(int16 *data, uint len) {
+	return flow(data, len, _volL, _volR);
+}
+
+int Channel::mixAccumulated(int32 *accum, st_sample_t *scratch, uint len, MixAccumulateFunc accumulate) {
+	// Let the rate converter produce the unscaled samples: adding at full
+	// volume into silence is exact, so the volume and balance can then be
+	// applied by the (vectorized) accumulation kernel.
+	memset(scratch, 0, 2 * len * sizeof(st_sample_t));
+
+	int res = flow(scratch, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+	if (res > 0)
+		accumulate(accum, scratch, res, _volL, _volR);
+
+	return res;
+}
+
+int Channel::flow(st_sample_t *data, uint len, st_volume_t volL, st_volume_t volR) {
 	assert(_stream);
 
 	int res = 0;
+	assert(_converter);
 	if (_stream->endOfData()) {
-		// TODO: call drain method
+		if (_draining) {
+			res = _converter->drain(data, len, volL, volR);
+			_draining = (res == (int)len);
+		}
 	} else {
-		assert(_converter);
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		res = _converter->flow(*_stream, data, len, volL, volR);
 		_samplesDecoded += res;
+
+		// If the output buffer was filled up just as the stream ended, the
+		// converter may not have written all of its output yet
+		_draining = (res == (int)len) && _stream->endOfStream();
 	}
 
 	return res;
@@ -25,6 +25,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
 
 namespace Audio {
 
@@ -78,6 +79,15 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	RateConverterQuality _rateConverterQuality;
+
+	bool _accumulateMode;
+	int32 *_accumBuf;
+	st_sample_t *_channelBuf;
+	uint _mixBufSize;
+	MixAccumulateFunc _mixAccumulate;
+	MixSaturateFunc _mixSaturate;
+
 
 public:
 
@@ -134,6 +144,9 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	int mixChannels(int16 *buf, uint len);
+	int mixChannelsAccumulated(int16 *buf, uint len);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -152,6 +165,28 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Switch between the default and the accumulating mixing mode.
+	 *
+	 * By default every channel is added into the output buffer, and clipped,
+	 * sample by sample. In accumulating mode every channel is added into a
+	 * 32-bit buffer instead, and the result is clipped once per callback,
+	 * using SIMD code where the CPU supports it. This is considerably
+	 * cheaper with many active channels.
+	 *
+	 * The output only differs from the default mode when an intermediate
+	 * sum would have clipped.
+	 */
+	void setAccumulateMode(bool enable);
+	bool isAccumulateMode() const { return _accumulateMode; }
+
+	/**
+	 * Set the quality of the rate converters used by channels started
+	 * after this call. Channels that are already playing are not affected.
+	 */
+	void setRateConverterQuality(RateConverterQuality quality);
+	RateConverterQuality getRateConverterQuality() const { return _rateConverterQuality; }
 };
 
 /** @} */
@@ -0,0 +1,62 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+#include "common/util.h"
+
+#include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+
+namespace Audio {
+
+void mixAccumulate(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; len > 0; len--) {
+		accum[0] += (src[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
+		accum[1] += (src[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
+		accum += 2;
+		src += 2;
+	}
+}
+
+void mixSaturate(st_sample_t *dst, const int32 *accum, uint len) {
+	for (len *= 2; len > 0; len--)
+		*dst++ = (st_sample_t)CLIP<int32>(*accum++, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+void getMixerKernels(MixAccumulateFunc &accumulate, MixSaturateFunc &saturate) {
+	accumulate = mixAccumulate;
+	saturate = mixSaturate;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		accumulate = mixAccumulateSSE2;
+		saturate = mixSaturateSSE2;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		accumulate = mixAccumulateNEON;
+		saturate = mixSaturateNEON;
+	}
+#endif
+}
+
+} // End of namespace Audio
@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIXER_KERNELS_H
+#define AUDIO_MIXER_KERNELS_H
+
+#include "common/scummsys.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mixer_kernels Mixer kernels
+ * @ingroup audio
+ *
+ * @brief Sample loops used by the accumulating mixer mode.
+ *
+ * All buffers hold interleaved stereo samples and all lengths are given
+ * in sample *pairs*. Every implementation produces exactly the same output
+ * as the plain C++ one.
+ * @{
+ */
+
+/**
+ * Scale a buffer of stereo samples by the given volumes and add the result
+ * into a 32-bit accumulation buffer. Scaling rounds towards zero, exactly
+ * like the rate converters do.
+ */
+typedef void (*MixAccumulateFunc)(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Clamp a 32-bit accumulation buffer into the 16-bit output range.
+ */
+typedef void (*MixSaturateFunc)(st_sample_t *dst, const int32 *accum, uint len);
+
+void mixAccumulate(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r);
+void mixSaturate(st_sample_t *dst, const int32 *accum, uint len);
+
+#ifdef SCUMMVM_SSE2
+void mixAccumulateSSE2(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r);
+void mixSaturateSSE2(st_sample_t *dst, const int32 *accum, uint len);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixAccumulateNEON(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r);
+void mixSaturateNEON(st_sample_t *dst, const int32 *accum, uint len);
+#endif
+
+/**
+ * Select the fastest kernels supported by the CPU we are running on.
+ */
+void getMixerKernels(MixAccumulateFunc &accumulate, MixSaturateFunc &saturate);
+
+/** @} */
+} // End of namespace Audio
+
+#endif
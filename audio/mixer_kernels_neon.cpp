@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Audio {
+
+// The shifts below divide by the global volume range.
+STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, mixer_volume_range_is_8_bits);
+
+void mixAccumulateNEON(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16 volumes[4] = { (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r };
+	const int16x4_t vol = vld1_s16(volumes);
+	const int32x4_t bias = vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	for (; len >= 4; len -= 4) {
+		const int16x8_t in = vld1q_s16(src);
+		int32x4_t p0 = vmull_s16(vget_low_s16(in), vol);
+		int32x4_t p1 = vmull_s16(vget_high_s16(in), vol);
+
+		// Bias negative products so the arithmetic shift rounds towards
+		// zero, like the division in the scalar code.
+		p0 = vshrq_n_s32(vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), bias)), 8);
+		p1 = vshrq_n_s32(vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), bias)), 8);
+
+		vst1q_s32(accum, vaddq_s32(vld1q_s32(accum), p0));
+		vst1q_s32(accum + 4, vaddq_s32(vld1q_s32(accum + 4), p1));
+
+		src += 8;
+		accum += 8;
+	}
+
+	mixAccumulate(accum, src, len, vol_l, vol_r);
+}
+
+void mixSaturateNEON(st_sample_t *dst, const int32 *accum, uint len) {
+	for (; len >= 4; len -= 4) {
+		const int32x4_t a0 = vld1q_s32(accum);
+		const int32x4_t a1 = vld1q_s32(accum + 4);
+		vst1q_s16(dst, vcombine_s16(vqmovn_s32(a0), vqmovn_s32(a1)));
+
+		dst += 8;
+		accum += 8;
+	}
+
+	mixSaturate(dst, accum, len);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Audio {
+
+// The shifts below divide by the global volume range.
+STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, mixer_volume_range_is_8_bits);
+
+void mixAccumulateSSE2(int32 *accum, const st_sample_t *src, uint len, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	for (; len >= 4; len -= 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+		// Bias negative products so the arithmetic shift rounds towards
+		// zero, like the division in the scalar code.
+		p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+		p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+		_mm_storeu_si128((__m128i *)accum, _mm_add_epi32(_mm_loadu_si128((const __m128i *)accum), p0));
+		_mm_storeu_si128((__m128i *)(accum + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(accum + 4)), p1));
+
+		src += 8;
+		accum += 8;
+	}
+
+	mixAccumulate(accum, src, len, vol_l, vol_r);
+}
+
+void mixSaturateSSE2(st_sample_t *dst, const int32 *accum, uint len) {
+	for (; len >= 4; len -= 4) {
+		const __m128i a0 = _mm_loadu_si128((const __m128i *)accum);
+		const __m128i a1 = _mm_loadu_si128((const __m128i *)(accum + 4));
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(a0, a1));
+
+		dst += 8;
+		accum += 8;
+	}
+
+	mixSaturate(dst, accum, len);
+}
+
+} // End of namespace Audio
@@ -15,10 +15,12 @@ MODULE_OBJS := \
 	miles_adlib.o \
 	miles_midi.o \
 	mixer.o \
+	mixer_kernels.o \
 	mpu401.o \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
+	prefetchstream.o \
 	rate.o \
 	timestamp.o \
 	decoders/3do.o \
@@ -85,6 +87,20 @@ MODULE_OBJS += \
 	softsynth/opl/nuked.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mixer_kernels_sse2.o \
+	rate_kernels_sse2.o
+$(MODULE)/mixer_kernels_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/rate_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mixer_kernels_neon.o \
+	rate_kernels_neon.o
+endif
+
 ifdef USE_A52
 MODULE_OBJS += \
 	decoders/ac3.o
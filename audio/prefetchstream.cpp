@@ -0,0 +1,440 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/ringbuffer.h"
+#include "common/singleton.h"
+#include "common/thread.h"
+#include "common/util.h"
+
+#include "audio/prefetchstream.h"
+
+#include <atomic>
+
+namespace Audio {
+
+enum {
+	/** How much audio is decoded ahead, in milliseconds. */
+	kPrefetchMillis = 500,
+	/** The maximum number of samples decoded at a time. */
+	kPrefetchChunkSize = 4096
+};
+
+class PrefetchingAudioStreamImpl;
+
+/**
+ * Keeps track of all prefetching streams, and runs the worker thread
+ * which fills their buffers while there are any.
+ */
+class PrefetchManager : public Common::Singleton<PrefetchManager> {
+public:
+	PrefetchManager() : _nextStream(0), _quit(false), _wakePending(false) {}
+
+	/**
+	 * Register a stream with the worker thread, starting it if necessary.
+	 *
+	 * @return true if the stream is filled by the worker thread, false if
+	 *         threads are not available.
+	 */
+	bool addStream(PrefetchingAudioStreamImpl *stream);
+
+	/**
+	 * Unregister a stream, waiting for the worker to finish decoding it.
+	 * The worker thread is stopped when the last stream is removed.
+	 */
+	void removeStream(PrefetchingAudioStreamImpl *stream);
+
+	/** Tell the worker thread that there is buffer space to fill. */
+	void wakeUp() {
+		// Only post once until the worker wakes up, so the semaphore does
+		// not count up while the worker is busy
+		if (!_wakePending.exchange(true))
+			_wakeUp.post();
+	}
+
+	void getStats(Common::Array<PrefetchingAudioStream::Stats> &stats);
+
+private:
+	static void workerProc(void *data);
+	void run();
+	PrefetchingAudioStreamImpl *lockNextStream();
+
+	/** Serializes starting and stopping the worker thread. */
+	Common::Mutex _threadMutex;
+	/** Guards _streams and _nextStream. */
+	Common::Mutex _streamsMutex;
+	Common::Array<PrefetchingAudioStreamImpl *> _streams;
+	uint _nextStream;
+
+	Common::Thread _thread;
+	Common::Semaphore _wakeUp;
+	std::atomic<bool> _quit;
+	/** Set while _wakeUp has been posted and the worker has not woken up yet. */
+	std::atomic<bool> _wakePending;
+};
+
+class PrefetchingAudioStreamImpl : public PrefetchingAudioStream {
+public:
+	PrefetchingAudioStreamImpl(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+	~PrefetchingAudioStreamImpl();
+
+	// AudioStream API
+	int readBuffer(int16 *buffer, const int numSamples) override;
+	bool isStereo() const override { return _isStereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override {
+		return _seekRequest.load(std::memory_order_acquire) == _readGeneration &&
+			_sourceEnded.load(std::memory_order_acquire) && _buffer.size() == 0;
+	}
+
+	// SeekableAudioStream API
+	bool seek(const Timestamp &where) override;
+	Timestamp getLength() const override { return _length; }
+
+	// PrefetchingAudioStream API
+	Stats getStats() const override;
+
+	/** Whether the worker thread has something to do for this stream. */
+	bool needsData() const {
+		if (_seekRequest.load(std::memory_order_acquire) != _seekGeneration.load(std::memory_order_relaxed))
+			return true;
+		return !_sourceEnded.load(std::memory_order_acquire) && _buffer.space() >= _chunkSize;
+	}
+
+	/**
+	 * Carry out the last seek(), if necessary, and decode up to one chunk
+	 * from the source stream into the buffer. Must be called with
+	 * _sourceMutex held.
+	 */
+	void fill();
+
+	/** Held while the source stream is used. */
+	Common::Mutex _sourceMutex;
+
+private:
+	/** Decode the first part of the buffer on the calling thread. */
+	void prime();
+
+	/** Seek the source stream if seek() has been called. Producer side. */
+	void seekSource();
+
+	/** Drop the samples decoded before the last seek. Consumer side. */
+	void handleSeek();
+
+	Common::DisposablePtr<SeekableAudioStream> _stream;
+	const bool _isStereo;
+	const int _rate;
+	const Timestamp _length;
+
+	Common::SPSCRingBuffer<int16> _buffer;
+	uint32 _chunkSize;
+	bool _threaded;
+
+	/** Set by the producer once the source stream has no more data. */
+	std::atomic<bool> _sourceEnded;
+
+	/** Guards _seekTarget and the increments of _seekRequest. */
+	Common::Mutex _seekMutex;
+	Timestamp _seekTarget;
+	/** Incremented by seek(), after setting _seekTarget. */
+	std::atomic<uint32> _seekRequest;
+
+	/**
+	 * Set to _seekRequest by the producer once it has seeked the source,
+	 * after setting _seekPosition to the write position of the buffer at
+	 * the time. The consumer drops everything written before that, it was
+	 * decoded from the old position.
+	 */
+	std::atomic<uint32> _seekGeneration;
+	std::atomic<uint32> _seekPosition;
+	/** The last _seekGeneration handled by the consumer. */
+	uint32 _readGeneration;
+
+	// Statistics, each only written by either the producer or the consumer
+	uint32 _underruns;
+	uint32 _underrunSamples;
+	uint32 _decodedSamples;
+};
+
+#pragma mark -
+
+bool PrefetchManager::addStream(PrefetchingAudioStreamImpl *stream) {
+	Common::StackLock threadLock(_threadMutex);
+
+	{
+		Common::StackLock lock(_streamsMutex);
+		_streams.push_back(stream);
+	}
+
+	if (!_thread.isRunning()) {
+		_quit.store(false);
+		_wakePending.store(false);
+		_thread.start(workerProc, this, "Audio prefetch");
+	}
+
+	return _thread.isRunning();
+}
+
+void PrefetchManager::removeStream(PrefetchingAudioStreamImpl *stream) {
+	Common::StackLock threadLock(_threadMutex);
+	bool empty;
+
+	{
+		Common::StackLock lock(_streamsMutex);
+		for (uint i = 0; i < _streams.size(); ++i) {
+			if (_streams[i] == stream) {
+				_streams.remove_at(i);
+				break;
+			}
+		}
+		_nextStream = 0;
+		empty = _streams.empty();
+	}
+
+	// The worker might still be decoding for this stream
+	stream->_sourceMutex.lock();
+	stream->_sourceMutex.unlock();
+
+	if (empty && _thread.isRunning()) {
+		_quit.store(true);
+		_wakeUp.post();
+		_thread.join();
+	}
+}
+
+void PrefetchManager::getStats(Common::Array<PrefetchingAudioStream::Stats> &stats) {
+	Common::StackLock lock(_streamsMutex);
+
+	stats.clear();
+	for (uint i = 0; i < _streams.size(); ++i)
+		stats.push_back(_streams[i]->getStats());
+}
+
+void PrefetchManager::workerProc(void *data) {
+	((PrefetchManager *)data)->run();
+}
+
+void PrefetchManager::run() {
+	while (!_quit.load()) {
+		PrefetchingAudioStreamImpl *stream = lockNextStream();
+
+		if (stream) {
+			stream->fill();
+			stream->_sourceMutex.unlock();
+		} else {
+			// Sleep until a consumer has read enough to make room for
+			// another chunk. Data added before the flag is cleared is found
+			// by the next lockNextStream(), later additions post again.
+			_wakeUp.wait();
+			_wakePending.store(false);
+		}
+	}
+}
+
+PrefetchingAudioStreamImpl *PrefetchManager::lockNextStream() {
+	Common::StackLock lock(_streamsMutex);
+
+	// Go round-robin over the streams, so one fast consumer does not
+	// starve the others
+	const uint count = _streams.size();
+	for (uint i = 0; i < count; ++i) {
+		const uint index = (_nextStream + i) % count;
+		PrefetchingAudioStreamImpl *stream = _streams[index];
+
+		if (stream->needsData()) {
+			// Locked before releasing _streamsMutex, so the stream can
+			// not be destroyed in between
+			stream->_sourceMutex.lock();
+			_nextStream = (index + 1) % count;
+			return stream;
+		}
+	}
+
+	return nullptr;
+}
+
+#pragma mark -
+
+PrefetchingAudioStreamImpl::PrefetchingAudioStreamImpl(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse)
+	: _stream(stream, disposeAfterUse),
+	  _isStereo(stream->isStereo()),
+	  _rate(stream->getRate()),
+	  _length(stream->getLength()),
+	  _buffer(stream->getRate() * (stream->isStereo() ? 2 : 1) * kPrefetchMillis / 1000),
+	  _threaded(false),
+	  _sourceEnded(false),
+	  _seekRequest(0),
+	  _seekGeneration(0),
+	  _seekPosition(0),
+	  _readGeneration(0),
+	  _underruns(0),
+	  _underrunSamples(0),
+	  _decodedSamples(0) {
+
+	_chunkSize = MIN<uint32>(kPrefetchChunkSize, _buffer.capacity() / 4);
+
+	prime();
+	_threaded = PrefetchManager::instance().addStream(this);
+}
+
+PrefetchingAudioStreamImpl::~PrefetchingAudioStreamImpl() {
+	PrefetchManager::instance().removeStream(this);
+}
+
+int PrefetchingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
+	if (!_threaded) {
+		Common::StackLock lock(_sourceMutex);
+		seekSource();
+		handleSeek();
+		while (_buffer.size() < (uint32)numSamples && !_sourceEnded.load(std::memory_order_relaxed))
+			fill();
+	} else {
+		handleSeek();
+	}
+
+	int samples = 0;
+	bool sourceEnded = false;
+	if (_seekRequest.load(std::memory_order_acquire) == _readGeneration) {
+		// Once the source has ended, all its samples are in the buffer
+		sourceEnded = _sourceEnded.load(std::memory_order_acquire);
+		samples = _buffer.read(buffer, numSamples);
+	}
+
+	if (samples < numSamples && !sourceEnded) {
+		// The worker has not caught up. Play silence rather than waiting,
+		// so the other channels keep playing.
+		_underruns++;
+		_underrunSamples += numSamples - samples;
+		memset(buffer + samples, 0, (numSamples - samples) * sizeof(int16));
+		samples = numSamples;
+	}
+
+	if (_threaded && _buffer.space() >= _chunkSize)
+		PrefetchManager::instance().wakeUp();
+
+	return samples;
+}
+
+bool PrefetchingAudioStreamImpl::seek(const Timestamp &where) {
+	// Neither the caller nor the mixer should wait for the source stream,
+	// so only the request is stored here. The producer seeks the source in
+	// seekSource(), and until then the consumer plays silence.
+	{
+		Common::StackLock lock(_seekMutex);
+		_seekTarget = where;
+		_seekRequest.fetch_add(1, std::memory_order_release);
+	}
+
+	if (_threaded)
+		PrefetchManager::instance().wakeUp();
+
+	// The source is only seeked later, so only report seeks past the end
+	return _length.totalNumberOfFrames() == 0 || where <= _length;
+}
+
+void PrefetchingAudioStreamImpl::seekSource() {
+	if (_seekRequest.load(std::memory_order_acquire) == _seekGeneration.load(std::memory_order_relaxed))
+		return;
+
+	uint32 request;
+	Timestamp where;
+	{
+		Common::StackLock lock(_seekMutex);
+		request = _seekRequest.load(std::memory_order_relaxed);
+		where = _seekTarget;
+	}
+
+	_stream->seek(where);
+
+	_sourceEnded.store(false, std::memory_order_release);
+	_seekPosition.store(_buffer.getWritePosition(), std::memory_order_relaxed);
+	_seekGeneration.store(request, std::memory_order_release);
+}
+
+void PrefetchingAudioStreamImpl::handleSeek() {
+	const uint32 generation = _seekGeneration.load(std::memory_order_acquire);
+	if (generation == _readGeneration)
+		return;
+
+	// If the producer seeks again in between, _seekPosition may be newer
+	// than the generation, which only drops more of the old samples
+	_readGeneration = generation;
+	_buffer.discardUntil(_seekPosition.load(std::memory_order_relaxed));
+}
+
+PrefetchingAudioStream::Stats PrefetchingAudioStreamImpl::getStats() const {
+	Stats stats;
+	stats.capacity = _buffer.capacity();
+	stats.occupancy = _buffer.size();
+	stats.underruns = _underruns;
+	stats.underrunSamples = _underrunSamples;
+	stats.decodedSamples = _decodedSamples;
+	stats.seekPending = _seekRequest.load(std::memory_order_acquire) != _seekGeneration.load(std::memory_order_acquire);
+	return stats;
+}
+
+void PrefetchingAudioStreamImpl::fill() {
+	seekSource();
+
+	uint32 count;
+	int16 *dst = _buffer.getWriteBuffer(count);
+
+	count = MIN(count, _chunkSize);
+	// Stereo streams must always be read in whole sample frames
+	if (_isStereo)
+		count &= ~1;
+	if (!count)
+		return;
+
+	const int samples = _stream->readBuffer(dst, count);
+	if (samples > 0) {
+		_buffer.commitWrite(samples);
+		_decodedSamples += samples;
+	}
+
+	if (samples < (int)count || _stream->endOfData())
+		_sourceEnded.store(true, std::memory_order_release);
+}
+
+void PrefetchingAudioStreamImpl::prime() {
+	// A quarter of the buffer is enough to bridge the time until the
+	// worker thread gets to this stream
+	while (_buffer.size() < _buffer.capacity() / 4 && !_sourceEnded.load(std::memory_order_relaxed))
+		fill();
+}
+
+#pragma mark -
+
+PrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	return new PrefetchingAudioStreamImpl(stream, disposeAfterUse);
+}
+
+void getPrefetchingAudioStreamStats(Common::Array<PrefetchingAudioStream::Stats> &stats) {
+	PrefetchManager::instance().getStats(stats);
+}
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PrefetchManager);
+}
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AUDIO_PREFETCHSTREAM_H
+#define AUDIO_PREFETCHSTREAM_H
+
+#include "common/array.h"
+#include "common/types.h"
+
+#include "audio/audiostream.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_prefetchstream Prefetching audio stream
+ * @ingroup audio
+ *
+ * @brief A stream wrapper which decodes ahead on a background thread.
+ * @{
+ */
+
+/**
+ * A seekable audio stream which decodes its source stream ahead on a
+ * background thread into a lock-free ring buffer, so that reading from
+ * it in the mixer callback only ever copies already decoded samples.
+ *
+ * When the decoder can not keep up, readBuffer() fills the missing part
+ * with silence and counts an underrun, instead of blocking the mixer.
+ * The same goes for seek(): the worker thread seeks the source stream,
+ * and the stream plays silence until it has done so.
+ *
+ * All prefetching streams share one worker thread. On backends without
+ * thread support the source is decoded in readBuffer() instead.
+ */
+class PrefetchingAudioStream : public SeekableAudioStream {
+public:
+	struct Stats {
+		/** Size of the ring buffer, in samples. */
+		uint32 capacity;
+		/** Number of decoded samples currently in the ring buffer. */
+		uint32 occupancy;
+		/** Number of readBuffer() calls which could not be fully served. */
+		uint32 underruns;
+		/** Number of samples replaced by silence due to underruns. */
+		uint32 underrunSamples;
+		/** Number of samples decoded from the source stream so far. */
+		uint32 decodedSamples;
+		/** Whether the worker thread has not carried out the last seek() yet. */
+		bool seekPending;
+	};
+
+	/**
+	 * Return the buffer statistics of this stream. The values are updated
+	 * by two threads without locking, so they are only approximate.
+	 */
+	virtual Stats getStats() const = 0;
+};
+
+/**
+ * Wrap a stream in a PrefetchingAudioStream.
+ *
+ * @param stream           The stream to decode ahead.
+ * @param disposeAfterUse  Whether to delete the stream along with the wrapper.
+ * @return The new prefetching stream.
+ */
+PrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+/**
+ * Return the statistics of all existing prefetching streams.
+ */
+void getPrefetchingAudioStreamStats(Common::Array<PrefetchingAudioStream::Stats> &stats);
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
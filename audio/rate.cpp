@@ -29,8 +29,14 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_kernels.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
 #include "common/frac.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -79,7 +85,7 @@ protected:
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
 		return ST_SUCCESS;
 	}
 };
@@ -185,7 +191,7 @@ protected:
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
 		return ST_SUCCESS;
 	}
 };
@@ -331,7 +337,7 @@ public:
 		return (obuf - ostart) / 2;
 	}
 
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
 		return ST_SUCCESS;
 	}
 };
@@ -339,10 +345,369 @@ public:
 
 #pragma mark -
 
+
+int32 sincDotProduct(const st_sample_t *samples, const int16 *coeffs, uint taps) {
+	int32 acc = 0;
+	for (uint i = 0; i < taps; i++)
+		acc += samples[i] * coeffs[i];
+	return acc;
+}
+
+SincDotProductFunc getSincDotProduct() {
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return sincDotProductSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return sincDotProductNEON;
+#endif
+	return sincDotProduct;
+}
+
+/**
+ * Number of fractional bits of the windowed-sinc filter coefficients. This
+ * leaves enough headroom for the 32-bit accumulator even with 32 taps.
+ */
+enum {
+	SINC_COEFF_BITS = 14
+};
+
+/**
+ * Coefficient table of a polyphase windowed-sinc filter.
+ *
+ * The table only depends on the filter quality and on the conversion ratio,
+ * so all converters with the same parameters share a single instance, see
+ * SincFilterCache.
+ */
+struct SincFilterTable {
+	RateConverterQuality quality;
+	st_rate_t inrate;
+	st_rate_t outrate;
+
+	uint taps;
+	uint phaseBits;
+
+	/** phases * taps coefficients, phase after phase */
+	int16 *coeffs;
+
+	int refCount;
+
+	SincFilterTable(RateConverterQuality q, st_rate_t in, st_rate_t out);
+	~SincFilterTable() { free(coeffs); }
+};
+
+SincFilterTable::SincFilterTable(RateConverterQuality q, st_rate_t in, st_rate_t out)
+	: quality(q), inrate(in), outrate(out), refCount(0) {
+	static const struct {
+		uint taps;
+		uint phaseBits;
+		double rolloff;
+	} params[] = {
+		{  8, 7, 0.85 },
+		{ 16, 8, 0.90 },
+		{ 32, 9, 0.95 }
+	};
+	assert(quality >= kRateConverterSincLow && quality <= kRateConverterSincHigh);
+
+	taps = params[quality - kRateConverterSincLow].taps;
+	phaseBits = params[quality - kRateConverterSincLow].phaseBits;
+
+	// The cut-off frequency, relative to the input Nyquist frequency. When
+	// downsampling it has to be lowered to the output Nyquist frequency.
+	double cutoff = params[quality - kRateConverterSincLow].rolloff;
+	if (outrate < inrate)
+		cutoff = cutoff * outrate / inrate;
+
+	const uint phases = 1 << phaseBits;
+	coeffs = (int16 *)malloc(phases * taps * sizeof(int16));
+	if (!coeffs)
+		error("[SincFilterTable::SincFilterTable] Cannot allocate memory for filter coefficients");
+
+	// The table is only computed once per ratio, so floating point is fine
+	// here. The conversion itself only uses integer arithmetic.
+	const int center = taps / 2 - 1;
+	const double halfWidth = taps / 2;
+	double h[32];
+	assert(taps <= ARRAYSIZE(h));
+
+	for (uint phase = 0; phase < phases; phase++) {
+		const double frac = (double)phase / phases;
+		double sum = 0;
+
+		for (uint k = 0; k < taps; k++) {
+			// Distance of this tap from the output position, in input samples
+			const double t = (int)k - center - frac;
+			const double x = M_PI * t * cutoff;
+			const double sinc = (x == 0) ? 1.0 : sin(x) / x;
+			// Blackman window
+			const double n = M_PI * t / halfWidth;
+			const double window = 0.42 + 0.5 * cos(n) + 0.08 * cos(2 * n);
+
+			h[k] = sinc * window;
+			sum += h[k];
+		}
+
+		// Normalize every phase to unity gain and make sure rounding does
+		// not change that, so a constant input stays constant.
+		int16 *c = coeffs + phase * taps;
+		int total = 0;
+		for (uint k = 0; k < taps; k++) {
+			c[k] = (int16)floor(h[k] / sum * (1 << SINC_COEFF_BITS) + 0.5);
+			total += c[k];
+		}
+		c[center + (frac >= 0.5 ? 1 : 0)] += (1 << SINC_COEFF_BITS) - total;
+	}
+}
+
+/**
+ * Keeps track of the SincFilterTable instances in use.
+ */
+class SincFilterCache : public Common::Singleton<SincFilterCache> {
+public:
+	SincFilterCache() {}
+	~SincFilterCache() {
+		for (uint i = 0; i < _tables.size(); i++)
+			delete _tables[i];
+	}
+
+	/**
+	 * Return the table for the given parameters, creating it if necessary.
+	 * Every call must be matched by a call to release().
+	 */
+	const SincFilterTable *acquire(RateConverterQuality quality, st_rate_t inrate, st_rate_t outrate) {
+		// Only the ratio matters, not the rates themselves
+		const st_rate_t gcd = Common::gcd(inrate, outrate);
+		inrate /= gcd;
+		outrate /= gcd;
+
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _tables.size(); i++) {
+			SincFilterTable *table = _tables[i];
+			if (table->quality == quality && table->inrate == inrate && table->outrate == outrate) {
+				table->refCount++;
+				return table;
+			}
+		}
+
+		SincFilterTable *table = new SincFilterTable(quality, inrate, outrate);
+		table->refCount++;
+		_tables.push_back(table);
+		return table;
+	}
+
+	void release(const SincFilterTable *table) {
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _tables.size(); i++) {
+			if (_tables[i] == table) {
+				if (--_tables[i]->refCount == 0) {
+					delete _tables[i];
+					_tables.remove_at(i);
+				}
+				return;
+			}
+		}
+	}
+
+private:
+	Common::Mutex _mutex;
+	Common::Array<SincFilterTable *> _tables;
+};
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter.
+ *
+ * This is considerably more expensive than linear interpolation, but does
+ * not suffer from its aliasing. The filter coefficients are precomputed in
+ * fixed point, and the input is kept in one contiguous buffer per channel,
+ * so the convolution can run through a vectorized dot product.
+ *
+ * The phase is tracked with 32 fractional bits, so there is no limit on
+ * the sampling frequencies other than the 32-bit range. The filter itself is
+ * only tabulated for 2^phaseBits phases, and the phase is truncated to the
+ * nearest table entry below rather than interpolated between two of them.
+ * That shifts each output sample by less than 1/128 (low quality) to 1/512
+ * (high quality) of an input sample, an error which grows with the signal
+ * frequency. Interpolating would cost a second dot product per sample.
+ *
+ * When the input stream ends, the second half of the filter is fed with
+ * silence, so the last input samples make it to the output as well.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	const SincFilterTable *_filter;
+	SincDotProductFunc _dotProduct;
+
+	/** deinterleaved input history (left/right channel) */
+	st_sample_t *_history[2];
+	/** size of each history buffer, in samples */
+	uint _historySize;
+	/** number of valid samples in the history buffers */
+	uint _avail;
+	/** position of the first filter tap in the history buffers */
+	uint _pos;
+	/** whether the silence after the end of the input has been added */
+	bool _flushed;
+
+	/** fractional part of the position in the input stream */
+	uint32 _frac;
+	/** position increment per output sample, integer and fractional part */
+	uint _intInc;
+	uint32 _fracInc;
+
+	bool refill(AudioStream *input);
+	int convert(AudioStream *input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+	st_sample_t convolve(const st_sample_t *samples, const int16 *coeffs) const {
+		const int32 acc = _dotProduct(samples, coeffs, _filter->taps);
+		return (st_sample_t)CLIP<int32>((acc + (1 << (SINC_COEFF_BITS - 1))) >> SINC_COEFF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality);
+	~SincRateConverter();
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convert(&input, obuf, osamp, vol_l, vol_r);
+	}
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
+		return convert(nullptr, obuf, osamp, vol_l, vol_r);
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
+	_filter = SincFilterCache::instance().acquire(quality, inrate, outrate);
+	_dotProduct = getSincDotProduct();
+
+	_historySize = _filter->taps + INTERMEDIATE_BUFFER_SIZE;
+	_history[0] = (st_sample_t *)calloc(_historySize, sizeof(st_sample_t));
+	_history[1] = stereo ? (st_sample_t *)calloc(_historySize, sizeof(st_sample_t)) : nullptr;
+	if (!_history[0] || (stereo && !_history[1]))
+		error("[SincRateConverter::SincRateConverter] Cannot allocate memory for history buffers");
+
+	// Start with silence in the first half of the filter, so that the first
+	// output sample lines up with the first input sample.
+	_avail = _filter->taps / 2 - 1;
+	_pos = 0;
+	_flushed = false;
+
+	const uint64 inc = ((uint64)inrate << 32) / outrate;
+	_intInc = (uint)(inc >> 32);
+	_fracInc = (uint32)inc;
+	_frac = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	free(_history[0]);
+	free(_history[1]);
+	SincFilterCache::instance().release(_filter);
+}
+
+/*
+ * Drop the consumed part of the history and append new input samples, or
+ * the trailing silence once the input stream has ended. Without an input
+ * stream, only the trailing silence is added. Return false if there is
+ * nothing more to add.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream *input) {
+	if (_pos >= _avail) {
+		_pos -= _avail;
+		_avail = 0;
+	} else if (_pos > 0) {
+		_avail -= _pos;
+		memmove(_history[0], _history[0] + _pos, _avail * sizeof(st_sample_t));
+		if (stereo)
+			memmove(_history[1], _history[1] + _pos, _avail * sizeof(st_sample_t));
+		_pos = 0;
+	}
+
+	const uint channels = stereo ? 2 : 1;
+	const uint space = MIN<uint>(_historySize - _avail, ARRAYSIZE(inBuf) / channels);
+	const int inLen = input ? input->readBuffer(inBuf, space * channels) : 0;
+	if (inLen <= 0) {
+		// A stream that merely ran dry may still get more data, so only
+		// flush the filter once it has really ended
+		if (_flushed || (input && !input->endOfStream()))
+			return false;
+
+		const uint tail = _filter->taps / 2;
+		memset(_history[0] + _avail, 0, tail * sizeof(st_sample_t));
+		if (stereo)
+			memset(_history[1] + _avail, 0, tail * sizeof(st_sample_t));
+		_avail += tail;
+		_flushed = true;
+		return true;
+	}
+
+	const st_sample_t *inPtr = inBuf;
+	st_sample_t *left = _history[0] + _avail;
+	st_sample_t *right = _history[1] + _avail;
+	for (int i = inLen / channels; i > 0; i--) {
+		*left++ = *inPtr++;
+		if (stereo)
+			*right++ = *inPtr++;
+	}
+
+	_avail += inLen / channels;
+	return true;
+}
+
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+int SincRateConverter<stereo, reverseStereo>::convert(AudioStream *input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const uint taps = _filter->taps;
+	const uint phaseShift = 32 - _filter->phaseBits;
+
+	while (obuf < oend) {
+		// make sure all filter taps are covered by input samples
+		while (_pos + taps > _avail) {
+			if (!refill(input))
+				return (obuf - ostart) / 2;
+		}
+
+		const int16 *coeffs = _filter->coeffs + (_frac >> phaseShift) * taps;
+
+		st_sample_t out0, out1;
+		out0 = convolve(_history[0] + _pos, coeffs);
+		out1 = (stereo ? convolve(_history[1] + _pos, coeffs) : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+
+		// Increment input position
+		const uint32 frac = _frac + _fracInc;
+		_pos += _intInc + (frac < _frac ? 1 : 0);
+		_frac = frac;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+#pragma mark -
+
+template<bool stereo, bool reverseStereo>
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (quality != kRateConverterDefault) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate, quality);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -355,14 +720,18 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterCache);
+}
@@ -51,6 +51,16 @@ enum {
 	ST_SUCCESS = 0
 };
 
+/**
+ * Resampling quality of the rate converters returned by makeRateConverter().
+ */
+enum RateConverterQuality {
+	kRateConverterDefault = 0,    ///< Copy, decimate or interpolate linearly, depending on the rates.
+	kRateConverterSincLow = 1,    ///< Polyphase windowed-sinc filter with 8 taps.
+	kRateConverterSincMedium = 2, ///< Polyphase windowed-sinc filter with 16 taps.
+	kRateConverterSincHigh = 3    ///< Polyphase windowed-sinc filter with 32 taps.
+};
+
 static inline void clampedAdd(int16& a, int b) {
 	int val;
 #ifdef OUTPUT_UNSIGNED_AUDIO
@@ -81,10 +91,16 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
-	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
+	/**
+	 * Output what the converter still holds after the input stream has
+	 * ended, e.g. the tail of a filter.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterQuality quality = kRateConverterDefault);
 /** @} */
 } // End of namespace Audio
 
@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_KERNELS_H
+#define AUDIO_RATE_KERNELS_H
+
+#include "common/scummsys.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_rate_kernels Rate converter kernels
+ * @ingroup audio
+ *
+ * @brief Inner loops of the windowed-sinc rate converter.
+ * @{
+ */
+
+/**
+ * Compute the dot product of a run of samples with a filter phase.
+ *
+ * @param samples samples of a single channel
+ * @param coeffs  filter coefficients
+ * @param taps    number of taps, must be a multiple of 8
+ */
+typedef int32 (*SincDotProductFunc)(const st_sample_t *samples, const int16 *coeffs, uint taps);
+
+int32 sincDotProduct(const st_sample_t *samples, const int16 *coeffs, uint taps);
+
+#ifdef SCUMMVM_SSE2
+int32 sincDotProductSSE2(const st_sample_t *samples, const int16 *coeffs, uint taps);
+#endif
+
+#ifdef SCUMMVM_NEON
+int32 sincDotProductNEON(const st_sample_t *samples, const int16 *coeffs, uint taps);
+#endif
+
+/**
+ * Select the fastest dot product supported by the CPU we are running on.
+ */
+SincDotProductFunc getSincDotProduct();
+
+/** @} */
+} // End of namespace Audio
+
+#endif
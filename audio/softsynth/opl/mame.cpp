@@ -67,15 +67,15 @@ void OPL::reset() {
 	MAME::OPLResetChip(_opl);
 }
 
-void OPL::write(int a, int v) {
+void OPL::writePort(int a, int v) {
 	MAME::OPLWrite(_opl, a, v);
 }
 
-byte OPL::read(int a) {
+byte OPL::readPort(int a) {
 	return MAME::OPLRead(_opl, a);
 }
 
-void OPL::writeReg(int r, int v) {
+void OPL::writeRegister(int r, int v) {
 	MAME::OPLWriteReg(_opl, r, v);
 }
 
@@ -183,15 +183,14 @@ public:
 	bool init();
 	void reset();
 
-	void write(int a, int v);
-	byte read(int a);
-
-	void writeReg(int r, int v);
-
 	bool isStereo() const { return false; }
 
 protected:
 	void generateSamples(int16 *buffer, int length);
+
+	void writePort(int a, int v);
+	byte readPort(int a);
+	void writeRegister(int r, int v);
 };
 
 } // End of namespace MAME
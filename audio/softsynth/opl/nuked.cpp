@@ -531,14 +531,10 @@ static void OPL3_EnvelopeKeyOff(opl3_slot *slot, Bit8u type)
 
 static void OPL3_PhaseGenerate(opl3_slot *slot)
 {
-    opl3_chip *chip;
     Bit16u f_num;
     Bit32u basefreq;
-    Bit8u rm_xor, n_bit;
-    Bit32u noise;
     Bit16u phase;
 
-    chip = slot->chip;
     f_num = slot->channel->f_num;
     if (slot->reg_vib)
     {
@@ -571,52 +567,76 @@ static void OPL3_PhaseGenerate(opl3_slot *slot)
         slot->pg_phase = 0;
     }
     slot->pg_phase += (basefreq * mt[slot->reg_mult]) >> 1;
-    // Rhythm mode
-    noise = chip->noise;
     slot->pg_phase_out = phase;
-    if (slot->slot_num == 13) // hh
-    {
-        chip->rm_hh_bit2 = (phase >> 2) & 1;
-        chip->rm_hh_bit3 = (phase >> 3) & 1;
-        chip->rm_hh_bit7 = (phase >> 7) & 1;
-        chip->rm_hh_bit8 = (phase >> 8) & 1;
-    }
-    if (slot->slot_num == 17 && (chip->rhy & 0x20)) // tc
-    {
-        chip->rm_tc_bit3 = (phase >> 3) & 1;
-        chip->rm_tc_bit5 = (phase >> 5) & 1;
-    }
+}
+
+//
+// Rhythm mode phase and noise generator.
+//
+// On the chip, the noise generator advances once per slot. Slots 13 (hh)
+// and 16 (sd) use the noise bit of their own step, and slot 13 sees the
+// top cymbal bits of the previous sample, since slot 17 comes after it.
+//
+
+static void OPL3_PhaseGenerateRhythm(opl3_chip *chip)
+{
+    Bit16u phase;
+    Bit8u rm_xor;
+    Bit32u noise;
+
+    noise = chip->noise;
+    phase = chip->slot[13].pg_phase_out;
+    chip->rm_hh_bit2 = (phase >> 2) & 1;
+    chip->rm_hh_bit3 = (phase >> 3) & 1;
+    chip->rm_hh_bit7 = (phase >> 7) & 1;
+    chip->rm_hh_bit8 = (phase >> 8) & 1;
+
     if (chip->rhy & 0x20)
     {
+        // hh
         rm_xor = (chip->rm_hh_bit2 ^ chip->rm_hh_bit7)
                | (chip->rm_hh_bit3 ^ chip->rm_tc_bit5)
                | (chip->rm_tc_bit3 ^ chip->rm_tc_bit5);
-        switch (slot->slot_num)
+        chip->slot[13].pg_phase_out = rm_xor << 9;
+        if (rm_xor ^ ((noise >> 13) & 1))
         {
-        case 13: // hh
-            slot->pg_phase_out = rm_xor << 9;
-            if (rm_xor ^ (noise & 1))
-            {
-                slot->pg_phase_out |= 0xd0;
-            }
-            else
-            {
-                slot->pg_phase_out |= 0x34;
-            }
-            break;
-        case 16: // sd
-            slot->pg_phase_out = (chip->rm_hh_bit8 << 9)
-                               | ((chip->rm_hh_bit8 ^ (noise & 1)) << 8);
-            break;
-        case 17: // tc
-            slot->pg_phase_out = (rm_xor << 9) | 0x80;
-            break;
-        default:
-            break;
+            chip->slot[13].pg_phase_out |= 0xd0;
+        }
+        else
+        {
+            chip->slot[13].pg_phase_out |= 0x34;
         }
+        // sd
+        chip->slot[16].pg_phase_out = (chip->rm_hh_bit8 << 9)
+                                    | ((chip->rm_hh_bit8 ^ ((noise >> 16) & 1)) << 8);
+        // tc
+        phase = chip->slot[17].pg_phase_out;
+        chip->rm_tc_bit3 = (phase >> 3) & 1;
+        chip->rm_tc_bit5 = (phase >> 5) & 1;
+        rm_xor = (chip->rm_hh_bit2 ^ chip->rm_hh_bit7)
+               | (chip->rm_hh_bit3 ^ chip->rm_tc_bit5)
+               | (chip->rm_tc_bit3 ^ chip->rm_tc_bit5);
+        chip->slot[17].pg_phase_out = (rm_xor << 9) | 0x80;
+    }
+}
+
+static void OPL3_NoiseGenerate(opl3_chip *chip)
+{
+    Bit32u noise;
+    Bit32u n_bits;
+    Bit8u steps;
+    Bit8u left;
+
+    // The 23 bit LFSR taps bits 0 and 14, so up to 8 steps can be done
+    // at once: none of the new bits reach bit 14 before the 9th step.
+    noise = chip->noise;
+    for (left = 36; left > 0; left -= steps)
+    {
+        steps = left < 8 ? left : 8;
+        n_bits = ((noise >> 14) ^ noise) & ((1 << steps) - 1);
+        noise = (noise >> steps) | (n_bits << (23 - steps));
     }
-    n_bit = ((noise >> 14) ^ noise) & 0x01;
-    chip->noise = (noise >> 1) | (n_bit << 22);
+    chip->noise = noise;
 }
 
 //
@@ -1069,11 +1089,24 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
 
     buf[1] = OPL3_ClipSample(chip->mixbuff[1]);
 
-    for (ii = 0; ii < 15; ii++)
+    // The envelope and phase generators of a slot don't depend on the
+    // output of any other slot, so they are run as separate passes over
+    // all 36 slots before the operators are evaluated in chip order.
+    for (ii = 0; ii < 36; ii++)
     {
-        OPL3_SlotCalcFB(&chip->slot[ii]);
         OPL3_EnvelopeCalc(&chip->slot[ii]);
+    }
+
+    for (ii = 0; ii < 36; ii++)
+    {
         OPL3_PhaseGenerate(&chip->slot[ii]);
+    }
+    OPL3_PhaseGenerateRhythm(chip);
+    OPL3_NoiseGenerate(chip);
+
+    for (ii = 0; ii < 15; ii++)
+    {
+        OPL3_SlotCalcFB(&chip->slot[ii]);
         OPL3_SlotGenerate(&chip->slot[ii]);
     }
 
@@ -1091,8 +1124,6 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
     for (ii = 15; ii < 18; ii++)
     {
         OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
         OPL3_SlotGenerate(&chip->slot[ii]);
     }
 
@@ -1101,8 +1132,6 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
     for (ii = 18; ii < 33; ii++)
     {
         OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
         OPL3_SlotGenerate(&chip->slot[ii]);
     }
 
@@ -1120,8 +1149,6 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
     for (ii = 33; ii < 36; ii++)
     {
         OPL3_SlotCalcFB(&chip->slot[ii]);
-        OPL3_EnvelopeCalc(&chip->slot[ii]);
-        OPL3_PhaseGenerate(&chip->slot[ii]);
         OPL3_SlotGenerate(&chip->slot[ii]);
     }
 
@@ -1421,7 +1448,7 @@ void OPL::reset() {
 	OPL3_Reset(&chip, _rate);
 }
 
-void OPL::write(int port, int val) {
+void OPL::writePort(int port, int val) {
 	if (port & 1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -1469,7 +1496,7 @@ void OPL::write(int port, int val) {
 }
 
 
-void OPL::writeReg(int r, int v) {
+void OPL::writeRegister(int r, int v) {
 	OPL3_WriteRegBuffered(&chip, (Bit16u)r, (Bit8u)v);
 }
 
@@ -1493,7 +1520,7 @@ void OPL::dualWrite(uint8 index, uint8 reg, uint8 val) {
 	OPL3_WriteRegBuffered(&chip, (Bit16u)fullReg, (Bit8u)val);
 }
 
-byte OPL::read(int port) {
+byte OPL::readPort(int port) {
 	return 0;
 }
 
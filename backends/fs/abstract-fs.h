@@ -172,6 +172,13 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Get the size and the modification time of the file referred by this
+	 * node, without opening it.
+	 *
+	 * @return true on success, false if not supported by the backend
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modTime) const { return false; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +189,16 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Like createReadStream(), but the backend may map the file into
+	 * memory. This is only meant for read-only data, such as game files
+	 * and archives: a mapped file which shrinks while the stream exists
+	 * crashes the process instead of causing a read error.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
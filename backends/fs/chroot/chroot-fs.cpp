@@ -95,6 +95,10 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::SeekableReadStream *ChRootFilesystemNode::createMappedReadStream() {
+	return _realNode->createMappedReadStream();
+}
+
 Common::SeekableWriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
@@ -61,6 +61,8 @@ public:
 
 	// AbstractFSNode API
 	Common::SeekableReadStream *createReadStream() override;
+	// The drives use their own stream configuration
+	Common::SeekableReadStream *createMappedReadStream() override { return createReadStream(); }
 	Common::SeekableWriteStream *createWriteStream() override;
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
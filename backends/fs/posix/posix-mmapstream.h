@@ -0,0 +1,69 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+#ifdef HAS_MMAP
+
+/**
+ * A read stream for a file mapped into memory with mmap().
+ *
+ * Reading does not need any system calls or copies into a stdio buffer, and
+ * getView() gives direct access to the file data in the page cache.
+ *
+ * @note The file must not be truncated while the stream exists, since
+ * accessing the pages past its new end raises SIGBUS.
+ */
+class PosixMmapStream final : public Common::MemoryReadStream {
+public:
+	enum {
+		/**
+		 * Smaller files are read with stdio instead, since mapping them
+		 * costs more than it saves.
+		 */
+		kMinMapSize = 64 * 1024
+	};
+
+	/**
+	 * Map the regular file at @p path into memory.
+	 *
+	 * @return The stream, or nullptr if the file can not be mapped, in which
+	 *         case it should be opened with PosixIoStream instead.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	~PosixMmapStream() override;
+
+private:
+	PosixMmapStream(void *data, uint32 size);
+
+	void *_data;
+	uint32 _mapSize;
+};
+
+#endif // HAS_MMAP
+
+#endif
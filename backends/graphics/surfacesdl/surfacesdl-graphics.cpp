@@ -136,7 +136,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false) {
+	_scalerPool(nullptr), _needRestoreAfterOverlay(false) {
 
 	// allocate palette storage
 	_currentPalette = (SDL_Color *)calloc(sizeof(SDL_Color), 256);
@@ -159,6 +159,19 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_scaler = nullptr;
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
 
+	// By default use all but one of the CPU cores for scaling, at most four
+	// of them, since the scalers are bound by memory bandwidth beyond that.
+	int scalerThreads = Common::WorkerPool::getDefaultNumWorkers(4);
+	if (ConfMan.hasKey("scaler_threads"))
+		scalerThreads = ConfMan.getInt("scaler_threads");
+	if (scalerThreads > 0) {
+		_scalerPool = new Common::WorkerPool(scalerThreads, "ScummVM scaler");
+		if (!_scalerPool->getNumWorkers()) {
+			delete _scalerPool;
+			_scalerPool = nullptr;
+		}
+	}
+
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
 	_videoMode.filtering = ConfMan.getBool("filtering");
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -171,6 +184,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
+	delete _scalerPool;
 	delete _scaler;
 	if (_mouseOrigSurface) {
 		SDL_FreeSurface(_mouseOrigSurface);
@@ -1074,6 +1088,22 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	internUpdateScreen();
 }
 
+// Smaller bands are not worth waking up a thread for. This also keeps the
+// bands tall enough for scalers which need a minimum height.
+static const int kMinScalerBandHeight = 32;
+
+void SurfaceSdlGraphicsManager::scaleRect(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int x, int y) {
+	const uint maxBands = _scalerPool ? _scalerPool->getNumWorkers() + 1 : 1;
+	const uint count = MIN<uint>(maxBands, height / kMinScalerBandHeight);
+
+	if (count < 2 || !_scalerPlugin->get<ScalerPluginObject>().canScaleInBands(_videoMode.scaleFactor)) {
+		_scaler->scale(src, srcPitch, dst, dstPitch, width, height, x, y);
+		return;
+	}
+
+	_scaler->scaleInBands(*_scalerPool, count, src, srcPitch, dst, dstPitch, width, height, x, y);
+}
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1227,7 +1257,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayVisible)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (r->x + _maxExtraPixels) * 2 + (r->y + _maxExtraPixels) * srcPitch, srcPitch,
+				scaleRect((byte *)srcSurf->pixels + (r->x + _maxExtraPixels) * 2 + (r->y + _maxExtraPixels) * srcPitch, srcPitch,
 					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h, r->x, r->y);
 			}
 
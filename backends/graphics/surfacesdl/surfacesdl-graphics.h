@@ -29,6 +29,7 @@
 #include "graphics/scalerplugin.h"
 #include "common/events.h"
 #include "common/mutex.h"
+#include "common/thread.h"
 
 #include "backends/events/sdl/sdl-events.h"
 
@@ -328,6 +329,9 @@ protected:
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
+	/** Threads for scaling large dirty rects in bands, or nullptr if disabled */
+	Common::WorkerPool *_scalerPool;
+
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
 
@@ -411,6 +415,13 @@ protected:
 
 	virtual void internUpdateScreen();
 
+	/**
+	 * Scale a rect of srcSurf into _hwScreen. Tall rects are split into
+	 * horizontal bands which are scaled in parallel on _scalerPool, unless
+	 * the scaler plugin does not give the same result that way.
+	 */
+	void scaleRect(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int x, int y);
+
 	virtual bool loadGFXMode();
 	virtual void unloadGFXMode();
 	virtual bool hotswapGFXMode();
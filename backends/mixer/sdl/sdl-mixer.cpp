@@ -28,6 +28,7 @@
 #include "common/system.h"
 #include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 #if defined(GP2X)
 #define SAMPLES_PER_SEC 11025
@@ -112,6 +113,12 @@ void SdlMixerManager::init() {
 
 	_mixer = new Audio::MixerImpl(_obtained.freq, desired.samples);
 	assert(_mixer);
+	if (ConfMan.hasKey("mixer_accumulate", Common::ConfigManager::kApplicationDomain))
+		_mixer->setAccumulateMode(ConfMan.getBool("mixer_accumulate", Common::ConfigManager::kApplicationDomain));
+	if (ConfMan.hasKey("resampling_quality", Common::ConfigManager::kApplicationDomain)) {
+		int quality = ConfMan.getInt("resampling_quality", Common::ConfigManager::kApplicationDomain);
+		_mixer->setRateConverterQuality((Audio::RateConverterQuality)CLIP<int>(quality, Audio::kRateConverterDefault, Audio::kRateConverterSincHigh));
+	}
 	_mixer->setReady(true);
 
 	startAudio();
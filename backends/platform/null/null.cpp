@@ -49,14 +49,18 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#ifdef POSIX
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mixer/null/null-mixer.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
-#include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -84,7 +88,12 @@ public:
 
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual bool hasFeature(Feature f);
+
 	virtual Common::MutexInternal *createMutex();
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data, const char *name);
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue);
+	virtual uint getCPUCount();
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -95,6 +104,10 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	void initMixerForTest();
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -117,11 +130,26 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Tests do not call initBackend(), but some code asks for the screen
+	// format, e.g. the video decoders
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+void OSystem_NULL::initMixerForTest() {
+	// Some code asks for the output rate, e.g. the OPL emulators. The mixer
+	// is never run.
+	_mixerManager = new NullMixerManager();
+	_mixerManager->init();
+}
+#endif
+
 #if defined(POSIX) && !defined(NULL_DRIVER_USE_FOR_TEST)
 static volatile bool intReceived = false;
 
@@ -184,8 +212,69 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 	return false;
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+	// There is no runtime CPU detection here, so only report what the
+	// compiler already assumes for the target.
+	if (f == kFeatureCpuSSE2) {
+#if defined(__SSE2__)
+		return true;
+#else
+		return false;
+#endif
+	}
+	if (f == kFeatureCpuNEON) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		return true;
+#else
+		return false;
+#endif
+	}
+	if (f == kFeatureCpuAVX2) {
+#if defined(__AVX2__)
+		return true;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		// AVX2 is rarely enabled at compile time, so ask the compiler
+		// runtime instead.
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+	return ModularGraphicsBackend::hasFeature(f);
+}
+
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef POSIX
+	// Real threads need real locks
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+Common::ThreadInternal *OSystem_NULL::createThread(Common::ThreadProc proc, void *data, const char *name) {
+#ifdef POSIX
+	return createPthreadThreadInternal(proc, data, name);
+#else
+	return nullptr;
+#endif
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore(uint initialValue) {
+#ifdef POSIX
+	return createPthreadSemaphoreInternal(initialValue);
+#else
+	return nullptr;
+#endif
+}
+
+uint OSystem_NULL::getCPUCount() {
+#if defined(POSIX) && defined(_SC_NPROCESSORS_ONLN)
+	const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cpus > 1)
+		return cpus;
+#endif
+	return 1;
 }
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
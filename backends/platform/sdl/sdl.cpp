@@ -44,6 +44,7 @@
 #include "backends/events/sdl/legacy-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -180,6 +181,13 @@ bool OSystem_SDL::hasFeature(Feature f) {
 	if (f == kFeatureJoystickDeadzone || f == kFeatureKbdMouseSpeed) {
 		return _eventSource->isJoystickConnected();
 	}
+	if (f == kFeatureCpuSSE2) return SDL_HasSSE2();
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	if (f == kFeatureCpuNEON) return SDL_HasNEON();
+#endif
+#if SDL_VERSION_ATLEAST(2, 0, 2)
+	if (f == kFeatureCpuAVX2) return SDL_HasAVX2();
+#endif
 	return ModularGraphicsBackend::hasFeature(f);
 }
 
@@ -646,6 +654,22 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(Common::ThreadProc proc, void *data, const char *name) {
+	return createSdlThreadInternal(proc, data, name);
+}
+
+Common::SemaphoreInternal *OSystem_SDL::createSemaphore(uint initialValue) {
+	return createSdlSemaphoreInternal(initialValue);
+}
+
+uint OSystem_SDL::getCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	return 1;
+#endif
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
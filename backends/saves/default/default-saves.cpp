@@ -35,12 +35,14 @@
 #if !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
 
 #include "backends/saves/default/default-saves.h"
+#include "backends/saves/default/default-savewriter.h"
 
 #include "common/savefile.h"
 #include "common/util.h"
 #include "common/fs.h"
 #include "common/archive.h"
 #include "common/config-manager.h"
+#include "common/memstream.h"
 #include "common/zlib.h"
 
 #include <errno.h>	// for removeSavefile()
@@ -49,13 +51,75 @@
 const char *DefaultSaveFileManager::TIMESTAMPS_FILENAME = "timestamps";
 #endif
 
-DefaultSaveFileManager::DefaultSaveFileManager() {
+/**
+ * A save file which collects its data in memory and passes it on to a
+ * DefaultSaveWriter when it is finalized or deleted.
+ */
+class AsyncOutSaveFile : public Common::OutSaveFile {
+public:
+	AsyncOutSaveFile(DefaultSaveWriter *writer, const Common::String &filename, Common::SeekableWriteStream *stream, SaveCompression compression) :
+		OutSaveFile(new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO)),
+		_writer(writer), _filename(filename), _stream(stream), _compression(compression) {}
+
+	~AsyncOutSaveFile() override {
+		submit();
+	}
+
+	void finalize() override {
+		submit();
+	}
+
+	// Behave like a synchronous save file, which can not seek in compressed data
+	bool seek(int64 offset, int whence) override {
+		if (_compression != kSaveUncompressed) {
+			warning("Seeking isn't supported for compressed save files");
+			return false;
+		}
+		return OutSaveFile::seek(offset, whence);
+	}
+
+	int64 size() const override {
+		if (_compression != kSaveUncompressed) {
+			warning("Size isn't supported for compressed save files");
+			return -1;
+		}
+		return OutSaveFile::size();
+	}
+
+private:
+	void submit() {
+		if (!_stream)
+			return;
+
+		Common::MemoryWriteStreamDynamic *buffer = (Common::MemoryWriteStreamDynamic *)_wrapped;
+		DefaultSaveWriter::Job *job = new DefaultSaveWriter::Job();
+		job->filename = _filename;
+		job->data = buffer->getData();
+		job->size = buffer->size();
+		job->stream = _stream;
+		job->compression = _compression;
+		_stream = nullptr;
+
+		_writer->submit(job);
+	}
+
+	DefaultSaveWriter *_writer;
+	Common::String _filename;
+	Common::SeekableWriteStream *_stream;
+	SaveCompression _compression;
+};
+
+DefaultSaveFileManager::DefaultSaveFileManager() : _asyncSaveLevel(0), _saveWriter(nullptr) {
 }
 
-DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) {
+DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) : _asyncSaveLevel(0), _saveWriter(nullptr) {
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+	delete _saveWriter;
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -97,6 +161,8 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &filename) {
+	waitForAsyncSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -113,6 +179,8 @@ Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &fi
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	waitForAsyncSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -135,6 +203,9 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 }
 
 Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+	// Do not write the same file from two threads
+	waitForAsyncSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	const Common::String savePathName = getSavePath();
 	assureCached(savePathName);
@@ -170,7 +241,20 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	Common::SeekableWriteStream *const sf = fileNode.createWriteStream();
 	if (!sf)
 		return nullptr;
-	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf) : sf);
+	// Saves in the LZ4 container are faster to write and to list, but can
+	// not be loaded by older versions
+	SaveCompression compression = kSaveUncompressed;
+	if (compress)
+		compression = ConfMan.get("save_compression") == "lz4" ? kSaveLZ4 : kSaveGZip;
+
+	Common::OutSaveFile *result;
+	if (_asyncSaveLevel > 0) {
+		if (!_saveWriter)
+			_saveWriter = new DefaultSaveWriter();
+		result = new AsyncOutSaveFile(_saveWriter, filename, sf, compression);
+	} else {
+		result = new Common::OutSaveFile(wrapSaveStream(sf, compression));
+	}
 
 	// Add file to cache now that it exists.
 	_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
@@ -179,6 +263,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	waitForAsyncSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -213,6 +299,32 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 }
 
+void DefaultSaveFileManager::beginAsyncSaves() {
+	_asyncSaveLevel++;
+}
+
+void DefaultSaveFileManager::endAsyncSaves() {
+	assert(_asyncSaveLevel > 0);
+	_asyncSaveLevel--;
+}
+
+bool DefaultSaveFileManager::pollAsyncSave(Common::String &filename, Common::Error &error) {
+	if (!_saveWriter || !_saveWriter->poll(filename, error))
+		return false;
+
+#if defined(USE_CLOUD) && defined(USE_LIBCURL)
+	// OutSaveFile::finalize() does this for synchronous saves
+	if (error.getCode() == Common::kNoError)
+		CloudMan.syncSaves();
+#endif
+	return true;
+}
+
+void DefaultSaveFileManager::waitForAsyncSaves() {
+	if (_saveWriter)
+		_saveWriter->wait();
+}
+
 Common::ErrorCode DefaultSaveFileManager::removeFile(const Common::String &filepath) {
 	if (remove(filepath.c_str()) == 0)
 		return Common::kNoError;
@@ -237,6 +349,21 @@ bool DefaultSaveFileManager::exists(const Common::String &filename) {
 	return _saveFileCache.contains(filename);
 }
 
+bool DefaultSaveFileManager::getSavefileStats(const Common::String &filename, int64 &size, int64 &modTime) {
+	// The file is only complete once it has been written
+	waitForAsyncSaves();
+
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return false;
+	return file->_value.getFileStats(size, modTime);
+}
+
 Common::String DefaultSaveFileManager::getSavePath() const {
 
 	Common::String dir;
@@ -29,6 +29,8 @@
 #include "common/hash-str.h"
 #include <limits.h>
 
+class DefaultSaveWriter;
+
 /**
  * Provides a default savefile manager implementation for common platforms.
  */
@@ -36,6 +38,7 @@ class DefaultSaveFileManager : public Common::SaveFileManager {
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::String &defaultSavepath);
+	~DefaultSaveFileManager() override;
 
 	void updateSavefilesList(Common::StringArray &lockedFiles) override;
 	Common::StringArray listSavefiles(const Common::String &pattern) override;
@@ -44,6 +47,12 @@ public:
 	Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true) override;
 	bool removeSavefile(const Common::String &filename) override;
 	bool exists(const Common::String &filename) override;
+	bool getSavefileStats(const Common::String &filename, int64 &size, int64 &modTime) override;
+
+	void beginAsyncSaves() override;
+	void endAsyncSaves() override;
+	bool pollAsyncSave(Common::String &filename, Common::Error &error) override;
+	void waitForAsyncSaves() override;
 
 #ifdef USE_LIBCURL
 
@@ -105,6 +114,17 @@ private:
 	 * The currently cached directory.
 	 */
 	Common::String _cachedDirectory;
+
+	/**
+	 * Number of beginAsyncSaves() calls without a matching endAsyncSaves().
+	 */
+	uint _asyncSaveLevel;
+
+	/**
+	 * Writes the save files opened while _asyncSaveLevel is non-zero.
+	 * Created on first use.
+	 */
+	DefaultSaveWriter *_saveWriter;
 };
 
 #endif
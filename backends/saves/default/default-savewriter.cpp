@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "backends/saves/default/default-savewriter.h"
+
+#include "common/lz4.h"
+#include "common/zlib.h"
+
+Common::WriteStream *wrapSaveStream(Common::WriteStream *stream, SaveCompression compression) {
+	switch (compression) {
+	case kSaveGZip:
+		return Common::wrapCompressedWriteStream(stream);
+	case kSaveLZ4:
+		return Common::wrapLZ4WriteStream(stream);
+	default:
+		return stream;
+	}
+}
+
+#pragma mark -
+
+DefaultSaveWriter::DefaultSaveWriter() : _pending(0), _waiters(0), _quit(false) {
+}
+
+DefaultSaveWriter::~DefaultSaveWriter() {
+	wait();
+	_quit = true;
+	_wake.post();
+	_thread.join();
+
+	for (Common::List<Job *>::iterator i = _finished.begin(); i != _finished.end(); ++i)
+		delete *i;
+}
+
+void DefaultSaveWriter::submit(Job *job) {
+	if (!_thread.isRunning() && !_thread.start(threadProc, this, "SaveWriter")) {
+		writeJob(job);
+		Common::StackLock lock(_mutex);
+		_finished.push_back(job);
+		return;
+	}
+
+	{
+		Common::StackLock lock(_mutex);
+		_queue.push_back(job);
+		_pending++;
+	}
+	_wake.post();
+}
+
+void DefaultSaveWriter::wait() {
+	while (true) {
+		{
+			Common::StackLock lock(_mutex);
+			if (_pending == 0)
+				return;
+			_waiters++;
+		}
+		// The worker posts once for every waiter when the queue runs dry.
+		// Jobs submitted meanwhile are caught by checking _pending again.
+		_jobDone.wait();
+	}
+}
+
+bool DefaultSaveWriter::poll(Common::String &filename, Common::Error &error) {
+	Common::StackLock lock(_mutex);
+	if (_finished.empty())
+		return false;
+
+	Job *job = _finished.front();
+	_finished.pop_front();
+	filename = job->filename;
+	error = job->result;
+	delete job;
+	return true;
+}
+
+void DefaultSaveWriter::writeJob(Job *job) {
+	Common::WriteStream *out = wrapSaveStream(job->stream, job->compression);
+	job->stream = nullptr;
+
+	out->write(job->data, job->size);
+	out->finalize();
+	job->result = out->err() ? Common::kWritingFailed : Common::kNoError;
+	delete out;
+
+	free(job->data);
+	job->data = nullptr;
+}
+
+void DefaultSaveWriter::threadProc(void *data) {
+	DefaultSaveWriter *writer = (DefaultSaveWriter *)data;
+
+	while (true) {
+		// submit() posts once per job, the destructor once more to quit
+		writer->_wake.wait();
+		if (writer->_quit)
+			return;
+
+		Job *job;
+		{
+			Common::StackLock lock(writer->_mutex);
+			if (writer->_queue.empty())
+				continue;
+			job = writer->_queue.front();
+			writer->_queue.pop_front();
+		}
+
+		writeJob(job);
+
+		uint wakeups = 0;
+		{
+			Common::StackLock lock(writer->_mutex);
+			writer->_finished.push_back(job);
+			writer->_pending--;
+			if (writer->_pending == 0) {
+				wakeups = writer->_waiters;
+				writer->_waiters = 0;
+			}
+		}
+		while (wakeups--)
+			writer->_jobDone.post();
+	}
+}
@@ -0,0 +1,94 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKEND_SAVES_DEFAULT_SAVEWRITER_H
+#define BACKEND_SAVES_DEFAULT_SAVEWRITER_H
+
+#include "common/error.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/stream.h"
+#include "common/str.h"
+#include "common/thread.h"
+
+#include <atomic>
+
+enum SaveCompression {
+	kSaveUncompressed,
+	kSaveGZip,
+	kSaveLZ4
+};
+
+/**
+ * Wrap a save file stream so that data written to it is compressed
+ * with the given method. The returned stream takes ownership of the
+ * wrapped one.
+ */
+Common::WriteStream *wrapSaveStream(Common::WriteStream *stream, SaveCompression compression);
+
+/**
+ * Compresses save files and writes them to disk on a background thread.
+ * Jobs are written in the order they were submitted. If the backend does
+ * not support threads, they are written right away by submit().
+ */
+class DefaultSaveWriter {
+public:
+	struct Job {
+		Common::String filename;
+		byte *data;
+		uint32 size;
+		Common::SeekableWriteStream *stream;
+		SaveCompression compression;
+		Common::Error result;
+	};
+
+	DefaultSaveWriter();
+	~DefaultSaveWriter();
+
+	/** Queue a job for writing. The writer takes ownership of it. */
+	void submit(Job *job);
+
+	/** Block until all submitted jobs have been written. */
+	void wait();
+
+	/**
+	 * Fetch the result of the oldest finished job which has not been
+	 * reported yet. Returns false if there is none.
+	 */
+	bool poll(Common::String &filename, Common::Error &error);
+
+private:
+	static void writeJob(Job *job);
+	static void threadProc(void *data);
+
+	Common::Thread _thread;
+	Common::Semaphore _wake;
+	Common::Semaphore _jobDone;
+	Common::Mutex _mutex;
+	Common::List<Job *> _queue;
+	Common::List<Job *> _finished;
+	uint _pending;
+	/** Number of threads blocked in wait(), guarded by _mutex. */
+	uint _waiters;
+	std::atomic<bool> _quit;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX)
+
+#include "backends/threads/pthread/pthread-threads.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <sys/time.h>
+#include <errno.h>
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data), _running(false) {}
+	~PthreadThreadInternal() override { join(); }
+
+	bool start() {
+		_running = (pthread_create(&_thread, nullptr, threadProc, this) == 0);
+		return _running;
+	}
+
+	void join() override {
+		if (_running) {
+			pthread_join(_thread, nullptr);
+			_running = false;
+		}
+	}
+
+private:
+	static void *threadProc(void *data) {
+		PthreadThreadInternal *thread = (PthreadThreadInternal *)data;
+		thread->_proc(thread->_data);
+		return nullptr;
+	}
+
+	Common::ThreadProc _proc;
+	void *_data;
+	pthread_t _thread;
+	bool _running;
+};
+
+/**
+ * Counting semaphore built on a mutex and a condition variable, since
+ * unnamed POSIX semaphores are not available everywhere.
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal(uint initialValue) : _value(initialValue) {
+		pthread_mutex_init(&_mutex, nullptr);
+		pthread_cond_init(&_cond, nullptr);
+	}
+
+	~PthreadSemaphoreInternal() override {
+		pthread_cond_destroy(&_cond);
+		pthread_mutex_destroy(&_mutex);
+	}
+
+	void post() override {
+		pthread_mutex_lock(&_mutex);
+		_value++;
+		pthread_cond_signal(&_cond);
+		pthread_mutex_unlock(&_mutex);
+	}
+
+	bool wait(uint msecs) override {
+		if (msecs == kWaitForever) {
+			pthread_mutex_lock(&_mutex);
+			while (_value == 0)
+				pthread_cond_wait(&_cond, &_mutex);
+			_value--;
+			pthread_mutex_unlock(&_mutex);
+			return true;
+		}
+
+		timeval now;
+		gettimeofday(&now, nullptr);
+
+		timespec timeout;
+		uint64 nsecs = (uint64)now.tv_usec * 1000 + (uint64)msecs * 1000000;
+		timeout.tv_sec = now.tv_sec + nsecs / 1000000000;
+		timeout.tv_nsec = nsecs % 1000000000;
+
+		pthread_mutex_lock(&_mutex);
+		int result = 0;
+		while (_value == 0 && result != ETIMEDOUT)
+			result = pthread_cond_timedwait(&_cond, &_mutex, &timeout);
+
+		const bool acquired = (_value != 0);
+		if (acquired)
+			_value--;
+		pthread_mutex_unlock(&_mutex);
+
+		return acquired;
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _value;
+};
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data, const char *name) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, data);
+	if (!thread->start()) {
+		warning("Failed to create thread '%s'", name);
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal(uint initialValue) {
+	return new PthreadSemaphoreInternal(initialValue);
+}
+
+#endif
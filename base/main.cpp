@@ -30,6 +30,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/detectioncache.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -736,6 +737,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #ifdef USE_FREETYPE2
 	Graphics::shutdownTTF();
 #endif
+	DetectionCache::destroy();
 	EngineManager::destroy();
 	Graphics::YUVToRGBManager::destroy();
 
@@ -33,6 +33,7 @@
 #include "base/detection/detection.h"
 
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 
 // Plugin versioning
 
@@ -744,6 +745,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) {
 		}
 	}
 
+	// Save the MD5s computed so far every now and then
+	DetectionCacheMan.flush();
+
 	return DetectionResults(candidates);
 }
 
@@ -27,11 +27,27 @@
 #include "common/util.h"
 #include "common/mutex.h"
 
+/**
+ * Enable the following define to take the reference counts of Strings from
+ * the process-wide small object allocator, instead of a MemoryPool guarded
+ * by a Mutex. Strings can then be copied on any thread without taking a
+ * lock, but the allocator relies on thread_local and std::atomic.
+ */
+//#define USE_STRING_SMALL_OBJECT_POOL
+
+#ifdef USE_STRING_SMALL_OBJECT_POOL
+#include "common/smallalloc.h"
+#endif
+
 namespace Common {
 
 #define TEMPLATE template<class T>
 #define BASESTRING BaseString<T>
 
+#ifdef USE_STRING_SMALL_OBJECT_POOL
+TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
+}
+#else
 MemoryPool *g_refCountPool = nullptr; // FIXME: This is never freed right now
 #ifndef SCUMMVM_UTIL
 Mutex *g_refCountPoolMutex = nullptr;
@@ -60,6 +76,7 @@ TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
 	}
 }
 
+#endif
 #endif
 
 static uint32 computeCapacity(uint32 len) {
@@ -181,6 +198,11 @@ TEMPLATE
 void BASESTRING::incRefCount() const {
 	assert(!isStorageIntern());
 	if (_extern._refCount == nullptr) {
+#ifdef USE_STRING_SMALL_OBJECT_POOL
+		// The small object allocator can be used from any thread, and
+		// before g_system is set up
+		_extern._refCount = (int *)allocSmallObject(sizeof(int));
+#else
 #ifndef SCUMMVM_UTIL
 		lockMemoryPoolMutex();
 #endif
@@ -192,6 +214,7 @@ void BASESTRING::incRefCount() const {
 		_extern._refCount = (int *)g_refCountPool->allocChunk();
 #ifndef SCUMMVM_UTIL
 		unlockMemoryPoolMutex();
+#endif
 #endif
 		*_extern._refCount = 2;
 	} else {
@@ -211,6 +234,9 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 		// The ref count reached zero, so we free the string storage
 		// and the ref count storage.
 		if (oldRefCount) {
+#ifdef USE_STRING_SMALL_OBJECT_POOL
+			freeSmallObject(oldRefCount, sizeof(int));
+#else
 #ifndef SCUMMVM_UTIL
 			lockMemoryPoolMutex();
 #endif
@@ -218,6 +244,7 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 			g_refCountPool->freeChunk(oldRefCount);
 #ifndef SCUMMVM_UTIL
 			unlockMemoryPoolMutex();
+#endif
 #endif
 		}
 		// Coverity thinks that we always free memory, as it assumes
@@ -0,0 +1,713 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+
+#if defined(SCUMMVM_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define FLATHASHMAP_USE_SSE2
+#elif defined(SCUMMVM_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FLATHASHMAP_USE_NEON
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table with inline storage.
+ *
+ * @{
+ */
+
+/**
+ * Control bytes of a FlatHashMap. Each slot of the table has one, which
+ * holds 7 bits of the hash of the key in the slot, or one of the special
+ * values below. Lookups compare a group of 16 of them at once.
+ */
+class FlatHashMapGroup {
+public:
+	enum {
+		kSize = 16,
+		kEmpty = -128,
+		kDeleted = -2
+	};
+
+	explicit FlatHashMapGroup(const int8 *ctrl) {
+#if defined(FLATHASHMAP_USE_SSE2)
+		_ctrl = _mm_loadu_si128((const __m128i *)ctrl);
+#elif defined(FLATHASHMAP_USE_NEON)
+		_ctrl = vld1q_s8(ctrl);
+#else
+		_ctrl = ctrl;
+#endif
+	}
+
+	/** Bit mask of the slots whose control byte is @p h2. */
+	uint32 match(int8 h2) const {
+#if defined(FLATHASHMAP_USE_SSE2)
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2)));
+#elif defined(FLATHASHMAP_USE_NEON)
+		return toMask(vceqq_s8(_ctrl, vdupq_n_s8(h2)));
+#else
+		uint32 mask = 0;
+		for (int i = 0; i < kSize; ++i)
+			mask |= (uint32)(_ctrl[i] == h2) << i;
+		return mask;
+#endif
+	}
+
+	/** Bit mask of the empty slots. */
+	uint32 matchEmpty() const {
+		return match(kEmpty);
+	}
+
+	/** Bit mask of the empty and the deleted slots. */
+	uint32 matchEmptyOrDeleted() const {
+#if defined(FLATHASHMAP_USE_SSE2)
+		return _mm_movemask_epi8(_ctrl);
+#elif defined(FLATHASHMAP_USE_NEON)
+		return toMask(vcltq_s8(_ctrl, vdupq_n_s8(0)));
+#else
+		uint32 mask = 0;
+		for (int i = 0; i < kSize; ++i)
+			mask |= (uint32)(_ctrl[i] < 0) << i;
+		return mask;
+#endif
+	}
+
+	/** Index of the lowest bit set in a non-zero mask. */
+	static uint lowestBit(uint32 mask) {
+#if defined(__GNUC__)
+		return __builtin_ctz(mask);
+#else
+		uint bit = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+private:
+#if defined(FLATHASHMAP_USE_SSE2)
+	__m128i _ctrl;
+#elif defined(FLATHASHMAP_USE_NEON)
+	int8x16_t _ctrl;
+
+	static uint32 toMask(uint8x16_t cmp) {
+		static const uint8 kBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x16_t bits = vandq_u8(cmp, vld1q_u8(kBits));
+		uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+		sum = vpadd_u8(sum, sum);
+		sum = vpadd_u8(sum, sum);
+		return vget_lane_u8(sum, 0) | (vget_lane_u8(sum, 1) << 8);
+	}
+#else
+	const int8 *_ctrl;
+#endif
+};
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * stores the keys and values in the table itself instead of in separately
+ * allocated nodes. Lookups therefore do not need to follow a pointer for
+ * every slot they look at, and only compare keys whose control byte matches
+ * the hash of the key looked for.
+ *
+ * It uses the same hash and equality functors as HashMap and has the same
+ * interface, except that inserting into the map (including operator[] for
+ * a new key) may move the other entries: references and iterators to them
+ * are invalidated, just like with Array. Erasing does not move anything, so
+ * erasing the entries while iterating over the map works as with HashMap.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = FlatHashMapGroup::kSize,
+
+		// The table is grown when more than 7/8 of it are in use,
+		// counting deleted slots
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	int8 *_ctrl;       ///< Control bytes, one per slot
+	Node *_slots;      ///< Uninitialized storage for _capacity nodes
+	size_type _capacity; ///< Zero or a power of two, at least FLATHASHMAP_MIN_CAPACITY
+	size_type _size;
+	size_type _deleted;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Spread the bits of the hash, many of the Hash functors return the key
+	 * itself. The top 7 bits become the control byte, the low bits select
+	 * the group the probing starts at, so every bit of the key has to reach
+	 * both ends. This is the finalizer of MurmurHash3.
+	 */
+	static uint32 mixHash(uint hash) {
+		uint32 h = (uint32)hash;
+		h ^= h >> 16;
+		h *= 0x85EBCA6BU;
+		h ^= h >> 13;
+		h *= 0xC2B2AE35U;
+		h ^= h >> 16;
+		return h;
+	}
+
+	static int8 h2(uint32 hash) {
+		return (int8)(hash >> 25);
+	}
+
+	size_type numGroups() const {
+		return _capacity / FlatHashMapGroup::kSize;
+	}
+
+	bool isFull(size_type idx) const {
+		return _ctrl[idx] >= 0;
+	}
+
+	void assign(const FHM_t &map);
+	void destroyAll();
+	void allocate(size_type capacity);
+	size_type lookup(const Key &key) const;
+	size_type findFreeSlot(uint32 hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->_capacity);
+			assert(_hashmap->isFull(_idx));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx < _hashmap->_capacity && !_hashmap->isFull(_idx));
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		destroyAll();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	/**
+	 * Make room for @p count entries, so that inserting them does not
+	 * grow the table several times.
+	 */
+	void reserve(size_type count);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+			if (isFull(ctr))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator(_capacity, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+			if (isFull(ctr))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator(_capacity, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap. No memory is allocated until
+ * the first entry is added.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() :
+	_defaultVal(), _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _deleted(0) {
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) :
+	_defaultVal(), _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _deleted(0) {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	destroyAll();
+}
+
+/**
+ * Internal method for destroying all entries and freeing the table.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::destroyAll() {
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (isFull(ctr))
+			_slots[ctr].~Node();
+	}
+
+	delete[] _ctrl;
+	free(_slots);
+	_ctrl = nullptr;
+	_slots = nullptr;
+	_capacity = 0;
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for allocating an empty table.
+ *
+ * @note The previous table is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocate(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && !(capacity & (capacity - 1)));
+
+	_capacity = capacity;
+	_ctrl = new int8[capacity];
+	memset(_ctrl, FlatHashMapGroup::kEmpty, capacity);
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	assert(_slots != nullptr);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one, which must be empty.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	if (!map._capacity)
+		return;
+
+	// Copy the table as it is, the entries stay in the same slots
+	allocate(map._capacity);
+	memcpy(_ctrl, map._ctrl, _capacity);
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (isFull(ctr))
+			new (&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray) {
+		destroyAll();
+		return;
+	}
+
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (isFull(ctr))
+			_slots[ctr].~Node();
+	}
+	if (_ctrl)
+		memset(_ctrl, FlatHashMapGroup::kEmpty, _capacity);
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::reserve(size_type count) {
+	size_type capacity = _capacity ? _capacity : (size_type)FLATHASHMAP_MIN_CAPACITY;
+	while (count * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		capacity *= 2;
+
+	if (capacity != _capacity)
+		rehash(capacity);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity >= _size);
+
+	const size_type old_size = _size;
+	const size_type old_capacity = _capacity;
+	int8 *old_ctrl = _ctrl;
+	Node *old_slots = _slots;
+
+	allocate(newCapacity);
+
+	// Move all the old elements. Since we know that no key exists twice in
+	// the old table, we don't have to call _equal().
+	for (size_type ctr = 0; ctr < old_capacity; ++ctr) {
+		if (old_ctrl[ctr] < 0)
+			continue;
+
+		const uint32 hash = mixHash(_hash(old_slots[ctr]._key));
+		const size_type idx = findFreeSlot(hash);
+		_ctrl[idx] = h2(hash);
+		new (&_slots[idx]) Node(old_slots[ctr]);
+		old_slots[ctr].~Node();
+	}
+	_size = old_size;
+
+	delete[] old_ctrl;
+	free(old_slots);
+}
+
+/**
+ * Internal method for finding the first empty or deleted slot on the probe
+ * sequence of @p hash. The table must not be full.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 hash) const {
+	const size_type groupMask = numGroups() - 1;
+	size_type group = hash & groupMask;
+	for (size_type step = 1; ; ++step) {
+		const uint32 mask = FlatHashMapGroup(_ctrl + group * FlatHashMapGroup::kSize).matchEmptyOrDeleted();
+		if (mask)
+			return group * FlatHashMapGroup::kSize + FlatHashMapGroup::lowestBit(mask);
+
+		// Triangular probing visits every group once
+		group = (group + step) & groupMask;
+	}
+}
+
+/**
+ * Internal method for finding the slot of @p key.
+ *
+ * @return The index of the slot, or _capacity if the key is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	if (!_size)
+		return _capacity;
+
+	const uint32 hash = mixHash(_hash(key));
+	const int8 tag = h2(hash);
+	const size_type groupMask = numGroups() - 1;
+	size_type group = hash & groupMask;
+	for (size_type step = 1; step <= numGroups(); ++step) {
+		const size_type base = group * FlatHashMapGroup::kSize;
+		const FlatHashMapGroup ctrl(_ctrl + base);
+
+		for (uint32 match = ctrl.match(tag); match; match &= match - 1) {
+			const size_type idx = base + FlatHashMapGroup::lowestBit(match);
+			if (_equal(_slots[idx]._key, key))
+				return idx;
+		}
+
+		// The key would have been put into this group if it had been added
+		if (ctrl.matchEmpty())
+			break;
+
+		group = (group + step) & groupMask;
+	}
+
+	return _capacity;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != _capacity)
+		return ctr;
+
+	// Keep the load factor below a certain threshold. Deleted slots are
+	// also counted, if there are many the table is rebuilt at the same size.
+	if (!_capacity) {
+		allocate(FLATHASHMAP_MIN_CAPACITY);
+	} else if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > _capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		if ((_size + 1) * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > _capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			rehash(_capacity * 2);
+		else
+			rehash(_capacity);
+	}
+
+	const uint32 hash = mixHash(_hash(key));
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == FlatHashMapGroup::kDeleted)
+		_deleted--;
+	_ctrl[ctr] = h2(hash);
+	new (&_slots[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != _capacity;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Inserting may reallocate _slots
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != _capacity)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != _capacity)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != _capacity)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != _capacity) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+/**
+ * Erase an entry from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr < _capacity && isFull(ctr));
+
+	// The slot can not become empty again, lookups of other keys may have
+	// probed past it
+	_slots[ctr].~Node();
+	_ctrl[ctr] = FlatHashMapGroup::kDeleted;
+	_size--;
+	_deleted++;
+}
+
+/**
+ * Erase an entry specified by @p key from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	const size_type ctr = lookup(key);
+	if (ctr != _capacity)
+		erase(iterator(ctr, this));
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/framearena.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+FrameArena::FrameArena(size_t chunkSize) : _chunkSize(chunkSize), _capacity(0), _chunk(nullptr), _pos(nullptr), _end(nullptr) {
+}
+
+FrameArena::~FrameArena() {
+	freeChunks(_chunk);
+}
+
+void FrameArena::freeChunks(Chunk *last) {
+	while (last) {
+		Chunk *prev = last->prev;
+		_capacity -= last->size;
+		free(last);
+		last = prev;
+	}
+}
+
+void FrameArena::addChunk(size_t size) {
+	Chunk *chunk = (Chunk *)malloc(sizeof(Chunk) + size);
+	if (!chunk)
+		error("FrameArena: failure to allocate %u bytes", (uint)size);
+
+	if (_chunk)
+		_chunk->used = _pos - chunkData(_chunk);
+	chunk->prev = _chunk;
+	chunk->size = size;
+	chunk->used = 0;
+	_chunk = chunk;
+	_capacity += size;
+	_pos = chunkData(chunk);
+	_end = _pos + size;
+}
+
+void *FrameArena::allocateSlow(size_t size, size_t alignment) {
+	// Big allocations get a chunk of their own
+	size_t chunkSize = _chunkSize;
+	if (size + alignment > chunkSize)
+		chunkSize = size + alignment;
+	addChunk(chunkSize);
+
+	byte *ptr = (byte *)(((uintptr)_pos + alignment - 1) & ~(uintptr)(alignment - 1));
+	_pos = ptr + size;
+	return ptr;
+}
+
+void FrameArena::reset() {
+	if (!_chunk)
+		return;
+
+	// Merge the chunks, so that the next frame needs only one
+	if (_chunk->prev) {
+		const size_t capacity = _capacity;
+		freeChunks(_chunk);
+		_chunk = nullptr;
+		addChunk(capacity);
+	}
+
+	_pos = chunkData(_chunk);
+}
+
+FrameArena::Mark FrameArena::getMark() const {
+	Mark mark;
+	mark.chunk = _chunk;
+	mark.pos = _pos;
+	return mark;
+}
+
+void FrameArena::rewind(const Mark &mark) {
+	// Free the chunks started after the mark was taken
+	while (_chunk != mark.chunk) {
+		assert(_chunk);
+		Chunk *prev = _chunk->prev;
+		_capacity -= _chunk->size;
+		free(_chunk);
+		_chunk = prev;
+	}
+
+	if (_chunk) {
+		_pos = mark.pos;
+		_end = chunkData(_chunk) + _chunk->size;
+	} else {
+		_pos = _end = nullptr;
+	}
+}
+
+size_t FrameArena::getUsedSize() const {
+	if (!_chunk)
+		return 0;
+
+	size_t used = _pos - chunkData(_chunk);
+	for (const Chunk *chunk = _chunk->prev; chunk; chunk = chunk->prev)
+		used += chunk->used;
+	return used;
+}
+
+} // End of namespace Common
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_FRAMEARENA_H
+#define COMMON_FRAMEARENA_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_framearena Frame arena
+ * @ingroup common_memory
+ *
+ * @brief Bump allocator whose allocations are all released at once.
+ * @{
+ */
+
+/**
+ * A bump allocator for data which only lives until a known point, usually
+ * the end of the current frame. Allocating is only a pointer increment, and
+ * freeing happens for all allocations at once with reset().
+ *
+ * The memory is taken from chunks which are kept for the next frame. When a
+ * frame needed more than one chunk, reset() replaces them by a single chunk
+ * big enough for all of them, so the arena settles after a few frames.
+ *
+ * Destructors of objects in the arena are never run, so it is meant for
+ * plain data like vertex lists and draw commands. It is not thread-safe.
+ */
+class FrameArena : NonCopyable {
+public:
+	enum {
+		kDefaultChunkSize = 64 * 1024,
+		kDefaultAlignment = 8
+	};
+
+	/** A position in the arena, see getMark(). */
+	struct Mark {
+		void *chunk;
+		byte *pos;
+	};
+
+	explicit FrameArena(size_t chunkSize = kDefaultChunkSize);
+	~FrameArena();
+
+	/**
+	 * Allocate @p size bytes aligned to @p alignment, which must be a power
+	 * of two. The memory stays valid until reset() is called.
+	 */
+	void *allocate(size_t size, size_t alignment = kDefaultAlignment) {
+		byte *ptr = (byte *)(((uintptr)_pos + alignment - 1) & ~(uintptr)(alignment - 1));
+		if (!_pos || ptr + size > _end)
+			return allocateSlow(size, alignment);
+		_pos = ptr + size;
+		return ptr;
+	}
+
+	/** Allocate an array of @p count default constructed objects. */
+	template<class T>
+	T *allocateArray(size_t count) {
+		T *array = (T *)allocate(count * sizeof(T), alignof(T));
+		for (size_t i = 0; i < count; ++i)
+			new ((void *)&array[i]) T();
+		return array;
+	}
+
+	/** Release all allocations. */
+	void reset();
+
+	/**
+	 * Remember the current position, to release the allocations made after
+	 * it with rewind(). This allows using the arena as a stack in functions
+	 * which need scratch memory.
+	 */
+	Mark getMark() const;
+
+	/** Release all allocations made since @p mark was taken. */
+	void rewind(const Mark &mark);
+
+	/** Return the number of bytes allocated since the last reset(). */
+	size_t getUsedSize() const;
+
+	/** Return the number of bytes in all chunks. */
+	size_t getCapacity() const { return _capacity; }
+
+private:
+	struct Chunk {
+		Chunk *prev;
+		size_t size;
+		size_t used; ///< Bytes used before the next chunk was started
+	};
+
+	void *allocateSlow(size_t size, size_t alignment);
+	void addChunk(size_t size);
+	void freeChunks(Chunk *last);
+
+	static byte *chunkData(Chunk *chunk) {
+		return (byte *)(chunk + 1);
+	}
+
+	size_t _chunkSize;
+	size_t _capacity;
+	Chunk *_chunk;	///< Current chunk, the others are linked through Chunk::prev
+	byte *_pos;
+	byte *_end;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -223,6 +223,22 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Get the size of the file referred by this node and the time it was
+	 * last modified, without opening it.
+	 *
+	 * This can be used to find out cheaply whether a file has changed, for
+	 * example to keep data computed from its contents in a cache.
+	 *
+	 * @param size     Receives the size of the file in bytes.
+	 * @param modTime  Receives the modification time in seconds. Only
+	 *                 comparisons between these values are meaningful.
+	 *
+	 * @return True on success, false if the file does not exist or the
+	 *         backend does not support this.
+	 */
+	bool getFileStats(int64 &size, int64 &modTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -232,6 +248,17 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Like createReadStream(), but the file may be mapped into memory,
+	 * which makes reading it cheaper. Only use this for read-only data,
+	 * such as game files and archives, and never for save files: a mapped
+	 * file which is truncated or rewritten while the stream exists crashes
+	 * the process instead of causing a read error.
+	 *
+	 * @return Pointer to the stream object, 0 in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -38,6 +38,13 @@
  */
 #define USE_HASHMAP_MEMORY_POOL
 
+/**
+ * Enable the following define to let the memory pools of all HashMaps take
+ * their nodes from the process-wide small object allocator, instead of each
+ * HashMap having pages of its own. This makes empty HashMaps smaller.
+ */
+//#define USE_HASHMAP_SMALL_OBJECT_POOL
+
 
 #include "common/func.h"
 
@@ -48,8 +55,12 @@
 #endif
 
 #ifdef USE_HASHMAP_MEMORY_POOL
+#ifdef USE_HASHMAP_SMALL_OBJECT_POOL
+#include "common/smallalloc.h"
+#else
 #include "common/memorypool.h"
 #endif
+#endif
 
 namespace Common {
 
@@ -115,7 +126,11 @@ private:
 	};
 
 #ifdef USE_HASHMAP_MEMORY_POOL
+#ifdef USE_HASHMAP_SMALL_OBJECT_POOL
+	SmallObjectPoolFor<Node> _nodePool;
+#else
 	ObjectPool<Node, HASHMAP_MEMORYPOOL_SIZE> _nodePool;
+#endif
 #endif
 
 	/** Default value, returned by the const getVal. */
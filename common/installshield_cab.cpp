@@ -47,6 +47,7 @@
 #include "common/hash-str.h"
 #include "common/installshield_cab.h"
 #include "common/memstream.h"
+#include "common/sharedbuffer.h"
 #include "common/substream.h"
 #include "common/ptr.h"
 #include "common/zlib.h"
@@ -82,8 +83,16 @@ private:
 	FileMap _map;
 	String _baseName;
 
+	/** The volumes opened so far, with null pointers for those not in memory */
+	typedef HashMap<uint, SharedBufferPtr> VolumeMap;
+	mutable VolumeMap _volumes;
+
+	/** Recently decompressed members */
+	mutable SharedBufferCache _cache;
+
 	String getHeaderName() const;
 	String getVolumeName(uint volume) const;
+	SharedBufferPtr getVolumeData(uint volume) const;
 };
 
 InstallShieldCabinet::InstallShieldCabinet() : _version(0) {
@@ -213,6 +222,8 @@ bool InstallShieldCabinet::open(const String &baseName) {
 void InstallShieldCabinet::close() {
 	_baseName.clear();
 	_map.clear();
+	_volumes.clear();
+	_cache.clear();
 	_version = 0;
 }
 
@@ -239,8 +250,20 @@ SeekableReadStream *InstallShieldCabinet::createReadStreamForMember(const Path &
 		return nullptr;
 
 	const FileEntry &entry = _map[name];
+	const uint volume = (entry.volume == 0) ? 1 : entry.volume;
+
+	if (!(entry.flags & 0x04)) {
+		// Uncompressed members of volumes in memory do not need to be copied
+		SharedBufferPtr data = getVolumeData(volume);
+		if (data && entry.offset <= data->getSize() && entry.uncompressedSize <= data->getSize() - entry.offset)
+			return new SharedBufferReadStream(data, entry.offset, entry.offset + entry.uncompressedSize);
+	} else {
+		SharedBufferPtr cached = _cache.get(name);
+		if (cached)
+			return new SharedBufferReadStream(cached);
+	}
 
-	ScopedPtr<SeekableReadStream> stream(SearchMan.createReadStreamForMember(getVolumeName((entry.volume == 0) ? 1 : entry.volume)));
+	ScopedPtr<SeekableReadStream> stream(SearchMan.createReadStreamForMember(getVolumeName(volume)));
 	if (!stream) {
 		warning("Failed to open volume for file '%s'", name.c_str());
 		return nullptr;
@@ -269,7 +292,9 @@ SeekableReadStream *InstallShieldCabinet::createReadStreamForMember(const Path &
 		return nullptr;
 	}
 
-	return new MemoryReadStream(dst, entry.uncompressedSize, DisposeAfterUse::YES);
+	SharedBufferPtr member(new SharedBuffer(dst, entry.uncompressedSize));
+	_cache.put(name, member);
+	return new SharedBufferReadStream(member);
 #else
 	warning("zlib required to extract compressed CAB file '%s'", name.c_str());
 	return 0;
@@ -284,6 +309,23 @@ String InstallShieldCabinet::getVolumeName(uint volume) const {
 	return String::format("%s%d.cab", _baseName.c_str(), volume);
 }
 
+SharedBufferPtr InstallShieldCabinet::getVolumeData(uint volume) const {
+	VolumeMap::const_iterator i = _volumes.find(volume);
+	if (i != _volumes.end())
+		return i->_value;
+
+	SharedBufferPtr data;
+	SeekableReadStream *stream = SearchMan.createReadStreamForMember(getVolumeName(volume));
+	if (stream) {
+		data = SharedBufferPtr(SharedBuffer::createFromStream(stream, DisposeAfterUse::YES));
+		if (!data)
+			delete stream;
+	}
+
+	_volumes[volume] = data;
+	return data;
+}
+
 } // End of anonymous namespace
 
 Archive *makeInstallShieldArchive(const String &baseName) {
@@ -117,6 +117,7 @@ bool InstallShieldV3::open(const Common::String &filename) {
 
 void InstallShieldV3::close() {
 	delete _stream; _stream = nullptr;
+	_cache.clear();
 	_map.clear();
 }
 
@@ -146,11 +147,26 @@ Common::SeekableReadStream *InstallShieldV3::createReadStreamForMember(const Com
 	if (!_stream || !_map.contains(name))
 		return nullptr;
 
+	Common::SharedBufferPtr cached = _cache.get(name);
+	if (cached)
+		return new Common::SharedBufferReadStream(cached);
+
 	const FileEntry &entry = _map[name];
 
+	byte *data = (byte *)malloc(entry.uncompressedSize);
+	if (!data)
+		return nullptr;
+
 	// Seek to our offset and then send it off to the decompressor
 	_stream->seek(entry.offset);
-	return Common::decompressDCL(_stream, entry.compressedSize, entry.uncompressedSize);
+	if (!Common::decompressDCL(_stream, data, entry.compressedSize, entry.uncompressedSize)) {
+		free(data);
+		return nullptr;
+	}
+
+	Common::SharedBufferPtr member(new Common::SharedBuffer(data, entry.uncompressedSize));
+	_cache.put(name, member);
+	return new Common::SharedBufferReadStream(member);
 }
 
 } // End of namespace Common
@@ -28,6 +28,7 @@
 #include "common/file.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
+#include "common/sharedbuffer.h"
 #include "common/str.h"
 
 namespace Common {
@@ -56,6 +57,9 @@ private:
 
 	Common::SeekableReadStream *_stream;
 
+	/** Recently decompressed members */
+	mutable Common::SharedBufferCache _cache;
+
 	typedef Common::HashMap<Common::String, FileEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileMap;
 	FileMap _map;
 };
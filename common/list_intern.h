@@ -24,6 +24,16 @@
 
 #include "common/scummsys.h"
 
+/**
+ * Enable the following define to allocate the nodes of all Lists with the
+ * process-wide small object allocator instead of operator new.
+ */
+//#define USE_LIST_SMALL_OBJECT_POOL
+
+#ifdef USE_LIST_SMALL_OBJECT_POOL
+#include "common/smallalloc.h"
+#endif
+
 namespace Common {
 
 template<typename T> class List;
@@ -40,6 +50,11 @@ namespace ListInternal {
 		T _data;
 
 		Node(const T &x) : _data(x) {}
+
+#ifdef USE_LIST_SMALL_OBJECT_POOL
+		static void *operator new(size_t size) { return allocSmallObject(size); }
+		static void operator delete(void *ptr, size_t size) { freeSmallObject(ptr, size); }
+#endif
 	};
 
 	template<typename T> struct ConstIterator;
@@ -0,0 +1,545 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/lz4.h"
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/stream.h"
+#include "common/util.h"
+
+namespace Common {
+
+namespace {
+
+enum {
+	kMinMatch = 4,
+	// The last match has to start at least 12 bytes before the end of the
+	// block, and the last 5 bytes are always literals
+	kMatchStartLimit = 12,
+	kLastLiterals = 5,
+	kMaxOffset = 65535,
+
+	kHashLog = 12
+};
+
+inline uint32 hashSequence(uint32 sequence) {
+	return (sequence * 2654435761U) >> (32 - kHashLog);
+}
+
+// Write the remainder of a literal or match length
+inline byte *writeLength(byte *op, uint32 length) {
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (byte)length;
+	return op;
+}
+
+// Read the remainder of a literal or match length
+inline bool readLength(const byte *&ip, const byte *iend, uint32 &length) {
+	byte b;
+	do {
+		if (ip >= iend)
+			return false;
+		b = *ip++;
+		length += b;
+	} while (b == 255);
+	return true;
+}
+
+} // End of anonymous namespace
+
+uint32 lz4CompressBound(uint32 srcSize) {
+	return srcSize + srcSize / 255 + 16;
+}
+
+uint32 lz4Compress(byte *dst, uint32 dstCapacity, const byte *src, uint32 srcSize) {
+	uint32 table[1 << kHashLog];
+	memset(table, 0, sizeof(table));
+
+	const byte *ip = src;
+	const byte *anchor = src;
+	const byte *const iend = src + srcSize;
+	byte *op = dst;
+	byte *const oend = dst + dstCapacity;
+
+	if (srcSize > kMatchStartLimit) {
+		const byte *const matchStartLimit = iend - kMatchStartLimit;
+		const byte *const matchEndLimit = iend - kLastLiterals;
+
+		while (ip < matchStartLimit) {
+			const uint32 sequence = READ_UINT32(ip);
+			const uint32 hash = hashSequence(sequence);
+			const byte *ref = src + table[hash];
+			table[hash] = ip - src;
+
+			if (ref >= ip || ip - ref > kMaxOffset || READ_UINT32(ref) != sequence) {
+				ip++;
+				continue;
+			}
+
+			// Extend the match in both directions
+			while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+				ip--;
+				ref--;
+			}
+			const byte *matchEnd = ip + kMinMatch;
+			const byte *refEnd = ref + kMinMatch;
+			while (matchEnd < matchEndLimit && *matchEnd == *refEnd) {
+				matchEnd++;
+				refEnd++;
+			}
+
+			const uint32 literals = ip - anchor;
+			const uint32 matchLength = matchEnd - ip - kMinMatch;
+			if ((uint32)(oend - op) < literals + literals / 255 + matchLength / 255 + 5)
+				return 0;
+
+			byte *token = op++;
+			*token = (byte)(MIN<uint32>(literals, 15) << 4 | MIN<uint32>(matchLength, 15));
+			if (literals >= 15)
+				op = writeLength(op, literals - 15);
+			memcpy(op, anchor, literals);
+			op += literals;
+
+			const uint32 offset = ip - ref;
+			*op++ = (byte)offset;
+			*op++ = (byte)(offset >> 8);
+			if (matchLength >= 15)
+				op = writeLength(op, matchLength - 15);
+
+			ip = anchor = matchEnd;
+			// Remember a position inside the match for the next search
+			if (ip < matchStartLimit)
+				table[hashSequence(READ_UINT32(ip - 2))] = ip - 2 - src;
+		}
+	}
+
+	// The final sequence only consists of literals
+	const uint32 literals = iend - anchor;
+	if ((uint32)(oend - op) < literals + literals / 255 + 2)
+		return 0;
+	*op++ = (byte)(MIN<uint32>(literals, 15) << 4);
+	if (literals >= 15)
+		op = writeLength(op, literals - 15);
+	memcpy(op, anchor, literals);
+	op += literals;
+
+	return op - dst;
+}
+
+bool lz4Decompress(byte *dst, uint32 dstSize, const byte *src, uint32 srcSize) {
+	const byte *ip = src;
+	const byte *const iend = src + srcSize;
+	byte *op = dst;
+	byte *const oend = dst + dstSize;
+
+	while (ip < iend) {
+		const byte token = *ip++;
+
+		uint32 literals = token >> 4;
+		if (literals == 15 && !readLength(ip, iend, literals))
+			return false;
+		if (literals > (uint32)(iend - ip) || literals > (uint32)(oend - op))
+			return false;
+		memcpy(op, ip, literals);
+		ip += literals;
+		op += literals;
+
+		// The last sequence has no match
+		if (ip == iend)
+			return op == oend;
+
+		if (iend - ip < 2)
+			return false;
+		const uint32 offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (uint32)(op - dst))
+			return false;
+
+		uint32 matchLength = token & 15;
+		if (matchLength == 15 && !readLength(ip, iend, matchLength))
+			return false;
+		matchLength += kMinMatch;
+		if (matchLength > (uint32)(oend - op))
+			return false;
+
+		const byte *match = op - offset;
+		if (offset >= matchLength) {
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		} else {
+			// Overlapping matches repeat the last offset bytes
+			for (uint32 i = 0; i < matchLength; ++i)
+				*op++ = *match++;
+		}
+	}
+
+	return false;
+}
+
+#pragma mark -
+
+namespace {
+
+enum {
+	kContainerMagic = MKTAG('S', 'V', 'L', 'Z'),
+	kContainerVersion = 1,
+	kCodecLZ4 = 1,
+	kContainerHeaderSize = 12,
+	kContainerTrailerSize = 12,
+
+	kBlockSize = 65536,
+	kMaxBlockSize = 1 << 24
+};
+
+// Set in the stored size of blocks which are not compressed
+const uint32 kStoredBlock = 0x80000000;
+
+class LZ4ReadStream : public SeekableReadStream {
+	struct Block {
+		uint32 offset;
+		uint32 start;
+		uint32 size;
+	};
+
+	SeekableReadStream *_wrapped;
+	Array<Block> _blocks;
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+	byte *_cache;
+	byte *_packed;
+	uint32 _packedCapacity;
+	int _cachedBlock;
+
+	uint findBlock(uint32 pos) const {
+		uint first = 0, last = _blocks.size() - 1;
+		while (first < last) {
+			const uint mid = (first + last + 1) / 2;
+			if (_blocks[mid].start <= pos)
+				first = mid;
+			else
+				last = mid - 1;
+		}
+		return first;
+	}
+
+	bool loadBlock(uint index) {
+		if ((int)index == _cachedBlock)
+			return true;
+		_cachedBlock = -1;
+
+		const Block &block = _blocks[index];
+		if (!_wrapped->seek(block.offset, SEEK_SET))
+			return false;
+		const uint32 stored = _wrapped->readUint32LE();
+		const uint32 storedSize = stored & ~kStoredBlock;
+		if (_wrapped->err() || _wrapped->eos())
+			return false;
+
+		if (stored & kStoredBlock) {
+			if (storedSize != block.size || _wrapped->read(_cache, storedSize) != storedSize)
+				return false;
+		} else {
+			if (storedSize > lz4CompressBound(block.size))
+				return false;
+			if (storedSize > _packedCapacity) {
+				free(_packed);
+				_packed = (byte *)malloc(storedSize);
+				_packedCapacity = _packed ? storedSize : 0;
+				if (!_packed)
+					return false;
+			}
+			if (_wrapped->read(_packed, storedSize) != storedSize)
+				return false;
+			if (!lz4Decompress(_cache, block.size, _packed, storedSize))
+				return false;
+		}
+
+		_cachedBlock = index;
+		return true;
+	}
+
+public:
+	LZ4ReadStream(SeekableReadStream *wrapped) : _wrapped(wrapped), _size(0), _pos(0), _eos(false), _err(false),
+		_cache(nullptr), _packed(nullptr), _packedCapacity(0), _cachedBlock(-1) {}
+
+	~LZ4ReadStream() {
+		free(_cache);
+		free(_packed);
+		delete _wrapped;
+	}
+
+	// Read the container header and index
+	bool init() {
+		const int64 fileSize = _wrapped->size();
+		if (fileSize < kContainerHeaderSize + kContainerTrailerSize || fileSize > 0xFFFFFFFF)
+			return false;
+
+		_wrapped->seek(0, SEEK_SET);
+		if (_wrapped->readUint32BE() != kContainerMagic || _wrapped->readByte() != kContainerVersion || _wrapped->readByte() != kCodecLZ4)
+			return false;
+		_wrapped->readUint16LE();
+		const uint32 blockSize = _wrapped->readUint32LE();
+		if (blockSize == 0 || blockSize > kMaxBlockSize)
+			return false;
+
+		_wrapped->seek(fileSize - kContainerTrailerSize, SEEK_SET);
+		const uint32 blockCount = _wrapped->readUint32LE();
+		const uint32 indexOffset = _wrapped->readUint32LE();
+		if (_wrapped->readUint32BE() != kContainerMagic || _wrapped->err())
+			return false;
+		if (indexOffset < kContainerHeaderSize || indexOffset > fileSize - kContainerTrailerSize ||
+		    (int64)blockCount * 8 != fileSize - kContainerTrailerSize - indexOffset)
+			return false;
+
+		_wrapped->seek(indexOffset, SEEK_SET);
+		_blocks.resize(blockCount);
+		for (uint32 i = 0; i < blockCount; ++i) {
+			Block &block = _blocks[i];
+			block.offset = _wrapped->readUint32LE();
+			block.size = _wrapped->readUint32LE();
+			block.start = _size;
+			if (block.offset < kContainerHeaderSize || block.offset >= indexOffset || block.size == 0 || block.size > blockSize ||
+			    _size + block.size < _size)
+				return false;
+			_size += block.size;
+		}
+		if (_wrapped->err())
+			return false;
+
+		_cache = (byte *)malloc(blockSize);
+		return _cache != nullptr;
+	}
+
+	bool err() const override { return _err || _wrapped->err(); }
+	void clearErr() override {
+		// I/O errors are not recoverable, only reset _eos
+		_eos = false;
+	}
+
+	bool eos() const override { return _eos; }
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		int64 newPos;
+		switch (whence) {
+		case SEEK_END:
+			newPos = _size + offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_SET:
+		default:
+			newPos = offset;
+			break;
+		}
+
+		if (newPos < 0 || newPos > _size)
+			return false;
+
+		_pos = newPos;
+		_eos = false;
+		return true;
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		byte *out = (byte *)dataPtr;
+		uint32 total = 0;
+
+		while (total < dataSize) {
+			if (_pos >= _size) {
+				_eos = true;
+				break;
+			}
+
+			const uint index = findBlock(_pos);
+			if (!loadBlock(index)) {
+				_err = true;
+				break;
+			}
+
+			const Block &block = _blocks[index];
+			const uint32 offset = _pos - block.start;
+			const uint32 count = MIN<uint32>(dataSize - total, block.size - offset);
+			memcpy(out + total, _cache + offset, count);
+			total += count;
+			_pos += count;
+		}
+
+		return total;
+	}
+};
+
+class LZ4WriteStream : public WriteStream {
+	WriteStream *_wrapped;
+	byte *_buffer;
+	uint32 _bufferSize;
+	byte *_packed;
+	Array<uint32> _index;
+	uint32 _written;
+	uint32 _pos;
+	bool _finalized;
+	bool _err;
+
+	void writeToWrapped(const void *data, uint32 size) {
+		if (_wrapped->write(data, size) != size)
+			_err = true;
+		_written += size;
+	}
+
+	void writeUint32ToWrapped(uint32 value) {
+		byte data[4];
+		WRITE_LE_UINT32(data, value);
+		writeToWrapped(data, 4);
+	}
+
+	void flushBlock() {
+		if (_bufferSize == 0)
+			return;
+
+		_index.push_back(_written);
+		_index.push_back(_bufferSize);
+
+		const uint32 packedSize = lz4Compress(_packed, _bufferSize - 1, _buffer, _bufferSize);
+		if (packedSize) {
+			writeUint32ToWrapped(packedSize);
+			writeToWrapped(_packed, packedSize);
+		} else {
+			// The data does not compress
+			writeUint32ToWrapped(_bufferSize | kStoredBlock);
+			writeToWrapped(_buffer, _bufferSize);
+		}
+		_bufferSize = 0;
+	}
+
+public:
+	LZ4WriteStream(WriteStream *w) : _wrapped(w), _bufferSize(0), _written(0), _pos(0), _finalized(false), _err(false) {
+		assert(w != nullptr);
+		_buffer = (byte *)malloc(kBlockSize);
+		_packed = (byte *)malloc(lz4CompressBound(kBlockSize));
+		assert(_buffer && _packed);
+
+		byte header[kContainerHeaderSize];
+		WRITE_BE_UINT32(header, kContainerMagic);
+		header[4] = kContainerVersion;
+		header[5] = kCodecLZ4;
+		header[6] = header[7] = 0;
+		WRITE_LE_UINT32(header + 8, kBlockSize);
+		writeToWrapped(header, sizeof(header));
+	}
+
+	~LZ4WriteStream() {
+		finalize();
+		free(_buffer);
+		free(_packed);
+		delete _wrapped;
+	}
+
+	bool err() const override { return _err || _wrapped->err(); }
+
+	void clearErr() override {
+		// As with the zlib stream, errors which already happened can not be
+		// undone, so only the wrapped stream is reset.
+		_wrapped->clearErr();
+	}
+
+	void finalize() override {
+		if (_finalized)
+			return;
+		_finalized = true;
+
+		flushBlock();
+
+		const uint32 indexOffset = _written;
+		for (uint i = 0; i < _index.size(); ++i)
+			writeUint32ToWrapped(_index[i]);
+
+		byte trailer[kContainerTrailerSize];
+		WRITE_LE_UINT32(trailer, _index.size() / 2);
+		WRITE_LE_UINT32(trailer + 4, indexOffset);
+		WRITE_BE_UINT32(trailer + 8, kContainerMagic);
+		writeToWrapped(trailer, sizeof(trailer));
+
+		_wrapped->finalize();
+	}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) override {
+		if (_finalized || err())
+			return 0;
+
+		const byte *in = (const byte *)dataPtr;
+		uint32 left = dataSize;
+		while (left > 0) {
+			const uint32 count = MIN<uint32>(left, kBlockSize - _bufferSize);
+			memcpy(_buffer + _bufferSize, in, count);
+			_bufferSize += count;
+			in += count;
+			left -= count;
+
+			if (_bufferSize == kBlockSize)
+				flushBlock();
+		}
+
+		_pos += dataSize;
+		return dataSize;
+	}
+
+	int64 pos() const override { return _pos; }
+};
+
+} // End of anonymous namespace
+
+bool isLZ4Container(SeekableReadStream *stream) {
+	if (!stream || stream->size() - stream->pos() < kContainerHeaderSize + kContainerTrailerSize)
+		return false;
+
+	const uint32 magic = stream->readUint32BE();
+	stream->seek(-4, SEEK_CUR);
+	return magic == kContainerMagic;
+}
+
+SeekableReadStream *wrapLZ4ReadStream(SeekableReadStream *toBeWrapped) {
+	if (!toBeWrapped)
+		return nullptr;
+
+	LZ4ReadStream *stream = new LZ4ReadStream(toBeWrapped);
+	if (!stream->init()) {
+		delete stream;
+		return nullptr;
+	}
+	return stream;
+}
+
+WriteStream *wrapLZ4WriteStream(WriteStream *toBeWrapped) {
+	if (!toBeWrapped)
+		return nullptr;
+	return new LZ4WriteStream(toBeWrapped);
+}
+
+} // End of namespace Common
@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_LZ4_H
+#define COMMON_LZ4_H
+
+#include "common/scummsys.h"
+#include "common/types.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_lz4 LZ4 compression
+ * @ingroup common
+ *
+ * @brief  Fast LZ4 block compression, and a block based container for
+ *         save files.
+ *
+ * The container stores its data in independently compressed blocks, with
+ * an index at the end of the file. This allows seeking without having to
+ * decompress everything before the new position, so that the header and
+ * thumbnail at the end of a save file can be read without decompressing
+ * the game state.
+ *
+ * Container layout (all values are little endian):
+ *  - 'SVLZ', version byte, codec byte, 2 reserved bytes, block size (uint32)
+ *  - The blocks: stored size (uint32, highest bit set if the block is not
+ *    compressed), followed by the stored data
+ *  - The index: for every block, its file offset and uncompressed size
+ *    (uint32 each)
+ *  - Number of blocks (uint32), file offset of the index (uint32), 'SVLZ'
+ * @{
+ */
+
+class SeekableReadStream;
+class WriteStream;
+
+/**
+ * Return the maximum compressed size of @p srcSize bytes of data.
+ */
+uint32 lz4CompressBound(uint32 srcSize);
+
+/**
+ * Compress a buffer in the LZ4 block format.
+ *
+ * @param dst          Buffer for the compressed data.
+ * @param dstCapacity  Size of the destination buffer. Compression can not
+ *                     fail if it is at least lz4CompressBound(srcSize).
+ * @param src          Data to compress.
+ * @param srcSize      Size of the data to compress.
+ *
+ * @return The size of the compressed data, or 0 if it did not fit.
+ */
+uint32 lz4Compress(byte *dst, uint32 dstCapacity, const byte *src, uint32 srcSize);
+
+/**
+ * Decompress a buffer in the LZ4 block format. Malformed data is detected
+ * and never causes reads or writes outside of the given buffers.
+ *
+ * @param dst      Buffer for the decompressed data.
+ * @param dstSize  Exact size of the decompressed data.
+ * @param src      Compressed data.
+ * @param srcSize  Size of the compressed data.
+ *
+ * @return true if exactly @p dstSize bytes were decompressed.
+ */
+bool lz4Decompress(byte *dst, uint32 dstSize, const byte *src, uint32 srcSize);
+
+/**
+ * Check whether the given stream starts with the LZ4 container signature.
+ * The stream position is not changed.
+ */
+bool isLZ4Container(SeekableReadStream *stream);
+
+/**
+ * Take a SeekableReadStream containing an LZ4 container and wrap it in a
+ * stream which provides the decompressed data. The returned stream
+ * supports fast seeking in both directions.
+ *
+ * The created stream becomes responsible for freeing the passed stream.
+ * If the container is invalid, NULL is returned and the passed stream is
+ * destroyed.
+ */
+SeekableReadStream *wrapLZ4ReadStream(SeekableReadStream *toBeWrapped);
+
+/**
+ * Take an arbitrary WriteStream and wrap it in a stream which writes an
+ * LZ4 container. The container is completed when the returned stream is
+ * finalized or deleted.
+ *
+ * The created stream becomes responsible for freeing the passed stream.
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ */
+WriteStream *wrapLZ4WriteStream(WriteStream *toBeWrapped);
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -78,6 +78,8 @@ public:
 	int64 size() const { return _size; }
 
 	bool seek(int64 offs, int whence = SEEK_SET);
+
+	const byte *getView(int64 offset, uint32 dataSize) const;
 };
 
 
@@ -96,6 +98,8 @@ public:
 	bool seek(int64 offs, int whence = SEEK_SET) override { return MemoryReadStream::seek(offs, whence); }
 
 	bool skip(uint32 offset) override { return MemoryReadStream::seek(offset, SEEK_CUR); }
+
+	const byte *getView(int64 offset, uint32 dataSize) const override { return MemoryReadStream::getView(offset, dataSize); }
 };
 
 /**
@@ -11,6 +11,7 @@ MODULE_OBJS := \
 	error.o \
 	events.o \
 	file.o \
+	framearena.o \
 	fs.o \
 	gui_options.o \
 	hashmap.o \
@@ -21,11 +22,13 @@ MODULE_OBJS := \
 	json.o \
 	language.o \
 	localization.o \
+	lz4.o \
 	macresman.o \
 	memorypool.o \
 	md5.o \
 	mdct.o \
 	mutex.o \
+	thread.o \
 	osd_message_queue.o \
 	path.o \
 	platform.o \
@@ -34,8 +37,11 @@ MODULE_OBJS := \
 	random.o \
 	rational.o \
 	rendermode.o \
+	ringbuffer.o \
+	sharedbuffer.o \
 	sinewindows.o \
 	str.o \
+	stringbuilder.o \
 	stream.o \
 	streamdebug.o \
 	str-enc.o \
@@ -64,6 +70,11 @@ MODULE_OBJS += \
 	rdft.o \
 	sinetables.o
 
+ifdef HAS_THREAD_LOCAL
+MODULE_OBJS += \
+	smallalloc.o
+endif
+
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
 	recorderfile.o
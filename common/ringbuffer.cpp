@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/ringbuffer.h"
+
+#include <atomic>
+
+namespace Common {
+
+struct SPSCRingBufferPositions::Atomics {
+	std::atomic<uint32> readPos;
+	std::atomic<uint32> writePos;
+
+	Atomics() : readPos(0), writePos(0) {}
+};
+
+SPSCRingBufferPositions::SPSCRingBufferPositions() {
+	_atomics = new Atomics();
+}
+
+SPSCRingBufferPositions::~SPSCRingBufferPositions() {
+	delete _atomics;
+}
+
+uint32 SPSCRingBufferPositions::loadRead() const {
+	return _atomics->readPos.load(std::memory_order_acquire);
+}
+
+uint32 SPSCRingBufferPositions::loadWrite() const {
+	return _atomics->writePos.load(std::memory_order_acquire);
+}
+
+void SPSCRingBufferPositions::storeRead(uint32 position) {
+	_atomics->readPos.store(position, std::memory_order_release);
+}
+
+void SPSCRingBufferPositions::storeWrite(uint32 position) {
+	_atomics->writePos.store(position, std::memory_order_release);
+}
+
+} // End of namespace Common
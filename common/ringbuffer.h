@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_RINGBUFFER_H
+#define COMMON_RINGBUFFER_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_ringbuffer Ring buffer
+ * @ingroup common
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ * @{
+ */
+
+/**
+ * The read and write positions of an SPSCRingBuffer. The atomic operations
+ * on them are implemented out of line, so that this header does not need
+ * the standard atomics.
+ *
+ * The positions only ever increase and wrap around at 2^32, so their
+ * difference is the number of elements in the buffer.
+ */
+class SPSCRingBufferPositions : NonCopyable {
+public:
+	SPSCRingBufferPositions();
+	~SPSCRingBufferPositions();
+
+	/** Load a position written by the other side. */
+	uint32 loadRead() const;
+	uint32 loadWrite() const;
+
+	/** Publish a new position to the other side. */
+	void storeRead(uint32 position);
+	void storeWrite(uint32 position);
+
+private:
+	struct Atomics;
+	Atomics *_atomics;
+};
+
+/**
+ * A fixed size FIFO of elements which one thread can write to while
+ * another one reads from it, without any locking.
+ *
+ * All producer methods (getWriteBuffer(), commitWrite(), write(),
+ * getWritePosition()) must be called from one thread, and all consumer
+ * methods (read(), discardUntil()) from one other thread. size() and
+ * space() can be called from either side; they are exact for the calling
+ * side and conservative for the other.
+ *
+ * The capacity is rounded up to a power of two.
+ */
+template<class T>
+class SPSCRingBuffer : NonCopyable {
+public:
+	explicit SPSCRingBuffer(uint32 capacity) {
+		_capacity = 1;
+		while (_capacity < capacity)
+			_capacity <<= 1;
+		_mask = _capacity - 1;
+
+		_storage = new T[_capacity];
+	}
+
+	~SPSCRingBuffer() {
+		delete[] _storage;
+	}
+
+	uint32 capacity() const { return _capacity; }
+
+	/** The number of elements which can be read. */
+	uint32 size() const {
+		return _positions.loadWrite() - _positions.loadRead();
+	}
+
+	/** The number of elements which can be written. */
+	uint32 space() const { return _capacity - size(); }
+
+	/**
+	 * Get the contiguous part of the free space at the write position.
+	 * This may be less than space() when the free space wraps around.
+	 */
+	T *getWriteBuffer(uint32 &count) {
+		const uint32 writePos = _positions.loadWrite();
+		const uint32 used = writePos - _positions.loadRead();
+		const uint32 offset = writePos & _mask;
+
+		count = MIN(_capacity - used, _capacity - offset);
+		return _storage + offset;
+	}
+
+	/** Make count elements written to the buffer from getWriteBuffer() visible to the consumer. */
+	void commitWrite(uint32 count) {
+		_positions.storeWrite(_positions.loadWrite() + count);
+	}
+
+	/**
+	 * Copy up to count elements into the buffer.
+	 *
+	 * @return The number of elements written.
+	 */
+	uint32 write(const T *data, uint32 count) {
+		uint32 written = 0;
+		while (written < count) {
+			uint32 chunk;
+			T *dst = getWriteBuffer(chunk);
+			chunk = MIN(chunk, count - written);
+			if (!chunk)
+				break;
+
+			copy(dst, data + written, chunk);
+			commitWrite(chunk);
+			written += chunk;
+		}
+		return written;
+	}
+
+	/**
+	 * The position after the last element written so far. The consumer can
+	 * pass it to discardUntil() to drop everything written before it.
+	 */
+	uint32 getWritePosition() const { return _positions.loadWrite(); }
+
+	/**
+	 * Copy up to count elements out of the buffer.
+	 *
+	 * @return The number of elements read.
+	 */
+	uint32 read(T *data, uint32 count) {
+		const uint32 readPos = _positions.loadRead();
+		const uint32 available = _positions.loadWrite() - readPos;
+		const uint32 offset = readPos & _mask;
+
+		count = MIN(count, available);
+		const uint32 first = MIN(count, _capacity - offset);
+		copy(data, _storage + offset, first);
+		copy(data + first, _storage, count - first);
+
+		_positions.storeRead(readPos + count);
+		return count;
+	}
+
+	/**
+	 * Drop the elements written before the given position, as returned by
+	 * getWritePosition(). Elements which have been read already are not
+	 * affected.
+	 */
+	void discardUntil(uint32 position) {
+		const uint32 readPos = _positions.loadRead();
+		if ((int32)(position - readPos) > 0)
+			_positions.storeRead(position);
+	}
+
+	/**
+	 * Drop all elements. Neither the producer nor the consumer may use the
+	 * buffer while this runs.
+	 */
+	void clear() {
+		_positions.storeRead(0);
+		_positions.storeWrite(0);
+	}
+
+private:
+	static void copy(T *dst, const T *src, uint32 count) {
+		for (uint32 i = 0; i < count; ++i)
+			dst[i] = src[i];
+	}
+
+	T *_storage;
+	uint32 _capacity;
+	uint32 _mask;
+
+	SPSCRingBufferPositions _positions;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -276,6 +276,54 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Get the size and modification time of a save file, e.g. to tell
+	 * whether cached information about it is still up to date.
+	 *
+	 * @param name     Name of the save file.
+	 * @param size     Receives the size of the file in bytes.
+	 * @param modTime  Receives the modification time. Only comparisons
+	 *                 between these values are meaningful.
+	 *
+	 * @return true on success, false if the file does not exist or this is
+	 *         not supported. The default implementation always fails.
+	 */
+	virtual bool getSavefileStats(const String &name, int64 &size, int64 &modTime) { return false; }
+
+	/**
+	 * Let openForSaving() return save files which are written in the
+	 * background, until the matching endAsyncSaves() call. Such save files
+	 * only collect the data in memory; compressing it and writing it to disk
+	 * happens on a separate thread once they are finalized or deleted.
+	 *
+	 * The result of every background save is reported by pollAsyncSave().
+	 * Calls may be nested. The default implementation does nothing, so that
+	 * all save files are written right away.
+	 */
+	virtual void beginAsyncSaves() {}
+
+	/**
+	 * Stop returning background save files from openForSaving(). Saves
+	 * which are still in progress are not waited for.
+	 */
+	virtual void endAsyncSaves() {}
+
+	/**
+	 * Check whether a background save has finished.
+	 *
+	 * @param name   Set to the name of the save file.
+	 * @param error  Set to the result of writing the save file.
+	 *
+	 * @return true if a result was returned, false if there are none left.
+	 */
+	virtual bool pollAsyncSave(String &name, Error &error) { return false; }
+
+	/**
+	 * Wait until all background saves have been written to disk. Their
+	 * results can still be retrieved with pollAsyncSave() afterwards.
+	 */
+	virtual void waitForAsyncSaves() {}
 };
 
 /** @} */
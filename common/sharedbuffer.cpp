@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/sharedbuffer.h"
+
+namespace Common {
+
+SharedBuffer::SharedBuffer(byte *data, uint32 size) :
+	_data(data), _size(size), _stream(nullptr), _dispose(DisposeAfterUse::YES) {
+}
+
+SharedBuffer::SharedBuffer(const byte *data, uint32 size, SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream) :
+	_data(data), _size(size), _stream(stream), _dispose(disposeStream) {
+}
+
+SharedBuffer *SharedBuffer::createFromStream(SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream) {
+	const int64 size = stream->size();
+	if (size < 0 || size > 0xFFFFFFFF)
+		return nullptr;
+
+	const byte *data = stream->getView(0, (uint32)size);
+	if (!data)
+		return nullptr;
+
+	return new SharedBuffer(data, (uint32)size, stream, disposeStream);
+}
+
+SharedBuffer::~SharedBuffer() {
+	if (_stream) {
+		if (_dispose == DisposeAfterUse::YES)
+			delete _stream;
+	} else if (_dispose == DisposeAfterUse::YES) {
+		free(const_cast<byte *>(_data));
+	}
+}
+
+SharedBufferReadStream::SharedBufferReadStream(const SharedBufferPtr &buffer) :
+	MemoryReadStream(buffer->getData(), buffer->getSize()), _buffer(buffer) {
+}
+
+SharedBufferReadStream::SharedBufferReadStream(const SharedBufferPtr &buffer, uint32 begin, uint32 end) :
+	MemoryReadStream(buffer->getData() + begin, end - begin), _buffer(buffer) {
+	assert(begin <= end && end <= buffer->getSize());
+}
+
+SharedBufferCache::SharedBufferCache(uint32 maxSize) : _maxSize(maxSize), _size(0) {
+}
+
+SharedBufferPtr SharedBufferCache::get(const String &key) {
+	EntryMap::iterator i = _map.find(key);
+	if (i == _map.end())
+		return SharedBufferPtr();
+
+	// Move the entry to the front
+	const Entry entry = *i->_value;
+	_entries.erase(i->_value);
+	_entries.push_front(entry);
+	i->_value = _entries.begin();
+
+	return entry.buffer;
+}
+
+void SharedBufferCache::put(const String &key, const SharedBufferPtr &buffer) {
+	if (!buffer || buffer->getSize() > _maxSize / 4)
+		return;
+
+	EntryMap::iterator i = _map.find(key);
+	if (i != _map.end()) {
+		_size -= i->_value->buffer->getSize();
+		_entries.erase(i->_value);
+		_map.erase(i);
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.buffer = buffer;
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_size += buffer->getSize();
+
+	while (_size > _maxSize) {
+		const Entry &last = _entries.back();
+		_size -= last.buffer->getSize();
+		_map.erase(last.key);
+		_entries.pop_back();
+	}
+}
+
+void SharedBufferCache::clear() {
+	_entries.clear();
+	_map.clear();
+	_size = 0;
+}
+
+} // End of namespace Common
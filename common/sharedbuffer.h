@@ -0,0 +1,151 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_SHAREDBUFFER_H
+#define COMMON_SHAREDBUFFER_H
+
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/ptr.h"
+#include "common/str.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_sharedbuffer Shared buffers
+ * @ingroup common_memory
+ *
+ * @brief Read-only memory shared by several streams, e.g. archive members.
+ * @{
+ */
+
+/**
+ * A read-only block of memory which is kept alive as long as any stream
+ * created from it exists.
+ *
+ * Archives use it to return members without copying them: stored members
+ * are views into the memory of the archive file, and decompressed members
+ * can be handed to all streams which open them.
+ */
+class SharedBuffer : NonCopyable {
+public:
+	/**
+	 * Create a buffer from memory allocated with malloc(), which is freed
+	 * together with the buffer.
+	 */
+	SharedBuffer(byte *data, uint32 size);
+
+	/**
+	 * Create a buffer from the data of a stream which keeps all of it in
+	 * memory, such as a memory mapped file.
+	 *
+	 * @param stream         The stream, for which getView() has to work.
+	 * @param disposeStream  Whether to delete the stream with the buffer.
+	 *                       The stream is not deleted if no buffer could be
+	 *                       created from it.
+	 *
+	 * @return The buffer, or nullptr if the stream data is not in memory.
+	 */
+	static SharedBuffer *createFromStream(SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream);
+
+	~SharedBuffer();
+
+	const byte *getData() const { return _data; }
+	uint32 getSize() const { return _size; }
+
+private:
+	SharedBuffer(const byte *data, uint32 size, SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream);
+
+	const byte *_data;
+	uint32 _size;
+	SeekableReadStream *_stream;
+	DisposeAfterUse::Flag _dispose;
+};
+
+typedef SharedPtr<SharedBuffer> SharedBufferPtr;
+
+/**
+ * A read stream over all or part of a shared buffer, which keeps the buffer
+ * alive. getView() works on it, so archives can be stacked without copies.
+ */
+class SharedBufferReadStream : public MemoryReadStream {
+public:
+	explicit SharedBufferReadStream(const SharedBufferPtr &buffer);
+	SharedBufferReadStream(const SharedBufferPtr &buffer, uint32 begin, uint32 end);
+
+private:
+	SharedBufferPtr _buffer;
+};
+
+/**
+ * A bounded cache of shared buffers, e.g. of the decompressed members of an
+ * archive, so that opening a member again does not decompress it again.
+ *
+ * The least recently used buffers are dropped when the total size of the
+ * cached buffers exceeds the limit. Streams which still use a dropped
+ * buffer keep it alive on their own.
+ */
+class SharedBufferCache : NonCopyable {
+public:
+	enum {
+		kDefaultMaxSize = 4 * 1024 * 1024
+	};
+
+	explicit SharedBufferCache(uint32 maxSize = kDefaultMaxSize);
+
+	/** Return the buffer cached for @p key, or a null pointer. */
+	SharedBufferPtr get(const String &key);
+
+	/**
+	 * Add a buffer to the cache. Buffers bigger than a quarter of the cache
+	 * are not kept, so they do not push out everything else.
+	 */
+	void put(const String &key, const SharedBufferPtr &buffer);
+
+	void clear();
+
+	uint32 getSize() const { return _size; }
+
+private:
+	struct Entry {
+		String key;
+		SharedBufferPtr buffer;
+	};
+
+	typedef List<Entry> EntryList;
+	typedef HashMap<String, EntryList::iterator, IgnoreCase_Hash, IgnoreCase_EqualTo> EntryMap;
+
+	/** The cached buffers, the most recently used first */
+	EntryList _entries;
+	EntryMap _map;
+	uint32 _maxSize;
+	uint32 _size;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
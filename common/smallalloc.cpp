@@ -0,0 +1,293 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/smallalloc.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#include <atomic>
+
+namespace Common {
+
+namespace {
+
+enum {
+	kNumSizeClasses = 16,
+	kPageSize = 64 * 1024,
+	/** Number of objects moved between a thread and the shared lists at once */
+	kBatchSize = 32,
+	/** Number of free objects of a class a thread keeps at most */
+	kMaxCachedObjects = 2 * kBatchSize,
+	/** Number of attempts to take a shared list lock before sleeping */
+	kLockSpinCount = 100
+};
+
+const uint16 kClassSizes[kNumSizeClasses] = {
+	8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256
+};
+
+inline uint sizeToClass(size_t size) {
+	if (size <= 64)
+		return size ? (size - 1) >> 3 : 0;
+	if (size <= 128)
+		return 8 + ((size - 65) >> 4);
+	return 12 + ((size - 129) >> 5);
+}
+
+/**
+ * The objects of a size class which no thread holds. This has no
+ * constructor and is initialized with constants, so it is ready before any
+ * static constructor runs and allocates memory.
+ */
+struct SharedList {
+	std::atomic_flag lock;
+	void *freeList;
+	uint32 pageCount;
+
+	uint64 allocCount;
+	uint64 freeCount;
+	int64 liveCount;
+	int64 peakLiveCount;
+};
+
+#define SHARED_LIST_INIT { ATOMIC_FLAG_INIT, nullptr, 0, 0, 0, 0, 0 }
+
+SharedList g_shared[kNumSizeClasses] = {
+	SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT,
+	SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT,
+	SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT,
+	SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT, SHARED_LIST_INIT
+};
+
+#undef SHARED_LIST_INIT
+
+/** The free objects a thread keeps, and its allocations not yet counted. */
+struct ThreadCache {
+	void *freeList[kNumSizeClasses];
+	uint32 count[kNumSizeClasses];
+	uint32 allocCount[kNumSizeClasses];
+	uint32 freeCount[kNumSizeClasses];
+	/** Set once the thread exits, from then on the shared lists are used directly */
+	bool disabled;
+};
+
+thread_local ThreadCache t_cache;
+
+/** Returns the objects of a thread to the shared lists when it exits. */
+struct ThreadCacheReaper {
+	bool active;
+	~ThreadCacheReaper();
+};
+
+thread_local ThreadCacheReaper t_reaper;
+
+class SharedListLock {
+public:
+	explicit SharedListLock(SharedList &list) : _list(list) {
+		uint spins = 0;
+		while (_list.lock.test_and_set(std::memory_order_acquire)) {
+			// The holder may be a thread of lower priority, which does not
+			// get to release the lock while this one keeps spinning. Before
+			// g_system is set up, there is only one thread anyway.
+			if (++spins >= kLockSpinCount && g_system) {
+				g_system->delayMillis(1);
+				spins = 0;
+			}
+		}
+	}
+	~SharedListLock() {
+		_list.lock.clear(std::memory_order_release);
+	}
+
+private:
+	SharedList &_list;
+};
+
+/** Add the allocations of this thread to the statistics. The list must be locked. */
+void publishStats(SharedList &list, ThreadCache &cache, uint sizeClass) {
+	list.allocCount += cache.allocCount[sizeClass];
+	list.freeCount += cache.freeCount[sizeClass];
+	list.liveCount += (int64)cache.allocCount[sizeClass] - cache.freeCount[sizeClass];
+	list.peakLiveCount = MAX(list.peakLiveCount, list.liveCount);
+	cache.allocCount[sizeClass] = 0;
+	cache.freeCount[sizeClass] = 0;
+}
+
+/** Split a new page into objects. The list must be locked. */
+void addPage(SharedList &list, uint sizeClass) {
+	const uint32 objectSize = kClassSizes[sizeClass];
+	byte *page = (byte *)malloc(kPageSize);
+	if (!page)
+		error("allocSmallObject: failure to allocate %u bytes", (uint)kPageSize);
+
+	for (uint32 offset = 0; offset + objectSize <= kPageSize; offset += objectSize) {
+		*(void **)(page + offset) = list.freeList;
+		list.freeList = page + offset;
+	}
+	list.pageCount++;
+}
+
+/** Move up to @p count objects from the shared list to the thread. The list must be locked. */
+void refill(SharedList &list, ThreadCache &cache, uint sizeClass, uint count) {
+	for (uint i = 0; i < count; ++i) {
+		if (!list.freeList)
+			addPage(list, sizeClass);
+
+		void *ptr = list.freeList;
+		list.freeList = *(void **)ptr;
+		*(void **)ptr = cache.freeList[sizeClass];
+		cache.freeList[sizeClass] = ptr;
+	}
+	cache.count[sizeClass] += count;
+}
+
+/** Move up to @p count objects from the thread to the shared list. The list must be locked. */
+void drain(SharedList &list, ThreadCache &cache, uint sizeClass, uint count) {
+	for (uint i = 0; i < count && cache.freeList[sizeClass]; ++i) {
+		void *ptr = cache.freeList[sizeClass];
+		cache.freeList[sizeClass] = *(void **)ptr;
+		*(void **)ptr = list.freeList;
+		list.freeList = ptr;
+		cache.count[sizeClass]--;
+	}
+}
+
+ThreadCacheReaper::~ThreadCacheReaper() {
+	ThreadCache &cache = t_cache;
+	for (uint sizeClass = 0; sizeClass < kNumSizeClasses; ++sizeClass) {
+		SharedListLock lock(g_shared[sizeClass]);
+		publishStats(g_shared[sizeClass], cache, sizeClass);
+		drain(g_shared[sizeClass], cache, sizeClass, cache.count[sizeClass]);
+	}
+	cache.disabled = true;
+}
+
+void *allocSlow(uint sizeClass) {
+	ThreadCache &cache = t_cache;
+	SharedList &list = g_shared[sizeClass];
+
+	if (!cache.disabled) {
+		// Make sure the objects are given back when the thread exits
+		t_reaper.active = true;
+	}
+
+	SharedListLock lock(list);
+	if (cache.disabled) {
+		cache.allocCount[sizeClass]++;
+		refill(list, cache, sizeClass, 1);
+	} else {
+		cache.allocCount[sizeClass]++;
+		refill(list, cache, sizeClass, kBatchSize);
+	}
+	publishStats(list, cache, sizeClass);
+
+	void *ptr = cache.freeList[sizeClass];
+	cache.freeList[sizeClass] = *(void **)ptr;
+	cache.count[sizeClass]--;
+	return ptr;
+}
+
+void freeSlow(void *ptr, uint sizeClass) {
+	ThreadCache &cache = t_cache;
+	SharedList &list = g_shared[sizeClass];
+
+	SharedListLock lock(list);
+	*(void **)ptr = list.freeList;
+	list.freeList = ptr;
+	cache.freeCount[sizeClass]++;
+	publishStats(list, cache, sizeClass);
+}
+
+} // End of anonymous namespace
+
+void *allocSmallObject(size_t size) {
+	if (size > kSmallObjectMaxSize) {
+		void *ptr = malloc(size);
+		if (!ptr)
+			error("allocSmallObject: failure to allocate %u bytes", (uint)size);
+		return ptr;
+	}
+
+	const uint sizeClass = sizeToClass(size);
+	ThreadCache &cache = t_cache;
+	void *ptr = cache.freeList[sizeClass];
+	if (!ptr)
+		return allocSlow(sizeClass);
+
+	cache.freeList[sizeClass] = *(void **)ptr;
+	cache.count[sizeClass]--;
+	cache.allocCount[sizeClass]++;
+	return ptr;
+}
+
+void freeSmallObject(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+	if (size > kSmallObjectMaxSize) {
+		free(ptr);
+		return;
+	}
+
+	const uint sizeClass = sizeToClass(size);
+	ThreadCache &cache = t_cache;
+	if (cache.disabled) {
+		freeSlow(ptr, sizeClass);
+		return;
+	}
+
+	if (!cache.count[sizeClass])
+		t_reaper.active = true;
+
+	*(void **)ptr = cache.freeList[sizeClass];
+	cache.freeList[sizeClass] = ptr;
+	cache.freeCount[sizeClass]++;
+
+	if (++cache.count[sizeClass] > kMaxCachedObjects) {
+		SharedList &list = g_shared[sizeClass];
+		SharedListLock lock(list);
+		publishStats(list, cache, sizeClass);
+		drain(list, cache, sizeClass, kBatchSize);
+	}
+}
+
+uint getSmallObjectSizeClasses() {
+	return kNumSizeClasses;
+}
+
+SmallObjectStats getSmallObjectStats(uint sizeClass) {
+	assert(sizeClass < kNumSizeClasses);
+	SharedList &list = g_shared[sizeClass];
+	SharedListLock lock(list);
+	publishStats(list, t_cache, sizeClass);
+
+	SmallObjectStats stats;
+	stats.objectSize = kClassSizes[sizeClass];
+	stats.allocCount = list.allocCount;
+	stats.freeCount = list.freeCount;
+	stats.liveCount = MAX<int64>(list.liveCount, 0);
+	stats.peakLiveCount = list.peakLiveCount;
+	stats.reservedBytes = list.pageCount * kPageSize;
+	return stats;
+}
+
+} // End of namespace Common
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_SMALLALLOC_H
+#define COMMON_SMALLALLOC_H
+
+#include "common/scummsys.h"
+
+#ifndef HAS_THREAD_LOCAL
+#error "The small object allocator needs thread_local support, see configure"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_smallalloc Small object allocator
+ * @ingroup common_memory
+ *
+ * @brief Process-wide allocator for small objects.
+ *
+ * Objects of up to kSmallObjectMaxSize bytes are served from pages shared
+ * by the whole process, split into size classes. Each thread keeps a few
+ * free objects of each class, so that allocating and freeing usually does
+ * not need any synchronization. Threads exchange objects with the shared
+ * lists in batches.
+ *
+ * Memory is freed with the size it was allocated with, so objects need no
+ * header. The pages are never given back to the system.
+ *
+ * @{
+ */
+
+enum {
+	kSmallObjectMaxSize = 256
+};
+
+/**
+ * Allocate @p size bytes. Sizes above kSmallObjectMaxSize are passed on
+ * to malloc().
+ */
+void *allocSmallObject(size_t size);
+
+/**
+ * Free memory obtained from allocSmallObject(). @p size must be the size
+ * it was allocated with.
+ */
+void freeSmallObject(void *ptr, size_t size);
+
+/** Allocation statistics of one size class. */
+struct SmallObjectStats {
+	uint32 objectSize;    ///< Size of the objects of this class
+	uint64 allocCount;    ///< Number of allocations so far
+	uint64 freeCount;     ///< Number of frees so far
+	uint32 liveCount;     ///< Number of objects in use
+	uint32 peakLiveCount; ///< Highest number of objects in use at once
+	uint32 reservedBytes; ///< Bytes in pages of this class
+};
+
+/** Return the number of size classes. */
+uint getSmallObjectSizeClasses();
+
+/**
+ * Return the statistics of a size class. Other threads report their
+ * allocations in batches, so the counts may lag behind a little.
+ */
+SmallObjectStats getSmallObjectStats(uint sizeClass);
+
+/**
+ * Drop-in replacement for MemoryPool, which takes its chunks from the
+ * small object allocator instead of pages of its own. It can therefore
+ * be used from several threads, and unused chunks of one pool can be
+ * reused by all others of a similar size.
+ */
+class SmallObjectPool {
+public:
+	explicit SmallObjectPool(size_t chunkSize) : _chunkSize(chunkSize) {}
+
+	void *allocChunk() { return allocSmallObject(_chunkSize); }
+	void freeChunk(void *ptr) { freeSmallObject(ptr, _chunkSize); }
+
+	/** The chunks are owned by the allocator, so there is nothing to do. */
+	void freeUnusedPages() {}
+
+	size_t getChunkSize() const { return _chunkSize; }
+
+private:
+	size_t _chunkSize;
+};
+
+/**
+ * Drop-in replacement for ObjectPool, see SmallObjectPool.
+ */
+template<class T>
+class SmallObjectPoolFor : public SmallObjectPool {
+public:
+	SmallObjectPoolFor() : SmallObjectPool(sizeof(T)) {}
+
+	/**
+	 * Return the memory chunk used as storage for the given object back
+	 * to the pool, after calling its destructor.
+	 */
+	void deleteChunk(T *ptr) {
+		ptr->~T();
+		this->freeChunk(ptr);
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+/**
+ * A custom placement new operator, using a SmallObjectPool.
+ */
+inline void *operator new(size_t nbytes, Common::SmallObjectPool &pool) {
+	assert(nbytes <= pool.getChunkSize());
+	return pool.allocChunk();
+}
+
+inline void operator delete(void *p, Common::SmallObjectPool &pool) {
+	pool.freeChunk(p);
+}
+
+#endif
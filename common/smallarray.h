@@ -0,0 +1,399 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_SMALLARRAY_H
+#define COMMON_SMALLARRAY_H
+
+#include "common/scummsys.h"
+#include "common/algorithm.h"
+#include "common/textconsole.h" // For error()
+#include "common/memory.h"
+#include "common/initializer_list.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_smallarray Small arrays
+ * @ingroup common
+ *
+ * @brief  Arrays which store a few elements without allocating memory.
+ * @{
+ */
+
+/**
+ * An array with room for @p N elements inside the object itself. It only
+ * allocates memory once it grows beyond that, so short lived arrays which
+ * are usually small, like the vertices of a path or the dirty rectangles of
+ * a frame, do not cost a malloc() each time.
+ *
+ * It has the same interface as Array. Since the elements are stored in the
+ * object, moving a SmallArray copies them while it uses the inline storage.
+ */
+template<class T, uint N>
+class SmallArray {
+public:
+	typedef T *iterator; /*!< Array iterator. */
+	typedef const T *const_iterator; /*!< Const-qualified array iterator. */
+
+	typedef T value_type; /*!< Value type of the array. */
+
+	typedef uint size_type; /*!< Size type of the array. */
+
+protected:
+	size_type _capacity; /*!< Maximum number of elements the array can hold. */
+	size_type _size; /*!< How many elements the array holds. */
+	T *_storage;  /*!< Memory used for element storage, either _inline or allocated. */
+
+	/** Storage for the first N elements. */
+	alignas(T) byte _inline[N * sizeof(T)];
+
+public:
+	SmallArray() : _capacity(N), _size(0), _storage(inlineStorage()) {}
+
+	/**
+	 * Construct an array with @p count default-inserted instances of @p T. No
+	 * copies are made.
+	 */
+	explicit SmallArray(size_type count) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		resize(count);
+	}
+
+	/**
+	 * Construct an array with @p count copies of elements with value @p value.
+	 */
+	SmallArray(size_type count, const T &value) : _capacity(N), _size(count), _storage(inlineStorage()) {
+		reserveExact(count);
+		uninitialized_fill_n(_storage, count, value);
+	}
+
+	/**
+	 * Construct an array as a copy of the given @p array.
+	 */
+	SmallArray(const SmallArray &array) : _capacity(N), _size(array._size), _storage(inlineStorage()) {
+		reserveExact(_size);
+		uninitialized_copy(array._storage, array._storage + _size, _storage);
+	}
+
+	/**
+	 * Construct an array as a copy of the given array using the C++11 move
+	 * semantic. The elements are only taken over if they are not stored
+	 * inline.
+	 */
+	SmallArray(SmallArray &&old) : _capacity(N), _size(0), _storage(inlineStorage()) {
+		*this = static_cast<SmallArray &&>(old);
+	}
+
+	/**
+	 * Construct an array using list initialization.
+	 */
+	SmallArray(std::initializer_list<T> list) : _capacity(N), _size(list.size()), _storage(inlineStorage()) {
+		reserveExact(_size);
+		uninitialized_copy(list.begin(), list.end(), _storage);
+	}
+
+	~SmallArray() {
+		freeStorage(_storage, _size);
+	}
+
+	/** Append an element to the end of the array. */
+	void push_back(const T &element) {
+		if (_size < _capacity) {
+			new ((void *)&_storage[_size++]) T(element);
+		} else {
+			// The element may be in the current storage, so copy it
+			// before the storage is freed
+			T *const oldStorage = _storage;
+			allocCapacity(roundUpCapacity(_size + 1));
+			new ((void *)&_storage[_size]) T(element);
+			uninitialized_copy(oldStorage, oldStorage + _size, _storage);
+			freeStorage(oldStorage, _size);
+			_size++;
+		}
+	}
+
+	/** Remove the last element of the array. */
+	void pop_back() {
+		assert(_size > 0);
+		_size--;
+		// We also need to destroy the last object properly here.
+		_storage[_size].~T();
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	const T *data() const {
+		return _storage;
+	}
+
+	/** Return a pointer to the underlying memory serving as element storage. */
+	T *data() {
+		return _storage;
+	}
+
+	/** Return a reference to the first element of the array. */
+	T &front() {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the first element of the array. */
+	const T &front() const {
+		assert(_size > 0);
+		return _storage[0];
+	}
+
+	/** Return a reference to the last element of the array. */
+	T &back() {
+		assert(_size > 0);
+		return _storage[_size-1];
+	}
+
+	/** Return a reference to the last element of the array. */
+	const T &back() const {
+		assert(_size > 0);
+		return _storage[_size-1];
+	}
+
+	/** Insert an element into the array at the given position. */
+	void insert_at(size_type idx, const T &element) {
+		assert(idx <= _size);
+		if (idx == _size) {
+			push_back(element);
+			return;
+		}
+
+		// The element may be moved by the insertion
+		const T tmp = element;
+		if (_size == _capacity)
+			reserve(roundUpCapacity(_size + 1));
+		new ((void *)&_storage[_size]) T(_storage[_size - 1]);
+		copy_backward(_storage + idx, _storage + _size - 1, _storage + _size);
+		_storage[idx] = tmp;
+		_size++;
+	}
+
+	/**
+	 * Insert an element before @p pos.
+	 */
+	void insert(iterator pos, const T &element) {
+		insert_at(pos - _storage, element);
+	}
+
+	/** Remove an element at the given position from the array and return the value of that element. */
+	T remove_at(size_type idx) {
+		assert(idx < _size);
+		T tmp = _storage[idx];
+		copy(_storage + idx + 1, _storage + _size, _storage + idx);
+		_size--;
+		// We also need to destroy the last object properly here.
+		_storage[_size].~T();
+		return tmp;
+	}
+
+	/** Return a reference to the element at the given position in the array. */
+	T &operator[](size_type idx) {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Return a const reference to the element at the given position in the array. */
+	const T &operator[](size_type idx) const {
+		assert(idx < _size);
+		return _storage[idx];
+	}
+
+	/** Assign the given @p array to this array. */
+	SmallArray &operator=(const SmallArray &array) {
+		if (this == &array)
+			return *this;
+
+		clear();
+		reserveExact(array._size);
+		uninitialized_copy(array._storage, array._storage + array._size, _storage);
+		_size = array._size;
+
+		return *this;
+	}
+
+	/** Assign the given array to this array using the C++11 move semantic. */
+	SmallArray &operator=(SmallArray &&old) {
+		if (this == &old)
+			return *this;
+
+		if (old.isInline()) {
+			*this = old;
+			old.clear();
+			return *this;
+		}
+
+		freeStorage(_storage, _size);
+		_capacity = old._capacity;
+		_size = old._size;
+		_storage = old._storage;
+
+		old._storage = old.inlineStorage();
+		old._capacity = N;
+		old._size = 0;
+
+		return *this;
+	}
+
+	/** Return the size of the array. */
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+	 * Clear the array of all its elements. Allocated memory is freed, the
+	 * array uses its inline storage again.
+	 */
+	void clear() {
+		freeStorage(_storage, _size);
+		_storage = inlineStorage();
+		_size = 0;
+		_capacity = N;
+	}
+
+	/** Erase the element at @p pos position and return an iterator pointing to the next element in the array. */
+	iterator erase(iterator pos) {
+		copy(pos + 1, _storage + _size, pos);
+		_size--;
+		// We also need to destroy the last object properly here.
+		_storage[_size].~T();
+		return pos;
+	}
+
+	/** Check whether the array is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+
+	/** Check whether the elements are stored inside the object. */
+	bool isInline() const {
+		return _storage == inlineStorage();
+	}
+
+	/** Check whether two arrays are identical. */
+	bool operator==(const SmallArray &other) const {
+		if (this == &other)
+			return true;
+		if (_size != other._size)
+			return false;
+		for (size_type i = 0; i < _size; ++i) {
+			if (_storage[i] != other._storage[i])
+				return false;
+		}
+		return true;
+	}
+
+	/** Check if two arrays are different. */
+	bool operator!=(const SmallArray &other) const {
+		return !(*this == other);
+	}
+
+	/** Return an iterator pointing to the first element in the array. */
+	iterator       begin() {
+		return _storage;
+	}
+
+	/** Return an iterator pointing past the last element in the array. */
+	iterator       end() {
+		return _storage + _size;
+	}
+
+	/** Return a const iterator pointing to the first element in the array. */
+	const_iterator begin() const {
+		return _storage;
+	}
+
+	/** Return a const iterator pointing past the last element in the array. */
+	const_iterator end() const {
+		return _storage + _size;
+	}
+
+	/** Reserve enough memory in the array so that it can store at least the given number of elements.
+	 *  The current content of the array is not modified.
+	 */
+	void reserve(size_type newCapacity) {
+		if (newCapacity <= _capacity)
+			return;
+
+		T *const oldStorage = _storage;
+		allocCapacity(newCapacity);
+		uninitialized_copy(oldStorage, oldStorage + _size, _storage);
+		freeStorage(oldStorage, _size);
+	}
+
+	/** Change the size of the array. */
+	void resize(size_type newSize) {
+		reserve(newSize);
+		for (size_type i = newSize; i < _size; ++i)
+			_storage[i].~T();
+		for (size_type i = _size; i < newSize; ++i)
+			new ((void *)&_storage[i]) T();
+		_size = newSize;
+	}
+
+protected:
+	T *inlineStorage() {
+		return (T *)_inline;
+	}
+
+	const T *inlineStorage() const {
+		return (const T *)_inline;
+	}
+
+	/** Round up capacity to the next power of 2, at least twice the inline capacity. */
+	static size_type roundUpCapacity(size_type capacity) {
+		size_type capa = 2 * N;
+		while (capa < capacity)
+			capa <<= 1;
+		return capa;
+	}
+
+	/** Reserve space for @p capacity elements in an empty array. */
+	void reserveExact(size_type capacity) {
+		if (capacity > N)
+			allocCapacity(capacity);
+	}
+
+	/** Allocate a specific capacity for the array. */
+	void allocCapacity(size_type capacity) {
+		_capacity = capacity;
+		_storage = (T *)malloc(sizeof(T) * capacity);
+		if (!_storage)
+			::error("Common::SmallArray: failure to allocate %u bytes", capacity * (size_type)sizeof(T));
+	}
+
+	/** Destroy the elements and free the storage, unless it is the inline one. */
+	void freeStorage(T *storage, const size_type elements) {
+		for (size_type i = 0; i < elements; ++i)
+			storage[i].~T();
+		if (storage != inlineStorage())
+			free(storage);
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -136,6 +136,13 @@ bool MemoryReadStream::seek(int64 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+const byte *MemoryReadStream::getView(int64 offset, uint32 dataSize) const {
+	if (offset < 0 || offset > _size || dataSize > _size - offset)
+		return nullptr;
+
+	return _ptrOrig + offset;
+}
+
 #pragma mark -
 
 enum {
@@ -270,6 +277,13 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getView(int64 offset, uint32 dataSize) const {
+	if (offset < 0 || offset > size() || dataSize > size() - offset)
+		return nullptr;
+
+	return _parentStream->getView(_begin + offset, dataSize);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
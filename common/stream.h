@@ -711,6 +711,22 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Get direct access to @p dataSize bytes of the stream data, starting at
+	 * @p offset, without copying them.
+	 *
+	 * This is only supported by streams which have all their data in memory
+	 * already, such as memory read streams and memory mapped files. The
+	 * position indicator of the stream is not changed.
+	 *
+	 * @note The data must not be modified, and stays valid only as long as
+	 * the stream exists.
+	 *
+	 * @return Pointer to the data, or nullptr if the stream does not support
+	 *         this or the range is not inside the stream.
+	 */
+	virtual const byte *getView(int64 offset, uint32 dataSize) const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/stringbuilder.h"
+#include "common/stream.h"
+
+#include <stdarg.h>
+
+namespace Common {
+
+StringBuilder::StringBuilder() : _str(_builtin), _size(0), _capacity(kBuiltinCapacity) {
+	_builtin[0] = 0;
+}
+
+StringBuilder::StringBuilder(uint32 capacity) : _str(_builtin), _size(0), _capacity(kBuiltinCapacity) {
+	_builtin[0] = 0;
+	reserve(capacity);
+}
+
+StringBuilder::~StringBuilder() {
+	if (_str != _builtin)
+		free(_str);
+}
+
+void StringBuilder::reserve(uint32 len) {
+	if (len < _capacity)
+		return;
+
+	// Grow geometrically, so that appending is linear in the total length
+	uint32 capacity = MAX<uint32>(_capacity * 2, len + 1);
+	char *str = (char *)malloc(capacity);
+	if (!str)
+		error("StringBuilder: failure to allocate %u bytes", capacity);
+	memcpy(str, _str, _size + 1);
+
+	if (_str != _builtin)
+		free(_str);
+	_str = str;
+	_capacity = capacity;
+}
+
+StringBuilder &StringBuilder::append(const char *str, uint32 len) {
+	// str may point into the text itself, which reserve() can free. The
+	// pointers are compared as integers, see BaseString::pointerInOwnBuffer().
+	const uintptr offset = (uintptr)str - (uintptr)_str;
+	const bool ownText = offset <= _size;
+
+	reserve(_size + len);
+	if (ownText)
+		str = _str + offset;
+
+	memmove(_str + _size, str, len);
+	_size += len;
+	_str[_size] = 0;
+	return *this;
+}
+
+StringBuilder &StringBuilder::append(char c) {
+	reserve(_size + 1);
+	_str[_size++] = c;
+	_str[_size] = 0;
+	return *this;
+}
+
+StringBuilder &StringBuilder::appendFormat(const char *fmt, ...) {
+	va_list va;
+	va_start(va, fmt);
+	appendVFormat(fmt, va);
+	va_end(va);
+	return *this;
+}
+
+StringBuilder &StringBuilder::appendVFormat(const char *fmt, va_list args) {
+	for (;;) {
+		const uint32 space = _capacity - _size;
+
+		va_list va;
+		scumm_va_copy(va, args);
+		const int len = vsnprintf(_str + _size, space, fmt, va);
+		va_end(va);
+
+		if (len >= 0 && (uint32)len < space) {
+			_size += len;
+			return *this;
+		}
+
+		// Some vsnprintf implementations return -1 instead of the length
+		// of the whole text when it does not fit
+		_str[_size] = 0;
+		reserve(len >= 0 ? _size + len : _capacity * 2);
+	}
+}
+
+void StringBuilder::truncate(uint32 len) {
+	if (len < _size) {
+		_size = len;
+		_str[_size] = 0;
+	}
+}
+
+StringRope::StringRope(size_t chunkSize) : _arena(chunkSize), _size(0) {
+}
+
+void StringRope::append(const char *str, uint32 len) {
+	if (!len)
+		return;
+
+	char *dst = (char *)_arena.allocate(len, 1);
+	memcpy(dst, str, len);
+	_size += len;
+
+	if (!_pieces.empty() && _pieces.back().str + _pieces.back().len == dst) {
+		_pieces.back().len += len;
+	} else {
+		Piece piece;
+		piece.str = dst;
+		piece.len = len;
+		_pieces.push_back(piece);
+	}
+}
+
+void StringRope::appendFormat(const char *fmt, ...) {
+	StringBuilder str;
+	va_list va;
+	va_start(va, fmt);
+	str.appendVFormat(fmt, va);
+	va_end(va);
+	append(str);
+}
+
+void StringRope::clear() {
+	_arena.reset();
+	_pieces.clear();
+	_size = 0;
+}
+
+String StringRope::toString() const {
+	if (_pieces.size() == 1)
+		return String(_pieces[0].str, _pieces[0].len);
+
+	StringBuilder str(_size);
+	for (uint i = 0; i < _pieces.size(); ++i)
+		str.append(_pieces[i].str, _pieces[i].len);
+	return str.toString();
+}
+
+bool StringRope::write(WriteStream &stream) const {
+	for (uint i = 0; i < _pieces.size(); ++i) {
+		if (stream.write(_pieces[i].str, _pieces[i].len) != _pieces[i].len)
+			return false;
+	}
+	return true;
+}
+
+} // End of namespace Common
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_STRINGBUILDER_H
+#define COMMON_STRINGBUILDER_H
+
+#include "common/array.h"
+#include "common/framearena.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+namespace Common {
+
+class WriteStream;
+
+/**
+ * @defgroup common_stringbuilder String builders
+ * @ingroup common_str
+ *
+ * @brief Helpers for building long texts piece by piece.
+ *
+ * @{
+ */
+
+/**
+ * A growable character buffer for building a text with many appends. Unlike
+ * String, it never shares its buffer, so appending does not need to check
+ * reference counts, and clear() keeps the buffer for the next text.
+ *
+ * Texts of up to kBuiltinCapacity - 1 characters are stored in the object
+ * itself. appendFormat() prints directly into the buffer, so it only
+ * allocates memory when the buffer has to grow.
+ */
+class StringBuilder : NonCopyable {
+public:
+	enum {
+		kBuiltinCapacity = 128
+	};
+
+	StringBuilder();
+	explicit StringBuilder(uint32 capacity);
+	~StringBuilder();
+
+	StringBuilder &append(const char *str, uint32 len);
+	StringBuilder &append(const char *str) { return append(str, strlen(str)); }
+	StringBuilder &append(const String &str) { return append(str.c_str(), str.size()); }
+	StringBuilder &append(char c);
+
+	/** Append formatted text, like sprintf(). */
+	StringBuilder &appendFormat(MSVC_PRINTF const char *fmt, ...) GCC_PRINTF(2, 3);
+	StringBuilder &appendVFormat(const char *fmt, va_list args);
+
+	StringBuilder &operator+=(const char *str) { return append(str); }
+	StringBuilder &operator+=(const String &str) { return append(str); }
+	StringBuilder &operator+=(char c) { return append(c); }
+
+	/** Return the text, which is always null-terminated. */
+	const char *c_str() const { return _str; }
+	uint32 size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	char lastChar() const { return _size ? _str[_size - 1] : 0; }
+
+	/** Remove the text, but keep the buffer. */
+	void clear() { truncate(0); }
+
+	/** Shorten the text to @p len characters. */
+	void truncate(uint32 len);
+
+	/** Make room for a text of @p len characters. */
+	void reserve(uint32 len);
+
+	/** Return a copy of the text. */
+	String toString() const { return String(_str, _size); }
+
+private:
+	char *_str;
+	uint32 _size;
+	uint32 _capacity; ///< Size of _str, including the terminating null
+	char _builtin[kBuiltinCapacity];
+};
+
+/**
+ * A text stored as a list of pieces in a FrameArena. Appending never moves
+ * the text appended before, so building a text of several megabytes, like
+ * the transcript of a long interactive fiction session, takes linear time
+ * and does not need a single huge allocation.
+ *
+ * Consecutive appends usually end up next to each other in the arena and
+ * then form a single piece. toString() or write() produce the whole text.
+ */
+class StringRope : NonCopyable {
+public:
+	enum {
+		kDefaultChunkSize = 16 * 1024
+	};
+
+	explicit StringRope(size_t chunkSize = kDefaultChunkSize);
+
+	void append(const char *str, uint32 len);
+	void append(const char *str) { append(str, strlen(str)); }
+	void append(const String &str) { append(str.c_str(), str.size()); }
+	void append(const StringBuilder &str) { append(str.c_str(), str.size()); }
+	void append(char c) { append(&c, 1); }
+
+	/** Append formatted text, like sprintf(). */
+	void appendFormat(MSVC_PRINTF const char *fmt, ...) GCC_PRINTF(2, 3);
+
+	StringRope &operator+=(const char *str) { append(str); return *this; }
+	StringRope &operator+=(const String &str) { append(str); return *this; }
+	StringRope &operator+=(char c) { append(c); return *this; }
+
+	uint32 size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	/** Remove the text. The memory of the arena is kept. */
+	void clear();
+
+	uint getPieceCount() const { return _pieces.size(); }
+
+	/** Return the characters of a piece, they are not null-terminated. */
+	const char *getPiece(uint index, uint32 &len) const {
+		len = _pieces[index].len;
+		return _pieces[index].str;
+	}
+
+	/** Return the whole text as one String. */
+	String toString() const;
+
+	/** Write the whole text to @p stream. */
+	bool write(WriteStream &stream) const;
+
+private:
+	struct Piece {
+		const char *str;
+		uint32 len;
+	};
+
+	FrameArena _arena;
+	Array<Piece> _pieces;
+	uint32 _size;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -30,6 +30,7 @@
 #include "common/hash-str.h"
 #include "common/hashmap.h"
 #include "common/memstream.h"
+#include "common/sharedbuffer.h"
 #include "common/substream.h"
 
 namespace Common {
@@ -62,11 +63,17 @@ private:
 
 	Common::SeekableReadStream *_stream;
 
+	/** The whole archive, if it is in memory */
+	Common::SharedBufferPtr _data;
+
+	/** Recently decompressed members */
+	mutable Common::SharedBufferCache _cache;
+
 	typedef Common::HashMap<Common::String, FileEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileMap;
 	FileMap _map;
 
 	// Decompression Functions
-	Common::SeekableReadStream *decompress14(Common::SeekableReadStream *src, uint32 uncompressedSize) const;
+	Common::SharedBuffer *decompress14(Common::SeekableReadStream *src, uint32 uncompressedSize) const;
 
 	// Decompression Helpers
 	void update14(uint16 first, uint16 last, byte *code, uint16 *freq) const;
@@ -102,6 +109,11 @@ bool StuffItArchive::open(Common::SeekableReadStream *stream) {
 	if (!_stream)
 		return false;
 
+	// Stored members of an archive in memory are returned as views into it
+	_data = Common::SharedBufferPtr(Common::SharedBuffer::createFromStream(_stream, DisposeAfterUse::YES));
+	if (_data)
+		_stream = new Common::SharedBufferReadStream(_data);
+
 	uint32 tag = _stream->readUint32BE();
 
 	// Check all the possible FourCC's
@@ -202,6 +214,8 @@ bool StuffItArchive::open(Common::SeekableReadStream *stream) {
 void StuffItArchive::close() {
 	delete _stream;
 	_stream = nullptr;
+	_data.reset();
+	_cache.clear();
 	_map.clear();
 }
 
@@ -232,14 +246,24 @@ Common::SeekableReadStream *StuffItArchive::createReadStreamForMember(const Comm
 	if (entry.compression & 0xF0)
 		error("Unhandled StuffIt encryption");
 
+	if (entry.compression == 0 && _data && entry.offset <= _data->getSize() && entry.compressedSize <= _data->getSize() - entry.offset)
+		return new Common::SharedBufferReadStream(_data, entry.offset, entry.offset + entry.compressedSize);
+
+	Common::SharedBufferPtr cached = _cache.get(name);
+	if (cached)
+		return new Common::SharedBufferReadStream(cached);
+
 	Common::SeekableSubReadStream subStream(_stream, entry.offset, entry.offset + entry.compressedSize);
 
 	// We currently only support type 14 compression
 	switch (entry.compression) {
 	case 0: // Uncompressed
 		return subStream.readStream(subStream.size());
-	case 14: // Installer
-		return decompress14(&subStream, entry.uncompressedSize);
+	case 14: { // Installer
+		Common::SharedBufferPtr member(decompress14(&subStream, entry.uncompressedSize));
+		_cache.put(name, member);
+		return new Common::SharedBufferReadStream(member);
+	}
 	default:
 		error("Unhandled StuffIt compression %d", entry.compression);
 	}
@@ -434,7 +458,7 @@ void StuffItArchive::readTree14(Common::BitStream8LSB *bits, SIT14Data *dat, uin
 	dat->window[j++] = x; \
 	j &= 0x3FFFF
 
-Common::SeekableReadStream *StuffItArchive::decompress14(Common::SeekableReadStream *src, uint32 uncompressedSize) const {
+Common::SharedBuffer *StuffItArchive::decompress14(Common::SeekableReadStream *src, uint32 uncompressedSize) const {
 	byte *dst = (byte *)malloc(uncompressedSize);
 	Common::MemoryWriteStream out(dst, uncompressedSize);
 
@@ -526,7 +550,7 @@ Common::SeekableReadStream *StuffItArchive::decompress14(Common::SeekableReadStr
 	delete dat;
 	delete bits;
 
-	return new Common::MemoryReadStream(dst, uncompressedSize, DisposeAfterUse::YES);
+	return new Common::SharedBuffer(dst, uncompressedSize);
 }
 
 #undef OUTPUT_VAL
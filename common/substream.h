@@ -85,6 +85,8 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	virtual const byte *getView(int64 offset, uint32 dataSize) const;
 };
 
 /**
@@ -108,6 +110,8 @@ public:
 	bool seek(int64 offset, int whence = SEEK_SET) override { return SeekableSubReadStream::seek(offset, whence); }
 	void hexdump(int len, int bytesPerLine = 16, int startOffset = 0) { SeekableSubReadStream::hexdump(len, bytesPerLine, startOffset); }
 	bool skip(uint32 offset) override { return SeekableSubReadStream::seek(offset, SEEK_CUR); }
+
+	const byte *getView(int64 offset, uint32 dataSize) const override { return SeekableSubReadStream::getView(offset, dataSize); }
 };
 
 /**
@@ -46,6 +46,9 @@ class OptionsContainerWidget;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
+typedef void (*ThreadProc)(void *data);
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -497,7 +500,29 @@ public:
 		/**
 		* For platforms that should not have a Quit button.
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		/**
+		 * The host CPU supports the SSE2 instruction set.
+		 *
+		 * Code which has SIMD variants checks this at runtime to pick an
+		 * implementation. This feature has no associated state.
+		 */
+		kFeatureCpuSSE2,
+
+		/**
+		 * The host CPU supports the ARM NEON instruction set.
+		 *
+		 * This feature has no associated state.
+		 */
+		kFeatureCpuNEON,
+
+		/**
+		 * The host CPU and operating system support the AVX2 instruction set.
+		 *
+		 * This feature has no associated state.
+		 */
+		kFeatureCpuAVX2
 	};
 
 	/**
@@ -1449,6 +1474,34 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create a new thread running the given function.
+	 *
+	 * Threads are optional, and only used to move work off the main or
+	 * audio thread where that is worth it. Code using them must work the
+	 * same (if slower) when this returns nullptr, which is what backends
+	 * without thread support do.
+	 *
+	 * @param proc  The function to run.
+	 * @param data  The argument passed to the function.
+	 * @param name  A name for the thread, for debugging purposes.
+	 * @return The newly created thread, or nullptr if threads are not supported.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data, const char *name) { return nullptr; }
+
+	/**
+	 * Create a new semaphore with the given initial value.
+	 *
+	 * @return The newly created semaphore, or nullptr if threads are not supported.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue) { return nullptr; }
+
+	/**
+	 * Return the number of CPU cores, as a hint for how many threads are
+	 * worth starting.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
 	/** @} */
 
 
@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/thread.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Common {
+
+Thread::Thread() : _thread(nullptr) {
+}
+
+Thread::~Thread() {
+	join();
+}
+
+bool Thread::start(ThreadProc proc, void *data, const char *name) {
+	if (_thread)
+		return false;
+
+	assert(g_system);
+	_thread = g_system->createThread(proc, data, name);
+	return _thread != nullptr;
+}
+
+void Thread::join() {
+	if (!_thread)
+		return;
+
+	_thread->join();
+	delete _thread;
+	_thread = nullptr;
+}
+
+
+#pragma mark -
+
+
+Semaphore::Semaphore(uint initialValue) {
+	assert(g_system);
+	_semaphore = g_system->createSemaphore(initialValue);
+}
+
+Semaphore::~Semaphore() {
+	delete _semaphore;
+}
+
+void Semaphore::post() {
+	if (_semaphore)
+		_semaphore->post();
+}
+
+void Semaphore::wait() {
+	if (_semaphore)
+		_semaphore->wait(SemaphoreInternal::kWaitForever);
+}
+
+bool Semaphore::wait(uint msecs) {
+	if (!_semaphore)
+		return false;
+
+	return _semaphore->wait(msecs);
+}
+
+
+#pragma mark -
+
+
+uint WorkerPool::getDefaultNumWorkers(uint maxWorkers) {
+	const uint cpus = g_system->getCPUCount();
+	return cpus > 1 ? MIN(cpus - 1, maxWorkers) : 0;
+}
+
+WorkerPool::WorkerPool(uint numWorkers, const char *name) : _quit(false), _proc(nullptr), _data(nullptr), _count(0), _next(0) {
+	for (uint i = 0; i < numWorkers; ++i) {
+		Thread *thread = new Thread();
+		if (!thread->start(workerProc, this, name)) {
+			delete thread;
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	_quit = true;
+	for (uint i = 0; i < _threads.size(); ++i)
+		_start.post();
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		delete _threads[i];
+}
+
+void WorkerPool::run(WorkerTaskProc proc, void *data, uint count) {
+	if (_threads.empty() || count < 2) {
+		for (uint i = 0; i < count; ++i)
+			proc(data, i);
+		return;
+	}
+
+	_proc = proc;
+	_data = data;
+	_count = count;
+	_next = 0;
+
+	// Wake up no more workers than there are tasks left for them
+	const uint numWorkers = MIN<uint>(_threads.size(), count - 1);
+	for (uint i = 0; i < numWorkers; ++i)
+		_start.post();
+
+	runTasks();
+
+	for (uint i = 0; i < numWorkers; ++i)
+		_done.wait();
+}
+
+void WorkerPool::runTasks() {
+	while (true) {
+		uint index;
+		{
+			StackLock lock(_nextMutex);
+			index = _next++;
+		}
+		if (index >= _count)
+			break;
+
+		_proc(_data, index);
+	}
+}
+
+void WorkerPool::workerProc(void *data) {
+	WorkerPool *pool = (WorkerPool *)data;
+
+	while (true) {
+		pool->_start.wait();
+		if (pool->_quit)
+			return;
+
+		pool->runTasks();
+		pool->_done.post();
+	}
+}
+
+} // End of namespace Common
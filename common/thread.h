@@ -0,0 +1,185 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief API for running work on background threads.
+ *
+ * Threads are optional: backends which do not support them return nullptr
+ * from OSystem::createThread(), in which case Thread::start() fails and the
+ * caller has to do the work on its own thread.
+ * @{
+ */
+
+/** The function run by a thread. */
+typedef void (*ThreadProc)(void *data);
+
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/** Wait for the thread function to return. */
+	virtual void join() = 0;
+};
+
+class SemaphoreInternal {
+public:
+	/** A timeout for wait() which never expires. */
+	static const uint kWaitForever = 0xFFFFFFFF;
+
+	virtual ~SemaphoreInternal() {}
+
+	/** Increment the semaphore, waking up one waiting thread. */
+	virtual void post() = 0;
+
+	/**
+	 * Wait until the semaphore can be decremented, or until the timeout
+	 * expires.
+	 *
+	 * @param msecs  The timeout in milliseconds, or kWaitForever.
+	 * @return true if the semaphore was decremented, false on timeout.
+	 */
+	virtual bool wait(uint msecs) = 0;
+};
+
+/**
+ * Wrapper class around the OSystem thread functions.
+ */
+class Thread : NonCopyable {
+	ThreadInternal *_thread;
+
+public:
+	Thread();
+	/** Joins the thread if it is still running. */
+	~Thread();
+
+	/**
+	 * Start running the given function on a new thread.
+	 *
+	 * @param proc  The function to run.
+	 * @param data  The argument passed to the function.
+	 * @param name  A name for the thread, for debugging purposes.
+	 * @return true on success, false if the thread is already running or
+	 *         the backend does not support threads.
+	 */
+	bool start(ThreadProc proc, void *data, const char *name);
+
+	/** Wait for the thread function to return. */
+	void join();
+
+	bool isRunning() const { return _thread != nullptr; }
+};
+
+/**
+ * Wrapper class around the OSystem semaphore functions.
+ *
+ * If the backend does not support threads, post() does nothing and wait()
+ * returns immediately.
+ */
+class Semaphore : NonCopyable {
+	SemaphoreInternal *_semaphore;
+
+public:
+	explicit Semaphore(uint initialValue = 0);
+	~Semaphore();
+
+	void post();
+	/** Wait until the semaphore can be decremented. */
+	void wait();
+	/** @return true if the semaphore was decremented, false on timeout. */
+	bool wait(uint msecs);
+};
+
+/** A task run by a WorkerPool, called once for every index. */
+typedef void (*WorkerTaskProc)(void *data, uint index);
+
+/**
+ * A fixed set of threads for splitting up a job which the caller waits for,
+ * such as scaling the bands of an image.
+ *
+ * The calling thread works on the tasks as well, so a pool without workers
+ * (e.g. because the backend does not support threads) simply runs all tasks
+ * in order on the calling thread.
+ */
+class WorkerPool : NonCopyable {
+public:
+	/**
+	 * Start the worker threads. If some of them fail to start, the pool
+	 * uses the ones which did.
+	 */
+	WorkerPool(uint numWorkers, const char *name);
+	/** Stops and joins all worker threads. */
+	~WorkerPool();
+
+	/**
+	 * The number of workers to use by default: one for every CPU core
+	 * besides the one of the caller, but at most maxWorkers.
+	 */
+	static uint getDefaultNumWorkers(uint maxWorkers);
+
+	/** The number of threads which run tasks in addition to the caller. */
+	uint getNumWorkers() const { return _threads.size(); }
+
+	/**
+	 * Call proc(data, i) for every i in [0, count) and wait for all of these
+	 * calls to finish. The calls may run in any order and at the same time,
+	 * so they must not write to shared data.
+	 *
+	 * Must only be called from one thread at a time.
+	 */
+	void run(WorkerTaskProc proc, void *data, uint count);
+
+private:
+	static void workerProc(void *data);
+	void runTasks();
+
+	Array<Thread *> _threads;
+	Semaphore _start;
+	Semaphore _done;
+	/** Set before waking up the workers for the last time. */
+	bool _quit;
+
+	WorkerTaskProc _proc;
+	void *_data;
+	uint _count;
+	/** The next task to run, guarded by _nextMutex. */
+	uint _next;
+	Mutex _nextMutex;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -105,6 +105,7 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/sharedbuffer.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -296,6 +297,13 @@ z_off_t unztell(unzFile file);
   Give the current position in uncompressed data
 */
 
+int unzGetCurrentFileDataOffset(unzFile file, uLong *offset);
+/*
+  Give the offset of the data of the current file (opened by
+  unzOpenCurrentFile) in the zipfile stream. For stored files, this is
+  where the uncompressed data is.
+*/
+
 int unzeof(unzFile file);
 /*
   return 1 if the end of file was reached, 0 elsewhere
@@ -1269,6 +1277,24 @@ z_off_t unztell(unzFile file) {
 }
 
 
+int unzGetCurrentFileDataOffset(unzFile file, uLong *offset) {
+	unz_s* s;
+	file_in_zip_read_info_s* pfile_in_zip_read_info;
+	if (file==nullptr)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	pfile_in_zip_read_info=s->pfile_in_zip_read;
+
+	if (pfile_in_zip_read_info==nullptr)
+		return UNZ_PARAMERROR;
+
+	*offset = pfile_in_zip_read_info->offset_local_extrafield +
+		pfile_in_zip_read_info->size_local_extrafield +
+		pfile_in_zip_read_info->byte_before_the_zipfile;
+	return UNZ_OK;
+}
+
+
 /*
   return 1 if the end of file was reached, 0 elsewhere
 */
@@ -1422,8 +1448,14 @@ namespace Common {
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
+	/** The whole zip file, if it is in memory */
+	SharedBufferPtr _data;
+
+	/** Recently decompressed members */
+	mutable SharedBufferCache _cache;
+
 public:
-	ZipArchive(unzFile zipFile);
+	ZipArchive(unzFile zipFile, const SharedBufferPtr &data);
 
 
 	~ZipArchive();
@@ -1452,7 +1484,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile, const SharedBufferPtr &data) : _zipFile(zipFile), _data(data) {
 	assert(_zipFile);
 }
 
@@ -1488,6 +1520,11 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) const {
 	String name = path.toString();
+
+	SharedBufferPtr cached = _cache.get(name);
+	if (cached)
+		return new SharedBufferReadStream(cached);
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return nullptr;
 
@@ -1498,6 +1535,15 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) cons
 	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
 		return nullptr;
 
+	// Stored members of a zip file in memory do not need to be copied
+	uLong offset;
+	if (_data && fileInfo.compression_method == 0 &&
+		unzGetCurrentFileDataOffset(_zipFile, &offset) == UNZ_OK &&
+		offset <= _data->getSize() && fileInfo.uncompressed_size <= _data->getSize() - offset) {
+		unzCloseCurrentFile(_zipFile);
+		return new SharedBufferReadStream(_data, offset, offset + fileInfo.uncompressed_size);
+	}
+
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
@@ -1511,7 +1557,9 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) cons
 		return nullptr;
 	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	SharedBufferPtr member(new SharedBuffer(buffer, fileInfo.uncompressed_size));
+	_cache.put(name, member);
+	return new SharedBufferReadStream(member);
 
 	// FIXME: instead of reading all into a memory stream, we could
 	// instead create a new ZipStream class. But then we have to be
@@ -1524,19 +1572,26 @@ Archive *makeZipArchive(const String &name) {
 }
 
 Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+	return makeZipArchive(node.createMappedReadStream());
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream) {
 	if (!stream)
 		return nullptr;
+
+	// If the zip file is in memory, e.g. memory mapped, stored members are
+	// returned as views into it. These keep it alive through the buffer.
+	SharedBufferPtr data(SharedBuffer::createFromStream(stream, DisposeAfterUse::YES));
+	if (data)
+		stream = new SharedBufferReadStream(data);
+
 	unzFile zipFile = unzOpen(stream);
 	if (!zipFile) {
 		// stream gets deleted by unzOpen() call if something
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile);
+	return new ZipArchive(zipFile, data);
 }
 
 } // End of namespace Common
@@ -23,6 +23,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/zlib.h"
+#include "common/lz4.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -497,6 +498,9 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 			delete toBeWrapped;
 			return nullptr;
 		}
+		if (isLZ4Container(toBeWrapped))
+			return wrapLZ4ReadStream(toBeWrapped);
+
 		uint16 header = toBeWrapped->readUint16BE();
 		bool isCompressed = (header == 0x1F8B ||
 				     ((header & 0x0F00) == 0x0800 &&
@@ -127,6 +127,9 @@ bool inflateZlibHeaderless(Common::WriteStream *dst, Common::SeekableReadStream
  * returned wrapped, unless there is no ZLIB support, then NULL is returned
  * and the old stream is destroyed.
  *
+ * Save files in the LZ4 container format (see common/lz4.h) are recognized
+ * as well, and wrapped independently of ZLIB support.
+ *
  * Certain GZip-formats don't supply an easily readable length, if you
  * still need the length carried along with the stream, and you know
  * the decompressed length at wrap-time, then it can be supplied as knownSize
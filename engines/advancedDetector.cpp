@@ -34,6 +34,7 @@
 #include "gui/gui-manager.h"
 #include "gui/message.h"
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "engines/obsolete.h"
 
 /**
@@ -512,8 +513,46 @@ static char flagsToMD5Prefix(uint32 flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps);
 
-bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
-	Common::String hashname = Common::String::format("%c:%s:%d", flagsToMD5Prefix(game.flags), fname.c_str(), _md5Bytes);
+namespace {
+
+/** A file whose properties are computed by detectGame() */
+struct PendingFile {
+	Common::String key;
+	Common::String fname;
+	const ADGameDescription *game;
+	FileProperties props;
+	bool found;
+};
+
+struct PendingFiles {
+	const AdvancedMetaEngine::FileMap *allFiles;
+	uint md5Bytes;
+	Common::Array<PendingFile> files;
+};
+
+void computePendingFile(void *data, uint index) {
+	PendingFiles *pending = (PendingFiles *)data;
+	PendingFile &file = pending->files[index];
+
+	// Resource forks are looked up in several places, leave them to the
+	// main thread
+	if (file.game->flags & ADGF_MACRESFORK)
+		return;
+
+	file.found = getFilePropertiesIntern(pending->md5Bytes, *pending->allFiles, *file.game, file.fname, file.props);
+}
+
+} // End of anonymous namespace
+
+/**
+ * Look up the properties of a file in the MD5 cache of the current
+ * detection pass and in the persistent detection cache.
+ *
+ * Resource fork MD5s are not kept in the persistent cache, since the fork
+ * can live in another file than the one the cache entry would be for.
+ */
+static bool getCachedFileProperties(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) {
+	Common::String hashname = Common::String::format("%c:%s:%d", flagsToMD5Prefix(game.flags), fname.c_str(), md5Bytes);
 
 	if (MD5Man.contains(hashname)) {
 		fileProps.md5 = MD5Man.getMD5(hashname);
@@ -521,13 +560,35 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
-
-	if (res) {
+	if (!(game.flags & ADGF_MACRESFORK) && allFiles.contains(fname) &&
+		DetectionCacheMan.get(allFiles[fname], flagsToMD5Prefix(game.flags), md5Bytes, fileProps)) {
 		MD5Man.setMD5(hashname, fileProps.md5);
 		MD5Man.setSize(hashname, fileProps.size);
+		return true;
 	}
 
+	return false;
+}
+
+static void cacheFileProperties(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, const FileProperties &fileProps) {
+	Common::String hashname = Common::String::format("%c:%s:%d", flagsToMD5Prefix(game.flags), fname.c_str(), md5Bytes);
+
+	MD5Man.setMD5(hashname, fileProps.md5);
+	MD5Man.setSize(hashname, fileProps.size);
+
+	if (!(game.flags & ADGF_MACRESFORK) && allFiles.contains(fname))
+		DetectionCacheMan.set(allFiles[fname], flagsToMD5Prefix(game.flags), md5Bytes, fileProps);
+}
+
+bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
+	if (getCachedFileProperties(_md5Bytes, allFiles, game, fname, fileProps))
+		return true;
+
+	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+
+	if (res)
+		cacheFileProperties(_md5Bytes, allFiles, game, fname, fileProps);
+
 	return res;
 }
 
@@ -583,6 +644,10 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
+	PendingFiles pending;
+	pending.allFiles = &allFiles;
+	pending.md5Bytes = _md5Bytes;
+
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
 		g = (const ADGameDescription *)descPtr;
 
@@ -593,17 +658,43 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 			if (filesProps.contains(key))
 				continue;
 
+			// Both positive and negative results are cached to avoid
+			// repeatedly checking for files.
 			FileProperties tmp;
-			if (getFileProperties(allFiles, *g, fname, tmp)) {
-				debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", key.c_str(), tmp.md5.c_str(), long(tmp.size));
+			if (getCachedFileProperties(_md5Bytes, allFiles, *g, fname, tmp)) {
+				debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld (cached)", key.c_str(), tmp.md5.c_str(), long(tmp.size));
+			} else if (allFiles.contains(fname) || (g->flags & ADGF_MACRESFORK)) {
+				PendingFile file;
+				file.key = key;
+				file.fname = fname;
+				file.game = g;
+				file.found = false;
+				pending.files.push_back(file);
 			}
 
-			// Both positive and negative results are cached to avoid
-			// repeatedly checking for files.
 			filesProps[key] = tmp;
 		}
 	}
 
+	// Read the files on several threads, most of the time is spent waiting
+	// for the disk
+	if (pending.files.size() > 1)
+		DetectionCacheMan.getWorkerPool().run(computePendingFile, &pending, pending.files.size());
+	else if (!pending.files.empty())
+		computePendingFile(&pending, 0);
+
+	for (uint i = 0; i < pending.files.size(); ++i) {
+		PendingFile &file = pending.files[i];
+		if (file.game->flags & ADGF_MACRESFORK)
+			file.found = getFilePropertiesIntern(_md5Bytes, allFiles, *file.game, file.fname, file.props);
+
+		if (file.found) {
+			debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", file.key.c_str(), file.props.md5.c_str(), long(file.props.size));
+			cacheFileProperties(_md5Bytes, allFiles, *file.game, file.fname, file.props);
+			filesProps[file.key] = file.props;
+		}
+	}
+
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
 
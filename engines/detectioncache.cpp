@@ -0,0 +1,189 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "engines/detectioncache.h"
+
+#include "common/debug.h"
+#include "common/ptr.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const char *const kCacheFileName = "scummvm-detection-cache.dat";
+
+enum {
+	kCacheVersion = 1,
+	/** When there are more entries, the ones not used in this session are dropped */
+	kMaxEntries = 50000,
+	/** Minimum time between writing the cache without being forced to */
+	kSaveInterval = 10000,
+	kNumWorkers = 3
+};
+
+DetectionCache::DetectionCache() : _loaded(false), _dirty(false), _lastSave(0), _pool(nullptr) {
+}
+
+DetectionCache::~DetectionCache() {
+	flush(true);
+	delete _pool;
+}
+
+Common::String DetectionCache::makeKey(const Common::FSNode &node, char md5Kind, uint md5Bytes) {
+	return Common::String::format("%c:%u:%s", md5Kind, md5Bytes, node.getPath().c_str());
+}
+
+bool DetectionCache::get(const Common::FSNode &node, char md5Kind, uint md5Bytes, FileProperties &fileProps) {
+	int64 fileSize, modTime;
+	if (!node.getFileStats(fileSize, modTime))
+		return false;
+
+	load();
+
+	EntryMap::iterator i = _entries.find(makeKey(node, md5Kind, md5Bytes));
+	if (i == _entries.end() || i->_value.fileSize != fileSize || i->_value.modTime != modTime)
+		return false;
+
+	i->_value.used = true;
+	fileProps = i->_value.props;
+	return true;
+}
+
+void DetectionCache::set(const Common::FSNode &node, char md5Kind, uint md5Bytes, const FileProperties &fileProps) {
+	int64 fileSize, modTime;
+	if (!node.getFileStats(fileSize, modTime))
+		return;
+
+	load();
+
+	Entry &entry = _entries[makeKey(node, md5Kind, md5Bytes)];
+	entry.fileSize = fileSize;
+	entry.modTime = modTime;
+	entry.props = fileProps;
+	entry.used = true;
+	_dirty = true;
+}
+
+void DetectionCache::flush(bool force) {
+	if (!_dirty)
+		return;
+
+	if (!force && g_system->getMillis() - _lastSave < kSaveInterval)
+		return;
+
+	save();
+}
+
+Common::WorkerPool &DetectionCache::getWorkerPool() {
+	if (!_pool)
+		_pool = new Common::WorkerPool(kNumWorkers, "Detection");
+	return *_pool;
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::ScopedPtr<Common::InSaveFile> in(saveFileMan ? saveFileMan->openRawFile(kCacheFileName) : nullptr);
+	if (!in)
+		return;
+
+	if (!loadFrom(*in))
+		debug(1, "DetectionCache: Ignoring %s of an unknown version", kCacheFileName);
+}
+
+void DetectionCache::save() {
+	_dirty = false;
+	_lastSave = g_system->getMillis();
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::ScopedPtr<Common::OutSaveFile> out(saveFileMan ? saveFileMan->openForSaving(kCacheFileName, false) : nullptr);
+	if (!out) {
+		warning("DetectionCache: Could not write %s", kCacheFileName);
+		return;
+	}
+
+	saveTo(*out);
+	out->finalize();
+	if (out->err())
+		warning("DetectionCache: Could not write %s", kCacheFileName);
+}
+
+bool DetectionCache::loadFrom(Common::SeekableReadStream &in) {
+	_loaded = true;
+	_entries.clear();
+
+	if (in.readUint32BE() != MKTAG('D', 'T', 'C', 'H') || in.readUint32LE() != kCacheVersion)
+		return false;
+
+	const uint32 count = in.readUint32LE();
+	for (uint32 i = 0; i < count && !in.eos() && !in.err(); ++i) {
+		const Common::String key = in.readString(0, in.readUint16LE());
+		Entry entry;
+		entry.fileSize = in.readSint64LE();
+		entry.modTime = in.readSint64LE();
+		entry.props.size = in.readSint64LE();
+		entry.props.md5 = in.readString(0, in.readByte());
+		entry.used = false;
+
+		if (in.eos() || in.err())
+			break;
+		_entries[key] = entry;
+	}
+
+	debug(1, "DetectionCache: Loaded %u entries", _entries.size());
+	return true;
+}
+
+void DetectionCache::saveTo(Common::WriteStream &out) {
+	_dirty = false;
+
+	// Only keep the files looked at in this session when the cache grows
+	// too big, the others were likely moved or deleted
+	const bool onlyUsed = _entries.size() > kMaxEntries;
+	uint32 count = 0;
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!onlyUsed || i->_value.used)
+			count++;
+	}
+
+	out.writeUint32BE(MKTAG('D', 'T', 'C', 'H'));
+	out.writeUint32LE(kCacheVersion);
+	out.writeUint32LE(count);
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (onlyUsed && !i->_value.used)
+			continue;
+
+		out.writeUint16LE(i->_key.size());
+		out.writeString(i->_key);
+		out.writeSint64LE(i->_value.fileSize);
+		out.writeSint64LE(i->_value.modTime);
+		out.writeSint64LE(i->_value.props.size);
+		out.writeByte(i->_value.props.md5.size());
+		out.writeString(i->_value.props.md5);
+	}
+}
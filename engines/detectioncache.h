@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/fs.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/singleton.h"
+#include "common/str.h"
+#include "common/thread.h"
+
+#include "engines/game.h"
+
+/**
+ * @defgroup engines_detectioncache Detection cache
+ * @ingroup engines
+ *
+ * @brief Persistent cache of the file properties used for game detection.
+ *
+ * @{
+ */
+
+/**
+ * Cache of the sizes and MD5s of game files, which is kept on disk so that
+ * detecting the games in the same directories again, e.g. when running
+ * "Mass Add" on a game collection once more, does not need to read the files.
+ *
+ * The entries are keyed by the full path of the file, the kind of MD5 and
+ * the number of bytes it covers. They are only used as long as the size and
+ * the modification time of the file did not change. Backends which do not
+ * support FSNode::getFileStats() get no caching.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	DetectionCache();
+	~DetectionCache();
+
+	/**
+	 * Look up the properties of a file.
+	 *
+	 * @param md5Kind   The prefix of the MD5 kind, as used in the keys of
+	 *                  FilePropertiesMap.
+	 * @param md5Bytes  The number of bytes the MD5 is computed over.
+	 */
+	bool get(const Common::FSNode &node, char md5Kind, uint md5Bytes, FileProperties &fileProps);
+
+	/** Store the properties of a file. */
+	void set(const Common::FSNode &node, char md5Kind, uint md5Bytes, const FileProperties &fileProps);
+
+	/**
+	 * Write the cache to disk if it was changed. Unless @p force is set,
+	 * this happens at most every few seconds, so that it can be called
+	 * after every detection pass.
+	 */
+	void flush(bool force = false);
+
+	/**
+	 * Read the entries stored by saveTo(), replacing the current ones.
+	 *
+	 * @return False if the stream does not contain a cache of the current
+	 *         version.
+	 */
+	bool loadFrom(Common::SeekableReadStream &in);
+
+	/** Write the entries in the format read by loadFrom(). */
+	void saveTo(Common::WriteStream &out);
+
+	/**
+	 * Get the worker pool used to compute the properties of several files
+	 * at once. The work is mostly waiting for the disk, so it uses a few
+	 * threads even on single core systems.
+	 */
+	Common::WorkerPool &getWorkerPool();
+
+private:
+	struct Entry {
+		int64 fileSize;
+		int64 modTime;
+		FileProperties props;
+		bool used;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	void load();
+	void save();
+
+	static Common::String makeKey(const Common::FSNode &node, char md5Kind, uint md5Bytes);
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	uint32 _lastSave;
+	Common::WorkerPool *_pool;
+};
+
+/** Convenience shortcut for accessing the detection cache. */
+#define DetectionCacheMan DetectionCache::instance()
+
+/** @} */
+
+#endif
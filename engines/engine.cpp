@@ -188,6 +188,15 @@ Engine::Engine(OSystem *syst)
 Engine::~Engine() {
 	_mixer->stopAll();
 
+	// Make sure a pending autosave is on disk before the game is left
+	_saveFileMan->waitForAsyncSaves();
+	Common::String saveName;
+	Common::Error saveError;
+	while (_saveFileMan->pollAsyncSave(saveName, saveError)) {
+		if (saveError.getCode() != Common::kNoError)
+			warning("Failed to write autosave '%s': %s", saveName.c_str(), saveError.getDesc().c_str());
+	}
+
 	delete _debugger;
 	delete _mainMenuDialog;
 	g_engine = NULL;
@@ -555,6 +564,18 @@ void Engine::handleAutoSave() {
 	if (!g_eventRec.processAutosave())
 		return;
 #endif
+	// Check on autosaves which are written in the background
+	Common::String saveName;
+	Common::Error saveError;
+	while (_saveFileMan->pollAsyncSave(saveName, saveError)) {
+		if (saveError.getCode() != Common::kNoError) {
+			warning("Failed to write autosave '%s': %s", saveName.c_str(), saveError.getDesc().c_str());
+			g_system->displayMessageOnOSD(_("Error occurred making autosave"));
+			// Try again in 5 minutes, as when saveAutosaveIfEnabled() fails
+			_lastAutosaveTime = _system->getMillis() + ((5 * 60 - _autosaveInterval) * 1000);
+		}
+	}
+
 	const int diff = _system->getMillis() - _lastAutosaveTime;
 
 	if (_autosaveInterval != 0 && diff > (_autosaveInterval * 1000)) {
@@ -612,10 +633,19 @@ void Engine::saveAutosaveIfEnabled() {
 	if (saveFlag)
 		saveFlag = warnBeforeOverwritingAutosave();
 
-	if (saveFlag && saveGameState(autoSaveSlot, autoSaveName, true).getCode() != Common::kNoError) {
-		// Couldn't autosave at the designated time
-		g_system->displayMessageOnOSD(_("Error occurred making autosave"));
-		saveFlag = false;
+	if (saveFlag) {
+		// Only the game state is serialized here. Compressing and writing
+		// the save file happens in the background, and handleAutoSave()
+		// reports if that fails.
+		_saveFileMan->beginAsyncSaves();
+		const Common::Error result = saveGameState(autoSaveSlot, autoSaveName, true);
+		_saveFileMan->endAsyncSaves();
+
+		if (result.getCode() != Common::kNoError) {
+			// Couldn't autosave at the designated time
+			g_system->displayMessageOnOSD(_("Error occurred making autosave"));
+			saveFlag = false;
+		}
 	}
 
 	if (saveFlag) {
@@ -74,36 +74,7 @@ BaseSurfaceOSystem::~BaseSurfaceOSystem() {
 }
 
 Graphics::AlphaType hasTransparencyType(const Graphics::Surface *surf) {
-	if (surf->format.bytesPerPixel != 4) {
-		warning("hasTransparencyType:: non 32 bpp surface passed as argument");
-		return Graphics::ALPHA_OPAQUE;
-	}
-	uint8 r, g, b, a;
-	bool seenAlpha = false;
-	bool seenFullAlpha = false;
-	for (int i = 0; i < surf->h; i++) {
-		if (seenFullAlpha) {
-			break;
-		}
-		for (int j = 0; j < surf->w; j++) {
-			uint32 pix = *(const uint32 *)surf->getBasePtr(j, i);
-			surf->format.colorToARGB(pix, a, r, g, b);
-			if (a != 255) {
-				seenAlpha = true;
-				if (a != 0) {
-					seenFullAlpha = true;
-					break;
-				}
-			}
-		}
-	}
-	if (seenFullAlpha) {
-		return Graphics::ALPHA_FULL;
-	} else if (seenAlpha) {
-		return Graphics::ALPHA_BINARY;
-	} else {
-		return Graphics::ALPHA_OPAQUE;
-	}
+	return Graphics::TransparentSurface::detectAlphaType(*surf);
 }
 
 //////////////////////////////////////////////////////////////////////////
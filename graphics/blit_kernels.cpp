@@ -0,0 +1,258 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/system.h"
+#include "common/util.h"
+
+#include "graphics/blit_kernels.h"
+
+namespace Graphics {
+
+static bool s_blitKernelsEnabled = true;
+
+bool buildPaletteBlitMap(PaletteBlitMap &map, const uint32 *palette, const PixelFormat &format) {
+	for (uint i = 0; i < 256; ++i) {
+		const uint32 col = palette[i];
+		const byte a = (col >> 24) & 0xff;
+
+		if (a == 0) {
+			map.colors[i] = 0;
+			map.masks[i] = 0;
+		} else if (a == 0xff) {
+			map.colors[i] = format.ARGBToColor(0xff, col & 0xff, (col >> 8) & 0xff, (col >> 16) & 0xff);
+			map.masks[i] = 0xffffffff;
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool isAlphaBlitFormat(const PixelFormat &format) {
+	return format.bytesPerPixel == 4 && format.aBits() == 8 && format.rBits() == 8
+		&& format.gBits() == 8 && format.bBits() == 8;
+}
+
+uint32 alphaBlendPixel(uint32 src, uint32 dst, const PixelFormat &format) {
+	byte aSrc, rSrc, gSrc, bSrc;
+	byte aDest, rDest, gDest, bDest;
+
+	format.colorToARGB(src, aSrc, rSrc, gSrc, bSrc);
+	if (aSrc == 0)
+		return dst;
+	if (aSrc == 0xff)
+		return format.ARGBToColor(0xff, rSrc, gSrc, bSrc);
+
+	// This has to stay in sync with ManagedSurface::blitFromInner
+	format.colorToARGB(dst, aDest, rDest, gDest, bDest);
+	double sAlpha = (double)aSrc / 255.0;
+	double dAlpha = (double)aDest / 255.0;
+	dAlpha *= (1.0 - sAlpha);
+	rDest = static_cast<uint8>((rSrc * sAlpha + rDest * dAlpha) / (sAlpha + dAlpha));
+	gDest = static_cast<uint8>((gSrc * sAlpha + gDest * dAlpha) / (sAlpha + dAlpha));
+	bDest = static_cast<uint8>((bSrc * sAlpha + bDest * dAlpha) / (sAlpha + dAlpha));
+	aDest = static_cast<uint8>(255. * (sAlpha + dAlpha));
+
+	return format.ARGBToColor(aDest, rDest, gDest, bDest);
+}
+
+void keyBlit(byte *dst, const byte *src, uint len, byte key) {
+	for (uint i = 0; i < len; ++i) {
+		if (src[i] != key)
+			dst[i] = src[i];
+	}
+}
+
+void paletteBlit(uint32 *dst, const byte *src, uint len, const PaletteBlitMap &map) {
+	for (uint i = 0; i < len; ++i) {
+		if (map.masks[src[i]])
+			dst[i] = map.colors[src[i]];
+	}
+}
+
+void alphaBlit(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format) {
+	for (uint i = 0; i < len; ++i)
+		dst[i] = alphaBlendPixel(src[i], dst[i], format);
+}
+
+// Divide by 255 with rounding, exact for products of two 8 bit values
+static inline uint32 div255(uint32 x) {
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+void spriteBlitOpaque(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	for (uint i = 0; i < len; ++i)
+		dst[i] = src[i] | 0xff;
+}
+
+void spriteBlitBinary(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	for (uint i = 0; i < len; ++i) {
+		if (src[i] & 0xff)
+			dst[i] = src[i] | 0xff;
+	}
+}
+
+// Byte offsets of the channels of a sprite pixel
+#ifdef SCUMM_LITTLE_ENDIAN
+enum { kAIndex = 0, kBIndex = 1, kGIndex = 2, kRIndex = 3 };
+#else
+enum { kAIndex = 3, kBIndex = 2, kGIndex = 1, kRIndex = 0 };
+#endif
+
+void spriteBlitAlpha(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const byte *in = (const byte *)src;
+	byte *out = (byte *)dst;
+
+	for (uint i = 0; i < len; ++i, in += 4, out += 4) {
+		const uint a = in[kAIndex];
+		if (!a)
+			continue;
+
+		out[kAIndex] = 255;
+		out[kRIndex] = (in[kRIndex] * a + out[kRIndex] * (255 - a)) >> 8;
+		out[kGIndex] = (in[kGIndex] * a + out[kGIndex] * (255 - a)) >> 8;
+		out[kBIndex] = (in[kBIndex] * a + out[kBIndex] * (255 - a)) >> 8;
+	}
+}
+
+void spriteBlitTinted(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint ca = color & 0xff;
+	const uint cb = (color >> 8) & 0xff;
+	const uint cg = (color >> 16) & 0xff;
+	const uint cr = (color >> 24) & 0xff;
+	const byte *in = (const byte *)src;
+	byte *out = (byte *)dst;
+
+	for (uint i = 0; i < len; ++i, in += 4, out += 4) {
+		const uint ina = in[kAIndex] * ca >> 8;
+		if (!ina)
+			continue;
+
+		out[kAIndex] = 255;
+		out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8) + (in[kBIndex] * ina * cb >> 16);
+		out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8) + (in[kGIndex] * ina * cg >> 16);
+		out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8) + (in[kRIndex] * ina * cr >> 16);
+	}
+}
+
+void spriteBlitPremultiplied(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	// Premultiplied colors only need one multiplication per channel. The
+	// factors are scaled to 1..256 so a shift can do the division.
+	const uint ca = (color & 0xff) + 1;
+	const uint mb = div255(((color >> 8) & 0xff) * (ca - 1)) + 1;
+	const uint mg = div255(((color >> 16) & 0xff) * (ca - 1)) + 1;
+	const uint mr = div255(((color >> 24) & 0xff) * (ca - 1)) + 1;
+	const byte *in = (const byte *)src;
+	byte *out = (byte *)dst;
+
+	for (uint i = 0; i < len; ++i, in += 4, out += 4) {
+		const uint a = in[kAIndex] * ca >> 8;
+		if (!a)
+			continue;
+
+		// Only clamps for pixels which are not properly premultiplied
+		out[kAIndex] = 255;
+		out[kRIndex] = MIN<uint>((in[kRIndex] * mr >> 8) + (out[kRIndex] * (256 - a) >> 8), 255);
+		out[kGIndex] = MIN<uint>((in[kGIndex] * mg >> 8) + (out[kGIndex] * (256 - a) >> 8), 255);
+		out[kBIndex] = MIN<uint>((in[kBIndex] * mb >> 8) + (out[kBIndex] * (256 - a) >> 8), 255);
+	}
+}
+
+void premultiplyAlpha(uint32 *dst, const uint32 *src, uint len) {
+	for (uint i = 0; i < len; ++i) {
+		const uint32 in = src[i];
+		const uint32 a = in & 0xff;
+		uint32 result = a;
+		for (int shift = 8; shift < 32; shift += 8)
+			result |= div255(((in >> shift) & 0xff) * a) << shift;
+		dst[i] = result;
+	}
+}
+
+void unpremultiplyAlpha(uint32 *dst, const uint32 *src, uint len) {
+	for (uint i = 0; i < len; ++i) {
+		const uint32 in = src[i];
+		const uint32 a = in & 0xff;
+		uint32 result = a;
+		if (a) {
+			for (int shift = 8; shift < 32; shift += 8)
+				result |= MIN<uint32>((((in >> shift) & 0xff) * 255 + a / 2) / a, 255) << shift;
+		}
+		dst[i] = result;
+	}
+}
+
+bool getBlitKernels(BlitKernels &kernels) {
+	kernels.keyBlit = keyBlit;
+	kernels.paletteBlit = paletteBlit;
+	kernels.alphaBlit = alphaBlit;
+	kernels.spriteOpaque = spriteBlitOpaque;
+	kernels.spriteBinary = spriteBlitBinary;
+	kernels.spriteAlpha = spriteBlitAlpha;
+	kernels.spriteTinted = spriteBlitTinted;
+	kernels.spritePremultiplied = spriteBlitPremultiplied;
+
+	if (!s_blitKernelsEnabled)
+		return false;
+	if (!g_system)
+		return true;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		kernels.keyBlit = keyBlitSSE2;
+		kernels.alphaBlit = alphaBlitSSE2;
+		kernels.spriteOpaque = spriteBlitOpaqueSSE2;
+		kernels.spriteBinary = spriteBlitBinarySSE2;
+		kernels.spriteAlpha = spriteBlitAlphaSSE2;
+		kernels.spriteTinted = spriteBlitTintedSSE2;
+		kernels.spritePremultiplied = spriteBlitPremultipliedSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		kernels.keyBlit = keyBlitAVX2;
+		kernels.paletteBlit = paletteBlitAVX2;
+		kernels.alphaBlit = alphaBlitAVX2;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		kernels.keyBlit = keyBlitNEON;
+		kernels.alphaBlit = alphaBlitNEON;
+		kernels.spriteOpaque = spriteBlitOpaqueNEON;
+		kernels.spriteBinary = spriteBlitBinaryNEON;
+		kernels.spriteAlpha = spriteBlitAlphaNEON;
+		kernels.spriteTinted = spriteBlitTintedNEON;
+		kernels.spritePremultiplied = spriteBlitPremultipliedNEON;
+	}
+#endif
+
+	return true;
+}
+
+void setBlitKernelsEnabled(bool enabled) {
+	s_blitKernelsEnabled = enabled;
+}
+
+} // End of namespace Graphics
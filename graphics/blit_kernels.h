@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_BLIT_KERNELS_H
+#define GRAPHICS_BLIT_KERNELS_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_blit_kernels Blit kernels
+ * @ingroup graphics
+ *
+ * @brief Row loops used by ManagedSurface for its most common blits.
+ *
+ * Every kernel handles a single row of @p len pixels and produces exactly
+ * the same output as the generic per-pixel code in ManagedSurface, which
+ * stays in place as the reference path.
+ * @{
+ */
+
+/**
+ * Palette entries converted to a 32bpp destination format.
+ *
+ * Only palettes whose entries are either fully opaque or fully
+ * transparent can be converted; transparent entries leave the
+ * destination pixel untouched.
+ */
+struct PaletteBlitMap {
+	uint32 colors[256]; ///< Palette entries in the destination format
+	uint32 masks[256];  ///< 0xFFFFFFFF for opaque entries, 0 for transparent ones
+};
+
+/**
+ * Fill a PaletteBlitMap from a ManagedSurface palette (ABGR, red in the
+ * low byte).
+ *
+ * @return false if the palette has translucent entries, in which case
+ *         the map can not be used.
+ */
+bool buildPaletteBlitMap(PaletteBlitMap &map, const uint32 *palette, const PixelFormat &format);
+
+/**
+ * Check if a 32bpp format can be handled by the alpha blending kernels,
+ * which need 8 bits for each of the four channels.
+ */
+bool isAlphaBlitFormat(const PixelFormat &format);
+
+/**
+ * Blend a single ARGB pixel over another one the same way the generic
+ * ManagedSurface code does. Both pixels are in @p format.
+ */
+uint32 alphaBlendPixel(uint32 src, uint32 dst, const PixelFormat &format);
+
+/**
+ * Copy 8bpp pixels, skipping those which match the transparent color @p key.
+ */
+typedef void (*KeyBlitFunc)(byte *dst, const byte *src, uint len, byte key);
+
+/**
+ * Convert 8bpp pixels to a 32bpp format through a palette map.
+ */
+typedef void (*PaletteBlitFunc)(uint32 *dst, const byte *src, uint len, const PaletteBlitMap &map);
+
+/**
+ * Alpha blend 32bpp pixels onto a destination of the same format, which
+ * must pass isAlphaBlitFormat().
+ */
+typedef void (*AlphaBlitFunc)(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format);
+
+/**
+ * Draw TransparentSurface pixels onto a target of the same format.
+ *
+ * Pixels and @p color are RGBA8888 values with alpha in the lowest byte.
+ * Drawn pixels get an alpha of 255 on the target, like the generic
+ * TransparentSurface code does. Kernels which do not apply color
+ * modulation ignore @p color.
+ */
+typedef void (*SpriteBlitFunc)(uint32 *dst, const uint32 *src, uint len, uint32 color);
+
+struct BlitKernels {
+	KeyBlitFunc keyBlit;
+	PaletteBlitFunc paletteBlit;
+	AlphaBlitFunc alphaBlit;
+
+	SpriteBlitFunc spriteOpaque;        ///< Copy, ignoring source alpha
+	SpriteBlitFunc spriteBinary;        ///< Copy pixels with non-zero alpha
+	SpriteBlitFunc spriteAlpha;         ///< Alpha blend without color modulation
+	SpriteBlitFunc spriteTinted;        ///< Alpha blend with color modulation
+	SpriteBlitFunc spritePremultiplied; ///< Blend premultiplied pixels, with color modulation
+};
+
+void keyBlit(byte *dst, const byte *src, uint len, byte key);
+void paletteBlit(uint32 *dst, const byte *src, uint len, const PaletteBlitMap &map);
+void alphaBlit(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format);
+
+void spriteBlitOpaque(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitBinary(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitAlpha(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitTinted(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitPremultiplied(uint32 *dst, const uint32 *src, uint len, uint32 color);
+
+/**
+ * Convert TransparentSurface pixels between straight and premultiplied
+ * alpha. Converting back loses precision for translucent pixels.
+ */
+void premultiplyAlpha(uint32 *dst, const uint32 *src, uint len);
+void unpremultiplyAlpha(uint32 *dst, const uint32 *src, uint len);
+
+#ifdef SCUMMVM_SSE2
+void keyBlitSSE2(byte *dst, const byte *src, uint len, byte key);
+void alphaBlitSSE2(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format);
+void spriteBlitOpaqueSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitBinarySSE2(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitAlphaSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitTintedSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitPremultipliedSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void keyBlitAVX2(byte *dst, const byte *src, uint len, byte key);
+void paletteBlitAVX2(uint32 *dst, const byte *src, uint len, const PaletteBlitMap &map);
+void alphaBlitAVX2(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format);
+#endif
+
+#ifdef SCUMMVM_NEON
+void keyBlitNEON(byte *dst, const byte *src, uint len, byte key);
+void alphaBlitNEON(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format);
+void spriteBlitOpaqueNEON(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitBinaryNEON(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitAlphaNEON(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitTintedNEON(uint32 *dst, const uint32 *src, uint len, uint32 color);
+void spriteBlitPremultipliedNEON(uint32 *dst, const uint32 *src, uint len, uint32 color);
+#endif
+
+/**
+ * Select the fastest kernels supported by the CPU we are running on.
+ *
+ * Palette lookups need a gather instruction to gain anything from SIMD,
+ * so only AVX2 replaces the plain C++ palette kernel. The sprite kernels
+ * work on 8 bit channels and gain little from wider vectors, so they have
+ * no AVX2 versions.
+ *
+ * @return false if the kernels have been disabled with
+ *         setBlitKernelsEnabled(), in which case ManagedSurface and
+ *         TransparentSurface use their generic code.
+ */
+bool getBlitKernels(BlitKernels &kernels);
+
+/**
+ * Enable or disable the use of the kernels by ManagedSurface and
+ * TransparentSurface. They are enabled by default; disabling them is
+ * useful to compare against the generic code.
+ */
+void setBlitKernelsEnabled(bool enabled);
+
+/** @} */
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/blit_kernels.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+void keyBlitAVX2(byte *dst, const byte *src, uint len, byte key) {
+	const __m256i keys = _mm256_set1_epi8((char)key);
+
+	for (; len >= 32; len -= 32, src += 32, dst += 32) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)src);
+		const __m256i transparent = _mm256_cmpeq_epi8(in, keys);
+		const uint bits = (uint)_mm256_movemask_epi8(transparent);
+
+		if (bits == 0xffffffff)
+			continue;
+		if (bits == 0) {
+			_mm256_storeu_si256((__m256i *)dst, in);
+			continue;
+		}
+
+		const __m256i old = _mm256_loadu_si256((const __m256i *)dst);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_blendv_epi8(in, old, transparent));
+	}
+
+	keyBlit(dst, src, len, key);
+}
+
+void paletteBlitAVX2(uint32 *dst, const byte *src, uint len, const PaletteBlitMap &map) {
+	for (; len >= 8; len -= 8, src += 8, dst += 8) {
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+		const __m256i colors = _mm256_i32gather_epi32((const int *)map.colors, index, 4);
+		const __m256i masks = _mm256_i32gather_epi32((const int *)map.masks, index, 4);
+		const __m256i old = _mm256_loadu_si256((const __m256i *)dst);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_blendv_epi8(old, colors, masks));
+	}
+
+	paletteBlit(dst, src, len, map);
+}
+
+void alphaBlitAVX2(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format) {
+	const __m128i shift = _mm_cvtsi32_si128(format.aShift);
+	const __m256i alphaMask = _mm256_set1_epi32(0xff);
+	const __m256i zero = _mm256_setzero_si256();
+
+	for (; len >= 8; len -= 8, src += 8, dst += 8) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)src);
+		const __m256i alpha = _mm256_and_si256(_mm256_srl_epi32(in, shift), alphaMask);
+		const __m256i opaque = _mm256_cmpeq_epi32(alpha, alphaMask);
+		const __m256i transparent = _mm256_cmpeq_epi32(alpha, zero);
+		const int opaqueBits = _mm256_movemask_ps(_mm256_castsi256_ps(opaque));
+		const int transparentBits = _mm256_movemask_ps(_mm256_castsi256_ps(transparent));
+
+		if (opaqueBits == 0xff) {
+			_mm256_storeu_si256((__m256i *)dst, in);
+		} else if ((opaqueBits | transparentBits) == 0xff) {
+			const __m256i old = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, _mm256_blendv_epi8(old, in, opaque));
+		} else {
+			alphaBlit(dst, src, 8, format);
+		}
+	}
+
+	alphaBlit(dst, src, len, format);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,222 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/blit_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+// Collapse a comparison mask into one value, 0 if no lane is set and ~0 if
+// all lanes are. This works on both ARMv7 and AArch64.
+static inline uint64 maskBits(uint32x4_t mask) {
+	return vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(mask)), 0);
+}
+
+void keyBlitNEON(byte *dst, const byte *src, uint len, byte key) {
+	const uint8x16_t keys = vdupq_n_u8(key);
+
+	for (; len >= 16; len -= 16, src += 16, dst += 16) {
+		const uint8x16_t in = vld1q_u8(src);
+		const uint8x16_t transparent = vceqq_u8(in, keys);
+		const uint64x2_t halves = vreinterpretq_u64_u8(transparent);
+		const uint64 lo = vgetq_lane_u64(halves, 0);
+		const uint64 hi = vgetq_lane_u64(halves, 1);
+
+		if ((lo & hi) == ~(uint64)0)
+			continue;
+		if ((lo | hi) == 0) {
+			vst1q_u8(dst, in);
+			continue;
+		}
+
+		vst1q_u8(dst, vbslq_u8(transparent, vld1q_u8(dst), in));
+	}
+
+	keyBlit(dst, src, len, key);
+}
+
+void alphaBlitNEON(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format) {
+	const int32x4_t shift = vdupq_n_s32(-(int32)format.aShift);
+	const uint32x4_t alphaMask = vdupq_n_u32(0xff);
+	const uint32x4_t zero = vdupq_n_u32(0);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const uint32x4_t in = vld1q_u32(src);
+		const uint32x4_t alpha = vandq_u32(vshlq_u32(in, shift), alphaMask);
+		const uint32x4_t opaque = vceqq_u32(alpha, alphaMask);
+		const uint32x4_t transparent = vceqq_u32(alpha, zero);
+		const uint64 opaqueBits = maskBits(opaque);
+
+		if (opaqueBits == ~(uint64)0) {
+			vst1q_u32(dst, in);
+		} else if (maskBits(vorrq_u32(opaque, transparent)) == ~(uint64)0) {
+			vst1q_u32(dst, vbslq_u32(opaque, in, vld1q_u32(dst)));
+		} else {
+			alphaBlit(dst, src, 4, format);
+		}
+	}
+
+	alphaBlit(dst, src, len, format);
+}
+
+#pragma mark -
+
+// The sprite kernels work on whole 32-bit pixels, so unlike byte-wise
+// code they do not depend on the memory order of the channels.
+
+static inline uint32x4_t channel(uint32x4_t pixels, int index) {
+	const uint32x4_t mask = vdupq_n_u32(0xff);
+	switch (index) {
+	case 1:
+		return vandq_u32(vshrq_n_u32(pixels, 8), mask);
+	case 2:
+		return vandq_u32(vshrq_n_u32(pixels, 16), mask);
+	default:
+		return vshrq_n_u32(pixels, 24);
+	}
+}
+
+static inline uint32x4_t placeChannel(uint32x4_t value, int index) {
+	switch (index) {
+	case 1:
+		return vshlq_n_u32(value, 8);
+	case 2:
+		return vshlq_n_u32(value, 16);
+	default:
+		return vshlq_n_u32(value, 24);
+	}
+}
+
+void spriteBlitOpaqueNEON(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint32x4_t alphaBits = vdupq_n_u32(0xff);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4)
+		vst1q_u32(dst, vorrq_u32(vld1q_u32(src), alphaBits));
+
+	spriteBlitOpaque(dst, src, len, color);
+}
+
+void spriteBlitBinaryNEON(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint32x4_t alphaBits = vdupq_n_u32(0xff);
+	const uint32x4_t zero = vdupq_n_u32(0);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const uint32x4_t in = vld1q_u32(src);
+		const uint32x4_t transparent = vceqq_u32(vandq_u32(in, alphaBits), zero);
+		if (maskBits(transparent) == ~(uint64)0)
+			continue;
+
+		vst1q_u32(dst, vbslq_u32(transparent, vld1q_u32(dst), vorrq_u32(in, alphaBits)));
+	}
+
+	spriteBlitBinary(dst, src, len, color);
+}
+
+void spriteBlitAlphaNEON(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint32x4_t alphaBits = vdupq_n_u32(0xff);
+	const uint32x4_t zero = vdupq_n_u32(0);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const uint32x4_t in = vld1q_u32(src);
+		const uint32x4_t a = vandq_u32(in, alphaBits);
+		const uint32x4_t transparent = vceqq_u32(a, zero);
+		if (maskBits(transparent) == ~(uint64)0)
+			continue;
+
+		const uint32x4_t out = vld1q_u32(dst);
+		const uint32x4_t ia = vsubq_u32(alphaBits, a);
+		uint32x4_t result = alphaBits;
+		for (int c = 1; c < 4; ++c) {
+			const uint32x4_t value = vshrq_n_u32(vmlaq_u32(vmulq_u32(channel(in, c), a), channel(out, c), ia), 8);
+			result = vorrq_u32(result, placeChannel(value, c));
+		}
+		vst1q_u32(dst, vbslq_u32(transparent, out, result));
+	}
+
+	spriteBlitAlpha(dst, src, len, color);
+}
+
+void spriteBlitTintedNEON(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint32x4_t alphaBits = vdupq_n_u32(0xff);
+	const uint32x4_t zero = vdupq_n_u32(0);
+	const uint32x4_t ca = vdupq_n_u32(color & 0xff);
+	const uint32x4_t colors = vdupq_n_u32(color);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const uint32x4_t in = vld1q_u32(src);
+		const uint32x4_t ina = vshrq_n_u32(vmulq_u32(vandq_u32(in, alphaBits), ca), 8);
+		const uint32x4_t transparent = vceqq_u32(ina, zero);
+		if (maskBits(transparent) == ~(uint64)0)
+			continue;
+
+		const uint32x4_t out = vld1q_u32(dst);
+		const uint32x4_t ia = vsubq_u32(alphaBits, ina);
+		uint32x4_t result = alphaBits;
+		for (int c = 1; c < 4; ++c) {
+			const uint32x4_t value = vaddq_u32(vshrq_n_u32(vmulq_u32(channel(out, c), ia), 8),
+				vshrq_n_u32(vmulq_u32(vmulq_u32(channel(in, c), ina), channel(colors, c)), 16));
+			result = vorrq_u32(result, placeChannel(value, c));
+		}
+		vst1q_u32(dst, vbslq_u32(transparent, out, result));
+	}
+
+	spriteBlitTinted(dst, src, len, color);
+}
+
+void spriteBlitPremultipliedNEON(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const uint32x4_t alphaBits = vdupq_n_u32(0xff);
+	const uint32x4_t zero = vdupq_n_u32(0);
+	const uint32x4_t c256 = vdupq_n_u32(256);
+	const bool modulate = color != 0xffffffff;
+	const uint32 caScalar = color & 0xff;
+	const uint32x4_t ca = vdupq_n_u32(caScalar + 1);
+	uint32x4_t mod[4];
+	for (int c = 1; c < 4; ++c)
+		mod[c] = vdupq_n_u32(((((color >> (c * 8)) & 0xff) * caScalar + 128) * 257 >> 16) + 1);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const uint32x4_t in = vld1q_u32(src);
+		uint32x4_t a = vandq_u32(in, alphaBits);
+		if (modulate)
+			a = vshrq_n_u32(vmulq_u32(a, ca), 8);
+		const uint32x4_t transparent = vceqq_u32(a, zero);
+		if (maskBits(transparent) == ~(uint64)0)
+			continue;
+
+		const uint32x4_t out = vld1q_u32(dst);
+		const uint32x4_t ia = vsubq_u32(c256, a);
+		uint32x4_t result = alphaBits;
+		for (int c = 1; c < 4; ++c) {
+			uint32x4_t value = channel(in, c);
+			if (modulate)
+				value = vshrq_n_u32(vmulq_u32(value, mod[c]), 8);
+			value = vaddq_u32(value, vshrq_n_u32(vmulq_u32(channel(out, c), ia), 8));
+			result = vorrq_u32(result, placeChannel(vminq_u32(value, alphaBits), c));
+		}
+		vst1q_u32(dst, vbslq_u32(transparent, out, result));
+	}
+
+	spriteBlitPremultiplied(dst, src, len, color);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,221 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/blit_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+void keyBlitSSE2(byte *dst, const byte *src, uint len, byte key) {
+	const __m128i keys = _mm_set1_epi8((char)key);
+
+	for (; len >= 16; len -= 16, src += 16, dst += 16) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i transparent = _mm_cmpeq_epi8(in, keys);
+		const int bits = _mm_movemask_epi8(transparent);
+
+		if (bits == 0xffff)
+			continue;
+		if (bits == 0) {
+			_mm_storeu_si128((__m128i *)dst, in);
+			continue;
+		}
+
+		const __m128i old = _mm_loadu_si128((const __m128i *)dst);
+		_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(transparent, old), _mm_andnot_si128(transparent, in)));
+	}
+
+	keyBlit(dst, src, len, key);
+}
+
+void alphaBlitSSE2(uint32 *dst, const uint32 *src, uint len, const PixelFormat &format) {
+	const __m128i shift = _mm_cvtsi32_si128(format.aShift);
+	const __m128i alphaMask = _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i alpha = _mm_and_si128(_mm_srl_epi32(in, shift), alphaMask);
+		const __m128i opaque = _mm_cmpeq_epi32(alpha, alphaMask);
+		const __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+		const int opaqueBits = _mm_movemask_ps(_mm_castsi128_ps(opaque));
+		const int transparentBits = _mm_movemask_ps(_mm_castsi128_ps(transparent));
+
+		if (opaqueBits == 0xf) {
+			_mm_storeu_si128((__m128i *)dst, in);
+		} else if ((opaqueBits | transparentBits) == 0xf) {
+			// Only fully opaque and fully transparent pixels, select
+			const __m128i old = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(opaque, in), _mm_andnot_si128(opaque, old)));
+		} else {
+			// Translucent pixels use the exact same math as the generic code
+			alphaBlit(dst, src, 4, format);
+		}
+	}
+
+	alphaBlit(dst, src, len, format);
+}
+
+#pragma mark -
+
+// The sprite kernels widen two pixels at a time to 16 bits per channel.
+// x86 is little endian, so alpha ends up in the first lane of each pixel.
+
+static inline __m128i broadcastAlpha(__m128i pixels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0x00), 0x00);
+}
+
+// Divide by 255 with rounding, exact for products of two 8 bit values
+static inline __m128i div255(__m128i x) {
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline void storeSelected(uint32 *dst, __m128i result, __m128i old, __m128i keepOld) {
+	_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(keepOld, old), _mm_andnot_si128(keepOld, result)));
+}
+
+void spriteBlitOpaqueSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const __m128i alphaBits = _mm_set1_epi32(0xff);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4)
+		_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_loadu_si128((const __m128i *)src), alphaBits));
+
+	spriteBlitOpaque(dst, src, len, color);
+}
+
+void spriteBlitBinarySSE2(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const __m128i alphaBits = _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(in, alphaBits), zero);
+		const int bits = _mm_movemask_epi8(transparent);
+
+		if (bits == 0xffff)
+			continue;
+		if (bits == 0)
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(in, alphaBits));
+		else
+			storeSelected(dst, _mm_or_si128(in, alphaBits), _mm_loadu_si128((const __m128i *)dst), transparent);
+	}
+
+	spriteBlitBinary(dst, src, len, color);
+}
+
+static inline __m128i blendAlpha(__m128i in, __m128i out) {
+	const __m128i a = broadcastAlpha(in);
+	const __m128i ia = _mm_sub_epi16(_mm_set1_epi16(255), a);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(in, a), _mm_mullo_epi16(out, ia)), 8);
+}
+
+void spriteBlitAlphaSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const __m128i alphaBits = _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(in, alphaBits), zero);
+		if (_mm_movemask_epi8(transparent) == 0xffff)
+			continue;
+
+		const __m128i out = _mm_loadu_si128((const __m128i *)dst);
+		const __m128i lo = blendAlpha(_mm_unpacklo_epi8(in, zero), _mm_unpacklo_epi8(out, zero));
+		const __m128i hi = blendAlpha(_mm_unpackhi_epi8(in, zero), _mm_unpackhi_epi8(out, zero));
+		storeSelected(dst, _mm_or_si128(_mm_packus_epi16(lo, hi), alphaBits), out, transparent);
+	}
+
+	spriteBlitAlpha(dst, src, len, color);
+}
+
+void spriteBlitTintedSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const __m128i alphaBits = _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i ca = _mm_set1_epi16(color & 0xff);
+	const __m128i mod = _mm_unpacklo_epi8(_mm_set1_epi32(color & 0xffffff00), zero);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i out = _mm_loadu_si128((const __m128i *)dst);
+		const __m128i inLo = _mm_unpacklo_epi8(in, zero);
+		const __m128i inHi = _mm_unpackhi_epi8(in, zero);
+
+		const __m128i inaLo = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha(inLo), ca), 8);
+		const __m128i inaHi = _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha(inHi), ca), 8);
+		const __m128i transparent = _mm_packs_epi16(_mm_cmpeq_epi16(inaLo, zero), _mm_cmpeq_epi16(inaHi, zero));
+		if (_mm_movemask_epi8(transparent) == 0xffff)
+			continue;
+
+		// in * ina * mod fits into 32 bits, and mulhi does the >> 16
+		const __m128i lo = _mm_add_epi16(
+			_mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(out, zero), _mm_sub_epi16(c255, inaLo)), 8),
+			_mm_mulhi_epu16(_mm_mullo_epi16(inLo, mod), inaLo));
+		const __m128i hi = _mm_add_epi16(
+			_mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(out, zero), _mm_sub_epi16(c255, inaHi)), 8),
+			_mm_mulhi_epu16(_mm_mullo_epi16(inHi, mod), inaHi));
+		storeSelected(dst, _mm_or_si128(_mm_packus_epi16(lo, hi), alphaBits), out, transparent);
+	}
+
+	spriteBlitTinted(dst, src, len, color);
+}
+
+void spriteBlitPremultipliedSSE2(uint32 *dst, const uint32 *src, uint len, uint32 color) {
+	const __m128i alphaBits = _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i c256 = _mm_set1_epi16(256);
+	const __m128i ca = _mm_set1_epi16((color & 0xff) + 1);
+	const bool modulate = color != 0xffffffff;
+	const __m128i mod = _mm_add_epi16(div255(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(color & 0xffffff00), zero), _mm_sub_epi16(ca, one))), one);
+
+	for (; len >= 4; len -= 4, src += 4, dst += 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)src);
+		const __m128i out = _mm_loadu_si128((const __m128i *)dst);
+		__m128i inLo = _mm_unpacklo_epi8(in, zero);
+		__m128i inHi = _mm_unpackhi_epi8(in, zero);
+
+		__m128i aLo = broadcastAlpha(inLo);
+		__m128i aHi = broadcastAlpha(inHi);
+		if (modulate) {
+			aLo = _mm_srli_epi16(_mm_mullo_epi16(aLo, ca), 8);
+			aHi = _mm_srli_epi16(_mm_mullo_epi16(aHi, ca), 8);
+			inLo = _mm_srli_epi16(_mm_mullo_epi16(inLo, mod), 8);
+			inHi = _mm_srli_epi16(_mm_mullo_epi16(inHi, mod), 8);
+		}
+		const __m128i transparent = _mm_packs_epi16(_mm_cmpeq_epi16(aLo, zero), _mm_cmpeq_epi16(aHi, zero));
+		if (_mm_movemask_epi8(transparent) == 0xffff)
+			continue;
+
+		const __m128i lo = _mm_add_epi16(inLo,
+			_mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(out, zero), _mm_sub_epi16(c256, aLo)), 8));
+		const __m128i hi = _mm_add_epi16(inHi,
+			_mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(out, zero), _mm_sub_epi16(c256, aHi)), 8));
+		storeSelected(dst, _mm_or_si128(_mm_packus_epi16(lo, hi), alphaBits), out, transparent);
+	}
+
+	spriteBlitPremultiplied(dst, src, len, color);
+}
+
+} // End of namespace Graphics
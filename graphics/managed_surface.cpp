@@ -20,6 +20,7 @@
  */
 
 #include "graphics/managed_surface.h"
+#include "graphics/blit_kernels.h"
 #include "common/algorithm.h"
 #include "common/textconsole.h"
 #include "common/endian.h"
@@ -299,6 +300,45 @@ void ManagedSurface::blitFrom(const ManagedSurface &src, const Common::Rect &src
 		blitFromInner(src._innerSurface, srcRect, destRect, src._paletteSet ? src._palette : nullptr);
 }
 
+/**
+ * Unscaled 8bpp to 32bpp paletted and 32bpp alpha blits, done a row at a
+ * time with the blit kernels. Returns false if the blit has to go through
+ * the generic code instead.
+ */
+static bool kernelBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest,
+		const Common::Rect &destRect, const uint32 *srcPalette) {
+	const bool paletted = src.format.bytesPerPixel == 1 && dest.format.bytesPerPixel == 4 && srcPalette;
+	if (!paletted && (src.format != dest.format || !isAlphaBlitFormat(dest.format)))
+		return false;
+
+	BlitKernels kernels;
+	if (!getBlitKernels(kernels))
+		return false;
+
+	PaletteBlitMap map;
+	if (paletted && !buildPaletteBlitMap(map, srcPalette, dest.format))
+		return false;
+
+	const int left = MAX<int>(destRect.left, 0);
+	const int right = MIN<int>(destRect.right, dest.w);
+	const int top = MAX<int>(destRect.top, 0);
+	const int bottom = MIN<int>(destRect.bottom, dest.h);
+	if (left >= right)
+		return true;
+
+	for (int destY = top; destY < bottom; ++destY) {
+		const void *srcP = src.getBasePtr(srcRect.left + left - destRect.left, srcRect.top + destY - destRect.top);
+		uint32 *destP = (uint32 *)dest.getBasePtr(left, destY);
+
+		if (paletted)
+			kernels.paletteBlit(destP, (const byte *)srcP, right - left, map);
+		else
+			kernels.alphaBlit(destP, (const uint32 *)srcP, right - left, dest.format);
+	}
+
+	return true;
+}
+
 void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRect,
 		const Common::Rect &destRect, const uint32 *srcPalette) {
 
@@ -324,6 +364,11 @@ void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRe
 	}
 
 	const bool noScale = scaleX == SCALE_THRESHOLD && scaleY == SCALE_THRESHOLD;
+	if (noScale && format.bytesPerPixel == 4 && kernelBlit(src, srcRect, *this, destRect, srcPalette)) {
+		addDirtyRect(destRect);
+		return;
+	}
+
 	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= h)
 			continue;
@@ -416,7 +461,7 @@ void ManagedSurface::blitFromInner(const Surface &src, const Common::Rect &srcRe
 		}
 	}
 
-	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
+	addDirtyRect(destRect);
 }
 
 void ManagedSurface::transBlitFrom(const Surface &src, uint transColor, bool flipped,
@@ -679,6 +724,33 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+/**
+ * Unscaled 8bpp keyed blits, done a row at a time with the blit kernels.
+ * Returns false if the blit has to go through the generic code instead.
+ */
+static bool kernelTransBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest,
+		const Common::Rect &destRect, byte transColor) {
+	BlitKernels kernels;
+	if (!getBlitKernels(kernels))
+		return false;
+
+	const int left = MAX<int>(destRect.left, 0);
+	const int right = MIN<int>(destRect.right, dest.w);
+	const int top = MAX<int>(destRect.top, 0);
+	const int bottom = MIN<int>(destRect.bottom, dest.h);
+	if (left >= right)
+		return true;
+
+	for (int destY = top; destY < bottom; ++destY) {
+		const byte *srcP = (const byte *)src.getBasePtr(srcRect.left + left - destRect.left, srcRect.top + destY - destRect.top);
+		byte *destP = (byte *)dest.getBasePtr(left, destY);
+
+		kernels.keyBlit(destP, srcP, right - left, transColor);
+	}
+
+	return true;
+}
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly); \
@@ -695,6 +767,16 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
+	// Plain keyed copies between paletted surfaces are the most common case
+	if (src.format.bytesPerPixel == 1 && format.bytesPerPixel == 1 && !mask && !maskOnly && !flipped
+			&& !overrideColor && srcAlpha != 0 && !(srcPalette && dstPalette)
+			&& SCALE_THRESHOLD * srcRect.width() / destRect.width() == SCALE_THRESHOLD
+			&& SCALE_THRESHOLD * srcRect.height() / destRect.height() == SCALE_THRESHOLD
+			&& kernelTransBlit(src, srcRect, *this, destRect, transColor)) {
+		addDirtyRect(destRect);
+		return;
+	}
+
 	HANDLE_BLIT(1, 1, byte, byte)
 	HANDLE_BLIT(1, 2, byte, uint16)
 	HANDLE_BLIT(1, 4, byte, uint32)
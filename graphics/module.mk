@@ -1,6 +1,7 @@
 MODULE := graphics
 
 MODULE_OBJS := \
+	blit_kernels.o \
 	conversion.o \
 	cursorman.o \
 	font.o \
@@ -48,7 +49,8 @@ MODULE_OBJS := \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	wincursor.o \
-	yuv_to_rgb.o
+	yuv_to_rgb.o \
+	yuv_to_rgb_kernels.o
 
 ifdef USE_TINYGL
 MODULE_OBJS += \
@@ -75,7 +77,20 @@ MODULE_OBJS += \
 	tinygl/zmath.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
-	tinygl/zdirtyrect.o
+	tinygl/zdirtyrect.o \
+	tinygl/zspan_kernels.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan_kernels_sse2.o
+$(MODULE)/tinygl/zspan_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan_kernels_neon.o
+endif
+
 endif
 
 ifdef USE_ASPECT
@@ -105,6 +120,17 @@ ifdef USE_HQ_SCALERS
 MODULE_OBJS += \
 	scaler/hq.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/hq_kernels_sse2.o
+$(MODULE)/scaler/hq_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/hq_kernels_neon.o
+endif
+
 ifdef USE_NASM
 MODULE_OBJS += \
 	scaler/hq2x_i386.o \
@@ -120,5 +146,27 @@ endif
 
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	blit_kernels_sse2.o \
+	yuv_to_rgb_kernels_sse2.o
+$(MODULE)/blit_kernels_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	blit_kernels_avx2.o \
+	yuv_to_rgb_kernels_avx2.o
+$(MODULE)/blit_kernels_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	blit_kernels_neon.o \
+	yuv_to_rgb_kernels_neon.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -20,7 +20,10 @@
 
 #include "graphics/scaler/hq.h"
 #include "graphics/scaler.h"
+#include "graphics/scaler/hq_kernels.h"
 #include "graphics/scaler/intern.h"
+#include "common/array.h"
+#include "common/system.h"
 
 // RGB-to-YUV lookup table
 
@@ -173,8 +176,6 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate_2_3_3(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate_14_1_1(w5, w6, w8);
 
-#define YUV(x)	(sizeof(Pixel) == 2 ? RGBtoYUV[w ## x] : ConvertYUV<ColorMask>(w ## x, RGBtoYUV))
-
 /**
  * Convert 32 bit RGB values to Yuv
  */
@@ -193,13 +194,110 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+void hqClassifyRow(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width) {
+	for (uint x = 0; x < width; ++x, ++prev, ++cur, ++next) {
+		const int yuv5 = cur[1];
+
+		int f = 0;
+		if (diffYUV(yuv5, prev[0])) f |= 0x0001;
+		if (diffYUV(yuv5, prev[1])) f |= 0x0002;
+		if (diffYUV(yuv5, prev[2])) f |= 0x0004;
+		if (diffYUV(yuv5, cur[0]))  f |= 0x0008;
+		if (diffYUV(yuv5, cur[2]))  f |= 0x0010;
+		if (diffYUV(yuv5, next[0])) f |= 0x0020;
+		if (diffYUV(yuv5, next[1])) f |= 0x0040;
+		if (diffYUV(yuv5, next[2])) f |= 0x0080;
+
+		if (diffYUV(prev[1], cur[2])) f |= kHQDiff26;
+		if (diffYUV(cur[2], next[1])) f |= kHQDiff68;
+		if (diffYUV(next[1], cur[0])) f |= kHQDiff84;
+		if (diffYUV(cur[0], prev[1])) f |= kHQDiff42;
+
+		flags[x] = f;
+	}
+}
+
+HQClassifyFunc hqGetClassifyFunc() {
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return hqClassifyRowSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return hqClassifyRowNEON;
+#endif
+	return hqClassifyRow;
+}
+
+/**
+ * Computes the HQFlags of the source pixels one row at a time.
+ *
+ * Every pixel is converted to YUV only once, and the rows are classified
+ * before the filter runs, so the filter loop only has to dispatch on the
+ * flags.
+ */
+template<typename ColorMask>
+class HQRowClassifier {
+	typedef typename ColorMask::PixelType Pixel;
+
+public:
+	/**
+	 * @param p  The first pixel of the first row to classify. The row above
+	 *           it and the pixels left and right of the rows are read as well.
+	 */
+	HQRowClassifier(const Pixel *p, uint32 nextlineSrc, int width, const uint32 *RGBtoYUV, HQClassifyFunc classify) :
+		_nextlineSrc(nextlineSrc), _width(width), _RGBtoYUV(RGBtoYUV), _classify(classify),
+		_yuv(3 * (width + 2)), _flags(width) {
+		for (int i = 0; i < 3; ++i)
+			_rows[i] = &_yuv[i * (width + 2)];
+
+		convertRow(_rows[0], p - nextlineSrc);
+		convertRow(_rows[1], p);
+	}
+
+	/**
+	 * Classify the row starting at @p p, which must be the row after the
+	 * one of the previous call.
+	 */
+	const uint16 *classifyRow(const Pixel *p) {
+		convertRow(_rows[2], p + _nextlineSrc);
+		_classify(&_flags[0], _rows[0], _rows[1], _rows[2], _width);
+
+		uint32 *tmp = _rows[0];
+		_rows[0] = _rows[1];
+		_rows[1] = _rows[2];
+		_rows[2] = tmp;
+
+		return &_flags[0];
+	}
+
+private:
+	void convertRow(uint32 *yuv, const Pixel *p) const {
+		for (int x = -1; x <= _width; ++x) {
+			if (sizeof(Pixel) == 2)
+				*yuv++ = _RGBtoYUV[p[x]];
+			else
+				*yuv++ = ConvertYUV<ColorMask>(p[x], _RGBtoYUV);
+		}
+	}
+
+	const uint32 _nextlineSrc;
+	const int _width;
+	const uint32 *_RGBtoYUV;
+	HQClassifyFunc _classify;
+
+	Common::Array<uint32> _yuv;
+	Common::Array<uint16> _flags;
+	uint32 *_rows[3];
+};
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (see http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQClassifyFunc classify) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +319,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQRowClassifier<ColorMask> classifier(p, nextlineSrc, width, RGBtoYUV, classify);
+
 	while (height--) {
+		const uint16 *flags = classifier.classifyRow(p);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -238,18 +340,9 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *flags++;
 
-			switch (pattern) {
+			switch (pattern & kHQPatternMask) {
 			case 0:
 			case 1:
 			case 4:
@@ -382,7 +475,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 18:
 			case 50:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_20
@@ -395,7 +488,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_22
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_20
@@ -405,7 +498,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 76:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_20
@@ -414,7 +507,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 10:
 			case 138:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_20
@@ -470,7 +563,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 22:
 			case 54:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -483,7 +576,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_22
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -493,7 +586,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 108:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -502,7 +595,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 11:
 			case 139:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -513,7 +606,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 19:
 			case 51:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_11
 					PIXEL01_10
 				} else {
@@ -526,7 +619,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 146:
 			case 178:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 					PIXEL11_12
 				} else {
@@ -538,7 +631,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 84:
 			case 85:
 				PIXEL00_20
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL01_11
 					PIXEL11_10
 				} else {
@@ -551,7 +644,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 113:
 				PIXEL00_20
 				PIXEL01_22
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL10_12
 					PIXEL11_10
 				} else {
@@ -563,7 +656,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 204:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 					PIXEL11_11
 				} else {
@@ -573,7 +666,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 73:
 			case 77:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_12
 					PIXEL10_10
 				} else {
@@ -585,7 +678,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 42:
 			case 170:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 					PIXEL10_11
 				} else {
@@ -597,7 +690,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 14:
 			case 142:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 					PIXEL01_12
 				} else {
@@ -657,12 +750,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 26:
 			case 31:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -673,13 +766,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 82:
 			case 214:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -689,12 +782,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 248:
 				PIXEL00_21
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -702,13 +795,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 74:
 			case 107:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -716,7 +809,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 27:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -727,7 +820,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 86:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -739,7 +832,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_21
 				PIXEL01_22
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -748,7 +841,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 106:
 				PIXEL00_10
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -757,7 +850,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 30:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -769,7 +862,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_22
 				PIXEL01_10
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -778,7 +871,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 120:
 				PIXEL00_21
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -786,7 +879,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 75:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -868,12 +961,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 58:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -883,13 +976,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 83:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -898,25 +991,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 92:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 202:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -924,13 +1017,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 78:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -938,12 +1031,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 154:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -953,13 +1046,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 114:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -968,34 +1061,34 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 89:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 90:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1003,7 +1096,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 55:
 			case 23:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_11
 					PIXEL01_0
 				} else {
@@ -1016,7 +1109,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 182:
 			case 150:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 					PIXEL11_12
 				} else {
@@ -1028,7 +1121,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 213:
 			case 212:
 				PIXEL00_20
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL01_11
 					PIXEL11_0
 				} else {
@@ -1041,7 +1134,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 240:
 				PIXEL00_20
 				PIXEL01_22
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL10_12
 					PIXEL11_0
 				} else {
@@ -1053,7 +1146,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 232:
 				PIXEL00_21
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 					PIXEL11_11
 				} else {
@@ -1063,7 +1156,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 109:
 			case 105:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_12
 					PIXEL10_0
 				} else {
@@ -1075,7 +1168,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 171:
 			case 43:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 					PIXEL10_11
 				} else {
@@ -1087,7 +1180,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 143:
 			case 15:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 					PIXEL01_12
 				} else {
@@ -1100,7 +1193,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 124:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1108,7 +1201,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 203:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -1119,7 +1212,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 62:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1131,7 +1224,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_11
 				PIXEL01_10
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1139,7 +1232,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 118:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1151,7 +1244,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_12
 				PIXEL01_22
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1160,7 +1253,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 110:
 				PIXEL00_10
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1168,7 +1261,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 155:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
@@ -1228,24 +1321,24 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 220:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 158:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1254,13 +1347,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 234:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1269,25 +1362,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 242:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 59:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1298,12 +1391,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 121:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1311,26 +1404,26 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 87:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 79:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1338,88 +1431,88 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 122:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 94:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 218:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 91:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1450,12 +1543,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 186:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1465,13 +1558,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 115:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1480,25 +1573,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 93:
 				PIXEL00_12
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
 				}
 				break;
 			case 206:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1509,7 +1602,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 201:
 				PIXEL00_12
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_10
 				} else {
 					PIXEL10_70
@@ -1518,7 +1611,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 174:
 			case 46:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_10
 				} else {
 					PIXEL00_70
@@ -1530,7 +1623,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 179:
 			case 147:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_10
 				} else {
 					PIXEL01_70
@@ -1543,7 +1636,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_11
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_10
 				} else {
 					PIXEL11_70
@@ -1563,12 +1656,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 126:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1576,21 +1669,21 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 219:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 125:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_12
 					PIXEL10_0
 				} else {
@@ -1602,7 +1695,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 221:
 				PIXEL00_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL01_11
 					PIXEL11_0
 				} else {
@@ -1612,7 +1705,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_10
 				break;
 			case 207:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 					PIXEL01_12
 				} else {
@@ -1625,7 +1718,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 238:
 				PIXEL00_10
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 					PIXEL11_11
 				} else {
@@ -1635,7 +1728,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 190:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 					PIXEL11_12
 				} else {
@@ -1645,7 +1738,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_11
 				break;
 			case 187:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 					PIXEL10_11
 				} else {
@@ -1658,7 +1751,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 243:
 				PIXEL00_11
 				PIXEL01_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL10_12
 					PIXEL11_0
 				} else {
@@ -1667,7 +1760,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 119:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_11
 					PIXEL01_0
 				} else {
@@ -1681,7 +1774,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 233:
 				PIXEL00_12
 				PIXEL01_20
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1690,7 +1783,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 175:
 			case 47:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
@@ -1702,7 +1795,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 183:
 			case 151:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1715,7 +1808,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL00_20
 				PIXEL01_11
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1724,25 +1817,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 250:
 				PIXEL00_10
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 123:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1750,12 +1843,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 95:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1765,13 +1858,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 222:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1780,12 +1873,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 252:
 				PIXEL00_21
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1794,25 +1887,25 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 249:
 				PIXEL00_12
 				PIXEL01_22
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 235:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_21
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1820,13 +1913,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 111:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1834,12 +1927,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_22
 				break;
 			case 63:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
@@ -1848,12 +1941,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_21
 				break;
 			case 159:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1863,13 +1956,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 215:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_21
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -1877,13 +1970,13 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 246:
 				PIXEL00_22
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1891,17 +1984,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 254:
 				PIXEL00_10
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -1910,43 +2003,43 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 253:
 				PIXEL00_12
 				PIXEL01_11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
 				}
 				break;
 			case 251:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
 				PIXEL01_10
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
 				}
 				break;
 			case 239:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
 				PIXEL01_12
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
@@ -1954,17 +2047,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_11
 				break;
 			case 127:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_20
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_20
@@ -1972,12 +2065,12 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_10
 				break;
 			case 191:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
@@ -1986,18 +2079,18 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11_12
 				break;
 			case 223:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_20
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_10
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_20
@@ -2005,35 +2098,35 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 247:
 				PIXEL00_11
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
 				PIXEL10_12
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
 				}
 				break;
 			case 255:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_0
 				} else {
 					PIXEL00_100
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_0
 				} else {
 					PIXEL01_100
 				}
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_0
 				} else {
 					PIXEL10_100
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL11_0
 				} else {
 					PIXEL11_100
@@ -2116,7 +2209,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, HQClassifyFunc classify) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2232,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQRowClassifier<ColorMask> classifier(p, nextlineSrc, width, RGBtoYUV, classify);
+
 	while (height--) {
+		const uint16 *flags = classifier.classifyRow(p);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2156,18 +2253,9 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *flags++;
 
-			switch (pattern) {
+			switch (pattern & kHQPatternMask) {
 			case 0:
 			case 1:
 			case 4:
@@ -2365,7 +2453,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 18:
 			case 50:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_1M
 					PIXEL12_C
@@ -2388,7 +2476,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_1M
@@ -2405,7 +2493,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_2
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_1M
 					PIXEL21_C
@@ -2418,7 +2506,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 10:
 			case 138:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL10_C
@@ -2511,7 +2599,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 22:
 			case 54:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -2534,7 +2622,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -2551,7 +2639,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_2
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -2564,7 +2652,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 11:
 			case 139:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -2582,7 +2670,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 19:
 			case 51:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_1M
@@ -2601,7 +2689,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 146:
 			case 178:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_1M
 					PIXEL12_C
@@ -2620,7 +2708,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 84:
 			case 85:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -2639,7 +2727,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 112:
 			case 113:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -2658,7 +2746,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 200:
 			case 204:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_1M
 					PIXEL21_C
@@ -2677,7 +2765,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 73:
 			case 77:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_1M
@@ -2696,7 +2784,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 42:
 			case 170:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL10_C
@@ -2715,7 +2803,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 14:
 			case 142:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 					PIXEL01_C
 					PIXEL02_1R
@@ -2822,7 +2910,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 26:
 			case 31:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -2830,7 +2918,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -2845,7 +2933,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 82:
 			case 214:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -2856,7 +2944,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -2870,7 +2958,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL01_1
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -2878,7 +2966,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -2888,7 +2976,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 74:
 			case 107:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -2899,7 +2987,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -2909,7 +2997,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 27:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -2927,7 +3015,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 86:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -2949,7 +3037,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -2965,7 +3053,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -2978,7 +3066,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 30:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3000,7 +3088,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3016,7 +3104,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3028,7 +3116,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 75:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3177,13 +3265,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 58:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3198,7 +3286,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 83:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3208,7 +3296,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1M
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3221,20 +3309,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 202:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3244,7 +3332,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3253,7 +3341,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 78:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3263,7 +3351,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3272,13 +3360,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 154:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3293,7 +3381,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 114:
 				PIXEL00_1M
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3303,7 +3391,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3316,26 +3404,26 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 90:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3343,13 +3431,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3357,7 +3445,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 55:
 			case 23:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_C
@@ -3376,7 +3464,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 182:
 			case 150:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3395,7 +3483,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 213:
 			case 212:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -3414,7 +3502,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 241:
 			case 240:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -3433,7 +3521,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 236:
 			case 232:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3452,7 +3540,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 109:
 			case 105:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_C
@@ -3471,7 +3559,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 171:
 			case 43:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3490,7 +3578,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 143:
 			case 15:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL02_1R
@@ -3513,7 +3601,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3525,7 +3613,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 203:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3543,7 +3631,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 62:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3565,7 +3653,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3577,7 +3665,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 118:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3599,7 +3687,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3615,7 +3703,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1R
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3627,7 +3715,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 155:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3737,12 +3825,12 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3753,12 +3841,12 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 158:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3774,7 +3862,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 234:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -3783,7 +3871,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3797,7 +3885,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 242:
 				PIXEL00_1M
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3805,7 +3893,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_1
 				PIXEL11
 				PIXEL20_1L
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3816,7 +3904,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 59:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3825,7 +3913,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -3842,7 +3930,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3851,7 +3939,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -3859,7 +3947,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 87:
 				PIXEL00_1L
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3872,14 +3960,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL20_1M
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 79:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3891,7 +3979,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1R
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -3900,20 +3988,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 122:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -3922,19 +4010,19 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 94:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -3945,38 +4033,38 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 218:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -3987,7 +4075,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 91:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -3996,20 +4084,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
 				}
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4060,13 +4148,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 186:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4081,7 +4169,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 115:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4091,7 +4179,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4104,20 +4192,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 206:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -4127,7 +4215,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -4143,7 +4231,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_1M
 				} else {
 					PIXEL20_2
@@ -4153,7 +4241,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 174:
 			case 46:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_1M
 				} else {
 					PIXEL00_2
@@ -4171,7 +4259,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 147:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_1M
 				} else {
 					PIXEL02_2
@@ -4193,7 +4281,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_1M
 				} else {
 					PIXEL22_2
@@ -4223,7 +4311,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 126:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4233,7 +4321,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL12_3
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4245,7 +4333,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 219:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4257,7 +4345,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -4268,7 +4356,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 125:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL00_1U
 					PIXEL10_C
 					PIXEL20_C
@@ -4286,7 +4374,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 221:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL02_1U
 					PIXEL12_C
 					PIXEL21_C
@@ -4304,7 +4392,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL20_1M
 				break;
 			case 207:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL02_1R
@@ -4322,7 +4410,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 238:
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4340,7 +4428,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_1
 				break;
 			case 190:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4358,7 +4446,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL21_1
 				break;
 			case 187:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4376,7 +4464,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 243:
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL20_1L
 					PIXEL21_C
@@ -4394,7 +4482,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				break;
 			case 119:
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL00_1L
 					PIXEL01_C
 					PIXEL02_C
@@ -4419,7 +4507,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4429,7 +4517,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 175:
 			case 47:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4447,7 +4535,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 151:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4469,7 +4557,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4480,7 +4568,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL01_C
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -4488,7 +4576,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4497,7 +4585,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 123:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4508,7 +4596,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4518,7 +4606,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 95:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -4526,7 +4614,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4540,7 +4628,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 222:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4551,7 +4639,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4565,7 +4653,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1U
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
@@ -4573,7 +4661,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_4
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4585,13 +4673,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL02_1M
 				PIXEL10_C
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4600,7 +4688,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 235:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4611,7 +4699,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4620,7 +4708,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 111:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4630,7 +4718,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4640,13 +4728,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 63:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4660,7 +4748,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 159:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
@@ -4668,7 +4756,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL10_3
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4682,7 +4770,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 215:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4691,7 +4779,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL11
 				PIXEL12_C
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4701,7 +4789,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 246:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4713,7 +4801,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4721,7 +4809,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				break;
 			case 254:
 				PIXEL00_1M
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 				} else {
@@ -4729,14 +4817,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL02_4
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 				} else {
 					PIXEL10_3
 					PIXEL20_4
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL21_C
 					PIXEL22_C
@@ -4753,20 +4841,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 251:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 				} else {
@@ -4775,7 +4863,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL02_1M
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL10_C
 					PIXEL20_C
 					PIXEL21_C
@@ -4784,7 +4872,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL20_2
 					PIXEL21_3
 				}
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL12_C
 					PIXEL22_C
 				} else {
@@ -4793,7 +4881,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				break;
 			case 239:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
@@ -4803,7 +4891,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_1
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
@@ -4812,7 +4900,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1R
 				break;
 			case 127:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL01_C
 					PIXEL10_C
@@ -4821,7 +4909,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL01_3
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 					PIXEL12_C
 				} else {
@@ -4829,7 +4917,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 					PIXEL12_3
 				}
 				PIXEL11
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 					PIXEL21_C
 				} else {
@@ -4839,13 +4927,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1M
 				break;
 			case 191:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4858,14 +4946,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL22_1D
 				break;
 			case 223:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 					PIXEL10_C
 				} else {
 					PIXEL00_4
 					PIXEL10_3
 				}
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL01_C
 					PIXEL02_C
 					PIXEL12_C
@@ -4876,7 +4964,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				}
 				PIXEL11
 				PIXEL20_1M
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL21_C
 					PIXEL22_C
 				} else {
@@ -4887,7 +4975,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			case 247:
 				PIXEL00_1L
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4897,20 +4985,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL12_C
 				PIXEL20_1L
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
 				}
 				break;
 			case 255:
-				if (diffYUV(YUV(4), YUV(2))) {
+				if (pattern & kHQDiff42) {
 					PIXEL00_C
 				} else {
 					PIXEL00_2
 				}
 				PIXEL01_C
-				if (diffYUV(YUV(2), YUV(6))) {
+				if (pattern & kHQDiff26) {
 					PIXEL02_C
 				} else {
 					PIXEL02_2
@@ -4918,13 +5006,13 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 				PIXEL10_C
 				PIXEL11
 				PIXEL12_C
-				if (diffYUV(YUV(8), YUV(4))) {
+				if (pattern & kHQDiff84) {
 					PIXEL20_C
 				} else {
 					PIXEL20_2
 				}
 				PIXEL21_C
-				if (diffYUV(YUV(6), YUV(8))) {
+				if (pattern & kHQDiff68) {
 					PIXEL22_C
 				} else {
 					PIXEL22_2
@@ -4951,7 +5039,7 @@ HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 #ifdef USE_NASM
 	_hqx_params(nullptr),
 #endif
-	_RGBtoYUV(nullptr) {
+	_RGBtoYUV(nullptr), _classify(hqGetClassifyFunc()) {
 	_factor = 2;
 
 	if (format.bytesPerPixel == 2) {
@@ -4987,19 +5075,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _classify);
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _classify);
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _classify);
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _classify);
 }
 #endif
 
@@ -5019,18 +5107,18 @@ void HQScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 		case 2:
 			if (_format.aLoss == 0)
 				HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height, _RGBtoYUV);
+						dstPitch, width, height, _RGBtoYUV, _classify);
 			else
 				HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height, _RGBtoYUV);
+						dstPitch, width, height, _RGBtoYUV, _classify);
 			break;
 		case 3:
 			if (_format.aLoss == 0)
 				HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height, _RGBtoYUV);
+						dstPitch, width, height, _RGBtoYUV, _classify);
 			else
 				HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-						dstPitch, width, height, _RGBtoYUV);
+						dstPitch, width, height, _RGBtoYUV, _classify);
 			break;
 		}
 	}
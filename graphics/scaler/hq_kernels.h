@@ -0,0 +1,78 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_SCALER_HQ_KERNELS_H
+#define GRAPHICS_SCALER_HQ_KERNELS_H
+
+#include "common/scummsys.h"
+
+/**
+ * Flags computed for every source pixel by the HQ pattern classification.
+ *
+ * The low byte is the pattern of the hqNx filters: bit n - 1 (n - 2 for
+ * n > 5) is set if neighbour w<n> differs from the center pixel w5 in the
+ * YUV color space:
+ *
+ *	 +----+----+----+
+ *	 | w1 | w2 | w3 |
+ *	 +----+----+----+
+ *	 | w4 | w5 | w6 |
+ *	 +----+----+----+
+ *	 | w7 | w8 | w9 |
+ *	 +----+----+----+
+ *
+ * The other flags store the comparisons between the edge neighbours which
+ * some of the patterns need.
+ */
+enum HQFlags {
+	kHQPatternMask = 0x00ff,
+	kHQDiff26      = 0x0100, ///< w2 differs from w6
+	kHQDiff68      = 0x0200, ///< w6 differs from w8
+	kHQDiff84      = 0x0400, ///< w8 differs from w4
+	kHQDiff42      = 0x0800  ///< w4 differs from w2
+};
+
+/**
+ * Classify a row of pixels.
+ *
+ * The rows hold the YUV values from the RGBtoYUV table of the row above,
+ * the row itself and the row below, starting one pixel left of the first
+ * pixel and ending one pixel right of the last one.
+ *
+ * @param flags  Receives the HQFlags of @p width pixels.
+ */
+typedef void (*HQClassifyFunc)(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width);
+
+void hqClassifyRow(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width);
+
+#ifdef SCUMMVM_SSE2
+void hqClassifyRowSSE2(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width);
+#endif
+
+#ifdef SCUMMVM_NEON
+void hqClassifyRowNEON(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width);
+#endif
+
+/** Select the fastest classification supported by the CPU we are running on. */
+HQClassifyFunc hqGetClassifyFunc();
+
+#endif
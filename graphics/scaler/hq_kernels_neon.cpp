@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/scaler/hq_kernels.h"
+
+#include <arm_neon.h>
+
+namespace {
+
+/**
+ * All bits set in the lanes where the YUV values are close enough to count
+ * as the same color for diffYUV(). The Y, U and V fields all fit in a byte,
+ * so saturating byte arithmetic gives the absolute differences.
+ */
+inline uint32x4_t sameYUV(uint32x4_t a, uint32x4_t b) {
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(0x00300706));
+	const uint8x16_t absDiff = vabdq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b));
+	return vceqq_u32(vreinterpretq_u32_u8(vqsubq_u8(absDiff, thresholds)), vdupq_n_u32(0));
+}
+
+inline uint32x4_t flagIfDifferent(uint32x4_t a, uint32x4_t b, uint32 flag) {
+	return vbicq_u32(vdupq_n_u32(flag), sameYUV(a, b));
+}
+
+inline uint32x4_t classify4(const uint32 *prev, const uint32 *cur, const uint32 *next) {
+	const uint32x4_t w2 = vld1q_u32(prev + 1);
+	const uint32x4_t w4 = vld1q_u32(cur);
+	const uint32x4_t w5 = vld1q_u32(cur + 1);
+	const uint32x4_t w6 = vld1q_u32(cur + 2);
+	const uint32x4_t w8 = vld1q_u32(next + 1);
+
+	uint32x4_t flags = flagIfDifferent(w5, vld1q_u32(prev), 0x0001);
+	flags = vorrq_u32(flags, flagIfDifferent(w5, w2, 0x0002));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, vld1q_u32(prev + 2), 0x0004));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, w4, 0x0008));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, w6, 0x0010));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, vld1q_u32(next), 0x0020));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, w8, 0x0040));
+	flags = vorrq_u32(flags, flagIfDifferent(w5, vld1q_u32(next + 2), 0x0080));
+
+	flags = vorrq_u32(flags, flagIfDifferent(w2, w6, kHQDiff26));
+	flags = vorrq_u32(flags, flagIfDifferent(w6, w8, kHQDiff68));
+	flags = vorrq_u32(flags, flagIfDifferent(w8, w4, kHQDiff84));
+	return vorrq_u32(flags, flagIfDifferent(w4, w2, kHQDiff42));
+}
+
+} // End of anonymous namespace
+
+void hqClassifyRowNEON(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width) {
+	for (; width >= 8; width -= 8, flags += 8, prev += 8, cur += 8, next += 8) {
+		const uint32x4_t lo = classify4(prev, cur, next);
+		const uint32x4_t hi = classify4(prev + 4, cur + 4, next + 4);
+		vst1q_u16(flags, vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+	}
+
+	hqClassifyRow(flags, prev, cur, next, width);
+}
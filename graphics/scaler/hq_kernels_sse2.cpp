@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/scaler/hq_kernels.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+/**
+ * All bits set in the lanes where the YUV values are close enough to count
+ * as the same color for diffYUV(). The Y, U and V fields all fit in a byte,
+ * so saturating byte arithmetic gives the absolute differences.
+ */
+inline __m128i sameYUV(__m128i a, __m128i b) {
+	const __m128i thresholds = _mm_set1_epi32(0x00300706);
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+	return _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, thresholds), _mm_setzero_si128());
+}
+
+inline __m128i flagIfDifferent(__m128i a, __m128i b, int flag) {
+	return _mm_andnot_si128(sameYUV(a, b), _mm_set1_epi32(flag));
+}
+
+inline __m128i load(const uint32 *p) {
+	return _mm_loadu_si128((const __m128i *)p);
+}
+
+inline __m128i classify4(const uint32 *prev, const uint32 *cur, const uint32 *next) {
+	const __m128i w2 = load(prev + 1);
+	const __m128i w4 = load(cur);
+	const __m128i w5 = load(cur + 1);
+	const __m128i w6 = load(cur + 2);
+	const __m128i w8 = load(next + 1);
+
+	__m128i flags = flagIfDifferent(w5, load(prev), 0x0001);
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, w2, 0x0002));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, load(prev + 2), 0x0004));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, w4, 0x0008));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, w6, 0x0010));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, load(next), 0x0020));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, w8, 0x0040));
+	flags = _mm_or_si128(flags, flagIfDifferent(w5, load(next + 2), 0x0080));
+
+	flags = _mm_or_si128(flags, flagIfDifferent(w2, w6, kHQDiff26));
+	flags = _mm_or_si128(flags, flagIfDifferent(w6, w8, kHQDiff68));
+	flags = _mm_or_si128(flags, flagIfDifferent(w8, w4, kHQDiff84));
+	return _mm_or_si128(flags, flagIfDifferent(w4, w2, kHQDiff42));
+}
+
+} // End of anonymous namespace
+
+void hqClassifyRowSSE2(uint16 *flags, const uint32 *prev, const uint32 *cur, const uint32 *next, uint width) {
+	for (; width >= 8; width -= 8, flags += 8, prev += 8, cur += 8, next += 8) {
+		const __m128i lo = classify4(prev, cur, next);
+		const __m128i hi = classify4(prev + 4, cur + 4, next + 4);
+		_mm_storeu_si128((__m128i *)flags, _mm_packs_epi32(lo, hi));
+	}
+
+	hqClassifyRow(flags, prev, cur, next, width);
+}
@@ -382,6 +382,9 @@ public:
 
 	bool canDrawCursor() const override { return true; }
 	uint extraPixels() const override { return 4; }
+	// Scale4x reads past the ends of its intermediate rows, so the first and
+	// last columns depend on what the rows above stored there
+	bool canScaleInBands(uint factor) const override { return factor != 4; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
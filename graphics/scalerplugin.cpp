@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/thread.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -40,6 +42,27 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 		dstPtr += dstPitch;
 	}
 }
+struct ScalerBands {
+	Scaler *scaler;
+	const uint8 *src;
+	uint32 srcPitch;
+	uint8 *dst;
+	uint32 dstPitch;
+	int width, height;
+	int x, y;
+	uint count;
+};
+
+void scaleBand(void *data, uint index) {
+	const ScalerBands *bands = (const ScalerBands *)data;
+
+	const int top = bands->height * index / bands->count;
+	const int bottom = bands->height * (index + 1) / bands->count;
+
+	bands->scaler->scale(bands->src + top * bands->srcPitch, bands->srcPitch,
+		bands->dst + top * bands->scaler->getFactor() * bands->dstPitch, bands->dstPitch,
+		bands->width, bottom - top, bands->x, bands->y + top);
+}
 } // End of anonymous namespace
 
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
@@ -55,6 +78,22 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	}
 }
 
+void Scaler::scaleInBands(Common::WorkerPool &pool, uint bands, const uint8 *srcPtr, uint32 srcPitch,
+                          uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	ScalerBands data;
+	data.scaler = this;
+	data.src = srcPtr;
+	data.srcPitch = srcPitch;
+	data.dst = dstPtr;
+	data.dstPitch = dstPitch;
+	data.width = width;
+	data.height = height;
+	data.x = x;
+	data.y = y;
+	data.count = bands;
+	pool.run(scaleBand, &data, bands);
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
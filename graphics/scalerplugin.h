@@ -25,6 +25,10 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 class Scaler {
 public:
 	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
@@ -45,6 +49,17 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Scale a rect like scale(), but split it into @p bands horizontal
+	 * bands which are scaled at the same time on @p pool. The band heights
+	 * differ by one row at most.
+	 *
+	 * Only use this if the plugin returns true for
+	 * ScalerPluginObject::canScaleInBands().
+	 */
+	void scaleInBands(Common::WorkerPool &pool, uint bands, const uint8 *srcPtr, uint32 srcPitch,
+	                  uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y);
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -199,6 +214,14 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether scaling a rect in horizontal bands with Scaler::scaleInBands()
+	 * gives the same result as scaling it at once. Scalers which keep state
+	 * between the rows they scale, or compare against the old source, must
+	 * return false.
+	 */
+	virtual bool canScaleInBands(uint factor) const { return !useOldSource(); }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -25,6 +25,8 @@
  * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
  */
 
+#include "common/config-manager.h"
+
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
@@ -32,6 +34,7 @@
 namespace TinyGL {
 
 GLContext *gl_ctx;
+static thread_local GLContext *gl_thread_ctx = nullptr;
 
 void GLContext::initSharedState() {
 	GLSharedState *s = &shared_state;
@@ -260,13 +263,37 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(kDrawCallMemory);
 	_debugRectsEnabled = false;
 
+	// The draw calls can only be sorted into tiles by their dirty regions.
+	// Like the scalers, use all but one of the CPU cores, at most four.
+	const uint kMaxTileThreads = 4;
+	_tileRasterizer = nullptr;
+	_tileVertices = nullptr;
+	if (_enableDirtyRectangles) {
+		int tileThreads = Common::WorkerPool::getDefaultNumWorkers(kMaxTileThreads);
+		if (ConfMan.hasKey("tinygl_threads"))
+			tileThreads = ConfMan.getInt("tinygl_threads");
+		if (tileThreads > 0) {
+			_tileRasterizer = new TileRasterizer(tileThreads);
+			if (!_tileRasterizer->getNumThreads()) {
+				delete _tileRasterizer;
+				_tileRasterizer = nullptr;
+			}
+		}
+	}
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
 GLContext *gl_get_context() {
+	if (gl_thread_ctx)
+		return gl_thread_ctx;
 	return gl_ctx;
 }
 
+void gl_set_thread_context(GLContext *c) {
+	gl_thread_ctx = c;
+}
+
 void destroyContext() {
 	GLContext *c = gl_get_context();
 	assert(c);
@@ -276,6 +303,8 @@ void destroyContext() {
 }
 
 void GLContext::deinit() {
+	delete _tileRasterizer;
+	_tileRasterizer = nullptr;
 	disposeDrawCallLists();
 	disposeResources();
 
@@ -29,17 +29,31 @@ namespace TinyGL {
 #define ZB_POINT_ST_UNIT (1 << ZB_POINT_ST_FRAC_BITS)
 #define ZB_POINT_ST_FRAC_MASK (ZB_POINT_ST_UNIT - 1)
 
-TexelBuffer::TexelBuffer(uint width, uint height, uint textureSize) {
+TexelBuffer::TexelBuffer(uint width, uint height, uint textureSize, bool mipmaps) {
 	assert(width);
 	assert(height);
 	assert(textureSize);
 
-	_width = width;
-	_height = height;
 	_fracTextureUnit = textureSize << ZB_POINT_ST_FRAC_BITS;
 	_fracTextureMask = _fracTextureUnit - 1;
-	_widthRatio = (float) width / textureSize;
-	_heightRatio = (float) height / textureSize;
+
+	_texelCount = 0;
+	for (;;) {
+		Level level;
+		level.width = width;
+		level.height = height;
+		level.tilesPerRow = (width + kTileMask) >> kTileShift;
+		level.offset = _texelCount;
+		level.widthRatio = (float) width / textureSize;
+		level.heightRatio = (float) height / textureSize;
+		_levels.push_back(level);
+		_texelCount += (level.tilesPerRow * ((height + kTileMask) >> kTileShift)) << (2 * kTileShift);
+
+		if (!mipmaps || (width == 1 && height == 1))
+			break;
+		width = MAX<uint>(width >> 1, 1);
+		height = MAX<uint>(height >> 1, 1);
+	}
 }
 
 static inline uint wrap(uint wrap_mode, int coord, uint _fracTextureUnit, uint _fracTextureMask) {
@@ -63,36 +77,100 @@ static inline uint wrap(uint wrap_mode, int coord, uint _fracTextureUnit, uint _
 
 void TexelBuffer::getARGBAt(
 	uint wrap_s, uint wrap_t,
-	int s, int t,
+	int s, int t, uint level,
 	uint8 &a, uint8 &r, uint8 &g, uint8 &b
 ) const {
+	const Level &l = _levels[level];
 	uint x, y;
-	x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * _widthRatio;
-	y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * _heightRatio;
+	x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * l.widthRatio;
+	y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * l.heightRatio;
 	getARGBAt(
-		(x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * _width,
+		l,
+		x >> ZB_POINT_ST_FRAC_BITS, y >> ZB_POINT_ST_FRAC_BITS,
 		x & ZB_POINT_ST_FRAC_MASK, y & ZB_POINT_ST_FRAC_MASK,
 		a, r, g, b
 	);
 }
 
+uint TexelBuffer::getLevel(int dsdx, int dtdx, int dsdy, int dtdy) const {
+	if (_levels.size() == 1)
+		return 0;
+
+	// The size of a screen pixel in texels of the first level, rounded to
+	// the nearest level
+	const float ds = MAX(ABS(dsdx), ABS(dsdy)) * _levels[0].widthRatio;
+	const float dt = MAX(ABS(dtdx), ABS(dtdy)) * _levels[0].heightRatio;
+	float footprint = MAX(ds, dt);
+	uint level = 0;
+	while (level + 1 < _levels.size() && footprint >= 1.5f * ZB_POINT_ST_UNIT) {
+		footprint *= 0.5f;
+		level++;
+	}
+	return level;
+}
+
+void TexelBuffer::readImage(const Graphics::PixelBuffer &buf, Common::Array<uint32> &image) const {
+	const uint count = _levels[0].width * _levels[0].height;
+	image.resize(count);
+	for (uint i = 0; i < count; i++) {
+		uint8 a, r, g, b;
+		buf.getARGBAt(i, a, r, g, b);
+		image[i] = (a << 24) | (r << 16) | (g << 8) | b;
+	}
+}
+
+void TexelBuffer::downsample(Common::Array<uint32> &image, const Level &from, const Level &to) const {
+	Common::Array<uint32> result(to.width * to.height);
+	for (uint y = 0; y < to.height; y++) {
+		const uint32 *row0 = &image[MIN(y * 2, from.height - 1) * from.width];
+		const uint32 *row1 = &image[MIN(y * 2 + 1, from.height - 1) * from.width];
+		for (uint x = 0; x < to.width; x++) {
+			const uint x0 = MIN(x * 2, from.width - 1);
+			const uint x1 = MIN(x * 2 + 1, from.width - 1);
+			uint32 texel = 0;
+			for (int shift = 0; shift < 32; shift += 8) {
+				const uint sum = ((row0[x0] >> shift) & 0xFF) + ((row0[x1] >> shift) & 0xFF) +
+				                 ((row1[x0] >> shift) & 0xFF) + ((row1[x1] >> shift) & 0xFF);
+				texel |= ((sum + 2) >> 2) << shift;
+			}
+			result[x + y * to.width] = texel;
+		}
+	}
+	image = result;
+}
+
 // Nearest: store texture in original size.
-NearestTexelBuffer::NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize) : TexelBuffer(width, height, textureSize) {
-	uint pixel_count = _width * _height;
-	_buf = Graphics::PixelBuffer(buf.getFormat(), pixel_count, DisposeAfterUse::NO);
-	_buf.copyBuffer(0, pixel_count, buf);
+NearestTexelBuffer::NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, bool mipmaps) : TexelBuffer(width, height, textureSize, mipmaps) {
+	_texels = new uint32[getTexelCount()];
+
+	Common::Array<uint32> image;
+	readImage(buf, image);
+	for (uint i = 0; i < _levels.size(); i++) {
+		const Level &level = _levels[i];
+		if (i > 0)
+			downsample(image, _levels[i - 1], level);
+		for (uint y = 0; y < level.height; y++) {
+			for (uint x = 0; x < level.width; x++)
+				_texels[texelOffset(level, x, y)] = image[x + y * level.width];
+		}
+	}
 }
 
 NearestTexelBuffer::~NearestTexelBuffer() {
-	_buf.free();
+	delete[] _texels;
 }
 
 void NearestTexelBuffer::getARGBAt(
-	uint pixel,
+	const Level &level,
+	uint x, uint y,
 	uint, uint,
 	uint8 &a, uint8 &r, uint8 &g, uint8 &b
 ) const {
-	_buf.getARGBAt(pixel, a, r, g, b);
+	const uint32 texel = _texels[texelOffset(level, x, y)];
+	a = texel >> 24;
+	r = texel >> 16;
+	g = texel >> 8;
+	b = texel;
 }
 
 // Bilinear: each texture coordinates corresponds to the 4 original image
@@ -111,56 +189,30 @@ void NearestTexelBuffer::getARGBAt(
 #define P11_OFFSET 3
 #define PIXEL_PER_TEXEL_SHIFT 2
 
-BilinearTexelBuffer::BilinearTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize) : TexelBuffer(width, height, textureSize) {
-	uint pixel00_offset = 0, pixel11_offset, pixel01_offset, pixel10_offset;
-	uint8 *texel8;
-	uint32 *texel32;
-
-	texel32 = _texels = new uint32[_width * _height << PIXEL_PER_TEXEL_SHIFT];
-	for (uint y = 0; y < _height; y++) {
-		for (uint x = 0; x < _width; x++) {
-			texel8 = (uint8 *)texel32;
-			pixel11_offset = pixel00_offset + _width + 1;
-			buf.getARGBAt(
-				pixel00_offset,
-				*(texel8 + P00_OFFSET + A_OFFSET),
-				*(texel8 + P00_OFFSET + R_OFFSET),
-				*(texel8 + P00_OFFSET + G_OFFSET),
-				*(texel8 + P00_OFFSET + B_OFFSET)
-			);
-			if ((x + 1) == _width) {
-				pixel11_offset -= 1;
-				pixel01_offset = pixel00_offset;
-			} else
-				pixel01_offset = pixel00_offset + 1;
-			buf.getARGBAt(
-				pixel01_offset,
-				*(texel8 + P01_OFFSET + A_OFFSET),
-				*(texel8 + P01_OFFSET + R_OFFSET),
-				*(texel8 + P01_OFFSET + G_OFFSET),
-				*(texel8 + P01_OFFSET + B_OFFSET)
-			);
-			if ((y + 1) == _height) {
-				pixel11_offset -= _width;
-				pixel10_offset = pixel00_offset;
-			} else
-				pixel10_offset = pixel00_offset + _width;
-			buf.getARGBAt(
-				pixel10_offset,
-				*(texel8 + P10_OFFSET + A_OFFSET),
-				*(texel8 + P10_OFFSET + R_OFFSET),
-				*(texel8 + P10_OFFSET + G_OFFSET),
-				*(texel8 + P10_OFFSET + B_OFFSET)
-			);
-			buf.getARGBAt(
-				pixel11_offset,
-				*(texel8 + P11_OFFSET + A_OFFSET),
-				*(texel8 + P11_OFFSET + R_OFFSET),
-				*(texel8 + P11_OFFSET + G_OFFSET),
-				*(texel8 + P11_OFFSET + B_OFFSET)
-			);
-			texel32 += 1 << PIXEL_PER_TEXEL_SHIFT;
-			pixel00_offset++;
+BilinearTexelBuffer::BilinearTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, bool mipmaps) : TexelBuffer(width, height, textureSize, mipmaps) {
+	_texels = new uint32[getTexelCount() << PIXEL_PER_TEXEL_SHIFT];
+
+	Common::Array<uint32> image;
+	readImage(buf, image);
+	for (uint i = 0; i < _levels.size(); i++) {
+		const Level &level = _levels[i];
+		if (i > 0)
+			downsample(image, _levels[i - 1], level);
+		for (uint y = 0; y < level.height; y++) {
+			// The last row and column use themselves as their neighbours
+			const uint32 *row0 = &image[y * level.width];
+			const uint32 *row1 = &image[MIN(y + 1, level.height - 1) * level.width];
+			for (uint x = 0; x < level.width; x++) {
+				const uint x1 = MIN(x + 1, level.width - 1);
+				const uint32 pixels[4] = { row0[x], row0[x1], row1[x], row1[x1] };
+				uint8 *texel8 = (uint8 *)(_texels + (texelOffset(level, x, y) << PIXEL_PER_TEXEL_SHIFT));
+				for (int p = 0; p < 4; p++) {
+					*(texel8 + p + A_OFFSET) = pixels[p] >> 24;
+					*(texel8 + p + R_OFFSET) = pixels[p] >> 16;
+					*(texel8 + p + G_OFFSET) = pixels[p] >> 8;
+					*(texel8 + p + B_OFFSET) = pixels[p];
+				}
+			}
 		}
 	}
 }
@@ -174,12 +226,13 @@ static inline int interpolate(int v00, int v01, int v10, int xf, int yf) {
 }
 
 void BilinearTexelBuffer::getARGBAt(
-	uint pixel,
+	const Level &level,
+	uint x, uint y,
 	uint ds, uint dt,
 	uint8 &a, uint8 &r, uint8 &g, uint8 &b
 ) const {
 	uint p00_offset, p01_offset, p10_offset;
-	uint8 *texel = (uint8 *)(_texels + (pixel << PIXEL_PER_TEXEL_SHIFT));
+	uint8 *texel = (uint8 *)(_texels + (texelOffset(level, x, y) << PIXEL_PER_TEXEL_SHIFT));
 	if ((ds + dt) > ZB_POINT_ST_UNIT) {
 		p00_offset = P11_OFFSET;
 		p10_offset = P01_OFFSET;
@@ -22,55 +22,108 @@
 #ifndef GRAPHICS_TEXELBUFFER_H
 #define GRAPHICS_TEXELBUFFER_H
 
+#include "common/array.h"
 #include "graphics/tinygl/pixelbuffer.h"
 
 namespace TinyGL {
 
+/**
+ * Texture storage, with optional mipmap levels.
+ *
+ * All levels are stored in tiles of 4x4 texels, so that texels which are
+ * close to each other on screen are close in memory as well, whichever
+ * way the texture is rotated.
+ */
 class TexelBuffer {
 public:
-	TexelBuffer(uint width, uint height, uint textureSize);
+	TexelBuffer(uint width, uint height, uint textureSize, bool mipmaps);
 	virtual ~TexelBuffer() {};
 
 	void getARGBAt(
 		uint wrap_s, uint wrap_t,
-		int s, int t,
+		int s, int t, uint level,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	/** Number of mipmap levels, 1 if the texture has no mipmaps. */
+	uint getLevelCount() const { return _levels.size(); }
+
+	/**
+	 * Select the mipmap level to sample from, given how much the texture
+	 * coordinates change from one screen pixel to the next one.
+	 */
+	uint getLevel(int dsdx, int dtdx, int dsdy, int dtdy) const;
+
 protected:
+	enum {
+		kTileShift = 2,
+		kTileSize = 1 << kTileShift,
+		kTileMask = kTileSize - 1
+	};
+
+	struct Level {
+		uint width, height;
+		uint tilesPerRow;
+		uint offset; ///< Index of the first texel of the level
+		float widthRatio, heightRatio;
+	};
+
+	/** Index of texel (x, y) of a level in the tiled storage. */
+	uint texelOffset(const Level &level, uint x, uint y) const {
+		return level.offset +
+		       ((((y >> kTileShift) * level.tilesPerRow + (x >> kTileShift)) << (2 * kTileShift)) |
+		        ((y & kTileMask) << kTileShift) | (x & kTileMask));
+	}
+
+	/** Total number of texels of all levels, including the padding of the tiles. */
+	uint getTexelCount() const { return _texelCount; }
+
+	/**
+	 * Read @p buf as ARGB values, with alpha in the highest byte, into
+	 * @p image. Each call of downsample() then replaces @p image by the
+	 * next mipmap level.
+	 */
+	void readImage(const Graphics::PixelBuffer &buf, Common::Array<uint32> &image) const;
+	void downsample(Common::Array<uint32> &image, const Level &from, const Level &to) const;
+
 	virtual void getARGBAt(
-		uint pixel,
+		const Level &level,
+		uint x, uint y,
 		uint ds, uint dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const = 0;
-	uint _width, _height, _fracTextureUnit, _fracTextureMask;
-	float _widthRatio, _heightRatio;
+
+	Common::Array<Level> _levels;
+	uint _texelCount;
+	uint _fracTextureUnit, _fracTextureMask;
 };
 
 class NearestTexelBuffer : public TexelBuffer {
 public:
-	NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize);
+	NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, bool mipmaps);
 	~NearestTexelBuffer();
 
 protected:
 	void getARGBAt(
-		uint pixel,
+		const Level &level,
+		uint x, uint y,
 		uint, uint,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const override;
 
 private:
-	Graphics::PixelBuffer _buf;
+	uint32 *_texels;
 };
 
 class BilinearTexelBuffer : public TexelBuffer {
 public:
-	BilinearTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize);
+	BilinearTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, bool mipmaps);
 	~BilinearTexelBuffer();
 
 protected:
 	void getARGBAt(
-		uint pixel,
+		const Level &level,
+		uint x, uint y,
 		uint ds, uint dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const override;
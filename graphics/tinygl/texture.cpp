@@ -174,6 +174,10 @@ void GLContext::glopTexImage2D(GLParam *p) {
 			filter = texture_mag_filter;
 		else
 			filter = texture_min_filter;
+		// The smaller levels are generated from the first one, only that one
+		// is used for drawing
+		const bool mipmaps = level == 0 && (filter == TGL_NEAREST_MIPMAP_NEAREST || filter == TGL_NEAREST_MIPMAP_LINEAR ||
+		                      filter == TGL_LINEAR_MIPMAP_NEAREST || filter == TGL_LINEAR_MIPMAP_LINEAR);
 		switch (filter) {
 		case TGL_LINEAR_MIPMAP_NEAREST:
 		case TGL_LINEAR_MIPMAP_LINEAR:
@@ -181,14 +185,14 @@ void GLContext::glopTexImage2D(GLParam *p) {
 			im->pixmap = new BilinearTexelBuffer(
 				srcInternal,
 				width, height,
-				_textureSize
+				_textureSize, mipmaps
 			);
 			break;
 		default:
 			im->pixmap = new NearestTexelBuffer(
 				srcInternal,
 				width, height,
-				_textureSize
+				_textureSize, mipmaps
 			);
 			break;
 		}
@@ -88,16 +88,30 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	_pbuf.set(_pbufFormat, new byte[_pbufHeight * _pbufPitch]);
 	_zbuf = (uint *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(uint));
+	_sbuf = nullptr;
 	if (enableStencilBuffer)
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
 
 	_offscreenBuffer.pbuf = _pbuf.getRawBuffer();
 	_offscreenBuffer.zbuf = _zbuf;
 
+	_ownsBuffers = true;
+
+	_clipRectangle = Common::Rect(_pbufWidth, _pbufHeight);
+	_enableScissor = false;
+
 	_currentTexture = nullptr;
+	_hasSpanKernels = getSpanKernels(_spanKernels, _pbufFormat);
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer *target) {
+	*this = *target;
+	_ownsBuffers = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
 	_pbuf.free();
 	gl_free(_zbuf);
 	if (_sbuf)
@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/pixelbuffer.h"
 #include "graphics/tinygl/texelbuffer.h"
+#include "graphics/tinygl/zspan_kernels.h"
 #include "graphics/tinygl/gl.h"
 
 #include "common/rect.h"
@@ -102,6 +103,12 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
+	/**
+	 * Create a frame buffer which draws into the buffers of @p target, starting
+	 * with a copy of its render state. Used to rasterize separate parts of the
+	 * screen at the same time.
+	 */
+	explicit FrameBuffer(const FrameBuffer *target);
 	~FrameBuffer();
 
 	Graphics::PixelFormat getPixelFormat() {
@@ -311,11 +318,16 @@ private:
 
 	template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 	FORCEINLINE void putPixelTexture(int fbOffset, const TexelBuffer *texture,
-	                                 uint wrap_s, uint wrap_t, uint *pz, byte *ps, int _a,
+	                                 uint wrap_s, uint wrap_t, uint level, uint *pz, byte *ps, int _a,
 	                                 int x, int y, uint &z, int &t, int &s,
 	                                 uint &r, uint &g, uint &b, uint &a,
 	                                 int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx);
 
+	template <bool kSmoothMode, bool kDepthTestEnabled>
+	FORCEINLINE void putTextureSpan(int fbOffset, const TexelBuffer *texture, uint level, const TextureSpanState &state,
+	                                uint *pz, uint &z, int t, int s, uint &r, uint &g, uint &b, uint &a,
+	                                int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, uint dadx);
+
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 	FORCEINLINE void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
 
@@ -651,6 +663,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -660,6 +673,8 @@ private:
 	bool _enableScissor;
 
 	const TexelBuffer *_currentTexture;
+	SpanKernels _spanKernels;
+	bool _hasSpanKernels;
 	uint _wrapS, _wrapT;
 	bool _blendingEnabled;
 	int _sourceBlendingFactor;
@@ -193,12 +193,21 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		// Selection writes its hits into a shared buffer, so it stays on this thread.
+		if (_tileRasterizer && render_mode == TGL_RENDER) {
+			Common::Array<Common::Rect> dirtyRegions;
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				dirtyRegions.push_back((*itRect).rectangle);
+			}
+			_tileRasterizer->execute(this, _drawCallsQueue, dirtyRegions);
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -345,7 +354,15 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	// Drawing changes the edge flags of the vertices for a while, which must
+	// not affect other tiles drawing this call at the same time.
+	if (c->_tileVertices) {
+		c->_tileVertices->resize(_vertexCount);
+		memcpy(c->_tileVertices->begin(), _vertex, sizeof(GLVertex) * _vertexCount);
+		c->vertex = c->_tileVertices->begin();
+	} else {
+		c->vertex = _vertex;
+	}
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
@@ -760,6 +777,157 @@ bool RasterizationDrawCall::RasterizationState::operator==(const RasterizationSt
 		viewportScaling[2] == other.viewportScaling[2];
 }
 
+TileRasterizer::TileRasterizer(uint numThreads) : _pool(numThreads, "TinyGL rasterizer"), _nextTile(0) {
+	_lanes.resize(_pool.getNumWorkers() + 1);
+	for (uint i = 0; i < _lanes.size(); i++) {
+		_lanes[i].context = new GLContext();
+	}
+}
+
+TileRasterizer::~TileRasterizer() {
+	// The lane contexts only point to resources of the real one
+	for (uint i = 0; i < _lanes.size(); i++) {
+		delete _lanes[i].context;
+	}
+}
+
+void TileRasterizer::copyRenderState(GLContext *lane, const GLContext *c) {
+	lane->fb = c->fb;
+	lane->renderRect = c->renderRect;
+	lane->_scissorRect = c->_scissorRect;
+	lane->render_mode = c->render_mode;
+
+	lane->blending_enabled = c->blending_enabled;
+	lane->source_blending_factor = c->source_blending_factor;
+	lane->destination_blending_factor = c->destination_blending_factor;
+	lane->alpha_test_enabled = c->alpha_test_enabled;
+	lane->alpha_test_func = c->alpha_test_func;
+	lane->alpha_test_ref_val = c->alpha_test_ref_val;
+	lane->depth_test_enabled = c->depth_test_enabled;
+	lane->depth_func = c->depth_func;
+	lane->depth_write_mask = c->depth_write_mask;
+	lane->stencil_test_enabled = c->stencil_test_enabled;
+	lane->stencil_test_func = c->stencil_test_func;
+	lane->stencil_ref_val = c->stencil_ref_val;
+	lane->stencil_mask = c->stencil_mask;
+	lane->stencil_write_mask = c->stencil_write_mask;
+	lane->stencil_sfail = c->stencil_sfail;
+	lane->stencil_dpfail = c->stencil_dpfail;
+	lane->stencil_dppass = c->stencil_dppass;
+	lane->offset_states = c->offset_states;
+	lane->offset_factor = c->offset_factor;
+	lane->offset_units = c->offset_units;
+
+	lane->lighting_enabled = c->lighting_enabled;
+	lane->cull_face_enabled = c->cull_face_enabled;
+	lane->current_cull_face = c->current_cull_face;
+	lane->current_front_face = c->current_front_face;
+	lane->current_shade_model = c->current_shade_model;
+	lane->polygon_mode_back = c->polygon_mode_back;
+	lane->polygon_mode_front = c->polygon_mode_front;
+	lane->color_mask_red = c->color_mask_red;
+	lane->color_mask_green = c->color_mask_green;
+	lane->color_mask_blue = c->color_mask_blue;
+	lane->color_mask_alpha = c->color_mask_alpha;
+	lane->_textureSize = c->_textureSize;
+	lane->texture_2d_enabled = c->texture_2d_enabled;
+	lane->current_texture = c->current_texture;
+	lane->texture_wrap_s = c->texture_wrap_s;
+	lane->texture_wrap_t = c->texture_wrap_t;
+	lane->viewport = c->viewport;
+
+	lane->begin_type = c->begin_type;
+	lane->vertex_n = c->vertex_n;
+	lane->vertex_cnt = c->vertex_cnt;
+	lane->vertex = c->vertex;
+	lane->draw_triangle_front = c->draw_triangle_front;
+	lane->draw_triangle_back = c->draw_triangle_back;
+}
+
+void TileRasterizer::execute(GLContext *c, const Common::List<DrawCall *> &drawCalls, const Common::Array<Common::Rect> &rectangles) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	const int tilesX = (c->fb->getPixelBufferWidth() + kTileSize - 1) / kTileSize;
+	const int tilesY = (c->fb->getPixelBufferHeight() + kTileSize - 1) / kTileSize;
+	if (_tiles.size() != (uint)(tilesX * tilesY)) {
+		_tiles.clear();
+		_tiles.resize(tilesX * tilesY);
+	}
+	for (uint i = 0; i < _tiles.size(); i++) {
+		_tiles[i].rectangles.resize(0);
+		_tiles[i].drawCalls.resize(0);
+	}
+
+	// Split the dirty rectangles into tiles
+	_dirtyTiles.resize(0);
+	for (uint i = 0; i < rectangles.size(); i++) {
+		const Common::Rect &rect = rectangles[i];
+		if (rect.isEmpty())
+			continue;
+		for (int y = rect.top / kTileSize; y <= (rect.bottom - 1) / kTileSize; y++) {
+			for (int x = rect.left / kTileSize; x <= (rect.right - 1) / kTileSize; x++) {
+				Tile &tile = _tiles[y * tilesX + x];
+				if (tile.rectangles.empty())
+					_dirtyTiles.push_back(y * tilesX + x);
+				Common::Rect tileRect(x * kTileSize, y * kTileSize, (x + 1) * kTileSize, (y + 1) * kTileSize);
+				tile.rectangles.push_back(tileRect.findIntersectingRect(rect));
+			}
+		}
+	}
+
+	// Sort the draw calls into the dirty tiles, keeping their order
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		Common::Rect region = (*it)->getDirtyRegion();
+		region.clip(c->renderRect);
+		if (region.isEmpty())
+			continue;
+		for (int y = region.top / kTileSize; y <= (region.bottom - 1) / kTileSize; y++) {
+			for (int x = region.left / kTileSize; x <= (region.right - 1) / kTileSize; x++) {
+				Tile &tile = _tiles[y * tilesX + x];
+				if (!tile.rectangles.empty())
+					tile.drawCalls.push_back(*it);
+			}
+		}
+	}
+
+	// Every lane draws with its own copy of the render state, as executing a
+	// draw call changes it
+	const uint lanes = MIN<uint>(_lanes.size(), _dirtyTiles.size());
+	for (uint i = 0; i < lanes; i++) {
+		copyRenderState(_lanes[i].context, c);
+		_lanes[i].context->_tileVertices = &_lanes[i].vertices;
+	}
+
+	_nextTile = 0;
+	_pool.run(rasterizeTiles, this, lanes);
+}
+
+void TileRasterizer::rasterizeTiles(void *data, uint lane) {
+	TileRasterizer *rasterizer = (TileRasterizer *)data;
+	GLContext *c = rasterizer->_lanes[lane].context;
+
+	// The render state of the frame buffer changes as well
+	FrameBuffer fb(c->fb);
+	c->fb = &fb;
+	gl_set_thread_context(c);
+
+	uint index;
+	while ((index = rasterizer->_nextTile++) < rasterizer->_dirtyTiles.size()) {
+		const Tile &tile = rasterizer->_tiles[rasterizer->_dirtyTiles[index]];
+		for (uint i = 0; i < tile.drawCalls.size(); i++) {
+			const DrawCall *drawCall = tile.drawCalls[i];
+			const Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+			for (uint j = 0; j < tile.rectangles.size(); j++) {
+				if (tile.rectangles[j].intersects(drawCallRegion)) {
+					drawCall->execute(tile.rectangles[j], true);
+				}
+			}
+		}
+	}
+
+	gl_set_thread_context(nullptr);
+}
+
 void *Internal::allocateFrame(int size) {
 	GLContext *c = gl_get_context();
 	return c->_drawCallAllocator[c->_currentAllocatorIndex].allocate(size);
@@ -25,9 +25,13 @@
 #include "common/types.h"
 #include "common/rect.h"
 #include "common/array.h"
+#include "common/list.h"
+#include "common/thread.h"
 
 #include "graphics/tinygl/zblit.h"
 
+#include <atomic>
+
 namespace TinyGL {
 
 namespace Internal {
@@ -205,6 +209,49 @@ private:
 	BlittingState _blitState;
 };
 
+// Replays the draw calls of a frame on screen tiles in parallel. Every draw
+// call is sorted into the tiles its dirty region touches, and tiles outside
+// of the dirty rectangles are skipped. Each thread draws with its own context
+// holding a copy of the render state, which shares the frame buffer memory.
+class TileRasterizer {
+public:
+	TileRasterizer(uint numThreads);
+	~TileRasterizer();
+
+	/** The number of threads which draw tiles in addition to the caller. */
+	uint getNumThreads() const { return _pool.getNumWorkers(); }
+
+	/**
+	 * Execute the draw calls clipped to the given rectangles, which must not
+	 * overlap, like executing every draw call for each of the rectangles.
+	 */
+	void execute(GLContext *c, const Common::List<DrawCall *> &drawCalls, const Common::Array<Common::Rect> &rectangles);
+
+private:
+	enum {
+		kTileSize = 64
+	};
+
+	struct Tile {
+		Common::Array<Common::Rect> rectangles;
+		Common::Array<const DrawCall *> drawCalls;
+	};
+
+	struct Lane {
+		GLContext *context;
+		Common::Array<GLVertex> vertices;
+	};
+
+	static void copyRenderState(GLContext *lane, const GLContext *c);
+	static void rasterizeTiles(void *data, uint lane);
+
+	Common::WorkerPool _pool;
+	Common::Array<Tile> _tiles;
+	Common::Array<uint> _dirtyTiles;
+	std::atomic<uint> _nextTile;
+	Common::Array<Lane> _lanes;
+};
+
 } // end of namespace TinyGL
 
 #endif
@@ -434,6 +434,13 @@ struct GLContext {
 	LinearAllocator _drawCallAllocator[2];
 	bool _debugRectsEnabled;
 
+	// Parallel replay of the draw calls on screen tiles, if enabled
+	TileRasterizer *_tileRasterizer;
+	// Scratch vertices for the draw calls. Only set in the copies of the
+	// context which rasterize tiles, as other tiles may use the same draw
+	// call at the same time.
+	Common::Array<GLVertex> *_tileVertices;
+
 	void gl_vertex_transform(GLVertex *v);
 
 public:
@@ -513,6 +520,9 @@ public:
 
 extern GLContext *gl_ctx;
 GLContext *gl_get_context();
+// Make gl_get_context() return the given context on the calling thread
+// instead of gl_ctx, or stop doing so when passing nullptr.
+void gl_set_thread_context(GLContext *c);
 
 #define VERTEX_ARRAY    0x0001
 #define COLOR_ARRAY     0x0002
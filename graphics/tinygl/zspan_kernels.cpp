@@ -0,0 +1,59 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zspan_kernels.h"
+
+namespace TinyGL {
+
+static bool s_spanKernelsEnabled = true;
+
+bool getSpanKernels(SpanKernels &kernels, const Graphics::PixelFormat &format) {
+	kernels.depthLess = nullptr;
+	kernels.textureSpan = nullptr;
+
+	if (!s_spanKernelsEnabled || !g_system)
+		return false;
+	if (format.bytesPerPixel != 4 || format.aLoss || format.rLoss || format.gLoss || format.bLoss)
+		return false;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		kernels.depthLess = spanDepthLessSSE2;
+		kernels.textureSpan = textureSpanSSE2;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		kernels.depthLess = spanDepthLessNEON;
+		kernels.textureSpan = textureSpanNEON;
+	}
+#endif
+
+	return kernels.textureSpan != nullptr;
+}
+
+void setSpanKernelsEnabled(bool enabled) {
+	s_spanKernelsEnabled = enabled;
+}
+
+} // end of namespace TinyGL
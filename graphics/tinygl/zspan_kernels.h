@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_KERNELS_H
+#define GRAPHICS_TINYGL_ZSPAN_KERNELS_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+namespace TinyGL {
+
+/**
+ * SIMD kernels drawing the textured triangle spans of FrameBuffer a block
+ * of kSpanPixels pixels at a time.
+ *
+ * They cover the common render states: texture modulated by the vertex
+ * color, depth test TGL_LESS or disabled, any alpha test, and no blending
+ * or blending with TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA. The result is
+ * exactly the same as that of the per-pixel code in ztriangle.cpp, which
+ * still draws everything else.
+ */
+enum {
+	kSpanPixels = 8
+};
+
+/** Render state which stays the same for a whole triangle. */
+struct TextureSpanState {
+	int alphaFunc;   ///< Alpha test function, TGL_ALWAYS if the test is disabled
+	int alphaRef;    ///< Alpha test reference value
+	bool blending;   ///< Blend with TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA
+	bool depthWrite; ///< Write the depth of drawn pixels
+	byte aShift, rShift, gShift, bShift; ///< Channel positions in the frame buffer pixels
+};
+
+/** A block of kSpanPixels pixels of a textured span. */
+struct TextureSpan {
+	uint32 *pixels;
+	uint *depth;
+	uint mask;           ///< Bit i is set if pixel i passed the depth test
+	uint z;
+	int dzdx;
+	uint r, g, b, a;     ///< Vertex color, as interpolated by fillTriangle()
+	int drdx, dgdx, dbdx;
+	uint dadx;
+	uint16 texA[kSpanPixels], texR[kSpanPixels], texG[kSpanPixels], texB[kSpanPixels]; ///< Texels of the pixels in mask
+};
+
+/**
+ * Return a mask with bit i set if depth[i] is lower than z + i * dzdx,
+ * which is what TGL_LESS means in TinyGL.
+ */
+typedef uint (*SpanDepthTestFunc)(const uint *depth, uint z, int dzdx);
+
+/** Modulate, alpha test, blend and write the pixels of a span. */
+typedef void (*TextureSpanFunc)(const TextureSpan &span, const TextureSpanState &state);
+
+struct SpanKernels {
+	SpanDepthTestFunc depthLess;
+	TextureSpanFunc textureSpan;
+};
+
+#ifdef SCUMMVM_SSE2
+uint spanDepthLessSSE2(const uint *depth, uint z, int dzdx);
+void textureSpanSSE2(const TextureSpan &span, const TextureSpanState &state);
+#endif
+
+#ifdef SCUMMVM_NEON
+uint spanDepthLessNEON(const uint *depth, uint z, int dzdx);
+void textureSpanNEON(const TextureSpan &span, const TextureSpanState &state);
+#endif
+
+/**
+ * Select the kernels supported by the CPU we are running on.
+ *
+ * @return false if there are none, if they have been disabled with
+ *         setSpanKernelsEnabled() or if they can not draw to @p format,
+ *         which needs 8 bits for each of its four channels.
+ */
+bool getSpanKernels(SpanKernels &kernels, const Graphics::PixelFormat &format);
+
+/**
+ * Enable or disable the kernels for frame buffers created afterwards.
+ * They are enabled by default; disabling them is useful to compare
+ * against the per-pixel code.
+ */
+void setSpanKernelsEnabled(bool enabled);
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/zspan_kernels.h"
+#include "graphics/tinygl/gl.h"
+
+#include <arm_neon.h>
+
+namespace TinyGL {
+
+namespace {
+
+// The values start + i * delta of the eight pixels, wrapping around like
+// the unsigned arithmetic of fillTriangle() does
+inline void interpolate(uint start, uint delta, uint32x4_t &lo, uint32x4_t &hi) {
+	static const uint32 steps[4] = { 0, 1, 2, 3 };
+	lo = vmlaq_n_u32(vdupq_n_u32(start), vld1q_u32(steps), delta);
+	hi = vaddq_u32(lo, vdupq_n_u32(4 * delta));
+}
+
+// The color of the eight pixels as used for modulation. Only the low 16
+// bits of the 8 bit shifted values affect the result.
+inline uint16x8_t colorLanes(uint start, uint delta) {
+	uint32x4_t lo, hi;
+	interpolate(start, delta, lo, hi);
+	return vcombine_u16(vmovn_u32(vshrq_n_u32(lo, 8)), vmovn_u32(vshrq_n_u32(hi, 8)));
+}
+
+inline uint16x8_t multiply(uint16x8_t a, uint16x8_t b) {
+	return vshrq_n_u16(vmulq_u16(a, b), 8);
+}
+
+inline uint16x8_t alphaTest(uint16x8_t a, const TextureSpanState &state) {
+	const uint16x8_t ref = vdupq_n_u16(state.alphaRef);
+
+	switch (state.alphaFunc) {
+	case TGL_ALWAYS:
+		return vdupq_n_u16(0xFFFF);
+	case TGL_LESS:
+		return vcltq_u16(a, ref);
+	case TGL_EQUAL:
+		return vceqq_u16(a, ref);
+	case TGL_LEQUAL:
+		return vcleq_u16(a, ref);
+	case TGL_GREATER:
+		return vcgtq_u16(a, ref);
+	case TGL_NOTEQUAL:
+		return vmvnq_u16(vceqq_u16(a, ref));
+	case TGL_GEQUAL:
+		return vcgeq_u16(a, ref);
+	default:
+		return vdupq_n_u16(0);
+	}
+}
+
+inline uint16x8_t channel(uint32x4_t lo, uint32x4_t hi, int shift) {
+	const int32x4_t count = vdupq_n_s32(-shift);
+	const uint32x4_t mask = vdupq_n_u32(0xFF);
+	lo = vandq_u32(vshlq_u32(lo, count), mask);
+	hi = vandq_u32(vshlq_u32(hi, count), mask);
+	return vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+}
+
+inline uint32x4_t place(uint16x4_t channel, int shift) {
+	return vshlq_u32(vmovl_u16(channel), vdupq_n_s32(shift));
+}
+
+} // End of anonymous namespace
+
+uint spanDepthLessNEON(const uint *depth, uint z, int dzdx) {
+	static const uint16 bits[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint32x4_t zLo, zHi;
+	interpolate(z, dzdx, zLo, zHi);
+
+	const uint32x4_t lo = vcltq_u32(vld1q_u32((const uint32 *)depth), zLo);
+	const uint32x4_t hi = vcltq_u32(vld1q_u32((const uint32 *)depth + 4), zHi);
+	const uint16x8_t mask = vandq_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)), vld1q_u16(bits));
+	const uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(mask));
+	return (uint)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+}
+
+void textureSpanNEON(const TextureSpan &span, const TextureSpanState &state) {
+	static const uint16 bits[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint16x8_t write = vtstq_u16(vdupq_n_u16(span.mask), vld1q_u16(bits));
+
+	const uint16x8_t a = multiply(vld1q_u16(span.texA), colorLanes(span.a, span.dadx));
+	write = vandq_u16(write, alphaTest(a, state));
+	if (vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(write)), 0) == 0)
+		return;
+
+	uint16x8_t r = multiply(vld1q_u16(span.texR), colorLanes(span.r, span.drdx));
+	uint16x8_t g = multiply(vld1q_u16(span.texG), colorLanes(span.g, span.dgdx));
+	uint16x8_t b = multiply(vld1q_u16(span.texB), colorLanes(span.b, span.dbdx));
+
+	const uint32x4_t dstLo = vld1q_u32(span.pixels);
+	const uint32x4_t dstHi = vld1q_u32(span.pixels + 4);
+
+	uint16x8_t outA = a;
+	if (state.blending) {
+		const uint16x8_t max = vdupq_n_u16(255);
+		const uint16x8_t invA = vsubq_u16(max, a);
+		r = vminq_u16(vaddq_u16(multiply(r, a), multiply(channel(dstLo, dstHi, state.rShift), invA)), max);
+		g = vminq_u16(vaddq_u16(multiply(g, a), multiply(channel(dstLo, dstHi, state.gShift), invA)), max);
+		b = vminq_u16(vaddq_u16(multiply(b, a), multiply(channel(dstLo, dstHi, state.bShift), invA)), max);
+		outA = max;
+	}
+
+	uint32x4_t outLo = place(vget_low_u16(outA), state.aShift);
+	outLo = vorrq_u32(outLo, place(vget_low_u16(r), state.rShift));
+	outLo = vorrq_u32(outLo, place(vget_low_u16(g), state.gShift));
+	outLo = vorrq_u32(outLo, place(vget_low_u16(b), state.bShift));
+	uint32x4_t outHi = place(vget_high_u16(outA), state.aShift);
+	outHi = vorrq_u32(outHi, place(vget_high_u16(r), state.rShift));
+	outHi = vorrq_u32(outHi, place(vget_high_u16(g), state.gShift));
+	outHi = vorrq_u32(outHi, place(vget_high_u16(b), state.bShift));
+
+	// Widen the 16 bit lanes of the mask, keeping all bits set
+	const uint32x4_t writeLo = vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_low_u16(write))));
+	const uint32x4_t writeHi = vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_high_u16(write))));
+	vst1q_u32(span.pixels, vbslq_u32(writeLo, outLo, dstLo));
+	vst1q_u32(span.pixels + 4, vbslq_u32(writeHi, outHi, dstHi));
+
+	if (state.depthWrite) {
+		uint32 *depth = (uint32 *)span.depth;
+		uint32x4_t zLo, zHi;
+		interpolate(span.z, span.dzdx, zLo, zHi);
+		vst1q_u32(depth, vbslq_u32(writeLo, zLo, vld1q_u32(depth)));
+		vst1q_u32(depth + 4, vbslq_u32(writeHi, zHi, vld1q_u32(depth + 4)));
+	}
+}
+
+} // end of namespace TinyGL
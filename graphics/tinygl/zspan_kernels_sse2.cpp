@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/zspan_kernels.h"
+#include "graphics/tinygl/gl.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+namespace {
+
+// The values start + i * delta of the eight pixels, wrapping around like
+// the unsigned arithmetic of fillTriangle() does
+inline void interpolate(uint start, uint delta, __m128i &lo, __m128i &hi) {
+	lo = _mm_set_epi32(start + 3 * delta, start + 2 * delta, start + delta, start);
+	hi = _mm_add_epi32(lo, _mm_set1_epi32(4 * delta));
+}
+
+// The color of the eight pixels as used for modulation. Only the low 16
+// bits of the 8 bit shifted values affect the result, so they are
+// truncated instead of saturated.
+inline __m128i colorLanes(uint start, uint delta) {
+	__m128i lo, hi;
+	interpolate(start, delta, lo, hi);
+	lo = _mm_srai_epi32(_mm_slli_epi32(_mm_srli_epi32(lo, 8), 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(_mm_srli_epi32(hi, 8), 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+inline __m128i multiply(__m128i a, __m128i b) {
+	return _mm_srli_epi16(_mm_mullo_epi16(a, b), 8);
+}
+
+inline __m128i alphaTest(__m128i a, const TextureSpanState &state) {
+	const __m128i ref = _mm_set1_epi16(state.alphaRef);
+	const __m128i all = _mm_set1_epi16(-1);
+
+	switch (state.alphaFunc) {
+	case TGL_ALWAYS:
+		return all;
+	case TGL_LESS:
+		return _mm_cmplt_epi16(a, ref);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi16(a, ref);
+	case TGL_LEQUAL:
+		return _mm_andnot_si128(_mm_cmpgt_epi16(a, ref), all);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi16(a, ref);
+	case TGL_NOTEQUAL:
+		return _mm_andnot_si128(_mm_cmpeq_epi16(a, ref), all);
+	case TGL_GEQUAL:
+		return _mm_andnot_si128(_mm_cmplt_epi16(a, ref), all);
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+inline __m128i channel(__m128i lo, __m128i hi, int shift) {
+	const __m128i count = _mm_cvtsi32_si128(shift);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	lo = _mm_and_si128(_mm_srl_epi32(lo, count), mask);
+	hi = _mm_and_si128(_mm_srl_epi32(hi, count), mask);
+	return _mm_packs_epi32(lo, hi);
+}
+
+inline __m128i place(__m128i channel32, int shift) {
+	return _mm_sll_epi32(channel32, _mm_cvtsi32_si128(shift));
+}
+
+inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline __m128i load(const uint16 *p) {
+	return _mm_loadu_si128((const __m128i *)p);
+}
+
+} // End of anonymous namespace
+
+uint spanDepthLessSSE2(const uint *depth, uint z, int dzdx) {
+	const __m128i sign = _mm_set1_epi32((int)0x80000000);
+	__m128i zLo, zHi;
+	interpolate(z, dzdx, zLo, zHi);
+
+	// SSE2 only compares signed values
+	const __m128i lo = _mm_cmpgt_epi32(_mm_xor_si128(zLo, sign), _mm_xor_si128(_mm_loadu_si128((const __m128i *)depth), sign));
+	const __m128i hi = _mm_cmpgt_epi32(_mm_xor_si128(zHi, sign), _mm_xor_si128(_mm_loadu_si128((const __m128i *)(depth + 4)), sign));
+	return _mm_movemask_ps(_mm_castsi128_ps(lo)) | (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+}
+
+void textureSpanSSE2(const TextureSpan &span, const TextureSpanState &state) {
+	const __m128i bits = _mm_set_epi16(128, 64, 32, 16, 8, 4, 2, 1);
+	__m128i write = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(span.mask), bits), bits);
+
+	const __m128i a = multiply(load(span.texA), colorLanes(span.a, span.dadx));
+	write = _mm_and_si128(write, alphaTest(a, state));
+	if (_mm_movemask_epi8(write) == 0)
+		return;
+
+	__m128i r = multiply(load(span.texR), colorLanes(span.r, span.drdx));
+	__m128i g = multiply(load(span.texG), colorLanes(span.g, span.dgdx));
+	__m128i b = multiply(load(span.texB), colorLanes(span.b, span.dbdx));
+
+	__m128i *pixels = (__m128i *)span.pixels;
+	const __m128i dstLo = _mm_loadu_si128(pixels);
+	const __m128i dstHi = _mm_loadu_si128(pixels + 1);
+
+	__m128i outA = a;
+	if (state.blending) {
+		const __m128i max = _mm_set1_epi16(255);
+		const __m128i invA = _mm_sub_epi16(max, a);
+		r = _mm_min_epi16(_mm_add_epi16(multiply(r, a), multiply(channel(dstLo, dstHi, state.rShift), invA)), max);
+		g = _mm_min_epi16(_mm_add_epi16(multiply(g, a), multiply(channel(dstLo, dstHi, state.gShift), invA)), max);
+		b = _mm_min_epi16(_mm_add_epi16(multiply(b, a), multiply(channel(dstLo, dstHi, state.bShift), invA)), max);
+		outA = max;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	__m128i outLo = place(_mm_unpacklo_epi16(outA, zero), state.aShift);
+	outLo = _mm_or_si128(outLo, place(_mm_unpacklo_epi16(r, zero), state.rShift));
+	outLo = _mm_or_si128(outLo, place(_mm_unpacklo_epi16(g, zero), state.gShift));
+	outLo = _mm_or_si128(outLo, place(_mm_unpacklo_epi16(b, zero), state.bShift));
+	__m128i outHi = place(_mm_unpackhi_epi16(outA, zero), state.aShift);
+	outHi = _mm_or_si128(outHi, place(_mm_unpackhi_epi16(r, zero), state.rShift));
+	outHi = _mm_or_si128(outHi, place(_mm_unpackhi_epi16(g, zero), state.gShift));
+	outHi = _mm_or_si128(outHi, place(_mm_unpackhi_epi16(b, zero), state.bShift));
+
+	const __m128i writeLo = _mm_unpacklo_epi16(write, write);
+	const __m128i writeHi = _mm_unpackhi_epi16(write, write);
+	_mm_storeu_si128(pixels, select(writeLo, outLo, dstLo));
+	_mm_storeu_si128(pixels + 1, select(writeHi, outHi, dstHi));
+
+	if (state.depthWrite) {
+		__m128i *depth = (__m128i *)span.depth;
+		__m128i zLo, zHi;
+		interpolate(span.z, span.dzdx, zLo, zHi);
+		_mm_storeu_si128(depth, select(writeLo, zLo, _mm_loadu_si128(depth)));
+		_mm_storeu_si128(depth + 1, select(writeHi, zHi, _mm_loadu_si128(depth + 1)));
+	}
+}
+
+} // end of namespace TinyGL
@@ -34,11 +34,22 @@ namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
+STATIC_ASSERT(NB_INTERP == kSpanPixels, span_kernels_must_draw_the_blocks_of_fillTriangle);
+
 template <bool kDepthWrite, bool kSmoothMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 FORCEINLINE void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
 	                                        int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
 	                                        int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		// Clipped pixels still step the interpolation, so that clipping
+		// does not change the pixels next to them
+		z += dzdx;
+		if (kSmoothMode) {
+			r += drdx;
+			g += dgdx;
+			b += dbdx;
+			a += dadx;
+		}
 		return;
 	}
 	if (kStencilEnabled) {
@@ -71,11 +82,20 @@ FORCEINLINE void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps
 
 template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 FORCEINLINE void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
-	                                      uint wrap_s, uint wrap_t, uint *pz, byte *ps, int _a,
+	                                      uint wrap_s, uint wrap_t, uint level, uint *pz, byte *ps, int _a,
 	                                      int x, int y, uint &z, int &t, int &s,
 	                                      uint &r, uint &g, uint &b, uint &a,
 	                                      int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		z += dzdx;
+		s += dsdx;
+		t += dtdx;
+		if (kSmoothMode) {
+			a += dadx;
+			r += drdx;
+			g += dgdx;
+			b += dbdx;
+		}
 		return;
 	}
 	if (kStencilEnabled) {
@@ -96,7 +116,7 @@ FORCEINLINE void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *t
 	}
 	if (depthTestResult) {
 		uint8 c_a, c_r, c_g, c_b;
-		texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
+		texture->getARGBAt(wrap_s, wrap_t, s, t, level, c_a, c_r, c_g, c_b);
 		if (kLightsMode) {
 			uint l_a = (a >> (ZB_POINT_ALPHA_BITS - 8));
 			uint l_r = (r >> (ZB_POINT_RED_BITS - 8));
@@ -120,9 +140,52 @@ FORCEINLINE void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *t
 	}
 }
 
+template <bool kSmoothMode, bool kDepthTestEnabled>
+FORCEINLINE void FrameBuffer::putTextureSpan(int fbOffset, const TexelBuffer *texture, uint level, const TextureSpanState &state,
+	                                     uint *pz, uint &z, int t, int s, uint &r, uint &g, uint &b, uint &a,
+	                                     int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, uint dadx) {
+	TextureSpan span;
+	span.mask = kDepthTestEnabled ? _spanKernels.depthLess(pz, z, dzdx) : (1 << kSpanPixels) - 1;
+	if (span.mask) {
+		// Only the texels of visible pixels are fetched
+		for (int i = 0; i < kSpanPixels; i++) {
+			uint8 c_a = 0, c_r = 0, c_g = 0, c_b = 0;
+			if (span.mask & (1 << i))
+				texture->getARGBAt(_wrapS, _wrapT, s, t, level, c_a, c_r, c_g, c_b);
+			span.texA[i] = c_a;
+			span.texR[i] = c_r;
+			span.texG[i] = c_g;
+			span.texB[i] = c_b;
+			s += dsdx;
+			t += dtdx;
+		}
+		span.pixels = (uint32 *)_pbuf.getRawBuffer(fbOffset);
+		span.depth = pz;
+		span.z = z;
+		span.dzdx = dzdx;
+		span.r = r;
+		span.g = g;
+		span.b = b;
+		span.a = a;
+		span.drdx = kSmoothMode ? drdx : 0;
+		span.dgdx = kSmoothMode ? dgdx : 0;
+		span.dbdx = kSmoothMode ? dbdx : 0;
+		span.dadx = kSmoothMode ? dadx : 0;
+		_spanKernels.textureSpan(span, state);
+	}
+	z += (uint)kSpanPixels * (uint)dzdx;
+	if (kSmoothMode) {
+		a += (uint)kSpanPixels * dadx;
+		r += (uint)kSpanPixels * (uint)drdx;
+		g += (uint)kSpanPixels * (uint)dgdx;
+		b += (uint)kSpanPixels * (uint)dbdx;
+	}
+}
+
 template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 FORCEINLINE void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		z += dzdx;
 		return;
 	}
 	if (kStencilEnabled) {
@@ -152,7 +215,7 @@ template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int k
           bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
 	const TexelBuffer *texture;
-	float fdzdx = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
+	float fdzdx = 0, fdzdy = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
 
 	ZBufferPoint *tp, *pr1 = 0, *pr2 = 0, *l1 = 0, *l2 = 0;
 	float fdx1, fdx2, fdy1, fdy2, fz0, d1, d2;
@@ -297,11 +360,29 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 	if (kInterpRGB && (kInterpST || kInterpSTZ)) {
 		texture = _currentTexture;
 		fdzdx = (float)dzdx;
+		fdzdy = (float)dzdy;
 		fndzdx = NB_INTERP * fdzdx;
 		ndszdx = NB_INTERP * dszdx;
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// Whole blocks of textured spans are drawn by the SIMD kernels if they
+	// support the render state
+	TextureSpanState spanState;
+	bool spanKernels = false;
+	if (kInterpRGB && kInterpZ && (kInterpST || kInterpSTZ) && !kStencilEnabled && _hasSpanKernels) {
+		spanKernels = (!kDepthTestEnabled || _depthFunc == TGL_LESS) &&
+		              (!kBlendingEnabled || (_sourceBlendingFactor == TGL_SRC_ALPHA && _destinationBlendingFactor == TGL_ONE_MINUS_SRC_ALPHA));
+		spanState.alphaFunc = kAlphaTestEnabled ? _alphaTestFunc : TGL_ALWAYS;
+		spanState.alphaRef = _alphaTestRefVal;
+		spanState.blending = kBlendingEnabled;
+		spanState.depthWrite = kDepthWrite;
+		spanState.aShift = _pbufFormat.aShift;
+		spanState.rShift = _pbufFormat.rShift;
+		spanState.gShift = _pbufFormat.gShift;
+		spanState.bShift = _pbufFormat.bShift;
+	}
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -392,10 +473,46 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 			x2 = pr1->x << 16;
 		}
 
+		// Lines above the scissor rectangle are stepped over at once. This
+		// is only exact for integer values, so not for texture coordinates.
+		if (kEnableScissor && !(kInterpST || kInterpSTZ) && y < _clipRectangle.top && nb_lines > 0) {
+			const int lines = MIN(nb_lines, _clipRectangle.top - y);
+			const int64 errorSum = error + (int64)lines * derror;
+			const uint maxSteps = errorSum > 0 ? (uint)((errorSum + 0xffff) >> 16) : 0;
+			const uint minSteps = lines - maxSteps;
+			error = (int)(errorSum - ((int64)maxSteps << 16));
+			x1 += maxSteps * dxdy_max + minSteps * dxdy_min;
+			if (kInterpZ) {
+				z1 += maxSteps * dzdl_max + minSteps * dzdl_min;
+			}
+			if (kInterpRGB && kSmoothMode) {
+				r1 += maxSteps * drdl_max + minSteps * drdl_min;
+				g1 += maxSteps * dgdl_max + minSteps * dgdl_min;
+				b1 += maxSteps * dbdl_max + minSteps * dbdl_min;
+				a1 += maxSteps * dadl_max + minSteps * dadl_min;
+			}
+			x2 += (uint)lines * dx2dy2;
+			if (kInterpRGB) {
+				pp1 += lines * _pbufWidth;
+			}
+			if (kInterpZ) {
+				pz1 += lines * _pbufWidth;
+			}
+			if (kStencilEnabled) {
+				ps1 += lines * _pbufWidth;
+			}
+			nb_lines -= lines;
+			y += lines;
+		}
+
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && y >= _clipRectangle.bottom) {
+				return;
+			} else if (kEnableScissor && y < _clipRectangle.top) {
+				// The whole line is clipped
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -408,6 +525,19 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (kEnableScissor) {
+					n = MIN(n, _clipRectangle.right - 1 - x);
+					const int skip = CLIP(_clipRectangle.left - x, 0, MAX(n + 1, 0));
+					if (kInterpZ) {
+						pz += skip;
+					}
+					if (kStencilEnabled) {
+						ps += skip;
+					}
+					z += (uint)skip * (uint)dzdx;
+					n -= skip;
+					x += skip;
+				}
 				while (n >= 3) {
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx);
@@ -451,6 +581,26 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (kEnableScissor) {
+					n = MIN(n, _clipRectangle.right - 1 - x);
+					const int skip = CLIP(_clipRectangle.left - x, 0, MAX(n + 1, 0));
+					pp += skip;
+					if (kInterpZ) {
+						pz += skip;
+					}
+					if (kStencilEnabled) {
+						ps += skip;
+					}
+					z += (uint)skip * (uint)dzdx;
+					if (kSmoothMode) {
+						r += (uint)skip * (uint)drdx;
+						g += (uint)skip * (uint)dgdx;
+						b += (uint)skip * (uint)dbdx;
+						a += (uint)skip * (uint)dadx;
+					}
+					n -= skip;
+					x += skip;
+				}
 				while (n >= 3) {
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -486,6 +636,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				int n, pp;
 				float sz, tz, fz, zinv;
 				int dsdx, dtdx;
+				// The mipmap level is selected once for every NB_INTERP pixels
+				uint level = 0;
+				const bool mipmaps = texture->getLevelCount() > 1;
 
 				n = (x2 >> 16) - x1;
 				fz = (float)z1;
@@ -505,6 +658,33 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				g = g1;
 				b = b1;
 				a = a1;
+				if (kEnableScissor) {
+					// The texture coordinates are corrected at fixed steps from
+					// the start of the line, so only whole steps are skipped
+					n = MIN(n, _clipRectangle.right - 1 - x);
+					while (n >= (NB_INTERP - 1) && x + NB_INTERP <= _clipRectangle.left) {
+						fz += fndzdx;
+						zinv = (float)(1.0 / fz);
+						pp += NB_INTERP;
+						if (kInterpZ) {
+							pz += NB_INTERP;
+						}
+						if (kStencilEnabled) {
+							ps += NB_INTERP;
+						}
+						z += (uint)NB_INTERP * (uint)dzdx;
+						if (kSmoothMode) {
+							r += (uint)NB_INTERP * (uint)drdx;
+							g += (uint)NB_INTERP * (uint)dgdx;
+							b += (uint)NB_INTERP * (uint)dbdx;
+							a += (uint)NB_INTERP * (uint)dadx;
+						}
+						sz += ndszdx;
+						tz += ndtzdx;
+						n -= NB_INTERP;
+						x += NB_INTERP;
+					}
+				}
 				while (n >= (NB_INTERP - 1)) {
 					{
 						float ss, tt;
@@ -514,12 +694,20 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						t = (int)tt;
 						dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 						dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+						if (mipmaps) {
+							level = texture->getLevel(dsdx, dtdx, (int)((dszdy - ss * fdzdy) * zinv), (int)((dtzdy - tt * fdzdy) * zinv));
+						}
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					if (spanKernels && (!kEnableScissor || x >= _clipRectangle.left)) {
+						putTextureSpan<kSmoothMode, kDepthTestEnabled>
+						              (pp, texture, level, spanState, pz, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, level, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -542,11 +730,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					t = (int)tt;
 					dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+					if (mipmaps) {
+						level = texture->getLevel(dsdx, dtdx, (int)((dszdy - ss * fdzdy) * zinv), (int)((dtzdy - tt * fdzdy) * zinv));
+					}
 				}
 
 				while (n >= 0) {
 					putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					               (pp, texture, _wrapS, _wrapT, level, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
 					pp += 1;
 					if (kInterpZ) {
 						pz += 1;
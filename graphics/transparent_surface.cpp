@@ -27,6 +27,7 @@
 #include "common/rect.h"
 #include "common/math.h"
 #include "common/textconsole.h"
+#include "graphics/blit_kernels.h"
 #include "graphics/conversion.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
@@ -59,9 +60,9 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
-TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
+TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL), _premultiplied(false) {}
 
-TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
+TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL), _premultiplied(false) {
 	if (copyData) {
 		copyFrom(surf);
 	} else {
@@ -87,7 +88,15 @@ void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	for (uint32 i = 0; i < height; i++) {
 		out = outo;
 		in = ino;
-		memcpy(out, in, width * 4);
+		if (inStep == 4) {
+			memcpy(out, in, width * 4);
+		} else {
+			// Horizontally flipped
+			for (uint32 j = 0; j < width; j++) {
+				*(uint32 *)(out + j * 4) = *(const uint32 *)in;
+				in += inStep;
+			}
+		}
 		for (uint32 j = 0; j < width; j++) {
 			out[kAIndex] = 0xFF;
 			out += 4;
@@ -391,6 +400,124 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 
 }
 
+/**
+ * Number of pixels of the row buffers on the stack. Wider rows are processed
+ * in several parts.
+ */
+static const uint32 kRowBufferSize = 256;
+
+/**
+ * Draw the pixels a row at a time with a sprite blit kernel. Rows of
+ * horizontally flipped images are reversed into a buffer first.
+ */
+static void doBlitKernel(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, SpriteBlitFunc func) {
+	if (inStep > 0) {
+		for (uint32 i = 0; i < height; i++) {
+			func((uint32 *)outo, (const uint32 *)ino, width, color);
+			outo += pitch;
+			ino += inoStep;
+		}
+		return;
+	}
+
+	uint32 row[kRowBufferSize];
+	for (uint32 i = 0; i < height; i++) {
+		const uint32 *in = (const uint32 *)ino;
+		uint32 *out = (uint32 *)outo;
+		for (uint32 x = 0; x < width; x += kRowBufferSize) {
+			const uint32 count = MIN(width - x, kRowBufferSize);
+			for (uint32 j = 0; j < count; j++)
+				row[j] = in[-(int32)(x + j)];
+			func(out + x, row, count, color);
+		}
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+/**
+ * Blend premultiplied pixels with one of the generic blend modes, which
+ * expect straight alpha.
+ */
+static void doBlitUnpremultiplied(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, TSpriteBlendMode blendMode) {
+	uint32 row[kRowBufferSize];
+
+	for (uint32 i = 0; i < height; i++) {
+		const uint32 *in = (const uint32 *)ino;
+		for (uint32 x = 0; x < width; x += kRowBufferSize) {
+			const uint32 count = MIN(width - x, kRowBufferSize);
+			if (inStep < 0) {
+				for (uint32 j = 0; j < count; j++)
+					row[j] = in[-(int32)(x + j)];
+				unpremultiplyAlpha(row, row, count);
+			} else {
+				unpremultiplyAlpha(row, in + x, count);
+			}
+
+			byte *rowData = (byte *)row;
+			byte *out = outo + x * 4;
+			if (blendMode == BLEND_ADDITIVE) {
+				doBlitAdditiveBlend(rowData, out, count, 1, pitch, 4, 0, color);
+			} else if (blendMode == BLEND_SUBTRACTIVE) {
+				doBlitSubtractiveBlend(rowData, out, count, 1, pitch, 4, 0, color);
+			} else {
+				assert(blendMode == BLEND_MULTIPLY);
+				doBlitMultiplyBlend(rowData, out, count, 1, pitch, 4, 0, color);
+			}
+		}
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void doBlit(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color,
+		TSpriteBlendMode blendMode, AlphaType alphaMode, bool premultiplied) {
+	BlitKernels kernels;
+	const bool useKernels = getBlitKernels(kernels);
+
+	if (premultiplied) {
+		// There is no generic code for premultiplied pixels, so the plain
+		// C++ kernel is used when the others are disabled.
+		if (blendMode == BLEND_NORMAL)
+			doBlitKernel(ino, outo, width, height, pitch, inStep, inoStep, color, kernels.spritePremultiplied);
+		else
+			doBlitUnpremultiplied(ino, outo, width, height, pitch, inStep, inoStep, color, blendMode);
+		return;
+	}
+
+	if (useKernels && blendMode == BLEND_NORMAL) {
+		SpriteBlitFunc func;
+		if (color == 0xFFFFFFFF && alphaMode == ALPHA_OPAQUE)
+			func = kernels.spriteOpaque;
+		else if (color == 0xFFFFFFFF && alphaMode == ALPHA_BINARY)
+			func = kernels.spriteBinary;
+		else if (color == 0xFFFFFFFF)
+			func = kernels.spriteAlpha;
+		else
+			func = kernels.spriteTinted;
+
+		doBlitKernel(ino, outo, width, height, pitch, inStep, inoStep, color, func);
+		return;
+	}
+
+	if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_OPAQUE) {
+		doBlitOpaqueFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_BINARY) {
+		doBlitBinaryFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else {
+		if (blendMode == BLEND_ADDITIVE) {
+			doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_SUBTRACTIVE) {
+			doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_MULTIPLY) {
+			doBlitMultiplyBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else {
+			assert(blendMode == BLEND_NORMAL);
+			doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		}
+	}
+}
+
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
 
 	Common::Rect retSize;
@@ -508,22 +635,7 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode, _premultiplied);
 
 	}
 
@@ -655,22 +767,7 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode, _premultiplied);
 
 	}
 
@@ -738,11 +835,50 @@ void TransparentSurface::setAlphaMode(AlphaType mode) {
 	_alphaMode = mode;
 }
 
+AlphaType TransparentSurface::detectAlphaType(const Graphics::Surface &surf) {
+	if (surf.format.bytesPerPixel != 4) {
+		warning("TransparentSurface::detectAlphaType: non 32 bpp surface passed as argument");
+		return ALPHA_OPAQUE;
+	}
+
+	if (surf.format.aBits() == 0)
+		return ALPHA_OPAQUE;
+
+	const uint32 aMask = surf.format.aMax() << surf.format.aShift;
+	bool seenAlpha = false;
+	for (int y = 0; y < surf.h; y++) {
+		const uint32 *row = (const uint32 *)surf.getBasePtr(0, y);
+		for (int x = 0; x < surf.w; x++) {
+			const uint32 a = row[x] & aMask;
+			if (a != aMask) {
+				if (a != 0)
+					return ALPHA_FULL;
+				seenAlpha = true;
+			}
+		}
+	}
+
+	return seenAlpha ? ALPHA_BINARY : ALPHA_OPAQUE;
+}
+
+void TransparentSurface::premultiplyAlpha() {
+	assert(format.bytesPerPixel == 4);
+	if (_premultiplied)
+		return;
+
+	for (int y = 0; y < h; y++) {
+		uint32 *row = (uint32 *)getBasePtr(0, y);
+		Graphics::premultiplyAlpha(row, row, w);
+	}
+	_premultiplied = true;
+}
+
 TransparentSurface *TransparentSurface::scale(int16 newWidth, int16 newHeight, bool filtering) const {
 
 	TransparentSurface *target = new TransparentSurface();
 
 	target->create(newWidth, newHeight, format);
+	target->_premultiplied = _premultiplied;
 
 	if (filtering) {
 		scaleBlitBilinear((byte *)target->getPixels(), (const byte *)getPixels(), target->pitch, pitch, target->w, target->h, w, h, format);
@@ -761,6 +897,7 @@ TransparentSurface *TransparentSurface::rotoscale(const TransformStruct &transfo
 	TransparentSurface *target = new TransparentSurface();
 
 	target->create((uint16)rect.right - rect.left, (uint16)rect.bottom - rect.top, this->format);
+	target->_premultiplied = _premultiplied;
 
 	if (filtering) {
 		rotoscaleBlitBilinear((byte *)target->getPixels(), (const byte *)getPixels(), target->pitch, pitch, target->w, target->h, w, h, format, transform, newHotspot);
@@ -779,6 +916,7 @@ TransparentSurface *TransparentSurface::convertTo(const PixelFormat &dstFormat,
 	// If the target format is the same, just copy
 	if (format == dstFormat) {
 		surface->copyFrom(*this);
+		surface->_premultiplied = _premultiplied;
 		return surface;
 	}
 
@@ -166,8 +166,35 @@ struct TransparentSurface : public Graphics::Surface {
 
 	AlphaType getAlphaMode() const;
 	void setAlphaMode(AlphaType);
+
+	/**
+	 * Find the cheapest alpha mode which still draws @p surf correctly.
+	 *
+	 * This scans every pixel, so engines should do it once when the pixel
+	 * data is loaded and keep the result with the surface rather than
+	 * redoing it before each blit.
+	 */
+	static AlphaType detectAlphaType(const Graphics::Surface &surf);
+
+	/**
+	 * Convert the pixels to premultiplied alpha and mark the surface as
+	 * such. blit() and blitClip() blend premultiplied pixels with fewer
+	 * operations per pixel.
+	 *
+	 * The other operations of TransparentSurface expect straight alpha, so
+	 * only do this once the pixel data is final.
+	 */
+	void premultiplyAlpha();
+
+	/**
+	 * Whether the pixels hold premultiplied alpha. Use setPremultiplied()
+	 * when wrapping pixel data which has already been converted.
+	 */
+	bool isPremultiplied() const { return _premultiplied; }
+	void setPremultiplied(bool premultiplied) { _premultiplied = premultiplied; }
 private:
 	AlphaType _alphaMode;
+	bool _premultiplied;
 };
 
 /**
@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+namespace Graphics {
+
+static bool s_yuvToRGBKernelsEnabled = true;
+
+bool getYUVToRGBKernels(YUVToRGBKernels &kernels, const PixelFormat &format) {
+	kernels.row444 = nullptr;
+	kernels.row420 = nullptr;
+
+	if (!s_yuvToRGBKernelsEnabled || !g_system)
+		return false;
+	if (format.bytesPerPixel != 2 && format.bytesPerPixel != 4)
+		return false;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		kernels.row444 = yuv444ToRGBRowSSE2;
+		kernels.row420 = yuv420ToRGBRowSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		kernels.row444 = yuv444ToRGBRowAVX2;
+		kernels.row420 = yuv420ToRGBRowAVX2;
+	}
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		kernels.row444 = yuv444ToRGBRowNEON;
+		kernels.row420 = yuv420ToRGBRowNEON;
+	}
+#endif
+
+	return kernels.row444 != nullptr;
+}
+
+void setYUVToRGBKernelsEnabled(bool enabled) {
+	s_yuvToRGBKernelsEnabled = enabled;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_KERNELS_H
+#define GRAPHICS_YUV_TO_RGB_KERNELS_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_yuv_to_rgb_kernels YUV to RGB kernels
+ * @ingroup graphics
+ *
+ * @brief Row loops used by YUVToRGBManager to convert whole vectors of pixels.
+ *
+ * The kernels compute the colors instead of looking them up in the tables
+ * of YUVToRGBManager, but produce exactly the same pixels. They only
+ * convert as many pixels of a row as fit into their vectors; the table
+ * code converts the rest.
+ * @{
+ */
+
+/**
+ * Fixed point factors of the chroma terms and of the ITU luminance scale.
+ *
+ * For every chroma value c - 128 in [-128, 127], (|c - 128| * k) >> 15
+ * is the same as the truncated product stored in the tables, and for
+ * every luminance value l in [0, 219], (l * kYUVScaleITU) >> 15 is
+ * l * 255 / 219.
+ */
+enum {
+	kYUVCrToR = 45919,   ///< 0.419 / 0.299
+	kYUVCrToG = 23383,   ///< 0.299 / 0.419, subtracted
+	kYUVCbToG = 11285,   ///< 0.114 / 0.331, subtracted
+	kYUVCbToB = 58111,   ///< 0.587 / 0.331
+	kYUVScaleITU = 38155 ///< 255 / 219
+};
+
+/**
+ * Convert a row of pixels to a 16bpp or 32bpp @p format.
+ *
+ * @param dst    the destination pixels
+ * @param ySrc   the y component of the row
+ * @param uSrc   the u component, one value per pixel or per two pixels
+ *               depending on the kernel
+ * @param vSrc   the v component, like @p uSrc
+ * @param aSrc   the alpha of the pixels, or nullptr for opaque pixels
+ * @param len    the number of pixels in the row
+ * @param format the destination format
+ * @param scale  the scale of the luminance values
+ * @return the number of pixels converted, which is @p len rounded down to
+ *         a multiple of the vector width
+ */
+typedef uint (*YUVToRGBRowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+
+struct YUVToRGBKernels {
+	YUVToRGBRowFunc row444; ///< One chroma value per pixel
+	YUVToRGBRowFunc row420; ///< One chroma value per two pixels
+};
+
+#ifdef SCUMMVM_SSE2
+uint yuv444ToRGBRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+uint yuv420ToRGBRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+#endif
+
+#ifdef SCUMMVM_AVX2
+uint yuv444ToRGBRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+uint yuv420ToRGBRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+#endif
+
+#ifdef SCUMMVM_NEON
+uint yuv444ToRGBRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+uint yuv420ToRGBRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale);
+#endif
+
+/**
+ * Select the fastest kernels supported by the CPU we are running on.
+ *
+ * @return false if there are none, if they have been disabled with
+ *         setYUVToRGBKernelsEnabled() or if @p format is neither 16bpp
+ *         nor 32bpp.
+ */
+bool getYUVToRGBKernels(YUVToRGBKernels &kernels, const PixelFormat &format);
+
+/**
+ * Enable or disable the use of the kernels by YUVToRGBManager. They are
+ * enabled by default; disabling them is useful to compare against the
+ * table code.
+ */
+void setYUVToRGBKernelsEnabled(bool enabled);
+
+/** @} */
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+// Shift counts of the four channels of a destination format
+struct ChannelCounts {
+	ChannelCounts(const PixelFormat &format) {
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+	}
+
+	__m128i aLoss, rLoss, gLoss, bLoss;
+	__m128i aShift, rShift, gShift, bShift;
+};
+
+inline __m256i load16(const byte *src) {
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+}
+
+// Eight chroma values, each one repeated for two pixels
+inline __m256i load8Twice(const byte *src) {
+	const __m128i values = _mm_loadl_epi64((const __m128i *)src);
+	return _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(values, values));
+}
+
+// The truncated product of the centered chroma values c and one of the
+// factors in the header
+inline __m256i chromaTerm(__m256i c, int factor) {
+	const __m256i product = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_abs_epi16(c), 1), _mm256_set1_epi16((int16)factor));
+	return _mm256_sign_epi16(product, c);
+}
+
+// Clamp the sums of luminance and chroma terms like the tables do
+inline __m256i channel(__m256i sum, bool itu) {
+	if (itu) {
+		const __m256i low = _mm256_set1_epi16(16);
+		sum = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(sum, low), _mm256_set1_epi16(235)), low);
+		return _mm256_mulhi_epu16(_mm256_slli_epi16(sum, 1), _mm256_set1_epi16((int16)kYUVScaleITU));
+	}
+	return _mm256_min_epi16(_mm256_max_epi16(sum, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+}
+
+inline __m256i place16(__m256i channel, __m128i loss, __m128i shift) {
+	return _mm256_sll_epi16(_mm256_srl_epi16(channel, loss), shift);
+}
+
+inline __m256i place32(__m128i channel, __m128i shift) {
+	return _mm256_sll_epi32(_mm256_cvtepu16_epi32(channel), shift);
+}
+
+template<bool kHalfChroma>
+uint convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+	const ChannelCounts counts(format);
+	const __m256i center = _mm256_set1_epi16(128);
+
+	uint x = 0;
+	for (; x + 16 <= len; x += 16) {
+		const __m256i y = load16(ySrc + x);
+		const __m256i u = _mm256_sub_epi16(kHalfChroma ? load8Twice(uSrc + x / 2) : load16(uSrc + x), center);
+		const __m256i v = _mm256_sub_epi16(kHalfChroma ? load8Twice(vSrc + x / 2) : load16(vSrc + x), center);
+
+		const __m256i r = channel(_mm256_add_epi16(y, chromaTerm(v, kYUVCrToR)), itu);
+		const __m256i g = channel(_mm256_sub_epi16(_mm256_sub_epi16(y, chromaTerm(v, kYUVCrToG)), chromaTerm(u, kYUVCbToG)), itu);
+		const __m256i b = channel(_mm256_add_epi16(y, chromaTerm(u, kYUVCbToB)), itu);
+		const __m256i a = aSrc ? load16(aSrc + x) : _mm256_set1_epi16(255);
+
+		if (format.bytesPerPixel == 2) {
+			__m256i out = place16(a, counts.aLoss, counts.aShift);
+			out = _mm256_or_si256(out, place16(r, counts.rLoss, counts.rShift));
+			out = _mm256_or_si256(out, place16(g, counts.gLoss, counts.gShift));
+			out = _mm256_or_si256(out, place16(b, counts.bLoss, counts.bShift));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), out);
+		} else {
+			const __m256i aLost = _mm256_srl_epi16(a, counts.aLoss);
+			const __m256i rLost = _mm256_srl_epi16(r, counts.rLoss);
+			const __m256i gLost = _mm256_srl_epi16(g, counts.gLoss);
+			const __m256i bLost = _mm256_srl_epi16(b, counts.bLoss);
+
+			__m256i lo = place32(_mm256_castsi256_si128(aLost), counts.aShift);
+			lo = _mm256_or_si256(lo, place32(_mm256_castsi256_si128(rLost), counts.rShift));
+			lo = _mm256_or_si256(lo, place32(_mm256_castsi256_si128(gLost), counts.gShift));
+			lo = _mm256_or_si256(lo, place32(_mm256_castsi256_si128(bLost), counts.bShift));
+			__m256i hi = place32(_mm256_extracti128_si256(aLost, 1), counts.aShift);
+			hi = _mm256_or_si256(hi, place32(_mm256_extracti128_si256(rLost, 1), counts.rShift));
+			hi = _mm256_or_si256(hi, place32(_mm256_extracti128_si256(gLost, 1), counts.gShift));
+			hi = _mm256_or_si256(hi, place32(_mm256_extracti128_si256(bLost, 1), counts.bShift));
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint yuv444ToRGBRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<false>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+uint yuv420ToRGBRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<true>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+namespace {
+
+inline int16x8_t load8(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+// Four chroma values, each one repeated for two pixels
+inline int16x8_t load4Twice(const byte *src) {
+	uint32 values;
+	memcpy(&values, src, sizeof(values));
+	const uint8x8_t lanes = vreinterpret_u8_u32(vdup_n_u32(values));
+	return vreinterpretq_s16_u16(vmovl_u8(vzip_u8(lanes, lanes).val[0]));
+}
+
+// (a * factor) >> 15 for the magnitudes a of the centered chroma values
+// and for the luminance values of the ITU scale
+inline uint16x8_t multiply(uint16x8_t a, uint16 factor) {
+	const uint32x4_t lo = vmull_n_u16(vget_low_u16(a), factor);
+	const uint32x4_t hi = vmull_n_u16(vget_high_u16(a), factor);
+	return vcombine_u16(vshrn_n_u32(lo, 15), vshrn_n_u32(hi, 15));
+}
+
+// The truncated product of the centered chroma values c and one of the
+// factors in the header
+inline int16x8_t chromaTerm(int16x8_t c, uint16 factor) {
+	const int16x8_t product = vreinterpretq_s16_u16(multiply(vreinterpretq_u16_s16(vabsq_s16(c)), factor));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(product), product);
+}
+
+// Clamp the sums of luminance and chroma terms like the tables do
+inline uint16x8_t channel(int16x8_t sum, bool itu) {
+	if (itu) {
+		const int16x8_t low = vdupq_n_s16(16);
+		sum = vsubq_s16(vminq_s16(vmaxq_s16(sum, low), vdupq_n_s16(235)), low);
+		return multiply(vreinterpretq_u16_s16(sum), kYUVScaleITU);
+	}
+	return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(sum, vdupq_n_s16(0)), vdupq_n_s16(255)));
+}
+
+inline uint16x8_t place16(uint16x8_t channel, int loss, int shift) {
+	return vshlq_u16(vshlq_u16(channel, vdupq_n_s16(-loss)), vdupq_n_s16(shift));
+}
+
+inline uint32x4_t place32(uint16x4_t channel, int shift) {
+	return vshlq_u32(vmovl_u16(channel), vdupq_n_s32(shift));
+}
+
+template<bool kHalfChroma>
+uint convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+	const int16x8_t center = vdupq_n_s16(128);
+
+	uint x = 0;
+	for (; x + 8 <= len; x += 8) {
+		const int16x8_t y = load8(ySrc + x);
+		const int16x8_t u = vsubq_s16(kHalfChroma ? load4Twice(uSrc + x / 2) : load8(uSrc + x), center);
+		const int16x8_t v = vsubq_s16(kHalfChroma ? load4Twice(vSrc + x / 2) : load8(vSrc + x), center);
+
+		const uint16x8_t r = channel(vaddq_s16(y, chromaTerm(v, kYUVCrToR)), itu);
+		const uint16x8_t g = channel(vsubq_s16(vsubq_s16(y, chromaTerm(v, kYUVCrToG)), chromaTerm(u, kYUVCbToG)), itu);
+		const uint16x8_t b = channel(vaddq_s16(y, chromaTerm(u, kYUVCbToB)), itu);
+		const uint16x8_t a = aSrc ? vmovl_u8(vld1_u8(aSrc + x)) : vdupq_n_u16(255);
+
+		if (format.bytesPerPixel == 2) {
+			uint16x8_t out = place16(a, format.aLoss, format.aShift);
+			out = vorrq_u16(out, place16(r, format.rLoss, format.rShift));
+			out = vorrq_u16(out, place16(g, format.gLoss, format.gShift));
+			out = vorrq_u16(out, place16(b, format.bLoss, format.bShift));
+			vst1q_u16((uint16 *)(dst + x * 2), out);
+		} else {
+			const uint16x8_t aLost = vshlq_u16(a, vdupq_n_s16(-format.aLoss));
+			const uint16x8_t rLost = vshlq_u16(r, vdupq_n_s16(-format.rLoss));
+			const uint16x8_t gLost = vshlq_u16(g, vdupq_n_s16(-format.gLoss));
+			const uint16x8_t bLost = vshlq_u16(b, vdupq_n_s16(-format.bLoss));
+
+			uint32x4_t lo = place32(vget_low_u16(aLost), format.aShift);
+			lo = vorrq_u32(lo, place32(vget_low_u16(rLost), format.rShift));
+			lo = vorrq_u32(lo, place32(vget_low_u16(gLost), format.gShift));
+			lo = vorrq_u32(lo, place32(vget_low_u16(bLost), format.bShift));
+			uint32x4_t hi = place32(vget_high_u16(aLost), format.aShift);
+			hi = vorrq_u32(hi, place32(vget_high_u16(rLost), format.rShift));
+			hi = vorrq_u32(hi, place32(vget_high_u16(gLost), format.gShift));
+			hi = vorrq_u32(hi, place32(vget_high_u16(bLost), format.bShift));
+			vst1q_u32((uint32 *)(dst + x * 4), lo);
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint yuv444ToRGBRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<false>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+uint yuv420ToRGBRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<true>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+// Shift counts of the four channels of a destination format
+struct ChannelCounts {
+	ChannelCounts(const PixelFormat &format) {
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+	}
+
+	__m128i aLoss, rLoss, gLoss, bLoss;
+	__m128i aShift, rShift, gShift, bShift;
+};
+
+inline __m128i load8(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+// Four chroma values, each one repeated for two pixels
+inline __m128i load4Twice(const byte *src) {
+	int32 values;
+	memcpy(&values, src, sizeof(values));
+	const __m128i lanes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(values), _mm_setzero_si128());
+	return _mm_unpacklo_epi16(lanes, lanes);
+}
+
+// The truncated product of the centered chroma values c and one of the
+// factors in the header
+inline __m128i chromaTerm(__m128i c, int factor) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	const __m128i product = _mm_mulhi_epu16(_mm_slli_epi16(magnitude, 1), _mm_set1_epi16((int16)factor));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+// Clamp the sums of luminance and chroma terms like the tables do
+inline __m128i channel(__m128i sum, bool itu) {
+	if (itu) {
+		const __m128i low = _mm_set1_epi16(16);
+		sum = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(sum, low), _mm_set1_epi16(235)), low);
+		return _mm_mulhi_epu16(_mm_slli_epi16(sum, 1), _mm_set1_epi16((int16)kYUVScaleITU));
+	}
+	return _mm_min_epi16(_mm_max_epi16(sum, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+inline __m128i place16(__m128i channel, __m128i loss, __m128i shift) {
+	return _mm_sll_epi16(_mm_srl_epi16(channel, loss), shift);
+}
+
+inline __m128i place32(__m128i channel, __m128i shift) {
+	return _mm_sll_epi32(channel, shift);
+}
+
+template<bool kHalfChroma>
+uint convertRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+	const ChannelCounts counts(format);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i center = _mm_set1_epi16(128);
+
+	uint x = 0;
+	for (; x + 8 <= len; x += 8) {
+		const __m128i y = load8(ySrc + x);
+		const __m128i u = _mm_sub_epi16(kHalfChroma ? load4Twice(uSrc + x / 2) : load8(uSrc + x), center);
+		const __m128i v = _mm_sub_epi16(kHalfChroma ? load4Twice(vSrc + x / 2) : load8(vSrc + x), center);
+
+		const __m128i r = channel(_mm_add_epi16(y, chromaTerm(v, kYUVCrToR)), itu);
+		const __m128i g = channel(_mm_sub_epi16(_mm_sub_epi16(y, chromaTerm(v, kYUVCrToG)), chromaTerm(u, kYUVCbToG)), itu);
+		const __m128i b = channel(_mm_add_epi16(y, chromaTerm(u, kYUVCbToB)), itu);
+		const __m128i a = aSrc ? load8(aSrc + x) : _mm_set1_epi16(255);
+
+		if (format.bytesPerPixel == 2) {
+			__m128i out = place16(a, counts.aLoss, counts.aShift);
+			out = _mm_or_si128(out, place16(r, counts.rLoss, counts.rShift));
+			out = _mm_or_si128(out, place16(g, counts.gLoss, counts.gShift));
+			out = _mm_or_si128(out, place16(b, counts.bLoss, counts.bShift));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), out);
+		} else {
+			const __m128i aLost = _mm_srl_epi16(a, counts.aLoss);
+			const __m128i rLost = _mm_srl_epi16(r, counts.rLoss);
+			const __m128i gLost = _mm_srl_epi16(g, counts.gLoss);
+			const __m128i bLost = _mm_srl_epi16(b, counts.bLoss);
+
+			__m128i lo = place32(_mm_unpacklo_epi16(aLost, zero), counts.aShift);
+			lo = _mm_or_si128(lo, place32(_mm_unpacklo_epi16(rLost, zero), counts.rShift));
+			lo = _mm_or_si128(lo, place32(_mm_unpacklo_epi16(gLost, zero), counts.gShift));
+			lo = _mm_or_si128(lo, place32(_mm_unpacklo_epi16(bLost, zero), counts.bShift));
+			__m128i hi = place32(_mm_unpackhi_epi16(aLost, zero), counts.aShift);
+			hi = _mm_or_si128(hi, place32(_mm_unpackhi_epi16(rLost, zero), counts.rShift));
+			hi = _mm_or_si128(hi, place32(_mm_unpackhi_epi16(gLost, zero), counts.gShift));
+			hi = _mm_or_si128(hi, place32(_mm_unpackhi_epi16(bLost, zero), counts.bShift));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+uint yuv444ToRGBRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<false>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+uint yuv420ToRGBRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, uint len, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	return convertRow<true>(dst, ySrc, uSrc, vSrc, aSrc, len, format, scale);
+}
+
+} // End of namespace Graphics
@@ -34,7 +34,12 @@
 #include "common/stream.h"
 #endif
 
+#ifdef HAS_THREAD_LOCAL
+#include "common/smallalloc.h"
+#endif
+
 #include "engines/engine.h"
+#include "audio/prefetchstream.h"
 
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
@@ -78,6 +83,11 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("audio_prefetch",		WRAP_METHOD(Debugger, cmdAudioPrefetch));
+#ifdef HAS_THREAD_LOCAL
+	registerCmd("alloc_stats",		WRAP_METHOD(Debugger, cmdAllocStats));
+#endif
 }
 
 Debugger::~Debugger() {
@@ -756,6 +766,42 @@ bool Debugger::cmdDebugFlagsList(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdAudioPrefetch(int argc, const char **argv) {
+	Common::Array<Audio::PrefetchingAudioStream::Stats> stats;
+	Audio::getPrefetchingAudioStreamStats(stats);
+
+	if (stats.empty()) {
+		debugPrintf("No prefetching audio streams\n");
+		return true;
+	}
+
+	debugPrintf("Stream  Buffered          Decoded  Underruns (samples)\n");
+	for (uint i = 0; i < stats.size(); ++i) {
+		const Audio::PrefetchingAudioStream::Stats &s = stats[i];
+		debugPrintf("%6d  %7d/%-7d  %9d  %9d (%d)\n", i, s.occupancy, s.capacity, s.decodedSamples, s.underruns, s.underrunSamples);
+	}
+	return true;
+}
+
+#ifdef HAS_THREAD_LOCAL
+bool Debugger::cmdAllocStats(int argc, const char **argv) {
+	uint64 totalLive = 0, totalReserved = 0;
+
+	debugPrintf("Size      Allocs       Frees    Live    Peak  Reserved\n");
+	for (uint i = 0; i < Common::getSmallObjectSizeClasses(); ++i) {
+		const Common::SmallObjectStats s = Common::getSmallObjectStats(i);
+		if (!s.allocCount)
+			continue;
+		debugPrintf("%4d  %10llu  %10llu  %6d  %6d  %7dK\n", s.objectSize, (unsigned long long)s.allocCount,
+			(unsigned long long)s.freeCount, s.liveCount, s.peakLiveCount, s.reservedBytes / 1024);
+		totalLive += (uint64)s.liveCount * s.objectSize;
+		totalReserved += s.reservedBytes;
+	}
+	debugPrintf("%dK of %dK in use\n", (int)(totalLive / 1024), (int)(totalReserved / 1024));
+	return true;
+}
+#endif
+
 bool Debugger::cmdDebugFlagEnable(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("debugflag_enable [<flag> | all]\n");
@@ -247,6 +247,10 @@ protected:
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
 	bool cmdExecFile(int argc, const char **argv);
+	bool cmdAudioPrefetch(int argc, const char **argv);
+#ifdef HAS_THREAD_LOCAL
+	bool cmdAllocStats(int argc, const char **argv);
+#endif
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
@@ -19,6 +19,7 @@
  *
  */
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -250,6 +251,9 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		// Keep the MD5s of this scan for the next one
+		DetectionCacheMan.flush(true);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -21,6 +21,7 @@ MODULE_OBJS := \
 	predictivedialog.o \
 	saveload.o \
 	saveload-dialog.o \
+	saveload-metainfo.o \
 	themebrowser.o \
 	ThemeEngine.o \
 	ThemeEval.o \
@@ -43,6 +43,15 @@ namespace GUI {
 
 #define SCALEVALUE(val) ((val) * g_gui.getScaleFactor())
 
+enum {
+	// How long handleTickle() may spend reading save files
+	kMetaInfoLoadTime = 15,
+	// Color of the thumbnails which are not loaded yet
+	kPlaceholderGray = 96,
+	// How many bytes of meta infos a chooser keeps while it is open
+	kMetaInfoCacheSize = 16 * 1024 * 1024
+};
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 
 enum {
@@ -138,7 +147,7 @@ enum {
 SaveLoadChooserDialog::SaveLoadChooserDialog(const Common::String &dialogName, const bool saveMode)
 	: Dialog(dialogName), _metaEngine(nullptr), _delSupport(false), _metaInfoSupport(false),
 	_thumbnailSupport(false), _saveDateSupport(false), _playTimeSupport(false), _saveMode(saveMode),
-	_dialogWasShown(false)
+	_dialogWasShown(false), _metaInfoCache(kMetaInfoCacheSize)
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 	, _listButton(nullptr), _gridButton(nullptr)
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
@@ -151,7 +160,7 @@ SaveLoadChooserDialog::SaveLoadChooserDialog(const Common::String &dialogName, c
 SaveLoadChooserDialog::SaveLoadChooserDialog(int x, int y, int w, int h, const bool saveMode)
 	: Dialog(x, y, w, h), _metaEngine(nullptr), _delSupport(false), _metaInfoSupport(false),
 	_thumbnailSupport(false), _saveDateSupport(false), _playTimeSupport(false), _saveMode(saveMode),
-	_dialogWasShown(false)
+	_dialogWasShown(false), _metaInfoCache(kMetaInfoCacheSize)
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 	, _listButton(nullptr), _gridButton(nullptr)
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
@@ -181,6 +190,9 @@ void SaveLoadChooserDialog::close() {
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 	CloudMan.setSyncTarget(nullptr); //not that dialog, at least
 #endif
+	// Do not hold on to the thumbnails while the game is running
+	_metaInfos.clearRequests();
+	_metaInfoCache.clear();
 	Dialog::close();
 }
 
@@ -245,6 +257,14 @@ void SaveLoadChooserDialog::runSaveSync(bool hasSavepathOverride) {
 #endif
 
 void SaveLoadChooserDialog::handleTickle() {
+	// Read the meta infos of some of the saves which are shown
+	const uint32 start = g_system->getMillis();
+	uint index;
+	while (g_system->getMillis() - start < kMetaInfoLoadTime && _metaInfos.next(index)) {
+		loadMetaInfos(index);
+		metaInfosLoaded(index);
+	}
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 	if (!_dialogWasShown && CloudMan.isSyncing()) {
 		Common::Array<Common::String> files = CloudMan.getSyncingFiles();
@@ -328,6 +348,63 @@ void SaveLoadChooserDialog::listSaves() {
 		Common::sort(_saveList.begin(), _saveList.end(), SaveStateDescriptorSlotComparator());
 	}
 #endif
+
+	resetMetaInfos();
+}
+
+void SaveLoadChooserDialog::resetMetaInfos() {
+	// Locked saves can not be read, so all there is to know about them is
+	// in the list already. Entries with a thumbnail have been filled in by
+	// querySaveMetaInfos(), which the default MetaEngine::listSaves() uses.
+	_metaInfos.reset(_saveList.size());
+	for (uint i = 0; i < _saveList.size(); ++i) {
+		if (_saveList[i].getLocked() || _saveList[i].getThumbnail())
+			_metaInfos.setLoaded(i);
+	}
+}
+
+bool SaveLoadChooserDialog::getMetaInfoCacheKey(uint index, Common::String &key) const {
+	const int slot = _saveList[index].getSaveSlot();
+	int64 size, modTime;
+	if (!g_system->getSavefileManager()->getSavefileStats(_metaEngine->getSavegameFile(slot, _target.c_str()), size, modTime))
+		return false;
+
+	key = Common::String::format("%s/%d/%u/%u", _target.c_str(), slot, (uint32)size, (uint32)modTime);
+	return true;
+}
+
+void SaveLoadChooserDialog::loadMetaInfos(uint index) {
+	SaveStateDescriptor &entry = _saveList[index];
+	SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), entry.getSaveSlot());
+	if (desc.getSaveSlot() >= 0) {
+		if (desc.getDescription().empty())
+			desc.setDescription(entry.getDescription());
+		if (entry.getWriteProtectedFlag())
+			desc.setWriteProtectedFlag(true);
+		entry = desc;
+	}
+	_metaInfos.setLoaded(index);
+
+	Common::String key;
+	if (getMetaInfoCacheKey(index, key)) {
+		const Graphics::Surface *thumbnail = entry.getThumbnail();
+		_metaInfoCache.put(key, entry, thumbnail ? thumbnail->pitch * thumbnail->h : 0);
+	}
+}
+
+bool SaveLoadChooserDialog::requestMetaInfos(uint index) {
+	if (_metaInfos.isLoaded(index))
+		return true;
+
+	Common::String key;
+	SaveStateDescriptor desc;
+	if (getMetaInfoCacheKey(index, key) && _metaInfoCache.get(key, desc)) {
+		_saveList[index] = desc;
+		_metaInfos.setLoaded(index);
+		return true;
+	}
+
+	return _metaInfos.request(index);
 }
 
 void SaveLoadChooserDialog::activate(int slot, const Common::U32String &description) {
@@ -579,6 +656,53 @@ void SaveLoadChooserSimple::reflowLayout() {
 	}
 }
 
+void SaveLoadChooserSimple::updateMetaInfoWidgets(int selItem) {
+	// We used to support letting the themes specify the fill color with our
+	// initial theme based GUI. But this support was dropped.
+	_gfxWidget->setGfx(-1, -1, 0, 0, 0);
+	_date->setLabel(_("No date saved"));
+	_time->setLabel(_("No time saved"));
+	_playtime->setLabel(_("No playtime saved"));
+
+	if (selItem < 0 || !_metaInfoSupport)
+		return;
+
+	const SaveStateDescriptor &desc = _saveList[selItem];
+
+	if (_thumbnailSupport && _gfxWidget->isVisible()) {
+		const Graphics::Surface *thumb = desc.getThumbnail();
+		if (!_metaInfos.isLoaded(selItem))
+			_gfxWidget->setGfx(-1, -1, kPlaceholderGray, kPlaceholderGray, kPlaceholderGray);
+		else if (thumb)
+			_gfxWidget->setGfx(thumb, true);
+	}
+
+	if (_saveDateSupport) {
+		const Common::U32String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty())
+			_date->setLabel(_("Date: ") + saveDate);
+
+		const Common::U32String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty())
+			_time->setLabel(_("Time: ") + saveTime);
+	}
+
+	if (_playTimeSupport) {
+		const Common::U32String &playTime = desc.getPlayTime();
+		if (!playTime.empty())
+			_playtime->setLabel(_("Playtime: ") + playTime);
+	}
+}
+
+void SaveLoadChooserSimple::metaInfosLoaded(uint index) {
+	if ((int)index != _list->getSelected())
+		return;
+
+	// The flags may have changed as well. updateSelection() does not
+	// restart an edit which is in progress.
+	updateSelection(true);
+}
+
 void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	int selItem = _list->getSelected();
 
@@ -587,57 +711,31 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	bool startEditMode = _list->isEditable();
 	bool isLocked = false;
 
-	// We used to support letting the themes specify the fill color with our
-	// initial theme based GUI. But this support was dropped.
-	_gfxWidget->setGfx(-1, -1, 0, 0, 0);
-	_date->setLabel(_("No date saved"));
-	_time->setLabel(_("No time saved"));
-	_playtime->setLabel(_("No playtime saved"));
-
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = (_saveList[selItem].getLocked() ? _saveList[selItem] : _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot()));
-		if (!_saveList[selItem].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[selItem] = desc;
+		// The flags are taken from the save list until the meta infos have
+		// been read. Editing waits for them, metaInfosLoaded() calls this
+		// again once they are.
+		if (!requestMetaInfos(selItem))
+			startEditMode = false;
+		const SaveStateDescriptor &desc = _saveList[selItem];
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
-		isWriteProtected = desc.getWriteProtectedFlag() ||
-			_saveList[selItem].getWriteProtectedFlag();
+		isWriteProtected = desc.getWriteProtectedFlag();
 		isLocked = desc.getLocked();
 
 		// Don't allow the user to change the description of write protected games
 		if (isWriteProtected)
 			startEditMode = false;
-
-		if (_thumbnailSupport) {
-			const Graphics::Surface *thumb = desc.getThumbnail();
-			if (thumb && _gfxWidget->isVisible())
-				_gfxWidget->setGfx(thumb, true);
-		}
-
-		if (_saveDateSupport) {
-			const Common::U32String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty())
-				_date->setLabel(_("Date: ") + saveDate);
-
-			const Common::U32String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty())
-				_time->setLabel(_("Time: ") + saveTime);
-		}
-
-		if (_playTimeSupport) {
-			const Common::U32String &playTime = desc.getPlayTime();
-			if (!playTime.empty())
-				_playtime->setLabel(_("Playtime: ") + playTime);
-		}
 	}
 
+	updateMetaInfoWidgets(selItem);
 
 	if (_list->isEditable()) {
 		// Disable the save button if slot is locked, nothing is selected,
 		// or if the selected game is write protected
 		_chooseButton->setEnabled(!isLocked && selItem >= 0 && !isWriteProtected);
 
-		if (startEditMode) {
+		if (startEditMode && !_list->isEditing()) {
 			_list->startEditMode();
 
 			if (_chooseButton->isEnabled() && _list->getSelectedString() == _("Untitled saved game") &&
@@ -757,6 +855,7 @@ void SaveLoadChooserSimple::updateSaveList() {
 		_saveList.push_back(dummySave);
 		colors.push_back(ThemeEngine::kFontColorNormal);
 	}
+	resetMetaInfos();
 
 	int selected = _list->getSelected();
 	_list->setList(saveNames, &colors);
@@ -1110,61 +1209,19 @@ void SaveLoadChooserGrid::hideButtons() {
 
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
+	clearMetaInfoRequests();
 
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
-
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		if (!_saveList[i].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[i] = desc;
+		requestMetaInfos(i);
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::U32String(Common::String::format("%d. ", saveSlot)) + desc.getDescription());
-
-		Common::U32String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
-
-		if (_saveDateSupport) {
-			const Common::U32String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::U32String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Time: ") + saveTime;
-			}
-		}
-
-		if (_playTimeSupport) {
-			const Common::U32String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Playtime: ") + playTime;
-			}
-		}
-
-		curButton.button->setTooltip(tooltip);
-
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		// We also disable and description the button if slot is locked
-		if ((_saveMode && desc.getWriteProtectedFlag()) || desc.getLocked()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
-		}
-		curButton.description->setEnabled(!desc.getLocked());
+		updateSaveButton(curButton, i);
 	}
 
+	// Read the next page ahead of time, so that turning to it is quick
+	for (uint i = (_curPage + 1) * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum)
+		requestMetaInfos(i);
+
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
 	_pageDisplay->setLabel(Common::String::format("%u/%u", _curPage + 1, numPages));
 
@@ -1179,6 +1236,66 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSaveButton(SlotButton &button, uint index) {
+	const SaveStateDescriptor &desc = _saveList[index];
+
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (!_metaInfos.isLoaded(index)) {
+		button.button->setGfx(kThumbnailWidth, kThumbnailHeight2, kPlaceholderGray, kPlaceholderGray, kPlaceholderGray);
+	} else if (thumbnail) {
+		button.button->setGfx(thumbnail);
+	} else {
+		button.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	button.description->setLabel(Common::U32String(Common::String::format("%d. ", desc.getSaveSlot())) + desc.getDescription());
+
+	Common::U32String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
+
+	if (_saveDateSupport) {
+		const Common::U32String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::U32String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::U32String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	button.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	// We also disable and description the button if slot is locked
+	if ((_saveMode && desc.getWriteProtectedFlag()) || desc.getLocked()) {
+		button.button->setEnabled(false);
+	} else {
+		button.button->setEnabled(true);
+	}
+	button.description->setEnabled(!desc.getLocked());
+}
+
+void SaveLoadChooserGrid::metaInfosLoaded(uint index) {
+	const uint first = _curPage * _entriesPerPage;
+	if (index < first || index >= first + _entriesPerPage)
+		return;
+
+	updateSaveButton(_buttons[index - first], index);
+	g_gui.scheduleTopDialogRedraw();
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
@@ -23,6 +23,7 @@
 #define GUI_SAVELOAD_DIALOG_H
 
 #include "gui/dialog.h"
+#include "gui/saveload-metainfo.h"
 #include "gui/widgets/list.h"
 
 #include "engines/metaengine.h"
@@ -111,6 +112,27 @@ protected:
 
 	void activate(int slot, const Common::U32String &description);
 
+	/**
+	 * Make sure the meta infos of the given _saveList entry are complete,
+	 * including the thumbnail.
+	 *
+	 * If they have been read before and the save file did not change since,
+	 * they are taken from a cache and true is returned. Otherwise the entry
+	 * is queued, and handleTickle() reads the save file a bit later and
+	 * calls metaInfosLoaded(). This keeps the dialog responsive when lots
+	 * of saves are shown.
+	 */
+	bool requestMetaInfos(uint index);
+
+	/** Forget which meta infos are complete. Call after changing _saveList. */
+	void resetMetaInfos();
+
+	/** Drop all queued requestMetaInfos() calls, e.g. after a page change. */
+	void clearMetaInfoRequests() { _metaInfos.clearRequests(); }
+
+	/** Called once the meta infos of a _saveList entry have been read. */
+	virtual void metaInfosLoaded(uint index) {}
+
 	const bool					_saveMode;
 	const MetaEngine		    *_metaEngine;
 	bool						_delSupport;
@@ -123,6 +145,11 @@ protected:
 	SaveStateList				_saveList;
 	Common::U32String			_resultString;
 
+	/** Which _saveList entries have complete meta infos, and which to read. */
+	SaveMetaInfoQueue			_metaInfos;
+	/** The meta infos read since the dialog was opened. */
+	SaveMetaInfoCache<SaveStateDescriptor>	_metaInfoCache;
+
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 	ButtonWidget *_listButton;
 	ButtonWidget *_gridButton;
@@ -130,6 +157,10 @@ protected:
 	void addChooserButtons();
 	ButtonWidget *createSwitchButton(const Common::String &name, const Common::U32String &desc, const Common::U32String &tooltip, const char *image, uint32 cmd = 0);
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
+
+private:
+	bool getMetaInfoCacheKey(uint index, Common::String &key) const;
+	void loadMetaInfos(uint index);
 };
 
 class SaveLoadChooserSimple : public SaveLoadChooserDialog {
@@ -165,6 +196,9 @@ private:
 
 	void addThumbnailContainer();
 	void updateSelection(bool redraw);
+	void updateMetaInfoWidgets(int selItem);
+
+	void metaInfosLoaded(uint index) override;
 };
 
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
@@ -243,6 +277,9 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSaveButton(SlotButton &button, uint index);
+
+	void metaInfosLoaded(uint index) override;
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
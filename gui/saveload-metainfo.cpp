@@ -0,0 +1,54 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/saveload-metainfo.h"
+
+#include "common/algorithm.h"
+
+namespace GUI {
+
+void SaveMetaInfoQueue::reset(uint count) {
+	_queue.clear();
+	_loaded.resize(count);
+	for (uint i = 0; i < count; ++i)
+		_loaded[i] = false;
+}
+
+bool SaveMetaInfoQueue::request(uint index) {
+	if (_loaded[index])
+		return true;
+
+	if (Common::find(_queue.begin(), _queue.end(), index) == _queue.end())
+		_queue.push_back(index);
+	return false;
+}
+
+bool SaveMetaInfoQueue::next(uint &index) {
+	while (!_queue.empty()) {
+		index = _queue.front();
+		_queue.remove_at(0);
+		if (index < _loaded.size() && !_loaded[index])
+			return true;
+	}
+	return false;
+}
+
+} // End of namespace GUI
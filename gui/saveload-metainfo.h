@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_SAVELOAD_METAINFO_H
+#define GUI_SAVELOAD_METAINFO_H
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/str.h"
+
+namespace GUI {
+
+/**
+ * The meta infos of save files which a save/load chooser has read, so that
+ * refreshing the list of saves does not read them again. Entries are keyed
+ * by the target, the slot and the size and modification time of the save
+ * file. Once the entries take up more than the given number of bytes, the
+ * least recently used ones are dropped.
+ */
+template<class Value>
+class SaveMetaInfoCache {
+public:
+	explicit SaveMetaInfoCache(uint32 maxSize) : _maxSize(maxSize), _size(0) {}
+
+	/** Look up an entry and mark it as the most recently used one. */
+	bool get(const Common::String &key, Value &value) {
+		typename IndexMap::iterator i = _index.find(key);
+		if (i == _index.end())
+			return false;
+
+		// Move the entry to the front
+		_entries.push_front(*i->_value);
+		_entries.erase(i->_value);
+		i->_value = _entries.begin();
+
+		value = _entries.front().value;
+		return true;
+	}
+
+	/**
+	 * Add or replace an entry, which takes up about size bytes. The most
+	 * recent entry is always kept, even if it alone is too big.
+	 */
+	void put(const Common::String &key, const Value &value, uint32 size) {
+		typename IndexMap::iterator i = _index.find(key);
+		if (i != _index.end()) {
+			_size -= i->_value->size;
+			_entries.erase(i->_value);
+			_index.erase(i);
+		}
+
+		Entry entry;
+		entry.key = key;
+		entry.value = value;
+		entry.size = sizeof(Entry) + size;
+
+		_entries.push_front(entry);
+		_index[key] = _entries.begin();
+		_size += entry.size;
+
+		while (_size > _maxSize && _entries.size() > 1) {
+			_size -= _entries.back().size;
+			_index.erase(_entries.back().key);
+			_entries.pop_back();
+		}
+	}
+
+	bool contains(const Common::String &key) const { return _index.contains(key); }
+
+	/** Drop all entries. */
+	void clear() {
+		_entries.clear();
+		_index.clear(true);
+		_size = 0;
+	}
+
+	/** The number of bytes the entries take up. */
+	uint32 size() const { return _size; }
+
+	uint count() const { return _index.size(); }
+
+private:
+	struct Entry {
+		Common::String key;
+		Value value;
+		uint32 size;
+	};
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Common::String, typename EntryList::iterator> IndexMap;
+
+	const uint32 _maxSize;
+	// Most recently used first
+	EntryList _entries;
+	IndexMap _index;
+	uint32 _size;
+};
+
+/**
+ * Keeps track of which entries of a save list have their meta infos read,
+ * and in which order the remaining ones were requested.
+ */
+class SaveMetaInfoQueue {
+public:
+	/** Forget all requests, and mark all of count entries as not read. */
+	void reset(uint count);
+
+	bool isLoaded(uint index) const { return _loaded[index]; }
+	void setLoaded(uint index) { _loaded[index] = true; }
+
+	/**
+	 * Queue an entry, unless it is read or queued already.
+	 *
+	 * @return Whether the entry has been read.
+	 */
+	bool request(uint index);
+
+	/** Drop all queued requests, e.g. after a page change. */
+	void clearRequests() { _queue.clear(); }
+
+	/**
+	 * Take the oldest request for an entry which has not been read yet.
+	 *
+	 * @return False if there is no such request.
+	 */
+	bool next(uint &index);
+
+	uint pendingRequests() const { return _queue.size(); }
+
+private:
+	Common::Array<bool> _loaded;
+	Common::Array<uint> _queue;
+};
+
+} // End of namespace GUI
+
+#endif
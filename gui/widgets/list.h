@@ -119,6 +119,7 @@ public:
 	void enableDictionarySelect(bool enable)	{ _dictionarySelect = enable; }
 
 	bool isEditable() const						{ return _editable; }
+	bool isEditing() const						{ return _editMode; }
 	void setEditable(bool editable)				{ _editable = editable; }
 	void setEditColor(ThemeEngine::FontColor color) { _editColor = color; }
 	void setFilterMatcher(FilterMatcher matcher, void *arg) { _filterMatcher = matcher; _filterMatcherArg = arg; }
@@ -0,0 +1,362 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/adpcm_intern.h"
+
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/util.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+/**
+ * The MS IMA ADPCM stream as it was before the block decoder: it reads a
+ * byte at a time from the stream and decodes each nibble with
+ * Ima_ADPCMStream::decodeIMA(). Only used to time the block decoder.
+ */
+class PerSampleMSImaStream : public Audio::Ima_ADPCMStream {
+public:
+	PerSampleMSImaStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Ima_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) {
+		memset(_samplesLeft, 0, sizeof(_samplesLeft));
+	}
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) {
+		int samples = 0;
+
+		while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+			if (_blockPos[0] == _blockAlign) {
+				for (int i = 0; i < _channels; i++) {
+					_status.ima_ch[i].last = _stream->readSint16LE();
+					_status.ima_ch[i].stepIndex = _stream->readSint16LE();
+				}
+
+				_blockPos[0] = _channels * 4;
+			}
+
+			for (int i = 0; i < _channels; i++) {
+				for (int j = 0; j < 4; j++) {
+					byte data = _stream->readByte();
+					_blockPos[0]++;
+					_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
+					_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
+					_samplesLeft[i] += 2;
+				}
+			}
+
+			while (samples < numSamples && _samplesLeft[0] != 0) {
+				for (int i = 0; i < _channels; i++) {
+					buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
+					_samplesLeft[i]--;
+				}
+
+				samples += _channels;
+			}
+		}
+
+		return samples;
+	}
+
+private:
+	int16 _buffer[2][8];
+	int _samplesLeft[2];
+};
+
+/**
+ * Compares the block ADPCM decoders with straightforward per-sample
+ * reference implementations of the formats.
+ */
+class ADPCMTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void fillNoise(byte *data, uint32 size, uint32 seed) {
+		for (uint32 i = 0; i < size; i++) {
+			data[i] = Test::nextSeed(seed) >> 16;
+		}
+	}
+
+	static int16 refIMA(int32 &last, int32 &index, byte code) {
+		const int32 E = (2 * (code & 0x7) + 1) * Audio::Ima_ADPCMStream::_imaTable[index] / 8;
+		last = CLIP<int32>(last + ((code & 0x08) ? -E : E), -32768, 32767);
+		index = CLIP<int32>(index + Audio::ADPCMStream::_stepAdjustTable[code], 0, 88);
+		return last;
+	}
+
+	static int16 refOKI(int32 &last, int32 &index, byte code) {
+		static const int16 okiStepSize[49] = {
+			   16,   17,   19,   21,   23,   25,   28,   31,
+			   34,   37,   41,   45,   50,   55,   60,   66,
+			   73,   80,   88,   97,  107,  118,  130,  143,
+			  157,  173,  190,  209,  230,  253,  279,  307,
+			  337,  371,  408,  449,  494,  544,  598,  658,
+			  724,  796,  876,  963, 1060, 1166, 1282, 1411,
+			 1552
+		};
+
+		const int32 E = (2 * (code & 0x7) + 1) * okiStepSize[index] / 8;
+		last = CLIP<int32>(last + ((code & 0x08) ? -E : E), -2048, 2047);
+		index = CLIP<int32>(index + Audio::ADPCMStream::_stepAdjustTable[code], 0, 48);
+		return last * 16;
+	}
+
+	static uint32 refDecodeOki(const byte *data, uint32 size, int16 *out) {
+		int32 last = 0, index = 0;
+		uint32 count = 0;
+		for (uint32 i = 0; i < size; i++) {
+			out[count++] = refOKI(last, index, data[i] >> 4);
+			out[count++] = refOKI(last, index, data[i] & 0x0f);
+		}
+		return count;
+	}
+
+	static uint32 refDecodeDVI(const byte *data, uint32 size, int channels, int16 *out) {
+		int32 last[2] = { 0, 0 }, index[2] = { 0, 0 };
+		const int right = (channels == 2) ? 1 : 0;
+		uint32 count = 0;
+		for (uint32 i = 0; i < size; i++) {
+			out[count++] = refIMA(last[0], index[0], data[i] >> 4);
+			out[count++] = refIMA(last[right], index[right], data[i] & 0x0f);
+		}
+		return count;
+	}
+
+	static uint32 refDecodeMSIma(const byte *data, uint32 size, int channels, uint32 blockAlign, int16 *out) {
+		uint32 count = 0;
+		for (uint32 block = 0; block + blockAlign <= size; block += blockAlign) {
+			const byte *src = data + block;
+			int32 last[2], index[2];
+			for (int i = 0; i < channels; i++) {
+				last[i] = (int16)READ_LE_UINT16(src);
+				index[i] = CLIP<int32>((int16)READ_LE_UINT16(src + 2), 0, 88);
+				src += 4;
+			}
+
+			for (uint32 pos = channels * 4; pos < blockAlign; pos += channels * 4) {
+				int16 samples[2][8];
+				for (int i = 0; i < channels; i++) {
+					for (int j = 0; j < 4; j++) {
+						const byte code = *src++;
+						samples[i][j * 2] = refIMA(last[i], index[i], code & 0x0f);
+						samples[i][j * 2 + 1] = refIMA(last[i], index[i], code >> 4);
+					}
+				}
+				for (int j = 0; j < 8; j++)
+					for (int i = 0; i < channels; i++)
+						out[count++] = samples[i][j];
+			}
+		}
+		return count;
+	}
+
+	struct MSChannel {
+		int32 delta, coeff1, coeff2, sample1, sample2;
+	};
+
+	static int16 refMS(MSChannel &c, byte code) {
+		static const int adaptationTable[] = {
+			230, 230, 230, 230, 307, 409, 512, 614,
+			768, 614, 512, 409, 307, 230, 230, 230
+		};
+
+		int32 predictor = (c.sample1 * c.coeff1 + c.sample2 * c.coeff2) / 256;
+		predictor += ((code & 0x08) ? (code - 0x10) : code) * c.delta;
+		predictor = CLIP<int32>(predictor, -32768, 32767);
+
+		c.sample2 = c.sample1;
+		c.sample1 = predictor;
+		c.delta = (int16)((adaptationTable[code] * c.delta) >> 8);
+		if (c.delta < 16)
+			c.delta = 16;
+		return predictor;
+	}
+
+	static uint32 refDecodeMS(const byte *data, uint32 size, int channels, uint32 blockAlign, int16 *out) {
+		static const int coeff1[] = { 256, 512, 0, 192, 240, 460, 392 };
+		static const int coeff2[] = { 0, -256, 0, 64, 0, -208, -232 };
+
+		uint32 count = 0;
+		for (uint32 block = 0; block + blockAlign <= size; block += blockAlign) {
+			const byte *src = data + block;
+			MSChannel ch[2];
+			int i;
+			for (i = 0; i < channels; i++) {
+				const byte predictor = MIN<byte>(*src++, 6);
+				ch[i].coeff1 = coeff1[predictor];
+				ch[i].coeff2 = coeff2[predictor];
+			}
+			for (i = 0; i < channels; i++, src += 2)
+				ch[i].delta = (int16)READ_LE_UINT16(src);
+			for (i = 0; i < channels; i++, src += 2)
+				ch[i].sample1 = (int16)READ_LE_UINT16(src);
+			for (i = 0; i < channels; i++, src += 2)
+				ch[i].sample2 = (int16)READ_LE_UINT16(src);
+
+			for (i = 0; i < channels; i++)
+				out[count++] = ch[i].sample2;
+			for (i = 0; i < channels; i++)
+				out[count++] = ch[i].sample1;
+
+			for (; src < data + block + blockAlign; src++) {
+				out[count++] = refMS(ch[0], *src >> 4);
+				out[count++] = refMS(ch[channels - 1], *src & 0x0f);
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Decodes the data with the given stream type, reading in chunks of
+	 * the given size, and compares the result with the reference output.
+	 */
+	void checkDecoder(Audio::ADPCMType type, const byte *data, uint32 size, int channels, uint32 blockAlign,
+	                  const int16 *expected, uint32 expectedCount, int readSize) {
+		Common::MemoryReadStream *stream = new Common::MemoryReadStream(data, size);
+		Audio::RewindableAudioStream *adpcm = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+
+		int16 *out = new int16[expectedCount + readSize];
+		uint32 count = 0;
+		while (!adpcm->endOfData()) {
+			const int samples = adpcm->readBuffer(out + count, readSize);
+			if (samples <= 0)
+				break;
+			count += samples;
+			TS_ASSERT_LESS_THAN_EQUALS(count, expectedCount);
+			if (count > expectedCount)
+				break;
+		}
+
+		TS_ASSERT_EQUALS(count, expectedCount);
+		for (uint32 i = 0; i < MIN(count, expectedCount); i++) {
+			if (out[i] != expected[i]) {
+				TS_FAIL(Common::String::format("Sample %d differs: %d != %d", i, out[i], expected[i]).c_str());
+				break;
+			}
+		}
+
+		// Rewinding has to restart decoding from scratch
+		TS_ASSERT(adpcm->rewind());
+		const int samples = adpcm->readBuffer(out, MIN<int>(readSize, expectedCount));
+		TS_ASSERT_EQUALS(samples, MIN<int>(readSize, expectedCount));
+		TS_ASSERT_SAME_DATA(out, expected, samples * sizeof(int16));
+
+		delete[] out;
+		delete adpcm;
+	}
+
+	void checkFormat(Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		const uint32 size = 4 * 2048 + (blockAlign ? 0 : 123);
+		byte *data = new byte[size];
+		fillNoise(data, size, type * 7 + channels);
+
+		int16 *expected = new int16[size * 2 + 8];
+		uint32 count = 0;
+		switch (type) {
+		case Audio::kADPCMOki:
+			count = refDecodeOki(data, size, expected);
+			break;
+		case Audio::kADPCMDVI:
+			count = refDecodeDVI(data, size, channels, expected);
+			break;
+		case Audio::kADPCMMSIma:
+			count = refDecodeMSIma(data, size, channels, blockAlign, expected);
+			break;
+		case Audio::kADPCMMS:
+			count = refDecodeMS(data, size, channels, blockAlign, expected);
+			break;
+		default:
+			break;
+		}
+
+		checkDecoder(type, data, size, channels, blockAlign, expected, count, 2048);
+		// Odd sized reads have to split decoded blocks
+		checkDecoder(type, data, size, channels, blockAlign, expected, count, channels * 37);
+
+		delete[] expected;
+		delete[] data;
+	}
+
+public:
+	void test_oki() {
+		checkFormat(Audio::kADPCMOki, 1, 0);
+	}
+
+	void test_dvi_mono() {
+		checkFormat(Audio::kADPCMDVI, 1, 0);
+	}
+
+	void test_dvi_stereo() {
+		checkFormat(Audio::kADPCMDVI, 2, 0);
+	}
+
+	void test_ms_ima_mono() {
+		checkFormat(Audio::kADPCMMSIma, 1, 512);
+	}
+
+	void test_ms_ima_stereo() {
+		checkFormat(Audio::kADPCMMSIma, 2, 1024);
+	}
+
+	void test_ms_mono() {
+		checkFormat(Audio::kADPCMMS, 1, 256);
+	}
+
+	void test_ms_stereo() {
+		checkFormat(Audio::kADPCMMS, 2, 2048);
+	}
+
+	/**
+	 * Time the MS IMA block decoder against the per-sample stream it
+	 * replaced, both decoding the same data through readBuffer().
+	 */
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		const uint32 size = 1024 * 1024;
+		const uint32 blockAlign = 2048;
+		const int rounds = 8;
+		byte *data = new byte[size];
+		fillNoise(data, size, 1);
+		// The per-sample stream does not clip the step index of the block
+		// headers, so keep them in range
+		for (uint32 block = 0; block < size; block += blockAlign) {
+			for (int i = 0; i < 2; i++)
+				WRITE_LE_UINT16(data + block + i * 4 + 2, data[block + i * 4 + 2] % 89);
+		}
+		int16 *out = new int16[4096];
+
+		uint32 checksums[2] = { 0, 0 };
+		uint32 times[2];
+		for (int pass = 0; pass < 2; pass++) {
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < rounds; i++) {
+				Common::MemoryReadStream *stream = new Common::MemoryReadStream(data, size);
+				Audio::AudioStream *adpcm;
+				if (pass == 0)
+					adpcm = new PerSampleMSImaStream(stream, size, 22050, 2, blockAlign);
+				else
+					adpcm = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, size, Audio::kADPCMMSIma, 22050, 2, blockAlign);
+
+				int samples;
+				while ((samples = adpcm->readBuffer(out, 4096)) > 0) {
+					for (int j = 0; j < samples; j++)
+						checksums[pass] = checksums[pass] * 31 + (uint16)out[j];
+				}
+				delete adpcm;
+			}
+			times[pass] = g_system->getMillis() - start;
+		}
+
+		TS_ASSERT_EQUALS(checksums[0], checksums[1]);
+		TS_TRACE(Common::String::format("MS IMA ADPCM, %d x %u KiB: per-sample %u ms, block %u ms",
+		                                rounds, size / 1024, times[0], times[1]).c_str());
+
+		delete[] out;
+		delete[] data;
+#endif
+	}
+};
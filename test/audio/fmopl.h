@@ -0,0 +1,211 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/fmopl.h"
+#include "audio/softsynth/opl/dosbox.h"
+#include "audio/softsynth/opl/nuked.h"
+
+#include "common/array.h"
+#include "common/func.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+/**
+ * An emulated OPL whose timer callbacks are only run by readBuffer(), and
+ * which can render samples directly.
+ */
+template<class Chip>
+class TestOPL : public Chip {
+public:
+	TestOPL() : Chip(OPL::Config::kOpl3) {}
+
+	void generate(int16 *buffer, int numSamples) {
+		this->generateSamples(buffer, numSamples);
+	}
+
+protected:
+	void startCallbacks(int timerFrequency) override {
+		this->setCallbackFrequency(timerFrequency);
+	}
+
+	void stopCallbacks() override {
+	}
+};
+
+/**
+ * Plays random notes on all channels of an OPL3, with the rhythm section,
+ * four-operator channels, vibrato and tremolo enabled.
+ */
+class RandomSong {
+public:
+	RandomSong(OPL::OPL *opl) : _opl(opl), _seed(1), _ticks(0) {}
+
+	void setup() {
+		_opl->writeReg(0x105, 0x01);
+		_opl->writeReg(0x104, 0x09);
+		_opl->writeReg(0x001, 0x20);
+		_opl->writeReg(0x0BD, 0xE0);
+
+		for (int bank = 0; bank < 0x200; bank += 0x100) {
+			for (int slot = 0; slot < 0x16; slot++) {
+				if ((slot & 7) >= 6)
+					continue;
+				_opl->writeReg(bank + 0x20 + slot, Test::nextRandom(_seed) & 0xff);
+				const uint32 keyScale = Test::nextRandom(_seed) & 0xc0;
+				_opl->writeReg(bank + 0x40 + slot, keyScale | (Test::nextRandom(_seed) % 24));
+				_opl->writeReg(bank + 0x60 + slot, 0xa0 | (Test::nextRandom(_seed) & 0x5f));
+				_opl->writeReg(bank + 0x80 + slot, Test::nextRandom(_seed) & 0xff);
+				_opl->writeReg(bank + 0xE0 + slot, Test::nextRandom(_seed) & 7);
+			}
+			for (int channel = 0; channel < 9; channel++)
+				_opl->writeReg(bank + 0xC0 + channel, 0x30 | (Test::nextRandom(_seed) & 0xcf));
+		}
+	}
+
+	void onTimer() {
+		_ticks++;
+
+		// Key a random channel on or off, and now and then hit a drum
+		const int bank = (Test::nextRandom(_seed) & 1) ? 0x100 : 0;
+		const int channel = Test::nextRandom(_seed) % 9;
+		const uint32 r = Test::nextRandom(_seed);
+		if (r & 1) {
+			_opl->writeReg(bank + 0xA0 + channel, (r >> 1) & 0xff);
+			_opl->writeReg(bank + 0xB0 + channel, 0x20 | ((r >> 9) & 0x1f));
+		} else {
+			_opl->writeReg(bank + 0xB0 + channel, (r >> 9) & 0x1f);
+		}
+		if ((_ticks % 5) == 0)
+			_opl->writeReg(0xBD, 0xE0 | ((r >> 16) & 0x1f));
+
+		// A read makes the queued writes be applied right away
+		if ((_ticks % 7) == 0)
+			_opl->read(0x388);
+	}
+
+private:
+	OPL::OPL *_opl;
+	uint32 _seed;
+	uint _ticks;
+};
+
+class FMOPLTestSuite : public CxxTest::TestSuite
+{
+	// The sizes of the buffers the mixer asks for, in sample frames
+	static const int kBufferSizes[5];
+
+	enum {
+		kTimerFrequency = 300,
+		kFrames = 22050
+	};
+
+	/**
+	 * Render the song the way EmulatedOPL::readBuffer() did before writes
+	 * were queued: each slice of samples up to the next timer callback or
+	 * the end of the buffer is generated right away, and the callback then
+	 * writes to the chip immediately.
+	 */
+	template<class Chip>
+	static void renderImmediately(Common::Array<int16> &out) {
+		TestOPL<Chip> opl;
+		opl.init();
+		RandomSong song(&opl);
+		song.setup();
+
+		const int rate = opl.getRate();
+		const int samplesPerTick = ((rate / kTimerFrequency) << 16) + ((rate % kTimerFrequency) << 16) / kTimerFrequency;
+
+		out.resize(kFrames * 2);
+		int nextTick = 0;
+		for (int start = 0, i = 0; start < kFrames; i++) {
+			const int len = MIN<int>(kFrames - start, kBufferSizes[i % ARRAYSIZE(kBufferSizes)]);
+			int pos = 0;
+			do {
+				const int step = MIN<int>(len - pos, nextTick >> 16);
+				opl.generate(&out[(start + pos) * 2], step * 2);
+				nextTick -= step << 16;
+				pos += step;
+
+				if (!(nextTick >> 16)) {
+					song.onTimer();
+					nextTick += samplesPerTick;
+				}
+			} while (pos < len);
+			start += len;
+		}
+	}
+
+	// Render the song through readBuffer()
+	template<class Chip>
+	static void renderQueued(Common::Array<int16> &out) {
+		TestOPL<Chip> opl;
+		opl.init();
+		RandomSong song(&opl);
+		song.setup();
+		opl.start(new Common::Functor0Mem<void, RandomSong>(&song, &RandomSong::onTimer), kTimerFrequency);
+
+		out.resize(kFrames * 2);
+		for (int start = 0, i = 0; start < kFrames; i++) {
+			const int len = MIN<int>(kFrames - start, kBufferSizes[i % ARRAYSIZE(kBufferSizes)]);
+			opl.readBuffer(&out[start * 2], len * 2);
+			start += len;
+		}
+		opl.stop();
+	}
+
+	template<class Chip>
+	static void checkQueuedWrites() {
+		Common::install_null_g_system();
+
+		Common::Array<int16> immediate, queued;
+		renderImmediately<Chip>(immediate);
+		renderQueued<Chip>(queued);
+
+		TS_ASSERT_EQUALS(immediate.size(), queued.size());
+		TS_ASSERT(memcmp(immediate.begin(), queued.begin(), immediate.size() * sizeof(int16)) == 0);
+	}
+
+public:
+	void test_queued_writes_dosbox() {
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(DISABLE_DOSBOX_OPL)
+		checkQueuedWrites<OPL::DOSBox::OPL>();
+#endif
+	}
+
+	void test_queued_writes_nuked() {
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(DISABLE_NUKED_OPL)
+		checkQueuedWrites<OPL::NUKED::OPL>();
+#endif
+	}
+
+	void test_nuked_bit_exact() {
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(DISABLE_NUKED_OPL)
+		Common::install_null_g_system();
+
+		// The checksum of the output of the upstream Nuked OPL3 code, before
+		// its generator loops were restructured
+		TestOPL<OPL::NUKED::OPL> opl;
+		opl.init();
+		RandomSong song(&opl);
+		song.setup();
+
+		int16 buffer[2000];
+		uint32 checksum = 0;
+		int nonSilent = 0;
+		for (int i = 0; i < 100; i++) {
+			song.onTimer();
+			opl.generate(buffer, ARRAYSIZE(buffer));
+			for (uint j = 0; j < ARRAYSIZE(buffer); j++) {
+				checksum = checksum * 31 + (uint16)buffer[j];
+				nonSilent += buffer[j] != 0;
+			}
+		}
+
+		TS_ASSERT_LESS_THAN(100 * ARRAYSIZE(buffer) / 2, nonSilent);
+		TS_ASSERT_EQUALS(checksum, 2001822065u);
+#endif
+	}
+};
+
+const int FMOPLTestSuite::kBufferSizes[5] = { 1024, 37, 512, 1, 2000 };
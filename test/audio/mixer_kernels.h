@@ -0,0 +1,82 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+
+#include "../test_helpers.h"
+
+class MixerKernelsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kLength = 67 // sample pairs, deliberately not a multiple of the vector width
+	};
+
+	static void fillSamples(int16 *buf, uint count, uint32 seed) {
+		for (uint i = 0; i < count; ++i) {
+			buf[i] = (int16)(Test::nextSeed(seed) >> 16);
+		}
+		// Make sure the extremes are covered as well
+		buf[0] = -32768;
+		buf[1] = 32767;
+	}
+
+	void checkKernels(Audio::MixAccumulateFunc accumulate, Audio::MixSaturateFunc saturate) {
+		static const Audio::st_volume_t volumes[][2] = {
+			{ 0, 0 }, { 256, 256 }, { 255, 1 }, { 17, 200 }, { 128, 127 }
+		};
+
+		int16 src[kLength * 2];
+		int32 refAccum[kLength * 2], accum[kLength * 2];
+		int16 refOut[kLength * 2], out[kLength * 2];
+
+		memset(refAccum, 0, sizeof(refAccum));
+		memset(accum, 0, sizeof(accum));
+
+		for (uint i = 0; i < ARRAYSIZE(volumes); ++i) {
+			fillSamples(src, kLength * 2, i);
+			Audio::mixAccumulate(refAccum, src, kLength, volumes[i][0], volumes[i][1]);
+			accumulate(accum, src, kLength, volumes[i][0], volumes[i][1]);
+			TS_ASSERT_EQUALS(memcmp(refAccum, accum, sizeof(accum)), 0);
+		}
+
+		Audio::mixSaturate(refOut, refAccum, kLength);
+		saturate(out, accum, kLength);
+		TS_ASSERT_EQUALS(memcmp(refOut, out, sizeof(out)), 0);
+	}
+
+public:
+	void test_scalar_matches_rate_converter_scaling() {
+		int16 src[4] = { -32768, 32767, -1, 1 };
+		int32 accum[4] = { 0, 0, 0, 0 };
+
+		Audio::mixAccumulate(accum, src, 2, 255, 3);
+		for (int i = 0; i < 4; ++i) {
+			const int vol = (i & 1) ? 3 : 255;
+			TS_ASSERT_EQUALS(accum[i], (src[i] * vol) / Audio::Mixer::kMaxMixerVolume);
+		}
+	}
+
+	void test_saturate_clamps() {
+		const int32 accum[4] = { 40000, -40000, 32767, -32768 };
+		int16 out[4];
+
+		Audio::mixSaturate(out, accum, 2);
+		TS_ASSERT_EQUALS(out[0], 32767);
+		TS_ASSERT_EQUALS(out[1], -32768);
+		TS_ASSERT_EQUALS(out[2], 32767);
+		TS_ASSERT_EQUALS(out[3], -32768);
+	}
+
+	void test_sse2_matches_scalar() {
+#ifdef SCUMMVM_SSE2
+		checkKernels(Audio::mixAccumulateSSE2, Audio::mixSaturateSSE2);
+#endif
+	}
+
+	void test_neon_matches_scalar() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Audio::mixAccumulateNEON, Audio::mixSaturateNEON);
+#endif
+	}
+};
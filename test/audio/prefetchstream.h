@@ -0,0 +1,219 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/prefetchstream.h"
+
+#include "common/endian.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+
+class PrefetchingAudioStreamTestSuite : public CxxTest::TestSuite {
+	enum {
+		kRate = 22050,
+		kFrames = kRate * 2
+	};
+
+	static Audio::SeekableAudioStream *createRampStream() {
+		byte *data = (byte *)malloc(kFrames * 2 * 2);
+		for (int i = 0; i < kFrames * 2; ++i)
+			WRITE_LE_UINT16(data + i * 2, i & 0x7fff);
+
+		return Audio::makeRawStream(data, kFrames * 2 * 2, kRate, Audio::FLAG_16BITS | Audio::FLAG_STEREO | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	// Give the worker thread the time to decode the next read, so that
+	// the test does not depend on scheduling
+	static void waitForData(Audio::PrefetchingAudioStream *stream, uint32 samples) {
+		for (int i = 0; i < 1000; ++i) {
+			const Audio::PrefetchingAudioStream::Stats stats = stream->getStats();
+			if (stats.occupancy >= samples || stream->endOfData() || stats.occupancy == stats.capacity)
+				return;
+			g_system->delayMillis(1);
+		}
+	}
+
+	// Wait for the worker thread to seek the source, and drop the samples
+	// from before the seek
+	static void waitForSeek(Audio::PrefetchingAudioStream *stream) {
+		for (int i = 0; i < 1000 && stream->getStats().seekPending; ++i)
+			g_system->delayMillis(1);
+		int16 dummy;
+		stream->readBuffer(&dummy, 0);
+	}
+
+	static int readAll(Audio::PrefetchingAudioStream *stream, int16 *out, int total) {
+		int read = 0;
+		while (!stream->endOfData() && read < total) {
+			const int chunk = MIN(1000, total - read);
+			waitForData(stream, chunk);
+			const int samples = stream->readBuffer(out + read, chunk);
+			if (samples <= 0)
+				break;
+			read += samples;
+		}
+		return read;
+	}
+
+	// A source stream which does not return from seek() until it is allowed
+	// to, like a decoder waiting for slow media
+	class BlockingSeekStream : public Audio::SeekableAudioStream {
+	public:
+		BlockingSeekStream() : _stream(createRampStream()) {}
+		~BlockingSeekStream() { delete _stream; }
+
+		int readBuffer(int16 *buffer, const int numSamples) override { return _stream->readBuffer(buffer, numSamples); }
+		bool isStereo() const override { return _stream->isStereo(); }
+		int getRate() const override { return _stream->getRate(); }
+		bool endOfData() const override { return _stream->endOfData(); }
+		Audio::Timestamp getLength() const override { return _stream->getLength(); }
+
+		bool seek(const Audio::Timestamp &where) override {
+			_allowSeek.wait();
+			return _stream->seek(where);
+		}
+
+		Common::Semaphore _allowSeek;
+
+	private:
+		Audio::SeekableAudioStream *_stream;
+	};
+
+	static void emptyProc(void *data) {}
+
+	static void seekProc(void *data) {
+		Audio::PrefetchingAudioStream *stream = (Audio::PrefetchingAudioStream *)data;
+		for (int i = 0; i < 50; ++i) {
+			stream->seek(Audio::Timestamp(0, (i * 997) % 8000, kRate));
+			g_system->delayMillis(1);
+		}
+		stream->seek(Audio::Timestamp(0, 5000, kRate));
+	}
+
+public:
+	void test_read() {
+		Common::install_null_g_system();
+
+		Audio::PrefetchingAudioStream *stream = Audio::makePrefetchingAudioStream(createRampStream());
+		TS_ASSERT(stream->isStereo());
+		TS_ASSERT_EQUALS(stream->getRate(), (int)kRate);
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), (int)kFrames);
+
+		int16 *out = new int16[kFrames * 2];
+		TS_ASSERT_EQUALS(readAll(stream, out, kFrames * 2), (int)kFrames * 2);
+		TS_ASSERT(stream->endOfData());
+
+		bool equal = true;
+		for (int i = 0; i < kFrames * 2; ++i)
+			equal &= (out[i] == (i & 0x7fff));
+		TS_ASSERT(equal);
+
+		const Audio::PrefetchingAudioStream::Stats stats = stream->getStats();
+		TS_ASSERT_EQUALS(stats.underruns, 0u);
+		TS_ASSERT_EQUALS(stats.decodedSamples, (uint32)kFrames * 2);
+		TS_ASSERT_EQUALS(stats.occupancy, 0u);
+
+		Common::Array<Audio::PrefetchingAudioStream::Stats> allStats;
+		Audio::getPrefetchingAudioStreamStats(allStats);
+		TS_ASSERT_EQUALS(allStats.size(), 1u);
+
+		delete[] out;
+		delete stream;
+
+		Audio::getPrefetchingAudioStreamStats(allStats);
+		TS_ASSERT(allStats.empty());
+	}
+
+	void test_seek() {
+		Common::install_null_g_system();
+
+		Audio::PrefetchingAudioStream *stream = Audio::makePrefetchingAudioStream(createRampStream());
+
+		int16 out[100];
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, kFrames - 50, kRate)));
+		TS_ASSERT(!stream->seek(Audio::Timestamp(0, kFrames + 50, kRate)));
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, kFrames - 50, kRate)));
+		waitForSeek(stream);
+		TS_ASSERT_EQUALS(readAll(stream, out, 200), 100);
+		TS_ASSERT_EQUALS(out[0], ((kFrames - 50) * 2) & 0x7fff);
+		TS_ASSERT_EQUALS(out[99], ((kFrames - 50) * 2 + 99) & 0x7fff);
+
+		TS_ASSERT(stream->rewind());
+		TS_ASSERT(!stream->endOfData());
+		waitForSeek(stream);
+		waitForData(stream, 100);
+		TS_ASSERT_EQUALS(stream->readBuffer(out, 100), 100);
+		TS_ASSERT_EQUALS(out[0], 0);
+		TS_ASSERT_EQUALS(out[99], 99);
+
+		delete stream;
+	}
+
+	void test_seek_while_reading() {
+		Common::install_null_g_system();
+
+		Audio::PrefetchingAudioStream *stream = Audio::makePrefetchingAudioStream(createRampStream());
+
+		// Seeks come from the engine thread while the mixer keeps reading
+		Common::Thread thread;
+		if (!thread.start(seekProc, stream, "test seek")) {
+			TS_TRACE("Threads are not supported, skipping");
+			delete stream;
+			return;
+		}
+
+		int16 out[1000];
+		for (int i = 0; i < 100; ++i) {
+			stream->readBuffer(out, 100);
+			g_system->delayMillis(1);
+		}
+		thread.join();
+
+		// Nothing from before the last seek may be left in the buffer
+		waitForSeek(stream);
+		TS_ASSERT_EQUALS(readAll(stream, out, 1000), 1000);
+		TS_ASSERT_LESS_THAN_EQUALS(5000 * 2, out[0]);
+		bool contiguous = true;
+		for (int i = 1; i < 1000; ++i)
+			contiguous &= (out[i] == out[i - 1] + 1);
+		TS_ASSERT(contiguous);
+
+		delete stream;
+	}
+
+	void test_seek_does_not_block() {
+		Common::install_null_g_system();
+
+		BlockingSeekStream *source = new BlockingSeekStream();
+		Audio::PrefetchingAudioStream *stream = Audio::makePrefetchingAudioStream(source);
+
+		// Without threads the source can only be seeked in readBuffer()
+		Common::Thread thread;
+		if (!thread.start(emptyProc, nullptr, "test thread")) {
+			TS_TRACE("Threads are not supported, skipping");
+			delete stream;
+			return;
+		}
+		thread.join();
+
+		// While the worker waits for the source, the reader gets silence
+		int16 out[100];
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, 1000, kRate)));
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT_EQUALS(stream->readBuffer(out, 100), 100);
+		TS_ASSERT_EQUALS(out[0], 0);
+		TS_ASSERT_EQUALS(out[99], 0);
+		TS_ASSERT(stream->getStats().underruns >= 1u);
+		TS_ASSERT(stream->getStats().seekPending);
+
+		source->_allowSeek.post();
+		waitForSeek(stream);
+		waitForData(stream, 100);
+		TS_ASSERT_EQUALS(stream->readBuffer(out, 100), 100);
+		TS_ASSERT_EQUALS(out[0], 2000);
+		TS_ASSERT_EQUALS(out[99], 2099);
+
+		delete stream;
+	}
+};
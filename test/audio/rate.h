@@ -0,0 +1,193 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/rate_kernels.h"
+
+#include "common/endian.h"
+
+#include <math.h>
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	static Audio::AudioStream *createConstantStream(int rate, int samples, int16 value, bool isStereo) {
+		const int count = samples * (isStereo ? 2 : 1);
+		byte *data = (byte *)malloc(count * 2);
+		for (int i = 0; i < count; ++i)
+			WRITE_LE_UINT16(data + i * 2, value);
+
+		byte flags = Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN;
+		if (isStereo)
+			flags |= Audio::FLAG_STEREO;
+		return Audio::makeRawStream(data, count * 2, rate, flags);
+	}
+
+	void checkConstant(Audio::RateConverterQuality quality, int inRate, int outRate, bool isStereo) {
+		Common::install_null_g_system();
+
+		const int16 value = 12345;
+		Audio::AudioStream *stream = createConstantStream(inRate, inRate, value, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, false, quality);
+
+		int16 *out = (int16 *)calloc(outRate * 2, sizeof(int16));
+		const int len = converter->flow(*stream, out, outRate, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+
+		// The filter needs a few samples at both ends of the input, so allow
+		// for some slack there.
+		TS_ASSERT_LESS_THAN(outRate - 64, len);
+		TS_ASSERT_LESS_THAN_EQUALS(len, outRate);
+
+		for (int i = 64; i < len - 64; ++i) {
+			TS_ASSERT_EQUALS(out[i * 2 + 0], value);
+			TS_ASSERT_EQUALS(out[i * 2 + 1], value);
+		}
+
+		free(out);
+		delete converter;
+		delete stream;
+	}
+
+	static Audio::AudioStream *createSineStream(int rate, int samples, double frequency) {
+		byte *data = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_UINT16(data + i * 2, (int16)floor(10000 * sin(2 * M_PI * frequency * i / rate) + 0.5));
+		return Audio::makeRawStream(data, samples * 2, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	// Convert one second of a sine tone and return the RMS level of the
+	// output, leaving out the ends
+	static double convertSine(Audio::RateConverterQuality quality, int inRate, int outRate, double frequency) {
+		Common::install_null_g_system();
+
+		Audio::AudioStream *stream = createSineStream(inRate, inRate, frequency);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, quality);
+
+		int16 *out = (int16 *)calloc(outRate * 2, sizeof(int16));
+		const int len = converter->flow(*stream, out, outRate, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+
+		double sum = 0;
+		for (int i = 64; i < len - 64; ++i)
+			sum += (double)out[i * 2] * out[i * 2];
+
+		free(out);
+		delete converter;
+		delete stream;
+		return sqrt(sum / (len - 128));
+	}
+
+public:
+	void test_sinc_upsample_mono() {
+		checkConstant(Audio::kRateConverterSincMedium, 22050, 48000, false);
+	}
+
+	void test_sinc_upsample_stereo() {
+		checkConstant(Audio::kRateConverterSincHigh, 22050, 44100, true);
+	}
+
+	void test_sinc_downsample() {
+		checkConstant(Audio::kRateConverterSincLow, 48000, 11025, true);
+	}
+
+	void test_sinc_dot_product() {
+		int16 samples[32], coeffs[32];
+		for (int i = 0; i < 32; ++i) {
+			samples[i] = (int16)(i * 2047 - 32768);
+			coeffs[i] = (int16)(8192 - i * 500);
+		}
+
+		const int32 expected = Audio::sincDotProduct(samples, coeffs, 32);
+#ifdef SCUMMVM_SSE2
+		TS_ASSERT_EQUALS(Audio::sincDotProductSSE2(samples, coeffs, 32), expected);
+		TS_ASSERT_EQUALS(Audio::sincDotProductSSE2(samples, coeffs, 8), Audio::sincDotProduct(samples, coeffs, 8));
+#endif
+#ifdef SCUMMVM_NEON
+		TS_ASSERT_EQUALS(Audio::sincDotProductNEON(samples, coeffs, 32), expected);
+		TS_ASSERT_EQUALS(Audio::sincDotProductNEON(samples, coeffs, 8), Audio::sincDotProduct(samples, coeffs, 8));
+#endif
+	}
+
+	void test_sinc_flushes_tail() {
+		Common::install_null_g_system();
+
+		// Every input sample makes it to the output, including the ones
+		// in the second half of the filter when the stream ends
+		const int samples = 1000;
+		Audio::AudioStream *stream = createConstantStream(22050, samples, 12345, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, false, false, Audio::kRateConverterSincHigh);
+		int16 out[samples * 4];
+		memset(out, 0, sizeof(out));
+		TS_ASSERT_EQUALS(converter->flow(*stream, out, samples * 2, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), samples * 2);
+		TS_ASSERT_LESS_THAN(12345 * 9 / 10, out[(samples * 2 - 2) * 2]);
+		delete converter;
+		delete stream;
+
+		// If the output buffer is full before the end of the filter is
+		// reached, drain() outputs the rest
+		int16 drained[samples * 4];
+		memset(drained, 0, sizeof(drained));
+		stream = createConstantStream(22050, samples, 12345, false);
+		converter = Audio::makeRateConverter(22050, 44100, false, false, Audio::kRateConverterSincHigh);
+		TS_ASSERT_EQUALS(converter->flow(*stream, drained, samples * 2 - 8, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), samples * 2 - 8);
+		TS_ASSERT(stream->endOfStream());
+		TS_ASSERT_EQUALS(converter->drain(drained + (samples * 2 - 8) * 2, 100, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 8);
+		TS_ASSERT_EQUALS(converter->drain(drained, 100, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 0);
+		TS_ASSERT(memcmp(out, drained, sizeof(out)) == 0);
+		delete converter;
+		delete stream;
+	}
+
+	void test_sinc_against_linear_downsample() {
+		// A 15 kHz tone is above the Nyquist frequency of 11025 Hz audio. The
+		// linear converter folds it back into the audible range, the sinc
+		// filters remove it.
+		const double linear = convertSine(Audio::kRateConverterDefault, 48000, 11025, 15000);
+		TS_ASSERT_LESS_THAN(5000, linear);
+		TS_ASSERT_LESS_THAN(convertSine(Audio::kRateConverterSincLow, 48000, 11025, 15000), linear / 10);
+		TS_ASSERT_LESS_THAN(convertSine(Audio::kRateConverterSincMedium, 48000, 11025, 15000), 10);
+		TS_ASSERT_LESS_THAN(convertSine(Audio::kRateConverterSincHigh, 48000, 11025, 15000), 10);
+
+		// Low frequencies pass with their level intact
+		TS_ASSERT_DELTA(convertSine(Audio::kRateConverterSincHigh, 48000, 11025, 1000), 7071, 100);
+	}
+
+	void test_sinc_against_linear_upsample() {
+		// Linear interpolation dulls high frequencies, the 32 tap sinc
+		// filter keeps their level
+		TS_ASSERT_LESS_THAN(convertSine(Audio::kRateConverterDefault, 22050, 44100, 8000), 5600);
+		TS_ASSERT_DELTA(convertSine(Audio::kRateConverterSincHigh, 22050, 44100, 8000), 7071, 70);
+		TS_ASSERT_DELTA(convertSine(Audio::kRateConverterSincHigh, 22050, 44100, 1000), 7071, 70);
+	}
+
+	void test_benchmark() {
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		// Ten seconds of 22050 Hz stereo audio, converted to 44100 Hz
+		static const char *const names[] = { "linear", "sinc 8 taps", "sinc 16 taps", "sinc 32 taps" };
+		int16 *out = (int16 *)malloc(441000 * 2 * sizeof(int16));
+		Common::String result;
+		for (int quality = Audio::kRateConverterDefault; quality <= Audio::kRateConverterSincHigh; ++quality) {
+			Audio::AudioStream *stream = createConstantStream(22050, 220500, 1000, true);
+			Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, true, false, (Audio::RateConverterQuality)quality);
+			memset(out, 0, 441000 * 2 * sizeof(int16));
+
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < 441000; i += 1024)
+				converter->flow(*stream, out + i * 2, MIN(1024, 441000 - i), Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			result += Common::String::format("%s%s %u ms", quality ? ", " : "", names[quality], g_system->getMillis() - start);
+
+			delete converter;
+			delete stream;
+		}
+		free(out);
+
+		TS_TRACE(("10 s of 22050 Hz stereo to 44100 Hz: " + result).c_str());
+	}
+};
@@ -0,0 +1,187 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/saves/default/default-savewriter.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/zlib.h"
+
+#include "../null_osystem.h"
+
+class SaveWriterTestSuite : public CxxTest::TestSuite {
+	struct WrittenFile {
+		Common::String name;
+		Common::Array<byte> data;
+	};
+
+	/**
+	 * Stands in for a file on disk. The writer deletes its streams, so
+	 * the data ends up in a list owned by the test once it is finalized.
+	 */
+	class TestSaveStream : public Common::SeekableWriteStream {
+	public:
+		TestSaveStream(Common::Array<WrittenFile> *files, const Common::String &name, bool fail) :
+			_files(files), _name(name), _fail(fail), _err(false) {}
+
+		uint32 write(const void *dataPtr, uint32 dataSize) override {
+			if (_fail) {
+				_err = true;
+				return 0;
+			}
+			const byte *data = (const byte *)dataPtr;
+			for (uint32 i = 0; i < dataSize; ++i)
+				_data.push_back(data[i]);
+			// Writing to disk takes a while
+			g_system->delayMillis(1);
+			return dataSize;
+		}
+
+		void finalize() override {
+			WrittenFile file;
+			file.name = _name;
+			file.data = _data;
+			_files->push_back(file);
+		}
+
+		bool err() const override { return _err; }
+		int64 pos() const override { return _data.size(); }
+		int64 size() const override { return _data.size(); }
+		bool seek(int64 offset, int whence) override { return false; }
+
+	private:
+		Common::Array<WrittenFile> *_files;
+		Common::String _name;
+		Common::Array<byte> _data;
+		bool _fail;
+		bool _err;
+	};
+
+	// Queue a save the way the save file manager does once the game
+	// has finished writing it to memory
+	static void save(DefaultSaveWriter &writer, Common::Array<WrittenFile> &files, const Common::String &name, uint size, SaveCompression compression, bool fail = false) {
+		DefaultSaveWriter::Job *job = new DefaultSaveWriter::Job();
+		job->filename = name;
+		job->data = (byte *)malloc(size);
+		for (uint i = 0; i < size; ++i)
+			job->data[i] = i * 7 + name.size();
+		job->size = size;
+		job->stream = new TestSaveStream(&files, name, fail);
+		job->compression = compression;
+		writer.submit(job);
+	}
+
+	static bool hasContents(const WrittenFile &file, uint size) {
+		if (file.data.size() != size)
+			return false;
+		for (uint i = 0; i < size; ++i) {
+			if (file.data[i] != (byte)(i * 7 + file.name.size()))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_async_save() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::Array<WrittenFile> files;
+		DefaultSaveWriter writer;
+
+		save(writer, files, "game.001", 5000, kSaveUncompressed);
+		writer.wait();
+
+		TS_ASSERT_EQUALS(files.size(), 1u);
+		TS_ASSERT_EQUALS(files[0].name, "game.001");
+		TS_ASSERT(hasContents(files[0], 5000));
+
+		Common::String filename;
+		Common::Error error;
+		TS_ASSERT(writer.poll(filename, error));
+		TS_ASSERT_EQUALS(filename, "game.001");
+		TS_ASSERT_EQUALS(error.getCode(), Common::kNoError);
+		TS_ASSERT(!writer.poll(filename, error));
+#endif
+	}
+
+	void test_compressed_save() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::Array<WrittenFile> files;
+		DefaultSaveWriter writer;
+
+		save(writer, files, "game.002", 20000, kSaveGZip);
+		writer.wait();
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		// Loading goes through the same wrapper for all save files
+		Common::SeekableReadStream *in = Common::wrapCompressedReadStream(new Common::MemoryReadStream(files[0].data.data(), files[0].data.size()));
+		WrittenFile loaded;
+		loaded.name = files[0].name;
+		while (true) {
+			const byte b = in->readByte();
+			if (in->eos())
+				break;
+			loaded.data.push_back(b);
+		}
+		delete in;
+		TS_ASSERT(hasContents(loaded, 20000));
+#endif
+	}
+
+	void test_wait_ordering() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::Array<WrittenFile> files;
+		DefaultSaveWriter writer;
+
+		// wait() only returns once everything queued before it is on disk,
+		// including jobs submitted while an earlier one is being written
+		for (uint i = 0; i < 20; ++i)
+			save(writer, files, Common::String::format("game.%03u", i), 200 + i * 50, kSaveUncompressed);
+		writer.wait();
+
+		TS_ASSERT_EQUALS(files.size(), 20u);
+		for (uint i = 0; i < files.size(); ++i) {
+			TS_ASSERT_EQUALS(files[i].name, Common::String::format("game.%03u", i));
+			TS_ASSERT(hasContents(files[i], 200 + i * 50));
+		}
+
+		// The results are reported in the same order
+		for (uint i = 0; i < 20; ++i) {
+			Common::String filename;
+			Common::Error error;
+			TS_ASSERT(writer.poll(filename, error));
+			TS_ASSERT_EQUALS(filename, Common::String::format("game.%03u", i));
+		}
+
+		// Waiting without any pending saves returns right away
+		writer.wait();
+#endif
+	}
+
+	void test_error_reporting() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::Array<WrittenFile> files;
+		DefaultSaveWriter writer;
+
+		save(writer, files, "full.001", 1000, kSaveUncompressed, true);
+		save(writer, files, "game.001", 1000, kSaveUncompressed);
+		writer.wait();
+
+		Common::String filename;
+		Common::Error error;
+		TS_ASSERT(writer.poll(filename, error));
+		TS_ASSERT_EQUALS(filename, "full.001");
+		TS_ASSERT_EQUALS(error.getCode(), Common::kWritingFailed);
+
+		// A failed save does not affect the ones after it
+		TS_ASSERT(writer.poll(filename, error));
+		TS_ASSERT_EQUALS(filename, "game.001");
+		TS_ASSERT_EQUALS(error.getCode(), Common::kNoError);
+		TS_ASSERT(!writer.poll(filename, error));
+#endif
+	}
+};
@@ -0,0 +1,258 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	// Object ids as used by the script interpreters: mostly small, dense
+	// numbers with some gaps
+	static void makeIds(Common::Array<uint32> &ids, uint count) {
+		uint32 seed = 1;
+		uint32 id = 0;
+		for (uint i = 0; i < count; ++i) {
+			id += 1 + (Test::nextRandom(seed) % 4 == 0 ? Test::nextRandom(seed) % 64 : 0);
+			ids.push_back(id);
+		}
+	}
+
+	// Game file names in mixed case, as looked up through SearchMan
+	static void makeFileNames(Common::Array<Common::String> &names, uint count) {
+		static const char *const kExtensions[] = { ".RES", ".dat", ".Bmp", ".wav", ".SCR", ".lfl" };
+		uint32 seed = 2;
+		for (uint i = 0; i < count; ++i) {
+			Common::String name = Common::String::format("%s%u", (i & 1) ? "room" : "SOUND", Test::nextRandom(seed) % 100000);
+			name += kExtensions[i % ARRAYSIZE(kExtensions)];
+			names.push_back(name);
+		}
+	}
+
+	template<class Map>
+	static uint32 benchIds(const Common::Array<uint32> &ids, uint lookups, uint32 &checksum) {
+		const uint32 start = g_system->getMillis();
+		Map map;
+		for (uint i = 0; i < ids.size(); ++i)
+			map[ids[i]] = i;
+
+		uint32 seed = 3;
+		for (uint i = 0; i < lookups; ++i) {
+			// Half of the lookups miss
+			const uint32 id = ids[Test::nextRandom(seed) % ids.size()] + (i & 1) * 0x100000;
+			typename Map::const_iterator it = map.find(id);
+			if (it != map.end())
+				checksum += it->_value;
+		}
+
+		for (uint i = 0; i < ids.size(); i += 2)
+			map.erase(ids[i]);
+		for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+			checksum += it->_key;
+		return g_system->getMillis() - start;
+	}
+
+	template<class Map>
+	static uint32 benchFileNames(const Common::Array<Common::String> &names, uint lookups, uint32 &checksum) {
+		const uint32 start = g_system->getMillis();
+		Map map;
+		for (uint i = 0; i < names.size(); ++i)
+			map[names[i]] = i;
+
+		Common::Array<Common::String> upper;
+		for (uint i = 0; i < names.size(); ++i) {
+			upper.push_back(names[i]);
+			upper.back().toUppercase();
+		}
+
+		uint32 seed = 4;
+		for (uint i = 0; i < lookups; ++i) {
+			const Common::String &name = upper[Test::nextRandom(seed) % upper.size()];
+			checksum += map.contains(name) ? map.getVal(name) : 0;
+		}
+		return g_system->getMillis() - start;
+	}
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		TS_ASSERT(container.begin() == container.end());
+		TS_ASSERT(!container.contains(0));
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+		TS_ASSERT(!container.contains(0));
+		container[2] = 4;
+		container.clear(true);
+		TS_ASSERT(container.empty());
+		TS_ASSERT(container.begin() == container.end());
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(0);
+		container.erase(1);
+		container.erase(7);
+		TS_ASSERT_EQUALS(container.size(), 3u);
+		TS_ASSERT_EQUALS(container.getValOrDefault(2), 45);
+		TS_ASSERT_EQUALS(container.getValOrDefault(0, -1), -1);
+
+		int val = 0;
+		TS_ASSERT(container.tryGetVal(3, val));
+		TS_ASSERT_EQUALS(val, 12);
+		TS_ASSERT(!container.tryGetVal(5, val));
+	}
+
+	void test_string_keys() {
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container;
+		container["Monkey.000"] = "index";
+		container.setVal("MONKEY.001", "resources");
+		TS_ASSERT(container.contains("monkey.000"));
+		TS_ASSERT_EQUALS(container.getVal("monkey.001"), "resources");
+		TS_ASSERT(!container.contains("monkey.002"));
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>::const_iterator it = container.find("MONKEY.000");
+		TS_ASSERT(it != container.end());
+		TS_ASSERT_EQUALS(it->_key, "Monkey.000");
+	}
+
+	void test_iterate_and_erase() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; ++i)
+			container[i * 3] = i;
+
+		int sum = 0, count = 0;
+		for (Common::FlatHashMap<int, int>::iterator it = container.begin(); it != container.end(); ++it) {
+			sum += it->_value;
+			count++;
+			if (it->_key & 1)
+				container.erase(it);
+		}
+		TS_ASSERT_EQUALS(count, 100);
+		TS_ASSERT_EQUALS(sum, 99 * 100 / 2);
+		TS_ASSERT_EQUALS(container.size(), 50u);
+
+		for (Common::FlatHashMap<int, int>::const_iterator it = container.begin(); it != container.end(); ++it)
+			TS_ASSERT_EQUALS(it->_key & 1, 0);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, Common::String> container;
+		for (int i = 0; i < 50; ++i)
+			container[i] = Common::String::format("%d", i);
+		container.erase(10);
+
+		Common::FlatHashMap<int, Common::String> copy(container);
+		Common::FlatHashMap<int, Common::String> assigned;
+		assigned[1000] = "gone";
+		assigned = container;
+		container.clear();
+
+		TS_ASSERT_EQUALS(copy.size(), 49u);
+		TS_ASSERT_EQUALS(assigned.size(), 49u);
+		TS_ASSERT(!copy.contains(10));
+		TS_ASSERT(!assigned.contains(1000));
+		TS_ASSERT_EQUALS(copy[20], "20");
+		TS_ASSERT_EQUALS(assigned[49], "49");
+	}
+
+	void test_against_hashmap() {
+		// Random inserts and erases, which also leave many deleted slots
+		Common::HashMap<uint32, uint32> reference;
+		Common::FlatHashMap<uint32, uint32> container;
+		container.reserve(100);
+		uint32 seed = 5;
+		for (uint i = 0; i < 20000; ++i) {
+			const uint32 key = Test::nextRandom(seed) % 2000;
+			if (Test::nextRandom(seed) % 3 == 0) {
+				reference.erase(key);
+				container.erase(key);
+			} else {
+				reference[key] = i;
+				container[key] = i;
+			}
+		}
+
+		TS_ASSERT_EQUALS(container.size(), reference.size());
+		uint matches = 0;
+		for (Common::HashMap<uint32, uint32>::const_iterator it = reference.begin(); it != reference.end(); ++it) {
+			if (container.getValOrDefault(it->_key, 0xFFFFFFFF) == it->_value)
+				matches++;
+		}
+		TS_ASSERT_EQUALS(matches, reference.size());
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint32, uint32>::const_iterator it = container.begin(); it != container.end(); ++it)
+			count++;
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_strided_keys() {
+		// Keys which only differ in their high bits, such as addresses or
+		// ids with flags in the low bits, must not all probe the same group
+		static const uint kShifts[] = { 8, 12, 16, 20 };
+		for (uint s = 0; s < ARRAYSIZE(kShifts); ++s) {
+			Common::FlatHashMap<uint32, uint32> container;
+			for (uint32 i = 0; i < 4000; ++i)
+				container[i << kShifts[s]] = i;
+
+			TS_ASSERT_EQUALS(container.size(), 4000U);
+			uint matches = 0;
+			for (uint32 i = 0; i < 4000; ++i) {
+				if (container.getValOrDefault(i << kShifts[s], 0xFFFFFFFF) == i)
+					matches++;
+			}
+			TS_ASSERT_EQUALS(matches, 4000U);
+			TS_ASSERT(!container.contains(4000 << kShifts[s]));
+			TS_ASSERT(!container.contains(1));
+		}
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		Common::Array<uint32> ids;
+		makeIds(ids, 100000);
+		Common::Array<Common::String> names;
+		makeFileNames(names, 20000);
+
+		Common::Array<uint32> strided;
+		for (uint32 i = 0; i < 50000; ++i)
+			strided.push_back(i << 12);
+
+		uint32 checksums[6] = { 0, 0, 0, 0, 0, 0 };
+		const uint32 idsHashMap = benchIds<Common::HashMap<uint32, uint32> >(ids, 2000000, checksums[0]);
+		const uint32 idsFlat = benchIds<Common::FlatHashMap<uint32, uint32> >(ids, 2000000, checksums[1]);
+		const uint32 namesHashMap = benchFileNames<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >(names, 500000, checksums[2]);
+		const uint32 namesFlat = benchFileNames<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >(names, 500000, checksums[3]);
+		const uint32 stridedHashMap = benchIds<Common::HashMap<uint32, uint32> >(strided, 500000, checksums[4]);
+		const uint32 stridedFlat = benchIds<Common::FlatHashMap<uint32, uint32> >(strided, 500000, checksums[5]);
+		TS_ASSERT_EQUALS(checksums[0], checksums[1]);
+		TS_ASSERT_EQUALS(checksums[2], checksums[3]);
+		TS_ASSERT_EQUALS(checksums[4], checksums[5]);
+
+		TS_TRACE(Common::String::format("100000 object ids, 2000000 lookups: HashMap %u ms, FlatHashMap %u ms", idsHashMap, idsFlat).c_str());
+		TS_TRACE(Common::String::format("20000 file names, 500000 case-insensitive lookups: HashMap %u ms, FlatHashMap %u ms", namesHashMap, namesFlat).c_str());
+		TS_TRACE(Common::String::format("50000 keys with a stride of 4096, 500000 lookups: HashMap %u ms, FlatHashMap %u ms", stridedHashMap, stridedFlat).c_str());
+#endif
+	}
+};
@@ -0,0 +1,69 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/framearena.h"
+
+class FrameArenaTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_allocate() {
+		Common::FrameArena arena(1024);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0u);
+
+		byte *a = (byte *)arena.allocate(3);
+		uint32 *b = arena.allocateArray<uint32>(10);
+		double *c = (double *)arena.allocate(sizeof(double), 16);
+		TS_ASSERT(a && b && c);
+		TS_ASSERT_EQUALS((uintptr)b % 4, 0u);
+		TS_ASSERT_EQUALS((uintptr)c % 16, 0u);
+		TS_ASSERT(a + 3 <= (byte *)b);
+		TS_ASSERT((byte *)(b + 10) <= (byte *)c);
+		TS_ASSERT_EQUALS(b[9], 0u);
+		TS_ASSERT_EQUALS(arena.getCapacity(), 1024u);
+	}
+
+	void test_reset_merges_chunks() {
+		Common::FrameArena arena(1024);
+		for (int i = 0; i < 10; ++i)
+			memset(arena.allocate(500), i, 500);
+		// A big allocation gets its own chunk
+		memset(arena.allocate(5000), 0xff, 5000);
+		TS_ASSERT(arena.getUsedSize() >= 10000u);
+		TS_ASSERT(arena.getCapacity() > 1024u);
+
+		// The next frame fits into one chunk
+		const size_t capacity = arena.getCapacity();
+		arena.reset();
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 0u);
+		TS_ASSERT_EQUALS(arena.getCapacity(), capacity);
+
+		byte *first = (byte *)arena.allocate(1);
+		for (int i = 0; i < 10; ++i)
+			arena.allocate(500);
+		byte *last = (byte *)arena.allocate(5000);
+		TS_ASSERT(last > first && last - first < (ptrdiff_t)capacity);
+		TS_ASSERT_EQUALS(arena.getCapacity(), capacity);
+	}
+
+	void test_rewind() {
+		Common::FrameArena arena(256);
+		byte *a = (byte *)arena.allocate(100);
+		const Common::FrameArena::Mark mark = arena.getMark();
+		byte *b = (byte *)arena.allocate(100);
+		arena.allocate(1000);
+		TS_ASSERT(arena.getCapacity() > 256u);
+
+		arena.rewind(mark);
+		TS_ASSERT_EQUALS(arena.getCapacity(), 256u);
+		TS_ASSERT_EQUALS(arena.getUsedSize(), 100u);
+		TS_ASSERT_EQUALS(arena.allocate(100), b);
+		TS_ASSERT(a < b);
+
+		// Rewinding to before the first allocation
+		Common::FrameArena empty;
+		const Common::FrameArena::Mark start = empty.getMark();
+		empty.allocate(10);
+		empty.rewind(start);
+		TS_ASSERT_EQUALS(empty.getCapacity(), 0u);
+		TS_ASSERT(empty.allocate(10));
+	}
+};
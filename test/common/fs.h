@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#include <stdio.h>
+
+class FSNodeTestSuite : public CxxTest::TestSuite {
+	static byte testByte(uint32 i) {
+		return (byte)(i * 7 + (i >> 9));
+	}
+
+	bool writeFile(const char *path, uint32 size) {
+		Common::ScopedPtr<Common::SeekableWriteStream> out(Common::FSNode(path).createWriteStream());
+		if (!out)
+			return false;
+		for (uint32 i = 0; i < size; ++i)
+			out->writeByte(testByte(i));
+		return out->flush() && !out->err();
+	}
+
+	void checkFile(const char *path, uint32 size, bool mapped, bool expectView) {
+		TS_ASSERT(writeFile(path, size));
+
+		Common::FSNode node(path);
+		Common::ScopedPtr<Common::SeekableReadStream> in(mapped ? node.createMappedReadStream() : node.createReadStream());
+		TS_ASSERT(in);
+		if (!in) {
+			remove(path);
+			return;
+		}
+		TS_ASSERT_EQUALS(in->size(), (int64)size);
+
+		int64 fileSize, modTime;
+		bool hasStats = Common::FSNode(path).getFileStats(fileSize, modTime);
+		if (hasStats)
+			TS_ASSERT_EQUALS(fileSize, (int64)size);
+#ifdef POSIX
+		TS_ASSERT(hasStats);
+#endif
+
+		bool same = true;
+		for (uint32 i = 0; i < size && same; ++i)
+			same = in->readByte() == testByte(i);
+		TS_ASSERT(same);
+		in->readByte();
+		TS_ASSERT(in->eos());
+
+		TS_ASSERT(in->seek(size / 2));
+		TS_ASSERT_EQUALS(in->readByte(), testByte(size / 2));
+
+		const byte *view = in->getView(size / 3, size / 3);
+		TS_ASSERT_EQUALS(view != nullptr, expectView);
+		if (view) {
+			for (uint32 i = 0; i < size / 3 && same; ++i)
+				same = view[i] == testByte(size / 3 + i);
+			TS_ASSERT(same);
+			TS_ASSERT(!in->getView(size / 3, size));
+		}
+
+		in.reset();
+		remove(path);
+	}
+
+public:
+	void test_read_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		checkFile("fs_test_small.tmp", 1000, false, false);
+		checkFile("fs_test_small.tmp", 1000, true, false);
+		// Only files opened as read-only data, never save files, are mapped
+		checkFile("fs_test_large.tmp", 300000, false, false);
+#if defined(POSIX) && defined(HAS_MMAP)
+		checkFile("fs_test_large.tmp", 300000, true, true);
+#else
+		checkFile("fs_test_large.tmp", 300000, true, false);
+#endif
+#endif
+	}
+};
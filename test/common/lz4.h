@@ -0,0 +1,214 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/lz4.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/system.h"
+#include "common/zlib.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class LZ4TestSuite : public CxxTest::TestSuite {
+	// Something resembling a game state: repetitive records with a bit of noise
+	static void makeData(Common::Array<byte> &data, uint32 size, uint32 seed) {
+		data.resize(size);
+		for (uint32 i = 0; i < size; ++i) {
+			const uint32 noise = Test::nextSeed(seed);
+			data[i] = (i % 64 < 48) ? (byte)(i / 64 + i % 7) : (byte)(noise >> 16);
+		}
+	}
+
+	static bool roundTrip(const Common::Array<byte> &data) {
+		const uint32 size = data.size();
+		Common::Array<byte> packed(Common::lz4CompressBound(size));
+		const uint32 packedSize = Common::lz4Compress(packed.data(), packed.size(), data.data(), size);
+		if (!packedSize)
+			return false;
+
+		Common::Array<byte> unpacked(size + 1);
+		if (!Common::lz4Decompress(unpacked.data(), size, packed.data(), packedSize))
+			return false;
+		return size == 0 || !memcmp(unpacked.data(), data.data(), size);
+	}
+
+	// Write data in the container, the way save files are written
+	static Common::MemoryReadStream *writeContainer(const Common::Array<byte> &data) {
+		Common::MemoryWriteStreamDynamic *out = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::ScopedPtr<Common::WriteStream> stream(Common::wrapLZ4WriteStream(out));
+		// Odd write sizes, so that writes cross block boundaries
+		for (uint32 i = 0; i < data.size(); i += 1000)
+			stream->write(data.data() + i, MIN<uint32>(1000, data.size() - i));
+		stream->finalize();
+		TS_ASSERT(!stream->err());
+		TS_ASSERT_EQUALS(stream->pos(), (int64)data.size());
+
+		Common::MemoryReadStream *result = new Common::MemoryReadStream(out->getData(), out->size(), DisposeAfterUse::YES);
+		return result;
+	}
+
+public:
+	void test_codec() {
+		Common::Array<byte> data;
+		TS_ASSERT(roundTrip(data));
+
+		const char *text = "abcabcabcabcabcabcabcabcabcabcabcabc";
+		data.resize(strlen(text));
+		memcpy(data.data(), text, data.size());
+		TS_ASSERT(roundTrip(data));
+
+		makeData(data, 200000, 1);
+		TS_ASSERT(roundTrip(data));
+
+		// Long runs, which use overlapping matches and long lengths
+		memset(data.data(), 'x', data.size());
+		TS_ASSERT(roundTrip(data));
+		Common::Array<byte> packed(Common::lz4CompressBound(data.size()));
+		TS_ASSERT_LESS_THAN(Common::lz4Compress(packed.data(), packed.size(), data.data(), data.size()), 1000u);
+
+		// Incompressible data
+		uint32 seed = 7;
+		for (uint i = 0; i < data.size(); ++i) {
+			data[i] = Test::nextSeed(seed) >> 16;
+		}
+		TS_ASSERT(roundTrip(data));
+		TS_ASSERT_EQUALS(Common::lz4Compress(packed.data(), data.size() / 2, data.data(), data.size()), 0u);
+	}
+
+	void test_malformed() {
+		Common::Array<byte> data;
+		makeData(data, 5000, 2);
+		Common::Array<byte> packed(Common::lz4CompressBound(data.size()));
+		const uint32 packedSize = Common::lz4Compress(packed.data(), packed.size(), data.data(), data.size());
+		Common::Array<byte> unpacked(data.size());
+
+		TS_ASSERT(Common::lz4Decompress(unpacked.data(), data.size(), packed.data(), packedSize));
+		TS_ASSERT(!Common::lz4Decompress(unpacked.data(), data.size() - 1, packed.data(), packedSize));
+		TS_ASSERT(!Common::lz4Decompress(unpacked.data(), data.size(), packed.data(), packedSize - 1));
+
+		// Random damage must be detected or at least stay inside the buffers
+		uint32 seed = 3;
+		for (uint i = 0; i < 200; ++i) {
+			Common::Array<byte> damaged(packed);
+			Test::nextSeed(seed);
+			damaged[(seed >> 8) % packedSize] ^= (byte)(seed >> 24) | 1;
+			Common::lz4Decompress(unpacked.data(), data.size(), damaged.data(), packedSize);
+		}
+	}
+
+	void test_container() {
+		Common::Array<byte> data;
+		makeData(data, 300000, 3);
+		Common::MemoryReadStream *file = writeContainer(data);
+		TS_ASSERT_LESS_THAN(file->size(), (int64)data.size() / 2);
+
+		Common::ScopedPtr<Common::SeekableReadStream> in(Common::wrapCompressedReadStream(file));
+		TS_ASSERT(in);
+		if (!in)
+			return;
+		TS_ASSERT_EQUALS(in->size(), (int64)data.size());
+
+		Common::Array<byte> read(data.size());
+		TS_ASSERT_EQUALS(in->read(read.data(), read.size()), read.size());
+		TS_ASSERT(!memcmp(read.data(), data.data(), data.size()));
+		TS_ASSERT(!in->eos());
+		in->readByte();
+		TS_ASSERT(in->eos());
+
+		// Random access in both directions
+		TS_ASSERT(in->seek(-4, SEEK_END));
+		TS_ASSERT(!in->eos());
+		TS_ASSERT_EQUALS(in->readUint32BE(), READ_BE_UINT32(data.data() + data.size() - 4));
+		TS_ASSERT(in->seek(65534, SEEK_SET));
+		TS_ASSERT_EQUALS(in->readUint32BE(), READ_BE_UINT32(data.data() + 65534));
+		TS_ASSERT(in->seek(-100, SEEK_CUR));
+		TS_ASSERT_EQUALS(in->pos(), 65438);
+		TS_ASSERT_EQUALS(in->readByte(), data[65438]);
+		TS_ASSERT(!in->seek(1, SEEK_END));
+		TS_ASSERT(!in->err());
+	}
+
+	void test_container_invalid() {
+		Common::Array<byte> data;
+		makeData(data, 100000, 4);
+		Common::ScopedPtr<Common::MemoryReadStream> file(writeContainer(data));
+
+		// A truncated container is rejected
+		Common::Array<byte> truncated(file->size() - 1);
+		file->read(truncated.data(), truncated.size());
+		TS_ASSERT(!Common::wrapLZ4ReadStream(new Common::MemoryReadStream(truncated.data(), truncated.size())));
+
+		// Damaged blocks are reported as errors
+		Common::Array<byte> damaged(file->size());
+		file->seek(0, SEEK_SET);
+		file->read(damaged.data(), damaged.size());
+		for (uint i = 20; i < 40; ++i)
+			damaged[i] ^= 0x55;
+		Common::ScopedPtr<Common::SeekableReadStream> in(Common::wrapLZ4ReadStream(new Common::MemoryReadStream(damaged.data(), damaged.size())));
+		TS_ASSERT(in);
+		if (in) {
+			in->readUint32LE();
+			TS_ASSERT(in->err());
+		}
+
+		// Other data is passed through
+		byte plain[32];
+		memset(plain, 'S', sizeof(plain));
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(plain, sizeof(plain));
+		TS_ASSERT(!Common::isLZ4Container(stream));
+		Common::ScopedPtr<Common::SeekableReadStream> wrapped(Common::wrapCompressedReadStream(stream));
+		TS_ASSERT_EQUALS(wrapped.get(), stream);
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_ZLIB)
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		// A 1 MB save with its metadata at the end, the way the save dialogs
+		// read it
+		Common::Array<byte> data;
+		makeData(data, 1 << 20, 5);
+
+		uint32 start = g_system->getMillis();
+		Common::MemoryWriteStreamDynamic *gzipFile = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::ScopedPtr<Common::WriteStream> gzip(Common::wrapCompressedWriteStream(gzipFile));
+		gzip->write(data.data(), data.size());
+		gzip->finalize();
+		const uint32 gzipSize = gzipFile->size();
+		Common::SharedPtr<byte> gzipData(gzipFile->getData(), free);
+		gzip.reset();
+		const uint32 gzipWrite = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		Common::ScopedPtr<Common::MemoryReadStream> lz4File(writeContainer(data));
+		const uint32 lz4Write = g_system->getMillis() - start;
+
+		uint32 readTimes[2];
+		uint32 checksums[2] = { 0, 0 };
+		for (int format = 0; format < 2; ++format) {
+			start = g_system->getMillis();
+			for (int save = 0; save < 20; ++save) {
+				Common::SeekableReadStream *file;
+				if (format == 0) {
+					file = new Common::MemoryReadStream(gzipData.get(), gzipSize);
+				} else {
+					lz4File->seek(0, SEEK_SET);
+					file = new Common::SeekableSubReadStream(lz4File.get(), 0, lz4File->size());
+				}
+				Common::ScopedPtr<Common::SeekableReadStream> in(Common::wrapCompressedReadStream(file));
+				in->seek(-40000, SEEK_END);
+				for (int i = 0; i < 10000; ++i)
+					checksums[format] += in->readUint32LE();
+			}
+			readTimes[format] = g_system->getMillis() - start;
+		}
+		TS_ASSERT_EQUALS(checksums[0], checksums[1]);
+
+		TS_TRACE(Common::String::format("1 MB save: gzip %u bytes, written in %u ms; LZ4 %u bytes, written in %u ms", gzipSize, gzipWrite, (uint32)lz4File->size(), lz4Write).c_str());
+		TS_TRACE(Common::String::format("Reading the metadata of 20 saves: gzip %u ms, LZ4 %u ms", readTimes[0], readTimes[1]).c_str());
+#endif
+	}
+};
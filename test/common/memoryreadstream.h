@@ -104,4 +104,20 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_view() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		ms.seek(2);
+
+		TS_ASSERT_EQUALS(ms.getView(0, 7), contents);
+		TS_ASSERT_EQUALS(ms.getView(3, 4), contents + 3);
+		TS_ASSERT_EQUALS(ms.getView(7, 0), contents + 7);
+		TS_ASSERT(!ms.getView(3, 5));
+		TS_ASSERT(!ms.getView(8, 0));
+		TS_ASSERT(!ms.getView(-1, 1));
+
+		// The position is not changed
+		TS_ASSERT_EQUALS(ms.pos(), 2);
+	}
 };
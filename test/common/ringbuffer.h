@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/ringbuffer.h"
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+
+class RingBufferTestSuite : public CxxTest::TestSuite {
+	struct ThreadData {
+		Common::SPSCRingBuffer<uint32> *buffer;
+		uint32 count;
+	};
+
+	static void producer(void *data) {
+		ThreadData *threadData = (ThreadData *)data;
+
+		uint32 next = 0;
+		while (next < threadData->count) {
+			uint32 chunk[7];
+			uint32 count = MIN<uint32>(ARRAYSIZE(chunk), threadData->count - next);
+			for (uint32 i = 0; i < count; ++i)
+				chunk[i] = next + i;
+
+			next += threadData->buffer->write(chunk, count);
+		}
+	}
+
+public:
+	void test_capacity() {
+		Common::SPSCRingBuffer<int> buffer(100);
+		TS_ASSERT_EQUALS(buffer.capacity(), 128u);
+		TS_ASSERT_EQUALS(buffer.size(), 0u);
+		TS_ASSERT_EQUALS(buffer.space(), 128u);
+	}
+
+	void test_write_read() {
+		Common::SPSCRingBuffer<int> buffer(8);
+		int data[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+		int out[10];
+
+		TS_ASSERT_EQUALS(buffer.write(data, 10), 8u);
+		TS_ASSERT_EQUALS(buffer.space(), 0u);
+
+		TS_ASSERT_EQUALS(buffer.read(out, 3), 3u);
+		TS_ASSERT_EQUALS(out[0], 1);
+		TS_ASSERT_EQUALS(out[2], 3);
+
+		// This wraps around the end of the storage
+		TS_ASSERT_EQUALS(buffer.write(data + 8, 2), 2u);
+		TS_ASSERT_EQUALS(buffer.read(out, 10), 7u);
+		for (int i = 0; i < 7; ++i)
+			TS_ASSERT_EQUALS(out[i], i + 4);
+
+		TS_ASSERT_EQUALS(buffer.size(), 0u);
+		TS_ASSERT_EQUALS(buffer.read(out, 1), 0u);
+	}
+
+	void test_write_buffer() {
+		Common::SPSCRingBuffer<int> buffer(8);
+		int out[8];
+
+		uint32 count;
+		int *dst = buffer.getWriteBuffer(count);
+		TS_ASSERT_EQUALS(count, 8u);
+		dst[0] = 42;
+		buffer.commitWrite(6);
+		TS_ASSERT_EQUALS(buffer.read(out, 4), 4u);
+		TS_ASSERT_EQUALS(out[0], 42);
+
+		// Only the part up to the end of the storage is contiguous
+		buffer.getWriteBuffer(count);
+		TS_ASSERT_EQUALS(count, 2u);
+		TS_ASSERT_EQUALS(buffer.space(), 6u);
+
+		buffer.clear();
+		TS_ASSERT_EQUALS(buffer.size(), 0u);
+	}
+
+	void test_discard() {
+		Common::SPSCRingBuffer<int> buffer(8);
+		int data[6] = { 1, 2, 3, 4, 5, 6 };
+		int out[8];
+
+		buffer.write(data, 4);
+		const uint32 position = buffer.getWritePosition();
+		buffer.write(data + 4, 2);
+
+		TS_ASSERT_EQUALS(buffer.read(out, 1), 1u);
+		buffer.discardUntil(position);
+		TS_ASSERT_EQUALS(buffer.size(), 2u);
+		TS_ASSERT_EQUALS(buffer.read(out, 8), 2u);
+		TS_ASSERT_EQUALS(out[0], 5);
+
+		// Nothing happens if the elements have been read already
+		buffer.write(data, 3);
+		buffer.discardUntil(position);
+		TS_ASSERT_EQUALS(buffer.size(), 3u);
+	}
+
+	void test_threaded() {
+		Common::install_null_g_system();
+
+		Common::SPSCRingBuffer<uint32> buffer(64);
+		ThreadData data;
+		data.buffer = &buffer;
+		data.count = 100000;
+
+		Common::Thread thread;
+		if (!thread.start(producer, &data, "test producer")) {
+			TS_TRACE("Threads are not supported, skipping");
+			return;
+		}
+
+		uint32 expected = 0;
+		bool ordered = true;
+		while (expected < data.count) {
+			uint32 out[5];
+			const uint32 count = buffer.read(out, ARRAYSIZE(out));
+			for (uint32 i = 0; i < count; ++i)
+				ordered &= (out[i] == expected++);
+		}
+
+		thread.join();
+		TS_ASSERT(ordered);
+		TS_ASSERT_EQUALS(buffer.size(), 0u);
+	}
+};
@@ -0,0 +1,163 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/sharedbuffer.h"
+#include "common/unzip.h"
+
+class SharedBufferTestSuite : public CxxTest::TestSuite {
+	static Common::SharedBufferPtr makeBuffer(uint32 size, byte value) {
+		byte *data = (byte *)malloc(size);
+		memset(data, value, size);
+		return Common::SharedBufferPtr(new Common::SharedBuffer(data, size));
+	}
+
+	// Append a stored member to a zip file and its central directory
+	static void writeZipMember(Common::MemoryWriteStreamDynamic &zip, Common::MemoryWriteStreamDynamic &dir, const char *name, const char *contents) {
+		const uint32 offset = zip.pos();
+		const uint32 nameLength = strlen(name);
+		const uint32 size = strlen(contents);
+		Common::CRC32 crc;
+		crc.init();
+		const uint32 checksum = crc.crcFast((const byte *)contents, size);
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(10); // version
+		zip.writeUint16LE(0);  // flags
+		zip.writeUint16LE(0);  // stored
+		zip.writeUint32LE(0);  // date/time
+		zip.writeUint32LE(checksum);
+		zip.writeUint32LE(size);
+		zip.writeUint32LE(size);
+		zip.writeUint16LE(nameLength);
+		zip.writeUint16LE(0);
+		zip.write(name, nameLength);
+		zip.write(contents, size);
+
+		dir.writeUint32LE(0x02014b50);
+		dir.writeUint16LE(10);
+		dir.writeUint16LE(10);
+		dir.writeUint16LE(0);
+		dir.writeUint16LE(0);
+		dir.writeUint32LE(0);
+		dir.writeUint32LE(checksum);
+		dir.writeUint32LE(size);
+		dir.writeUint32LE(size);
+		dir.writeUint16LE(nameLength);
+		dir.writeUint16LE(0); // extra field
+		dir.writeUint16LE(0); // comment
+		dir.writeUint16LE(0); // disk
+		dir.writeUint16LE(0); // internal attributes
+		dir.writeUint32LE(0); // external attributes
+		dir.writeUint32LE(offset);
+		dir.write(name, nameLength);
+	}
+
+public:
+	void test_stream_keeps_buffer() {
+		Common::SharedBufferPtr buffer = makeBuffer(16, 7);
+		Common::SeekableReadStream *stream = new Common::SharedBufferReadStream(buffer, 4, 12);
+		const byte *data = buffer->getData();
+		buffer.reset();
+
+		TS_ASSERT_EQUALS(stream->size(), 8);
+		TS_ASSERT_EQUALS(stream->getView(0, 8), data + 4);
+		TS_ASSERT_EQUALS(stream->readByte(), 7);
+		delete stream;
+	}
+
+	void test_create_from_stream() {
+		byte contents[] = { 1, 2, 3, 4 };
+		Common::MemoryReadStream *stream = new Common::MemoryReadStream(contents, sizeof(contents));
+		Common::SharedBufferPtr buffer(Common::SharedBuffer::createFromStream(stream, DisposeAfterUse::YES));
+
+		TS_ASSERT(buffer);
+		TS_ASSERT_EQUALS(buffer->getData(), contents);
+		TS_ASSERT_EQUALS(buffer->getSize(), sizeof(contents));
+
+		// Streams which are not in memory can not be shared
+		Common::MemoryReadWriteStream other(DisposeAfterUse::YES);
+		other.writeUint32LE(0);
+		TS_ASSERT(!Common::SharedBuffer::createFromStream(&other, DisposeAfterUse::NO));
+	}
+
+	void test_cache() {
+		Common::SharedBufferCache cache(400);
+		Common::SharedBufferPtr a = makeBuffer(100, 1);
+		Common::SharedBufferPtr b = makeBuffer(100, 2);
+		Common::SharedBufferPtr c = makeBuffer(100, 3);
+
+		cache.put("a", a);
+		cache.put("b", b);
+		cache.put("c", c);
+		TS_ASSERT_EQUALS(cache.getSize(), 300u);
+		TS_ASSERT_EQUALS(cache.get("A").get(), a.get());
+
+		// "b" is the least recently used now
+		cache.put("d", makeBuffer(100, 4));
+		cache.put("e", makeBuffer(100, 5));
+		TS_ASSERT(!cache.get("b"));
+		TS_ASSERT(cache.get("a"));
+		TS_ASSERT(cache.get("c"));
+		TS_ASSERT_EQUALS(cache.getSize(), 400u);
+
+		// Dropped buffers stay alive as long as they are used
+		TS_ASSERT_EQUALS(b->getData()[0], 2);
+
+		// Too big to be cached
+		cache.put("f", makeBuffer(101, 6));
+		TS_ASSERT(!cache.get("f"));
+
+		// Replacing an entry
+		cache.put("a", b);
+		TS_ASSERT_EQUALS(cache.get("a").get(), b.get());
+		TS_ASSERT_EQUALS(cache.getSize(), 400u);
+
+		cache.clear();
+		TS_ASSERT(!cache.get("a"));
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+	}
+
+	void test_zip_views() {
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		Common::MemoryWriteStreamDynamic dir(DisposeAfterUse::YES);
+		writeZipMember(zip, dir, "first.txt", "Hello");
+		writeZipMember(zip, dir, "second.txt", "World!");
+
+		const uint32 dirOffset = zip.pos();
+		zip.write(dir.getData(), dir.size());
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(2);
+		zip.writeUint16LE(2);
+		zip.writeUint32LE(dir.size());
+		zip.writeUint32LE(dirOffset);
+		zip.writeUint16LE(0);
+
+		const byte *zipData = zip.getData();
+		const uint32 zipSize = zip.size();
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zipData, zipSize, DisposeAfterUse::YES));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::SeekableReadStream *first = archive->createReadStreamForMember("first.txt");
+		Common::SeekableReadStream *second = archive->createReadStreamForMember("SECOND.TXT");
+		TS_ASSERT(first && second);
+		delete archive;
+
+		// The members are views into the zip file, which they keep alive
+		if (first) {
+			TS_ASSERT_EQUALS(first->size(), 5);
+			const byte *view = first->getView(0, 5);
+			TS_ASSERT(view >= zipData && view + 5 <= zipData + zipSize);
+			TS_ASSERT_SAME_DATA(view, "Hello", 5);
+		}
+		if (second)
+			TS_ASSERT_EQUALS(second->readString(0, 6), "World!");
+
+		delete first;
+		delete second;
+	}
+};
@@ -0,0 +1,126 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/thread.h"
+
+#ifdef HAS_THREAD_LOCAL
+#include "common/smallalloc.h"
+#endif
+
+#include "../null_osystem.h"
+
+// The allocator is only built where configure found thread_local support
+class SmallAllocTestSuite : public CxxTest::TestSuite {
+#ifdef HAS_THREAD_LOCAL
+	enum {
+		kObjectsPerTask = 500
+	};
+
+	struct TaskData {
+		uint32 *objects[8][kObjectsPerTask];
+		bool ok[8];
+	};
+
+	static uint objectSize(uint i) {
+		return 4 + (i * 12) % 240;
+	}
+
+	// Allocate and fill a set of objects, then check that no other task
+	// overwrote them, as it would if two threads got the same object
+	static void task(void *data, uint index) {
+		TaskData *taskData = (TaskData *)data;
+		bool ok = true;
+		for (uint i = 0; i < kObjectsPerTask; ++i) {
+			uint32 *object = (uint32 *)Common::allocSmallObject(objectSize(i));
+			for (uint j = 0; j < objectSize(i) / 4; ++j)
+				object[j] = index * 100000 + i;
+			taskData->objects[index][i] = object;
+		}
+		for (uint i = 0; i < kObjectsPerTask; ++i) {
+			const uint32 *object = taskData->objects[index][i];
+			for (uint j = 0; j < objectSize(i) / 4; ++j)
+				ok = ok && object[j] == index * 100000 + i;
+		}
+		taskData->ok[index] = ok;
+	}
+
+	static uint sizeClassOf(size_t size) {
+		for (uint i = 0; i < Common::getSmallObjectSizeClasses(); ++i) {
+			if (Common::getSmallObjectStats(i).objectSize >= size)
+				return i;
+		}
+		return 0;
+	}
+#endif
+
+public:
+	void test_reuse() {
+#ifdef HAS_THREAD_LOCAL
+		// Freed objects are handed out again first
+		void *a = Common::allocSmallObject(20);
+		Common::freeSmallObject(a, 20);
+		void *b = Common::allocSmallObject(17);
+		TS_ASSERT_EQUALS(a, b);
+		Common::freeSmallObject(b, 17);
+
+		// Objects of different sizes do not overlap
+		byte *small = (byte *)Common::allocSmallObject(8);
+		byte *big = (byte *)Common::allocSmallObject(200);
+		byte *huge = (byte *)Common::allocSmallObject(Common::kSmallObjectMaxSize + 1);
+		memset(small, 1, 8);
+		memset(big, 2, 200);
+		memset(huge, 3, Common::kSmallObjectMaxSize + 1);
+		TS_ASSERT_EQUALS(small[7], 1);
+		TS_ASSERT_EQUALS(big[199], 2);
+		Common::freeSmallObject(small, 8);
+		Common::freeSmallObject(big, 200);
+		Common::freeSmallObject(huge, Common::kSmallObjectMaxSize + 1);
+#endif
+	}
+
+	void test_stats() {
+#ifdef HAS_THREAD_LOCAL
+		const uint sizeClass = sizeClassOf(100);
+		const Common::SmallObjectStats before = Common::getSmallObjectStats(sizeClass);
+		TS_ASSERT(before.objectSize >= 100);
+
+		void *objects[1000];
+		for (int i = 0; i < 1000; ++i)
+			objects[i] = Common::allocSmallObject(100);
+		const Common::SmallObjectStats during = Common::getSmallObjectStats(sizeClass);
+		for (int i = 0; i < 1000; ++i)
+			Common::freeSmallObject(objects[i], 100);
+		const Common::SmallObjectStats after = Common::getSmallObjectStats(sizeClass);
+
+		TS_ASSERT_EQUALS(during.allocCount - before.allocCount, 1000u);
+		TS_ASSERT_EQUALS(during.liveCount, before.liveCount + 1000);
+		TS_ASSERT(during.peakLiveCount >= during.liveCount);
+		TS_ASSERT(during.reservedBytes >= 1000 * during.objectSize);
+		TS_ASSERT_EQUALS(after.freeCount - before.freeCount, 1000u);
+		TS_ASSERT_EQUALS(after.liveCount, before.liveCount);
+#endif
+	}
+
+	void test_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(HAS_THREAD_LOCAL)
+		Common::install_null_g_system();
+		Common::WorkerPool pool(3, "SmallAlloc");
+		TaskData data;
+
+		for (int run = 0; run < 5; ++run) {
+			memset(data.ok, 0, sizeof(data.ok));
+			pool.run(task, &data, ARRAYSIZE(data.ok));
+
+			for (uint i = 0; i < ARRAYSIZE(data.ok); ++i)
+				TS_ASSERT(data.ok[i]);
+
+			// Free the objects of all workers on this thread, which moves
+			// them through its cache back to the shared lists
+			for (uint i = 0; i < ARRAYSIZE(data.ok); ++i) {
+				for (uint j = 0; j < kObjectsPerTask; ++j)
+					Common::freeSmallObject(data.objects[i][j], objectSize(j));
+			}
+		}
+#endif
+	}
+};
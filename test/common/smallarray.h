@@ -0,0 +1,98 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/smallarray.h"
+#include "common/str.h"
+
+class SmallArrayTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_inline_storage() {
+		Common::SmallArray<int, 4> array;
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+
+		for (int i = 0; i < 4; ++i)
+			array.push_back(i * 10);
+		TS_ASSERT(array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 4u);
+
+		// Growing beyond the inline capacity moves the elements to the heap
+		array.push_back(array[0]);
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array.size(), 5u);
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT_EQUALS(array[i], i * 10);
+		TS_ASSERT_EQUALS(array.back(), 0);
+
+		array.clear();
+		TS_ASSERT(array.empty());
+		TS_ASSERT(array.isInline());
+	}
+
+	void test_insert_remove() {
+		Common::SmallArray<Common::String, 3> array;
+		array.push_back("b");
+		array.insert_at(0, "a");
+		array.insert_at(2, "d");
+		TS_ASSERT(array.isInline());
+		array.insert_at(2, "c");
+		TS_ASSERT(!array.isInline());
+		array.insert(array.begin(), array[3]);
+
+		TS_ASSERT_EQUALS(array.size(), 5u);
+		TS_ASSERT_EQUALS(array[0], "d");
+		TS_ASSERT_EQUALS(array[1], "a");
+		TS_ASSERT_EQUALS(array[2], "b");
+		TS_ASSERT_EQUALS(array[3], "c");
+		TS_ASSERT_EQUALS(array[4], "d");
+
+		TS_ASSERT_EQUALS(array.remove_at(1), "a");
+		array.erase(array.begin());
+		array.pop_back();
+		TS_ASSERT_EQUALS(array.size(), 2u);
+		TS_ASSERT_EQUALS(array.front(), "b");
+		TS_ASSERT_EQUALS(array.back(), "c");
+	}
+
+	void test_copy_move() {
+		Common::SmallArray<Common::String, 2> small = { "one", "two" };
+		Common::SmallArray<Common::String, 2> big = { "one", "two", "three" };
+		TS_ASSERT(small.isInline());
+		TS_ASSERT(!big.isInline());
+
+		Common::SmallArray<Common::String, 2> copy(big);
+		TS_ASSERT(copy == big);
+		copy = small;
+		TS_ASSERT(copy == small);
+		TS_ASSERT(copy != big);
+
+		// Heap storage is taken over, inline elements are copied
+		const Common::String *bigData = big.data();
+		Common::SmallArray<Common::String, 2> moved(static_cast<Common::SmallArray<Common::String, 2> &&>(big));
+		TS_ASSERT_EQUALS(moved.data(), bigData);
+		TS_ASSERT(big.empty());
+		TS_ASSERT(big.isInline());
+
+		moved = static_cast<Common::SmallArray<Common::String, 2> &&>(small);
+		TS_ASSERT(moved.isInline());
+		TS_ASSERT_EQUALS(moved.size(), 2u);
+		TS_ASSERT_EQUALS(moved[1], "two");
+		TS_ASSERT(small.empty());
+	}
+
+	void test_resize() {
+		Common::SmallArray<int, 8> array(3, 7);
+		TS_ASSERT(array.isInline());
+		array.resize(10);
+		TS_ASSERT(!array.isInline());
+		TS_ASSERT_EQUALS(array[2], 7);
+		TS_ASSERT_EQUALS(array[9], 0);
+		array.resize(1);
+		TS_ASSERT_EQUALS(array.size(), 1u);
+
+		int sum = 0;
+		for (Common::SmallArray<int, 8>::const_iterator i = array.begin(); i != array.end(); ++i)
+			sum += *i;
+		TS_ASSERT_EQUALS(sum, 7);
+	}
+};
@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/stringbuilder.h"
+
+class StringBuilderTestSuite : public CxxTest::TestSuite {
+public:
+	void test_append() {
+		Common::StringBuilder str;
+		TS_ASSERT(str.empty());
+		TS_ASSERT_EQUALS(str.c_str()[0], 0);
+
+		str += "Hello";
+		str += ',';
+		str.append(Common::String(" world"));
+		str.append("!!!", 1);
+		TS_ASSERT_EQUALS(Common::String(str.c_str()), "Hello, world!");
+		TS_ASSERT_EQUALS(str.size(), 13u);
+		TS_ASSERT_EQUALS(str.lastChar(), '!');
+
+		str.truncate(5);
+		TS_ASSERT_EQUALS(str.toString(), "Hello");
+		str.clear();
+		TS_ASSERT(str.empty());
+	}
+
+	void test_self_append() {
+		Common::StringBuilder str;
+		str += "abc";
+		str.append(str.c_str(), str.size());
+		TS_ASSERT_EQUALS(str.toString(), "abcabc");
+
+		// Past the built-in storage, so that the text is reallocated while
+		// it is being appended
+		Common::String expected = "abcabc";
+		for (int i = 0; i < 8; ++i) {
+			str.append(str.c_str(), str.size());
+			expected += expected;
+		}
+		TS_ASSERT_EQUALS(str.toString(), expected);
+
+		str.append(str.c_str() + 2, 3);
+		expected += "cab";
+		TS_ASSERT_EQUALS(str.toString(), expected);
+	}
+
+	void test_growth() {
+		Common::StringBuilder str;
+		Common::String expected;
+		for (int i = 0; i < 1000; ++i) {
+			str.append("0123456789");
+			expected += "0123456789";
+		}
+		TS_ASSERT_EQUALS(str.size(), 10000u);
+		TS_ASSERT_EQUALS(str.toString(), expected);
+
+		// The text may be appended to itself
+		str.truncate(10);
+		str.append(str.c_str(), str.size());
+		TS_ASSERT_EQUALS(str.toString(), "01234567890123456789");
+	}
+
+	void test_format() {
+		Common::StringBuilder str;
+		str.appendFormat("%d-%s", 42, "abc");
+		const char *builtin = str.c_str();
+		str.appendFormat("%c", 'x');
+		TS_ASSERT_EQUALS(str.toString(), "42-abcx");
+		// Short texts need no memory of their own
+		TS_ASSERT_EQUALS(str.c_str(), builtin);
+
+		// Longer than the built-in storage
+		Common::String longText;
+		for (int i = 0; i < 300; ++i)
+			longText += ' ';
+		str.appendFormat("[%s]", longText.c_str());
+		TS_ASSERT_EQUALS(str.size(), 7u + 302u);
+		TS_ASSERT_EQUALS(str.lastChar(), ']');
+		TS_ASSERT_EQUALS(str.toString(), Common::String::format("42-abcx[%s]", longText.c_str()));
+	}
+
+	void test_rope() {
+		Common::StringRope rope(256);
+		TS_ASSERT(rope.empty());
+		TS_ASSERT_EQUALS(rope.toString(), "");
+
+		Common::String expected;
+		for (int i = 0; i < 100; ++i) {
+			rope.appendFormat("line %d\n", i);
+			expected += Common::String::format("line %d\n", i);
+		}
+		rope += "";
+		TS_ASSERT_EQUALS(rope.size(), expected.size());
+		TS_ASSERT_EQUALS(rope.toString(), expected);
+
+		// Appends within an arena chunk are merged
+		TS_ASSERT(rope.getPieceCount() <= expected.size() / 256 + 1);
+
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		TS_ASSERT(rope.write(stream));
+		TS_ASSERT_EQUALS(stream.size(), expected.size());
+		TS_ASSERT_EQUALS(Common::String((const char *)stream.getData(), stream.size()), expected);
+
+		rope.clear();
+		TS_ASSERT(rope.empty());
+		rope += 'a';
+		rope += Common::String("b");
+		TS_ASSERT_EQUALS(rope.toString(), "ab");
+		TS_ASSERT_EQUALS(rope.getPieceCount(), 1u);
+	}
+};
@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class ThreadTestSuite : public CxxTest::TestSuite {
+	struct TaskData {
+		uint32 results[100];
+		uint32 calls[100];
+	};
+
+	static void task(void *data, uint index) {
+		TaskData *taskData = (TaskData *)data;
+
+		// Enough work for the workers to pick up some of the tasks
+		uint32 value = index;
+		for (int i = 0; i < 10000; ++i)
+			Test::nextSeed(value);
+
+		taskData->results[index] = value;
+		taskData->calls[index]++;
+	}
+
+	static uint32 expectedResult(uint index) {
+		uint32 value = index;
+		for (int i = 0; i < 10000; ++i)
+			Test::nextSeed(value);
+		return value;
+	}
+
+	void checkPool(Common::WorkerPool &pool) {
+		TaskData data;
+
+		// Run more than once to check that the workers go back to waiting
+		for (int run = 0; run < 3; ++run) {
+			memset(&data, 0, sizeof(data));
+			pool.run(task, &data, ARRAYSIZE(data.results));
+
+			for (uint i = 0; i < ARRAYSIZE(data.results); ++i) {
+				TS_ASSERT_EQUALS(data.calls[i], 1u);
+				TS_ASSERT_EQUALS(data.results[i], expectedResult(i));
+			}
+		}
+
+		// Fewer tasks than workers
+		memset(&data, 0, sizeof(data));
+		pool.run(task, &data, 2);
+		TS_ASSERT_EQUALS(data.calls[0], 1u);
+		TS_ASSERT_EQUALS(data.calls[1], 1u);
+		TS_ASSERT_EQUALS(data.calls[2], 0u);
+
+		pool.run(task, &data, 0);
+		TS_ASSERT_EQUALS(data.calls[0], 1u);
+	}
+
+public:
+	void test_worker_pool() {
+		Common::install_null_g_system();
+
+		Common::WorkerPool pool(3, "test worker");
+		if (!pool.getNumWorkers())
+			TS_TRACE("Threads are not supported, only testing the serial path");
+		checkPool(pool);
+	}
+
+	void test_worker_pool_without_workers() {
+		Common::install_null_g_system();
+
+		Common::WorkerPool pool(0, "test worker");
+		TS_ASSERT_EQUALS(pool.getNumWorkers(), 0u);
+		checkPool(pool);
+	}
+
+	void test_default_num_workers() {
+		Common::install_null_g_system();
+
+		// One core stays with the caller
+		const uint cpus = g_system->getCPUCount();
+		TS_ASSERT(cpus >= 1);
+		TS_ASSERT_EQUALS(Common::WorkerPool::getDefaultNumWorkers(1000), cpus - 1);
+		TS_ASSERT(Common::WorkerPool::getDefaultNumWorkers(4) <= 4);
+		TS_ASSERT_EQUALS(Common::WorkerPool::getDefaultNumWorkers(0), 0u);
+	}
+};
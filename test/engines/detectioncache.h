@@ -0,0 +1,149 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/detectioncache.h"
+
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#include <stdio.h>
+#ifdef POSIX
+#include <utime.h>
+#endif
+
+class DetectionCacheTestSuite : public CxxTest::TestSuite {
+	static bool writeFile(const char *path, uint32 size, byte value) {
+		Common::ScopedPtr<Common::SeekableWriteStream> out(Common::FSNode(path).createWriteStream());
+		if (!out)
+			return false;
+		for (uint32 i = 0; i < size; ++i)
+			out->writeByte(value);
+		return out->flush() && !out->err();
+	}
+
+	static FileProperties makeProps(int64 size, const char *md5) {
+		FileProperties props;
+		props.size = size;
+		props.md5 = md5;
+		return props;
+	}
+
+	// Save the cache and load it into a new one, like on the next start
+	static void reload(DetectionCache &from, DetectionCache &to) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		from.saveTo(out);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(to.loadFrom(in));
+	}
+
+public:
+	void test_save_and_reload() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX)
+		Common::install_null_g_system();
+		const char *const kPath = "detection_cache_test.tmp";
+		TS_ASSERT(writeFile(kPath, 1000, 1));
+		const Common::FSNode node(kPath);
+
+		DetectionCache cache;
+		cache.set(node, 'f', 5000, makeProps(1000, "0123456789abcdef0123456789abcdef"));
+		cache.set(node, 't', 5000, makeProps(1000, "fedcba9876543210fedcba9876543210"));
+
+		DetectionCache reloaded;
+		reload(cache, reloaded);
+
+		FileProperties props;
+		TS_ASSERT(reloaded.get(node, 'f', 5000, props));
+		TS_ASSERT_EQUALS(props.size, 1000);
+		TS_ASSERT_EQUALS(props.md5, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT(reloaded.get(node, 't', 5000, props));
+		TS_ASSERT_EQUALS(props.md5, "fedcba9876543210fedcba9876543210");
+
+		// The MD5 kind and length are part of the key
+		TS_ASSERT(!reloaded.get(node, 'f', 0, props));
+		TS_ASSERT(!reloaded.get(node, 'r', 5000, props));
+		TS_ASSERT(!reloaded.get(Common::FSNode("detection_cache_other.tmp"), 'f', 5000, props));
+
+		remove(kPath);
+#endif
+	}
+
+	void test_unknown_version() {
+		byte data[] = { 'D', 'T', 'C', 'H', 99, 0, 0, 0, 0, 0, 0, 0 };
+		Common::MemoryReadStream in(data, sizeof(data));
+		DetectionCache cache;
+		TS_ASSERT(!cache.loadFrom(in));
+	}
+
+	void test_invalidate_on_size_change() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX)
+		Common::install_null_g_system();
+		const char *const kPath = "detection_cache_test.tmp";
+		TS_ASSERT(writeFile(kPath, 1000, 1));
+		const Common::FSNode node(kPath);
+
+		DetectionCache cache;
+		cache.set(node, 'f', 5000, makeProps(1000, "0123456789abcdef0123456789abcdef"));
+
+		// Still valid with the same size and modification time
+		int64 size, modTime;
+		TS_ASSERT(node.getFileStats(size, modTime));
+		TS_ASSERT(writeFile(kPath, 1000, 2));
+		struct utimbuf times;
+		times.actime = modTime;
+		times.modtime = modTime;
+		TS_ASSERT_EQUALS(utime(kPath, &times), 0);
+
+		DetectionCache reloaded;
+		reload(cache, reloaded);
+		FileProperties props;
+		TS_ASSERT(reloaded.get(node, 'f', 5000, props));
+
+		TS_ASSERT(writeFile(kPath, 1200, 2));
+		TS_ASSERT_EQUALS(utime(kPath, &times), 0);
+		TS_ASSERT(!reloaded.get(node, 'f', 5000, props));
+
+		remove(kPath);
+#endif
+	}
+
+	void test_invalidate_on_mtime_change() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX)
+		Common::install_null_g_system();
+		const char *const kPath = "detection_cache_test.tmp";
+		TS_ASSERT(writeFile(kPath, 1000, 1));
+		const Common::FSNode node(kPath);
+
+		DetectionCache cache;
+		cache.set(node, 'f', 5000, makeProps(1000, "0123456789abcdef0123456789abcdef"));
+
+		DetectionCache reloaded;
+		reload(cache, reloaded);
+
+		// Same size, but modified a minute earlier
+		int64 size, modTime;
+		TS_ASSERT(node.getFileStats(size, modTime));
+		struct utimbuf times;
+		times.actime = modTime - 60;
+		times.modtime = modTime - 60;
+		TS_ASSERT_EQUALS(utime(kPath, &times), 0);
+
+		FileProperties props;
+		TS_ASSERT(!reloaded.get(node, 'f', 5000, props));
+
+		// Storing the new properties makes the entry valid again
+		reloaded.set(node, 'f', 5000, makeProps(1000, "00000000000000000000000000000000"));
+		TS_ASSERT(reloaded.get(node, 'f', 5000, props));
+		TS_ASSERT_EQUALS(props.md5, "00000000000000000000000000000000");
+
+		DetectionCache updated;
+		reload(reloaded, updated);
+		TS_ASSERT(updated.get(node, 'f', 5000, props));
+		TS_ASSERT_EQUALS(props.md5, "00000000000000000000000000000000");
+
+		remove(kPath);
+#endif
+	}
+};
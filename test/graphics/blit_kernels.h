@@ -0,0 +1,230 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/blit_kernels.h"
+#include "graphics/managed_surface.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class BlitKernelsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxLength = 71, // deliberately not a multiple of any vector width
+		kWidth = 53,
+		kHeight = 17
+	};
+
+	// Mostly opaque or transparent runs, with the odd translucent pixel
+	static uint32 randomPixel(uint32 &seed, const Graphics::PixelFormat &format) {
+		const uint32 r = Test::nextRandom(seed);
+		byte a;
+		switch ((r >> 20) & 7) {
+		case 0:
+			a = r & 0xff;
+			break;
+		case 1:
+		case 2:
+			a = 0;
+			break;
+		default:
+			a = 0xff;
+			break;
+		}
+		return format.ARGBToColor(a, r & 0xff, (r >> 8) & 0xff, (r >> 16) & 0xff);
+	}
+
+	static Graphics::PixelFormat rgba() {
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+
+	void checkKeyBlit(Graphics::KeyBlitFunc func) {
+		byte src[kMaxLength], ref[kMaxLength], dst[kMaxLength];
+		uint32 seed = 1;
+
+		for (uint len = 0; len <= kMaxLength; ++len) {
+			for (uint i = 0; i < kMaxLength; ++i) {
+				// Keep a few fully keyed and fully opaque runs
+				src[i] = (len & 3) == 0 ? 7 : ((len & 3) == 1 ? 9 : Test::nextRandom(seed) % 12);
+				ref[i] = dst[i] = Test::nextRandom(seed) & 0xff;
+			}
+
+			Graphics::keyBlit(ref, src, len, 7);
+			func(dst, src, len, 7);
+			TS_ASSERT_EQUALS(memcmp(ref, dst, sizeof(dst)), 0);
+		}
+	}
+
+	void checkPaletteBlit(Graphics::PaletteBlitFunc func) {
+		Graphics::PaletteBlitMap map;
+		uint32 palette[256];
+		byte src[kMaxLength];
+		uint32 ref[kMaxLength], dst[kMaxLength];
+		uint32 seed = 2;
+
+		for (uint i = 0; i < 256; ++i)
+			palette[i] = (Test::nextRandom(seed) & 0xffffff) | ((i % 5) ? 0xff000000 : 0);
+		TS_ASSERT(Graphics::buildPaletteBlitMap(map, palette, rgba()));
+
+		for (uint len = 0; len <= kMaxLength; ++len) {
+			for (uint i = 0; i < kMaxLength; ++i) {
+				src[i] = Test::nextRandom(seed) & 0xff;
+				ref[i] = dst[i] = Test::nextRandom(seed);
+			}
+
+			Graphics::paletteBlit(ref, src, len, map);
+			func(dst, src, len, map);
+			TS_ASSERT_EQUALS(memcmp(ref, dst, sizeof(dst)), 0);
+		}
+	}
+
+	void checkAlphaBlit(Graphics::AlphaBlitFunc func, const Graphics::PixelFormat &format) {
+		uint32 src[kMaxLength], ref[kMaxLength], dst[kMaxLength];
+		uint32 seed = 3;
+
+		for (uint len = 0; len <= kMaxLength; ++len) {
+			for (uint i = 0; i < kMaxLength; ++i) {
+				src[i] = randomPixel(seed, format);
+				ref[i] = dst[i] = randomPixel(seed, format);
+			}
+
+			Graphics::alphaBlit(ref, src, len, format);
+			func(dst, src, len, format);
+			TS_ASSERT_EQUALS(memcmp(ref, dst, sizeof(dst)), 0);
+		}
+	}
+
+	// Blit through ManagedSurface with and without kernels, at positions
+	// which need clipping on every side.
+	template<typename BLIT>
+	void checkSurfaceBlit(Graphics::ManagedSurface &src, const Graphics::PixelFormat &destFormat, BLIT blit) {
+		static const int positions[][2] = {
+			{ 0, 0 }, { 5, 3 }, { -7, -2 }, { kWidth - 20, kHeight - 5 }, { -3, kHeight - 1 }
+		};
+
+		uint32 seed = 4;
+		Graphics::ManagedSurface dest(kWidth, kHeight, destFormat);
+		for (int y = 0; y < kHeight; ++y)
+			for (int x = 0; x < kWidth; ++x)
+				dest.setPixel(x, y, destFormat.bytesPerPixel == 1 ? Test::nextRandom(seed) & 0xff : randomPixel(seed, destFormat));
+
+		for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+			const Common::Point pos(positions[i][0], positions[i][1]);
+			Graphics::ManagedSurface ref(dest);
+
+			Graphics::setBlitKernelsEnabled(false);
+			blit(ref, src, pos);
+			Graphics::setBlitKernelsEnabled(true);
+			blit(dest, src, pos);
+
+			for (int y = 0; y < kHeight; ++y)
+				TS_ASSERT_EQUALS(memcmp(ref.getBasePtr(0, y), dest.getBasePtr(0, y), kWidth * destFormat.bytesPerPixel), 0);
+		}
+	}
+
+	static void plainBlit(Graphics::ManagedSurface &dest, const Graphics::ManagedSurface &src, const Common::Point &pos) {
+		dest.blitFrom(src, pos);
+	}
+
+	static void keyedBlit(Graphics::ManagedSurface &dest, const Graphics::ManagedSurface &src, const Common::Point &pos) {
+		dest.transBlitFrom(src.rawSurface(), pos, 7);
+	}
+
+public:
+	void setUp() {
+		Common::install_null_g_system();
+	}
+
+	void tearDown() {
+		Graphics::setBlitKernelsEnabled(true);
+	}
+
+	void test_scalar_alpha_blend_matches_pixel_format() {
+		const Graphics::PixelFormat format = rgba();
+
+		TS_ASSERT_EQUALS(Graphics::alphaBlendPixel(0x11223300, 0x44556677, format), 0x44556677u);
+		TS_ASSERT_EQUALS(Graphics::alphaBlendPixel(0x112233ff, 0x44556677, format), 0x112233ffu);
+		// Half transparent white over opaque black
+		TS_ASSERT_EQUALS(Graphics::alphaBlendPixel(0xffffff80, 0x000000ff, format), 0x808080ffu);
+	}
+
+	void test_palette_map_rejects_translucent_entries() {
+		Graphics::PaletteBlitMap map;
+		uint32 palette[256];
+
+		for (uint i = 0; i < 256; ++i)
+			palette[i] = 0xff000000 | i;
+		TS_ASSERT(Graphics::buildPaletteBlitMap(map, palette, rgba()));
+		TS_ASSERT_EQUALS(map.colors[0x12], 0x120000ffu);
+
+		palette[3] = 0x80000000;
+		TS_ASSERT(!Graphics::buildPaletteBlitMap(map, palette, rgba()));
+	}
+
+	void test_simd_kernels_match_scalar() {
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			checkKeyBlit(Graphics::keyBlitSSE2);
+			checkAlphaBlit(Graphics::alphaBlitSSE2, rgba());
+			checkAlphaBlit(Graphics::alphaBlitSSE2, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			checkKeyBlit(Graphics::keyBlitAVX2);
+			checkPaletteBlit(Graphics::paletteBlitAVX2);
+			checkAlphaBlit(Graphics::alphaBlitAVX2, rgba());
+			checkAlphaBlit(Graphics::alphaBlitAVX2, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			checkKeyBlit(Graphics::keyBlitNEON);
+			checkAlphaBlit(Graphics::alphaBlitNEON, rgba());
+			checkAlphaBlit(Graphics::alphaBlitNEON, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		}
+#endif
+	}
+
+	void test_keyed_blit_matches_reference() {
+		const Graphics::PixelFormat clut8 = Graphics::PixelFormat::createFormatCLUT8();
+		Graphics::ManagedSurface src(37, 9, clut8);
+		uint32 seed = 5;
+
+		for (int y = 0; y < src.h; ++y)
+			for (int x = 0; x < src.w; ++x)
+				src.setPixel(x, y, (x / 8 + y) & 1 ? 7 : Test::nextRandom(seed) % 12);
+
+		checkSurfaceBlit(src, clut8, keyedBlit);
+	}
+
+	void test_paletted_blit_matches_reference() {
+		Graphics::ManagedSurface src(37, 9, Graphics::PixelFormat::createFormatCLUT8());
+		byte palette[3 * 64];
+		uint32 seed = 6;
+
+		// Only part of the palette is set, the rest stays transparent
+		for (uint i = 0; i < sizeof(palette); ++i)
+			palette[i] = Test::nextRandom(seed) & 0xff;
+		src.setPalette(palette, 0, 64);
+
+		for (int y = 0; y < src.h; ++y)
+			for (int x = 0; x < src.w; ++x)
+				src.setPixel(x, y, Test::nextRandom(seed) % 80);
+
+		checkSurfaceBlit(src, rgba(), plainBlit);
+		checkSurfaceBlit(src, Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), plainBlit);
+	}
+
+	void test_alpha_blit_matches_reference() {
+		Graphics::ManagedSurface src(37, 9, rgba());
+		uint32 seed = 7;
+
+		for (int y = 0; y < src.h; ++y)
+			for (int x = 0; x < src.w; ++x)
+				src.setPixel(x, y, randomPixel(seed, rgba()));
+
+		checkSurfaceBlit(src, rgba(), plainBlit);
+	}
+};
@@ -0,0 +1,63 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/scaler/hq_kernels.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class HQKernelsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 61 // deliberately not a multiple of any vector width
+	};
+
+	// YUV values as produced by HQScaler::initLUT(), mostly close to each
+	// other so that the thresholds of diffYUV() are exercised
+	static uint32 randomYUV(uint32 &seed) {
+		const uint32 r = Test::nextRandom(seed);
+		const int y = 96 + ((r >> 0) & 0x3f) - 32;
+		const int u = 128 + ((r >> 6) & 0x0f) - 8;
+		const int v = 128 + ((r >> 10) & 0x0f) - 8;
+		return (y << 16) | (u << 8) | v;
+	}
+
+#if defined(USE_HQ_SCALERS) && (defined(SCUMMVM_SSE2) || defined(SCUMMVM_NEON))
+	void checkClassify(HQClassifyFunc classify) {
+		uint32 rows[3][kWidth + 2];
+		uint32 seed = 42;
+
+		for (int run = 0; run < 20; ++run) {
+			for (int i = 0; i < 3; ++i) {
+				for (int x = 0; x < kWidth + 2; ++x)
+					rows[i][x] = randomYUV(seed);
+			}
+			// Runs of the same color are common in game graphics
+			for (int x = 5; x < 15; ++x)
+				rows[run % 3][x] = rows[run % 3][4];
+
+			for (uint width = 0; width <= kWidth; ++width) {
+				uint16 expected[kWidth], result[kWidth];
+				hqClassifyRow(expected, rows[0], rows[1], rows[2], width);
+				classify(result, rows[0], rows[1], rows[2], width);
+				TS_ASSERT_SAME_DATA(expected, result, width * sizeof(uint16));
+			}
+		}
+	}
+#endif
+
+public:
+	void test_classify() {
+		Common::install_null_g_system();
+
+#if defined(USE_HQ_SCALERS) && defined(SCUMMVM_SSE2)
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			checkClassify(hqClassifyRowSSE2);
+#endif
+#if defined(USE_HQ_SCALERS) && defined(SCUMMVM_NEON)
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			checkClassify(hqClassifyRowNEON);
+#endif
+	}
+};
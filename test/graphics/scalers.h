@@ -0,0 +1,254 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+#include "../scaler/frames.h"
+
+#include <float.h>
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+private:
+	struct Checksum {
+		const char *scaler;
+		uint factor;
+		int bytesPerPixel;
+		int frame;
+		uint32 checksum;
+	};
+
+	static const Checksum *findChecksum(const char *scaler, uint factor, int bytesPerPixel, int frame) {
+		// As printed by "test/scalerbench --checksums". Update them when a scaler is
+		// changed on purpose.
+		static const Checksum checksums[] = {
+			{ "normal", 1, 2, 0, 0x87180031 },
+			{ "normal", 1, 2, 1, 0x290e4851 },
+			{ "normal", 2, 2, 0, 0xd20fc84d },
+			{ "normal", 2, 2, 1, 0x8af80995 },
+			{ "normal", 3, 2, 0, 0x715e3a25 },
+			{ "normal", 3, 2, 1, 0x12ab8831 },
+			{ "normal", 4, 2, 0, 0x4349cee5 },
+			{ "normal", 4, 2, 1, 0x479e1905 },
+			{ "normal", 5, 2, 0, 0xb5dd1529 },
+			{ "normal", 5, 2, 1, 0xbe7a7881 },
+			{ "normal", 1, 4, 0, 0x851fc0f1 },
+			{ "normal", 1, 4, 1, 0x9e1ed042 },
+			{ "normal", 2, 4, 0, 0x0263fb85 },
+			{ "normal", 2, 4, 1, 0x665c383d },
+			{ "normal", 3, 4, 0, 0xf5c92731 },
+			{ "normal", 3, 4, 1, 0x422f5de6 },
+			{ "normal", 4, 4, 0, 0x4dcede45 },
+			{ "normal", 4, 4, 1, 0xd1a09f25 },
+			{ "normal", 5, 4, 0, 0x64e5bdb1 },
+			{ "normal", 5, 4, 1, 0xe960865a },
+			{ "hq", 2, 2, 0, 0x372e2f7d },
+			{ "hq", 2, 2, 1, 0x577ea830 },
+			{ "hq", 3, 2, 0, 0x0194dbd6 },
+			{ "hq", 3, 2, 1, 0xe803561c },
+			{ "hq", 2, 4, 0, 0x57a46f35 },
+			{ "hq", 2, 4, 1, 0x77653c70 },
+			{ "hq", 3, 4, 0, 0x3013ad59 },
+			{ "hq", 3, 4, 1, 0x153f12b9 },
+			{ "edge", 2, 2, 0, 0x83d689c4 },
+			{ "edge", 2, 2, 1, 0xfe454d36 },
+			{ "edge", 3, 2, 0, 0x9e17b454 },
+			{ "edge", 3, 2, 1, 0xed505315 },
+			{ "edge", 2, 4, 0, 0x031aa440 },
+			{ "edge", 2, 4, 1, 0x38d60cf3 },
+			{ "edge", 3, 4, 0, 0xad5f77c7 },
+			{ "edge", 3, 4, 1, 0xe6054675 },
+			{ "advmame", 2, 2, 0, 0x156a235e },
+			{ "advmame", 2, 2, 1, 0xc4da59ca },
+			{ "advmame", 3, 2, 0, 0xb78e8c49 },
+			{ "advmame", 3, 2, 1, 0x825d51c2 },
+			{ "advmame", 2, 4, 0, 0x82d918c2 },
+			{ "advmame", 2, 4, 1, 0x42afb8c1 },
+			{ "advmame", 3, 4, 0, 0x72356bbc },
+			{ "advmame", 3, 4, 1, 0x9874fd51 },
+			{ "sai", 2, 2, 0, 0x48af2b00 },
+			{ "sai", 2, 2, 1, 0xea3525ea },
+			{ "sai", 2, 4, 0, 0xf1e3109e },
+			{ "sai", 2, 4, 1, 0x82c5a21f },
+			{ "supersai", 2, 2, 0, 0x1d995736 },
+			{ "supersai", 2, 2, 1, 0x26c65bc8 },
+			{ "supersai", 2, 4, 0, 0xd706dda4 },
+			{ "supersai", 2, 4, 1, 0xdcfc1909 },
+			{ "supereagle", 2, 2, 0, 0xa42e7c99 },
+			{ "supereagle", 2, 2, 1, 0x94f54e53 },
+			{ "supereagle", 2, 4, 0, 0xef092a6a },
+			{ "supereagle", 2, 4, 1, 0xd5ab0980 },
+			{ "pm", 2, 2, 0, 0x5d9edb79 },
+			{ "pm", 2, 2, 1, 0x10873082 },
+			{ "pm", 2, 4, 0, 0x0fa7db4d },
+			{ "pm", 2, 4, 1, 0x8e5f9d21 },
+			{ "dotmatrix", 2, 2, 0, 0x96a6a91d },
+			{ "dotmatrix", 2, 2, 1, 0x32a10807 },
+			{ "dotmatrix", 2, 4, 0, 0xabfdbe8f },
+			{ "dotmatrix", 2, 4, 1, 0x2251b75c },
+			{ "tv", 2, 2, 0, 0xdf0d24c5 },
+			{ "tv", 2, 2, 1, 0x52f0b071 },
+			{ "tv", 2, 4, 0, 0x87d8e7bd },
+			{ "tv", 2, 4, 1, 0x5ce354e9 },
+			{ nullptr, 0, 0, 0, 0 }
+		};
+
+		for (const Checksum *c = checksums; c->scaler; ++c) {
+			if (!strcmp(c->scaler, scaler) && c->factor == factor && c->bytesPerPixel == bytesPerPixel && c->frame == frame)
+				return c;
+		}
+		return nullptr;
+	}
+
+	/** Whether the output of a scaler may differ between platforms */
+	static bool isPlatformDependent(const char *scaler, uint factor, int bytesPerPixel) {
+		// Scale4x reads past the ends of its intermediate rows on the stack
+		if (!strcmp(scaler, "advmame") && factor == 4)
+			return true;
+#ifdef USE_NASM
+		// The HQ assembly code is used instead at 16bpp
+		if (!strcmp(scaler, "hq") && bytesPerPixel == 2)
+			return true;
+#endif
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD != 0
+		// The edge detection uses floating point math
+		if (!strcmp(scaler, "edge"))
+			return true;
+#endif
+		return false;
+	}
+
+	/**
+	 * Scale a frame in @p bands horizontal bands, the way the SDL backend
+	 * scales tall rects with multiple threads.
+	 */
+	static uint32 scale(Scaler *scaler, const ScalerTest::PaddedFrame &frame, int bands) {
+		const uint factor = scaler->getFactor();
+		const int bpp = frame.format().bytesPerPixel;
+		const uint32 dstPitch = frame.width() * factor * bpp;
+		Common::Array<byte> dst(dstPitch * frame.height() * factor);
+
+		for (int band = 0; band < bands; ++band) {
+			const int top = frame.height() * band / bands;
+			const int bottom = frame.height() * (band + 1) / bands;
+			scaler->scale(frame.pixels() + top * frame.pitch(), frame.pitch(),
+				&dst[top * factor * dstPitch], dstPitch, frame.width(), bottom - top, 0, top);
+		}
+
+		return ScalerTest::checksumPixels(&dst[0], dstPitch, frame.width() * factor, frame.height() * factor, bpp);
+	}
+
+	void checkScaler(ScalerPluginObject *plugin, int bytesPerPixel) {
+		const Graphics::PixelFormat format = ScalerTest::getTestFormat(bytesPerPixel);
+		Scaler *scaler = plugin->createInstance(format);
+
+		const Common::Array<uint> &factors = plugin->getFactors();
+		for (uint f = 0; f < factors.size(); ++f) {
+			scaler->setFactor(factors[f]);
+
+			for (int i = 0; i < ScalerTest::kNumTestFrames; ++i) {
+				Graphics::Surface surface;
+				byte palette[256 * 3];
+				ScalerTest::drawTestFrame(i, surface, palette);
+				ScalerTest::PaddedFrame frame(surface, format, palette);
+				surface.free();
+
+				const uint32 checksum = scale(scaler, frame, 1);
+				const Common::String name = Common::String::format("%s %ux %dbpp frame %d: %08x",
+					plugin->getName(), factors[f], bytesPerPixel * 8, i, checksum);
+
+				// The scaler must only look at the rows around what it
+				// scales, so it gives the same result in bands
+				if (plugin->canScaleInBands(factors[f]))
+					TSM_ASSERT_EQUALS(name.c_str(), scale(scaler, frame, 3), checksum);
+
+				if (isPlatformDependent(plugin->getName(), factors[f], bytesPerPixel))
+					continue;
+
+				const Checksum *expected = findChecksum(plugin->getName(), factors[f], bytesPerPixel, i);
+				TSM_ASSERT(name.c_str(), expected);
+				if (expected)
+					TSM_ASSERT_EQUALS(name.c_str(), checksum, expected->checksum);
+			}
+		}
+
+		delete scaler;
+	}
+
+	/**
+	 * Compare scaling a rect at once with scaling it in bands on a worker
+	 * pool, like the SDL backend does for tall dirty rects.
+	 */
+	void checkThreadedBands(Common::WorkerPool &pool, ScalerPluginObject *plugin, const ScalerTest::PaddedFrame &frame) {
+		Scaler *scaler = plugin->createInstance(frame.format());
+		const int bpp = frame.format().bytesPerPixel;
+
+		const Common::Array<uint> &factors = plugin->getFactors();
+		for (uint f = 0; f < factors.size(); ++f) {
+			if (!plugin->canScaleInBands(factors[f]))
+				continue;
+			scaler->setFactor(factors[f]);
+
+			const uint32 dstPitch = frame.width() * factors[f] * bpp;
+			Common::Array<byte> serial(dstPitch * frame.height() * factors[f]);
+			Common::Array<byte> banded(serial.size());
+			scaler->scale(frame.pixels(), frame.pitch(), &serial[0], dstPitch, frame.width(), frame.height(), 0, 0);
+			scaler->scaleInBands(pool, pool.getNumWorkers() + 1, frame.pixels(), frame.pitch(), &banded[0], dstPitch, frame.width(), frame.height(), 0, 0);
+
+			const Common::String name = Common::String::format("%s %ux %dbpp", plugin->getName(), factors[f], bpp * 8);
+			TSM_ASSERT(name.c_str(), !memcmp(&serial[0], &banded[0], serial.size()));
+		}
+
+		delete scaler;
+	}
+
+public:
+	void test_scalers() {
+		Common::install_null_g_system();
+
+		Common::Array<ScalerPluginObject *> plugins;
+		ScalerTest::createScalerPlugins(plugins);
+
+		for (uint i = 0; i < plugins.size(); ++i) {
+			checkScaler(plugins[i], 2);
+			checkScaler(plugins[i], 4);
+			delete plugins[i];
+		}
+	}
+
+	void test_threaded_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::WorkerPool pool(3, "ScalerTest");
+
+		Common::Array<ScalerPluginObject *> plugins;
+		ScalerTest::createScalerPlugins(plugins);
+
+		for (int bytesPerPixel = 2; bytesPerPixel <= 4; bytesPerPixel += 2) {
+			// Both test frames on top of each other, taller than any screen
+			const Graphics::PixelFormat format = ScalerTest::getTestFormat(bytesPerPixel);
+			Graphics::Surface tall;
+			tall.create(ScalerTest::kFrameWidth, ScalerTest::kFrameHeight * ScalerTest::kNumTestFrames, format);
+			for (int i = 0; i < ScalerTest::kNumTestFrames; ++i) {
+				Graphics::Surface surface;
+				byte palette[256 * 3];
+				ScalerTest::drawTestFrame(i, surface, palette);
+				Graphics::Surface *converted = surface.convertTo(format, palette);
+				tall.copyRectToSurface(*converted, 0, i * ScalerTest::kFrameHeight, Common::Rect(surface.w, surface.h));
+				converted->free();
+				delete converted;
+				surface.free();
+			}
+			ScalerTest::PaddedFrame frame(tall, format);
+			tall.free();
+
+			for (uint i = 0; i < plugins.size(); ++i)
+				checkThreadedBands(pool, plugins[i], frame);
+		}
+
+		for (uint i = 0; i < plugins.size(); ++i)
+			delete plugins[i];
+#endif
+	}
+};
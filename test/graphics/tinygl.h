@@ -0,0 +1,300 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan_kernels.h"
+#endif
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#ifdef USE_TINYGL
+	enum {
+		kWidth = 640,
+		kHeight = 480
+	};
+
+	static float randomCoord(uint32 &seed, int range) {
+		return (float)((int)(Test::nextRandom(seed) % (range + 80)) - 40);
+	}
+
+	// Overlapping triangles and quads in several render states, some of
+	// them partly off screen. A different seed only moves some of them.
+	static void drawScene(uint32 frameSeed, int count, TGLuint texture, TinyGL::BlitImage *image) {
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		uint32 seed = 1;
+		for (int i = 0; i < count; i++) {
+			// Every eighth shape changes between frames
+			uint32 shapeSeed = (i % 8 == 0) ? seed ^ frameSeed : seed;
+			if (i % 5 == 0) {
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			} else {
+				tglDisable(TGL_BLEND);
+			}
+
+			if (i % 4 == 0) {
+				tglEnable(TGL_ALPHA_TEST);
+				tglAlphaFunc((i % 8 == 0) ? TGL_GREATER : TGL_LEQUAL, 0.6f);
+			} else {
+				tglDisable(TGL_ALPHA_TEST);
+			}
+			tglDepthMask(i % 11 == 0 ? TGL_FALSE : TGL_TRUE);
+
+			const bool textured = (i % 3 == 0);
+			if (textured) {
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, texture);
+			} else {
+				tglDisable(TGL_TEXTURE_2D);
+			}
+
+			const bool quad = (i % 7 == 0);
+			tglBegin(quad ? TGL_QUADS : TGL_TRIANGLES);
+			for (int v = 0; v < (quad ? 4 : 3); v++) {
+				tglColor4ub(Test::nextRandom(shapeSeed), Test::nextRandom(shapeSeed), Test::nextRandom(shapeSeed), 96 + Test::nextRandom(shapeSeed) % 160);
+				tglTexCoord2f((v & 1) ? 1.0f : 0.0f, (v & 2) ? 1.0f : 0.0f);
+				const float x = randomCoord(shapeSeed, kWidth);
+				const float y = randomCoord(shapeSeed, kHeight);
+				tglVertex4f(x, y, (float)(Test::nextRandom(shapeSeed) % 200) / 100.0f - 1.0f, textured ? 1.0f + (v * 0.25f) : 1.0f);
+			}
+			tglEnd();
+			Test::nextRandom(seed);
+		}
+
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_ALPHA_TEST);
+		tglDepthMask(TGL_TRUE);
+		tglDisable(TGL_DEPTH_TEST);
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglBlit(image, 100 + frameSeed % 7, 50);
+		tglBlit(image, kWidth - 40, kHeight - 30);
+	}
+
+	static TinyGL::BlitImage *createImage() {
+		Graphics::Surface surface;
+		surface.create(73, 41, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		for (int y = 0; y < surface.h; y++) {
+			for (int x = 0; x < surface.w; x++) {
+				const byte alpha = (x + y) % 3 == 0 ? 0 : (x * 7) & 0xFF;
+				*(uint32 *)surface.getBasePtr(x, y) = surface.format.ARGBToColor(alpha, x * 3, y * 5, 200);
+			}
+		}
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, surface, 0, false);
+		surface.free();
+		return image;
+	}
+
+	static TGLuint createTexture() {
+		byte pixels[64 * 64 * 4];
+		for (int i = 0; i < 64 * 64; i++) {
+			pixels[i * 4 + 0] = (i * 5) & 0xFF;
+			pixels[i * 4 + 1] = (i / 64) * 4;
+			pixels[i * 4 + 2] = ((i % 64) ^ (i / 64)) * 4;
+			pixels[i * 4 + 3] = 255;
+		}
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+		return texture;
+	}
+
+	// Render a few frames and keep the last one
+	static uint32 render(bool dirtyRects, int threads, int count, int frames, Common::Array<byte> &pixels) {
+		ConfMan.setInt("tinygl_threads", threads, Common::ConfigManager::kTransientDomain);
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, false, dirtyRects);
+		ConfMan.removeKey("tinygl_threads", Common::ConfigManager::kTransientDomain);
+
+		TGLuint texture = createTexture();
+		TinyGL::BlitImage *image = createImage();
+		const uint32 start = g_system ? g_system->getMillis() : 0;
+		for (int frame = 0; frame < frames; frame++) {
+			drawScene(frame * 0x9E3779B9, count, texture, image);
+			TinyGL::presentBuffer();
+		}
+		const uint32 time = g_system ? g_system->getMillis() - start : 0;
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		pixels.resize(surface.pitch * surface.h);
+		memcpy(pixels.begin(), surface.getPixels(), pixels.size());
+
+		tglDeleteBlitImage(image);
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext();
+		return time;
+	}
+
+	static void texturedQuad(const float (&corners)[4][2]) {
+		tglBegin(TGL_QUADS);
+		for (int v = 0; v < 4; v++) {
+			tglTexCoord2f((v == 1 || v == 2) ? 1.0f : 0.0f, (v >= 2) ? 1.0f : 0.0f);
+			tglVertex2f(corners[v][0], corners[v][1]);
+		}
+		tglEnd();
+	}
+
+	// A checkerboard of single texels, drawn at a quarter of its size on
+	// many rotated quads. The last one is not rotated and stays in the top
+	// left corner.
+	static uint32 renderMinified(TGLint minFilter, int frames, Common::Array<byte> &pixels, Graphics::PixelFormat &format) {
+		format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::createContext(kWidth, kHeight, format, 256, false, false);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, minFilter);
+
+		Common::Array<byte> checkerboard(256 * 256 * 4);
+		for (int i = 0; i < 256 * 256; i++)
+			memset(&checkerboard[i * 4], ((i ^ (i / 256)) & 1) ? 255 : 0, 4);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 256, 256, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, checkerboard.begin());
+
+		const uint32 start = g_system ? g_system->getMillis() : 0;
+		for (int frame = 0; frame < frames; frame++) {
+			tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+			tglClear(TGL_COLOR_BUFFER_BIT);
+			tglMatrixMode(TGL_PROJECTION);
+			tglLoadIdentity();
+			tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+			tglMatrixMode(TGL_MODELVIEW);
+			tglLoadIdentity();
+			tglEnable(TGL_TEXTURE_2D);
+			tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+			for (int y = 0; y < kHeight; y += 32) {
+				for (int x = (y / 32) % 2 * 16; x < kWidth; x += 32) {
+					const float diamond[4][2] = { { x + 45.0f, (float)y }, { x + 90.0f, y + 45.0f }, { x + 45.0f, y + 90.0f }, { (float)x, y + 45.0f } };
+					texturedQuad(diamond);
+				}
+			}
+			const float square[4][2] = { { 0.0f, 0.0f }, { 64.0f, 0.0f }, { 64.0f, 64.0f }, { 0.0f, 64.0f } };
+			texturedQuad(square);
+			TinyGL::presentBuffer();
+		}
+		const uint32 time = g_system ? g_system->getMillis() - start : 0;
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		pixels.resize(surface.pitch * surface.h);
+		memcpy(pixels.begin(), surface.getPixels(), pixels.size());
+
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext();
+		return time;
+	}
+
+	// Count the pixels inside the square of renderMinified() with a red
+	// value in the given range
+	static int countMinified(const Common::Array<byte> &pixels, const Graphics::PixelFormat &format, int min, int max) {
+		int count = 0;
+		for (int y = 8; y < 56; y++) {
+			for (int x = 8; x < 56; x++) {
+				uint8 r, g, b;
+				format.colorToRGB(*(const uint32 *)&pixels[(y * kWidth + x) * 4], r, g, b);
+				if (r >= min && r <= max)
+					count++;
+			}
+		}
+		return count;
+	}
+#endif
+
+public:
+	void test_clipping_matches_full_redraw() {
+#ifdef USE_TINYGL
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Only the changed parts of the later frames are drawn again, clipped
+		// to the dirty rectangles or to the tiles within them
+		Common::Array<byte> full, clipped, tiled;
+		render(false, 0, 300, 3, full);
+		render(true, 0, 300, 3, clipped);
+		render(true, 3, 300, 3, tiled);
+		TS_ASSERT_EQUALS(full.size(), clipped.size());
+		TS_ASSERT_EQUALS(full.size(), tiled.size());
+		if (full.size() == clipped.size() && full.size() == tiled.size()) {
+			TS_ASSERT(memcmp(full.begin(), clipped.begin(), full.size()) == 0);
+			TS_ASSERT(memcmp(full.begin(), tiled.begin(), full.size()) == 0);
+		}
+#endif
+	}
+
+	void test_span_kernels_match_scalar() {
+#ifdef USE_TINYGL
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Textured shapes in all the render states of the scene, drawn with
+		// and without the SIMD span kernels
+		Common::Array<byte> scalar, kernels;
+		TinyGL::setSpanKernelsEnabled(false);
+		const uint32 scalarTime = render(false, 0, 600, 3, scalar);
+		TinyGL::setSpanKernelsEnabled(true);
+		const uint32 kernelsTime = render(false, 0, 600, 3, kernels);
+		TS_ASSERT_EQUALS(scalar.size(), kernels.size());
+		if (scalar.size() == kernels.size())
+			TS_ASSERT(memcmp(scalar.begin(), kernels.begin(), scalar.size()) == 0);
+
+		if (Test::benchmarksEnabled())
+			TS_TRACE(Common::String::format("3 frames of 600 shapes at %dx%d: per-pixel spans %u ms, span kernels %u ms", kWidth, kHeight, scalarTime, kernelsTime).c_str());
+#endif
+	}
+
+	void test_mipmaps_for_minified_textures() {
+#ifdef USE_TINYGL
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Without mipmaps, every pixel shows a black or a white texel. With
+		// them, the checkerboard is averaged to gray.
+		Common::Array<byte> nearest, mipmapped;
+		Graphics::PixelFormat format;
+		const uint32 nearestTime = renderMinified(TGL_NEAREST, 5, nearest, format);
+		const uint32 mipmappedTime = renderMinified(TGL_NEAREST_MIPMAP_NEAREST, 5, mipmapped, format);
+		TS_ASSERT_EQUALS(countMinified(nearest, format, 0, 10) + countMinified(nearest, format, 245, 255), 48 * 48);
+		TS_ASSERT_EQUALS(countMinified(mipmapped, format, 110, 145), 48 * 48);
+
+		if (Test::benchmarksEnabled())
+			TS_TRACE(Common::String::format("5 frames of a minified 256x256 texture at %dx%d: without mipmaps %u ms, with mipmaps %u ms", kWidth, kHeight, nearestTime, mipmappedTime).c_str());
+#endif
+	}
+
+	void test_benchmark() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		Common::Array<byte> serial, tiled;
+		const uint32 serialTime = render(true, 0, 1000, 5, serial);
+		const uint32 tiledTime = render(true, 3, 1000, 5, tiled);
+		TS_ASSERT(memcmp(serial.begin(), tiled.begin(), serial.size()) == 0);
+
+		TS_TRACE(Common::String::format("5 frames of 1000 shapes at %dx%d: single thread %u ms, tiles on 3 extra threads %u ms", kWidth, kHeight, serialTime, tiledTime).c_str());
+#endif
+	}
+};
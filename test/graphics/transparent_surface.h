@@ -0,0 +1,246 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/blit_kernels.h"
+#include "graphics/transparent_surface.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxLength = 71, // deliberately not a multiple of any vector width
+		kWidth = 61,
+		kHeight = 23
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		const uint32 value = Test::nextSeed(seed);
+		return (value >> 16) | (value << 16);
+	}
+
+	// Mostly opaque or transparent runs, with the odd translucent pixel
+	static uint32 randomPixel(uint32 &seed) {
+		const uint32 r = nextRandom(seed);
+		switch ((r >> 4) & 7) {
+		case 0:
+		case 1:
+			return r;
+		case 2:
+			return r & 0xffffff00;
+		default:
+			return r | 0xff;
+		}
+	}
+
+	static void fill(Graphics::Surface &surf, uint32 seed) {
+		for (int y = 0; y < surf.h; y++)
+			for (int x = 0; x < surf.w; x++)
+				*(uint32 *)surf.getBasePtr(x, y) = randomPixel(seed);
+	}
+
+	void checkSprite(Graphics::SpriteBlitFunc ref, Graphics::SpriteBlitFunc func, bool premultiplied) {
+		static const uint32 colors[] = { 0xffffffff, 0x80ff40c0, 0xffffff01, 0x123456ff };
+		uint32 src[kMaxLength], refOut[kMaxLength], out[kMaxLength];
+		uint32 seed = 1;
+
+		for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+			for (uint len = 0; len <= kMaxLength; ++len) {
+				for (uint i = 0; i < kMaxLength; ++i) {
+					src[i] = randomPixel(seed);
+					refOut[i] = out[i] = nextRandom(seed);
+				}
+				if (premultiplied)
+					Graphics::premultiplyAlpha(src, src, kMaxLength);
+
+				ref(refOut, src, len, colors[c]);
+				func(out, src, len, colors[c]);
+				TS_ASSERT_EQUALS(memcmp(refOut, out, sizeof(out)), 0);
+			}
+		}
+	}
+
+	// Blit with and without kernels, covering flipping, clipping and
+	// color modulation. The target is kWidth - 37 pixels wider than the
+	// sprite.
+	void checkBlit(Graphics::AlphaType alphaMode, uint32 color, Graphics::TSpriteBlendMode blendMode, int srcWidth = 37) {
+		const int width = srcWidth + kWidth - 37;
+		static const int positions[][3] = {
+			{ 0, 0, Graphics::FLIP_NONE }, { -9, 4, Graphics::FLIP_H }, { 30, -5, Graphics::FLIP_V },
+			{ 50, 15, Graphics::FLIP_HV }, { 3, 2, Graphics::FLIP_NONE }
+		};
+
+		Graphics::TransparentSurface src;
+		src.create(srcWidth, 13, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(src, 2);
+		src.setAlphaMode(alphaMode);
+
+		Graphics::Surface ref, target;
+		ref.create(width, kHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		target.create(width, kHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(ref, 3);
+		target.copyFrom(ref);
+
+		for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+			Graphics::setBlitKernelsEnabled(false);
+			src.blit(ref, positions[i][0], positions[i][1], positions[i][2], nullptr, color, -1, -1, blendMode);
+			Graphics::setBlitKernelsEnabled(true);
+			src.blit(target, positions[i][0], positions[i][1], positions[i][2], nullptr, color, -1, -1, blendMode);
+		}
+
+		for (int y = 0; y < kHeight; y++)
+			TS_ASSERT_EQUALS(memcmp(ref.getBasePtr(0, y), target.getBasePtr(0, y), width * 4), 0);
+
+		src.free();
+		ref.free();
+		target.free();
+	}
+
+public:
+	void setUp() {
+		Common::install_null_g_system();
+	}
+
+	void tearDown() {
+		Graphics::setBlitKernelsEnabled(true);
+	}
+
+	void test_simd_sprite_kernels_match_scalar() {
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			checkSprite(Graphics::spriteBlitOpaque, Graphics::spriteBlitOpaqueSSE2, false);
+			checkSprite(Graphics::spriteBlitBinary, Graphics::spriteBlitBinarySSE2, false);
+			checkSprite(Graphics::spriteBlitAlpha, Graphics::spriteBlitAlphaSSE2, false);
+			checkSprite(Graphics::spriteBlitTinted, Graphics::spriteBlitTintedSSE2, false);
+			checkSprite(Graphics::spriteBlitPremultiplied, Graphics::spriteBlitPremultipliedSSE2, true);
+			checkSprite(Graphics::spriteBlitPremultiplied, Graphics::spriteBlitPremultipliedSSE2, false);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			checkSprite(Graphics::spriteBlitOpaque, Graphics::spriteBlitOpaqueNEON, false);
+			checkSprite(Graphics::spriteBlitBinary, Graphics::spriteBlitBinaryNEON, false);
+			checkSprite(Graphics::spriteBlitAlpha, Graphics::spriteBlitAlphaNEON, false);
+			checkSprite(Graphics::spriteBlitTinted, Graphics::spriteBlitTintedNEON, false);
+			checkSprite(Graphics::spriteBlitPremultiplied, Graphics::spriteBlitPremultipliedNEON, true);
+			checkSprite(Graphics::spriteBlitPremultiplied, Graphics::spriteBlitPremultipliedNEON, false);
+		}
+#endif
+	}
+
+	void test_blit_matches_reference() {
+		checkBlit(Graphics::ALPHA_OPAQUE, 0xffffffff, Graphics::BLEND_NORMAL);
+		checkBlit(Graphics::ALPHA_BINARY, 0xffffffff, Graphics::BLEND_NORMAL);
+		checkBlit(Graphics::ALPHA_FULL, 0xffffffff, Graphics::BLEND_NORMAL);
+		checkBlit(Graphics::ALPHA_FULL, 0x80ff40c0, Graphics::BLEND_NORMAL);
+		checkBlit(Graphics::ALPHA_FULL, 0xffffffff, Graphics::BLEND_ADDITIVE);
+
+		// Flipped rows longer than the row buffer are drawn in parts
+		checkBlit(Graphics::ALPHA_FULL, 0x80ff40c0, Graphics::BLEND_NORMAL, 600);
+	}
+
+	void test_premultiplied_blit_is_close_to_straight() {
+		// Wider than the row buffer, so flipped rows are drawn in parts
+		static const int kSrcWidth = 600;
+		static const int kOutWidth = kSrcWidth + 24;
+
+		Graphics::TransparentSurface src;
+		src.create(kSrcWidth, 13, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(src, 4);
+
+		Graphics::TransparentSurface premultiplied(src, true);
+		premultiplied.premultiplyAlpha();
+		TS_ASSERT(premultiplied.isPremultiplied());
+
+		static const uint32 colors[] = { 0xffffffff, 0x80ff40c0 };
+		static const Graphics::TSpriteBlendMode blendModes[] = { Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE };
+		for (uint m = 0; m < ARRAYSIZE(blendModes); ++m) {
+			for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+				Graphics::Surface straightOut, premultipliedOut;
+				straightOut.create(kOutWidth, kHeight, src.format);
+				fill(straightOut, 5);
+				premultipliedOut.copyFrom(straightOut);
+
+				src.blit(straightOut, 7, 3, Graphics::FLIP_H, nullptr, colors[c], -1, -1, blendModes[m]);
+				premultiplied.blit(premultipliedOut, 7, 3, Graphics::FLIP_H, nullptr, colors[c], -1, -1, blendModes[m]);
+
+				// The two paths approximate the division by 255 differently, so
+				// the results differ by a few steps at most
+				int maxDiff = 0;
+				for (int y = 0; y < kHeight; y++) {
+					const byte *a = (const byte *)straightOut.getBasePtr(0, y);
+					const byte *b = (const byte *)premultipliedOut.getBasePtr(0, y);
+					for (int x = 0; x < kOutWidth * 4; x++)
+						maxDiff = MAX<int>(maxDiff, ABS(a[x] - b[x]));
+				}
+				TS_ASSERT_LESS_THAN_EQUALS(maxDiff, 4);
+
+				straightOut.free();
+				premultipliedOut.free();
+			}
+		}
+
+		src.free();
+		premultiplied.free();
+	}
+
+	void test_detect_alpha_type() {
+		Graphics::TransparentSurface surf;
+		surf.create(9, 5, Graphics::TransparentSurface::getSupportedPixelFormat());
+
+		for (int y = 0; y < surf.h; y++)
+			for (int x = 0; x < surf.w; x++)
+				*(uint32 *)surf.getBasePtr(x, y) = TS_ARGB(255, x, y, 1);
+		TS_ASSERT_EQUALS(Graphics::TransparentSurface::detectAlphaType(surf), Graphics::ALPHA_OPAQUE);
+
+		*(uint32 *)surf.getBasePtr(3, 2) = TS_ARGB(0, 1, 2, 3);
+		TS_ASSERT_EQUALS(Graphics::TransparentSurface::detectAlphaType(surf), Graphics::ALPHA_BINARY);
+
+		*(uint32 *)surf.getBasePtr(8, 4) = TS_ARGB(17, 1, 2, 3);
+		TS_ASSERT_EQUALS(Graphics::TransparentSurface::detectAlphaType(surf), Graphics::ALPHA_FULL);
+
+		surf.free();
+	}
+
+	void test_benchmark() {
+		if (!Test::benchmarksEnabled())
+			return;
+
+		// An 800x600 scene with a full screen background and overlapping
+		// translucent sprites, drawn with and without the kernels.
+		Graphics::TransparentSurface background, sprite;
+		Graphics::Surface screen;
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		background.create(800, 600, format);
+		sprite.create(200, 150, format);
+		screen.create(800, 600, format);
+		fill(background, 6);
+		fill(sprite, 7);
+		background.setAlphaMode(Graphics::ALPHA_OPAQUE);
+
+		uint32 times[2];
+		Graphics::Surface generic;
+		for (int pass = 0; pass < 2; pass++) {
+			Graphics::setBlitKernelsEnabled(pass == 1);
+			const uint32 start = g_system->getMillis();
+			for (int frame = 0; frame < 20; frame++) {
+				background.blit(screen);
+				for (int i = 0; i < 16; i++)
+					sprite.blit(screen, (i * 97) % 700, (i * 61) % 500, Graphics::FLIP_NONE, nullptr, i & 1 ? 0xffffffff : 0xc0ffc0ff);
+			}
+			times[pass] = g_system->getMillis() - start;
+			if (pass == 0)
+				generic.copyFrom(screen);
+		}
+		TS_ASSERT(memcmp(generic.getPixels(), screen.getPixels(), screen.pitch * screen.h) == 0);
+
+		TS_TRACE(Common::String::format("800x600 TransparentSurface scene, 20 frames: generic %u ms, kernels %u ms", times[0], times[1]).c_str());
+
+		background.free();
+		sprite.free();
+		screen.free();
+		generic.free();
+	}
+};
@@ -0,0 +1,233 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 260, // deliberately not a multiple of any vector width
+		kHeight = 32,
+		kMaxDifference = 1
+	};
+
+	struct Planes {
+		Common::Array<byte> y, u, v, a;
+	};
+
+	// Random planes, large enough for the 444 chroma of the whole image
+	static void fillPlanes(Planes &planes, uint32 seed) {
+		planes.y.resize(kWidth * kHeight);
+		planes.u.resize(kWidth * kHeight);
+		planes.v.resize(kWidth * kHeight);
+		planes.a.resize(kWidth * kHeight);
+		for (uint i = 0; i < planes.y.size(); ++i) {
+			planes.y[i] = Test::nextRandom(seed) & 0xff;
+			planes.u[i] = Test::nextRandom(seed) & 0xff;
+			planes.v[i] = Test::nextRandom(seed) & 0xff;
+			planes.a[i] = Test::nextRandom(seed) & 0xff;
+		}
+	}
+
+	enum Layout {
+		kLayout444,
+		kLayout420,
+		kLayout420Alpha,
+		kLayout410
+	};
+
+	static void convert(Graphics::Surface &surface, Layout layout, Graphics::YUVToRGBManager::LuminanceScale scale, const Planes &planes) {
+		switch (layout) {
+		case kLayout444:
+			YUVToRGBMan.convert444(&surface, scale, planes.y.begin(), planes.u.begin(), planes.v.begin(), kWidth, kHeight, kWidth, kWidth);
+			break;
+		case kLayout420:
+			YUVToRGBMan.convert420(&surface, scale, planes.y.begin(), planes.u.begin(), planes.v.begin(), kWidth, kHeight, kWidth, kWidth / 2);
+			break;
+		case kLayout420Alpha:
+			YUVToRGBMan.convert420Alpha(&surface, scale, planes.y.begin(), planes.u.begin(), planes.v.begin(), planes.a.begin(), kWidth, kHeight, kWidth, kWidth / 2);
+			break;
+		case kLayout410:
+			YUVToRGBMan.convert410(&surface, scale, planes.y.begin(), planes.u.begin(), planes.v.begin(), kWidth, kHeight, kWidth, kWidth / 4 + 1);
+			break;
+		}
+	}
+
+	// The largest difference between two channels of the pixels
+	static int maxDifference(const Graphics::Surface &a, const Graphics::Surface &b, int width, int height) {
+		int result = 0;
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				byte aa, ar, ag, ab, ba, br, bg, bb;
+				const uint32 aPixel = a.format.bytesPerPixel == 2 ? *(const uint16 *)a.getBasePtr(x, y) : *(const uint32 *)a.getBasePtr(x, y);
+				const uint32 bPixel = b.format.bytesPerPixel == 2 ? *(const uint16 *)b.getBasePtr(x, y) : *(const uint32 *)b.getBasePtr(x, y);
+				a.format.colorToARGB(aPixel, aa, ar, ag, ab);
+				b.format.colorToARGB(bPixel, ba, br, bg, bb);
+				result = MAX(result, ABS(aa - ba));
+				result = MAX(result, ABS(ar - br));
+				result = MAX(result, ABS(ag - bg));
+				result = MAX(result, ABS(ab - bb));
+			}
+		}
+		return result;
+	}
+
+	static const Graphics::PixelFormat *formats(uint &count) {
+		static const Graphics::PixelFormat list[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		count = ARRAYSIZE(list);
+		return list;
+	}
+
+	// Compare a single kernel against the tables, on the first rows of the
+	// 444 and 420 layouts
+	void checkKernels(const Graphics::YUVToRGBKernels &kernels) {
+		Planes planes;
+		fillPlanes(planes, 7);
+
+		uint count;
+		const Graphics::PixelFormat *list = formats(count);
+		for (uint f = 0; f < count; ++f) {
+			for (int s = 0; s < 2; ++s) {
+				const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+				for (int layout = kLayout444; layout <= kLayout420Alpha; ++layout) {
+					Graphics::Surface ref, dst;
+					ref.create(kWidth, kHeight, list[f]);
+					dst.create(kWidth, 1, list[f]);
+
+					Graphics::setYUVToRGBKernelsEnabled(false);
+					convert(ref, (Layout)layout, scale, planes);
+					Graphics::setYUVToRGBKernelsEnabled(true);
+
+					const Graphics::YUVToRGBRowFunc row = (layout == kLayout444) ? kernels.row444 : kernels.row420;
+					const byte *alpha = (layout == kLayout420Alpha) ? planes.a.begin() : nullptr;
+					const uint done = row((byte *)dst.getPixels(), planes.y.begin(), planes.u.begin(), planes.v.begin(), alpha, kWidth, list[f], scale);
+					TS_ASSERT(done <= (uint)kWidth && done + 16 > (uint)kWidth);
+
+					TS_ASSERT_LESS_THAN_EQUALS(maxDifference(ref, dst, done, 1), (int)kMaxDifference);
+
+					ref.free();
+					dst.free();
+				}
+			}
+		}
+	}
+
+public:
+	void test_kernels_match_tables() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Whatever kernels the CPU supports, through all the conversions of
+		// YUVToRGBManager
+		Planes planes;
+		fillPlanes(planes, 3);
+
+		uint count;
+		const Graphics::PixelFormat *list = formats(count);
+		for (uint f = 0; f < count; ++f) {
+			for (int s = 0; s < 2; ++s) {
+				const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+				for (int layout = kLayout444; layout <= kLayout410; ++layout) {
+					Graphics::Surface tables, kernels;
+					tables.create(kWidth, kHeight, list[f]);
+					kernels.create(kWidth, kHeight, list[f]);
+
+					Graphics::setYUVToRGBKernelsEnabled(false);
+					convert(tables, (Layout)layout, scale, planes);
+					Graphics::setYUVToRGBKernelsEnabled(true);
+					convert(kernels, (Layout)layout, scale, planes);
+
+					TS_ASSERT_LESS_THAN_EQUALS(maxDifference(tables, kernels, kWidth, kHeight), (int)kMaxDifference);
+
+					tables.free();
+					kernels.free();
+				}
+			}
+		}
+	}
+
+	void test_sse2_kernels() {
+#if defined(SCUMMVM_SSE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		if (!g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			return;
+
+		Graphics::YUVToRGBKernels kernels;
+		kernels.row444 = Graphics::yuv444ToRGBRowSSE2;
+		kernels.row420 = Graphics::yuv420ToRGBRowSSE2;
+		checkKernels(kernels);
+#endif
+	}
+
+	void test_avx2_kernels() {
+#if defined(SCUMMVM_AVX2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		if (!g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			return;
+
+		Graphics::YUVToRGBKernels kernels;
+		kernels.row444 = Graphics::yuv444ToRGBRowAVX2;
+		kernels.row420 = Graphics::yuv420ToRGBRowAVX2;
+		checkKernels(kernels);
+#endif
+	}
+
+	void test_neon_kernels() {
+#if defined(SCUMMVM_NEON) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		if (!g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			return;
+
+		Graphics::YUVToRGBKernels kernels;
+		kernels.row444 = Graphics::yuv444ToRGBRowNEON;
+		kernels.row420 = Graphics::yuv420ToRGBRowNEON;
+		checkKernels(kernels);
+#endif
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		// 640x480 YUV420 frames, as decoded by most of the video codecs
+		const int width = 640, height = 480, frames = 50;
+		Common::Array<byte> y(width * height), u(width * height / 4), v(width * height / 4);
+		uint32 seed = 5;
+		for (uint i = 0; i < y.size(); ++i)
+			y[i] = Test::nextRandom(seed) & 0xff;
+		for (uint i = 0; i < u.size(); ++i) {
+			u[i] = Test::nextRandom(seed) & 0xff;
+			v[i] = Test::nextRandom(seed) & 0xff;
+		}
+
+		Graphics::Surface surface;
+		surface.create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		uint32 times[2];
+		for (int enabled = 0; enabled < 2; ++enabled) {
+			Graphics::setYUVToRGBKernelsEnabled(enabled != 0);
+			const uint32 start = g_system->getMillis();
+			for (int frame = 0; frame < frames; ++frame)
+				YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, y.begin(), u.begin(), v.begin(), width, height, width, width / 2);
+			times[enabled] = g_system->getMillis() - start;
+		}
+		Graphics::setYUVToRGBKernelsEnabled(true);
+		surface.free();
+
+		TS_TRACE(Common::String::format("%d YUV420 frames at %dx%d: tables %u ms, kernels %u ms", frames, width, height, times[0], times[1]).c_str());
+#endif
+	}
+};
@@ -0,0 +1,135 @@
+#include <cxxtest/TestSuite.h>
+
+#include "gui/saveload-metainfo.h"
+
+class SaveMetaInfoTestSuite : public CxxTest::TestSuite {
+	typedef GUI::SaveMetaInfoCache<int> Cache;
+
+	static Common::String key(int slot) {
+		return Common::String::format("monkey/%d/1000/1234", slot);
+	}
+
+public:
+	void test_queue_order() {
+		GUI::SaveMetaInfoQueue queue;
+		queue.reset(10);
+
+		// Requests are handed out oldest first, and only once
+		TS_ASSERT(!queue.request(5));
+		TS_ASSERT(!queue.request(2));
+		TS_ASSERT(!queue.request(5));
+		TS_ASSERT(!queue.request(7));
+		TS_ASSERT_EQUALS(queue.pendingRequests(), 3u);
+
+		uint index = 0;
+		TS_ASSERT(queue.next(index));
+		TS_ASSERT_EQUALS(index, 5u);
+		TS_ASSERT(queue.next(index));
+		TS_ASSERT_EQUALS(index, 2u);
+		TS_ASSERT(queue.next(index));
+		TS_ASSERT_EQUALS(index, 7u);
+		TS_ASSERT(!queue.next(index));
+	}
+
+	void test_queue_loaded() {
+		GUI::SaveMetaInfoQueue queue;
+		queue.reset(4);
+
+		// Entries which are read already are not queued
+		queue.setLoaded(1);
+		TS_ASSERT(queue.request(1));
+		TS_ASSERT_EQUALS(queue.pendingRequests(), 0u);
+
+		// Entries which are read while queued are skipped
+		TS_ASSERT(!queue.request(0));
+		TS_ASSERT(!queue.request(3));
+		queue.setLoaded(0);
+		uint index = 0;
+		TS_ASSERT(queue.next(index));
+		TS_ASSERT_EQUALS(index, 3u);
+		TS_ASSERT(!queue.next(index));
+	}
+
+	void test_queue_reset() {
+		GUI::SaveMetaInfoQueue queue;
+		queue.reset(8);
+		queue.setLoaded(2);
+		queue.request(6);
+		queue.request(7);
+
+		// A page change drops the requests, but keeps what was read
+		queue.clearRequests();
+		uint index = 0;
+		TS_ASSERT(!queue.next(index));
+		TS_ASSERT(queue.isLoaded(2));
+
+		// Requests for entries which are gone after a refresh are skipped
+		queue.request(6);
+		queue.request(1);
+		queue.reset(3);
+		TS_ASSERT(!queue.isLoaded(2));
+		TS_ASSERT(!queue.next(index));
+		queue.request(1);
+		queue.reset(8);
+		TS_ASSERT(!queue.next(index));
+	}
+
+	void test_cache_get_put() {
+		Cache cache(1024 * 1024);
+		int value = 0;
+		TS_ASSERT(!cache.get(key(1), value));
+
+		cache.put(key(1), 10, 100);
+		cache.put(key(2), 20, 100);
+		TS_ASSERT(cache.get(key(1), value));
+		TS_ASSERT_EQUALS(value, 10);
+		TS_ASSERT(cache.get(key(2), value));
+		TS_ASSERT_EQUALS(value, 20);
+
+		// Replacing an entry does not count its size twice
+		const uint32 size = cache.size();
+		cache.put(key(1), 11, 100);
+		TS_ASSERT_EQUALS(cache.size(), size);
+		TS_ASSERT_EQUALS(cache.count(), 2u);
+		TS_ASSERT(cache.get(key(1), value));
+		TS_ASSERT_EQUALS(value, 11);
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.count(), 0u);
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+		TS_ASSERT(!cache.get(key(1), value));
+	}
+
+	void test_cache_eviction() {
+		// Room for three entries of 1000 bytes
+		Cache probe(1024 * 1024);
+		probe.put(key(0), 0, 1000);
+		Cache cache(probe.size() * 3);
+
+		cache.put(key(1), 1, 1000);
+		cache.put(key(2), 2, 1000);
+		cache.put(key(3), 3, 1000);
+		TS_ASSERT_EQUALS(cache.count(), 3u);
+
+		// Using the oldest entry makes the second one the least recently used
+		int value = 0;
+		TS_ASSERT(cache.get(key(1), value));
+		cache.put(key(4), 4, 1000);
+		TS_ASSERT_EQUALS(cache.count(), 3u);
+		TS_ASSERT(!cache.contains(key(2)));
+		TS_ASSERT(cache.contains(key(1)));
+		TS_ASSERT(cache.contains(key(3)));
+		TS_ASSERT(cache.contains(key(4)));
+
+		cache.put(key(5), 5, 1000);
+		TS_ASSERT(!cache.contains(key(3)));
+		TS_ASSERT(cache.contains(key(1)));
+		TS_ASSERT(cache.size() <= probe.size() * 3);
+
+		// An entry which is too big on its own still replaces all others
+		cache.put(key(6), 6, 1000000);
+		TS_ASSERT_EQUALS(cache.count(), 1u);
+		TS_ASSERT(cache.get(key(6), value));
+		TS_ASSERT_EQUALS(value, 6);
+	}
+};
@@ -5,30 +5,39 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
-TEST_LIBS    :=
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h $(srcdir)/test/engines/*.h $(srcdir)/test/gui/*.h
+TEST_LIBS    := test/test_helpers.o
 
 ifdef POSIX
+TESTS += $(srcdir)/test/backends/*.h
 TEST_LIBS += test/null_osystem.o \
+	backends/saves/default/default-savewriter.o \
+	backends/mutex/pthread/pthread-mutex.o \
+	backends/threads/pthread/pthread-threads.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mmapstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mixer/null/null-mixer.o
 endif
 
 ifdef WIN32
+TESTS += $(srcdir)/test/backends/*.h
 TEST_LIBS += test/null_osystem.o \
+	backends/saves/default/default-savewriter.o \
 	backends/fs/windows/windows-fs-factory.o \
 	backends/fs/windows/windows-fs.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o \
+	backends/mixer/null/null-mixer.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	engines/detectioncache.o gui/saveload-metainfo.o video/libvideo.a audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -73,9 +82,15 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+# Scaler benchmark, see test/scaler/scalerbench.cpp
+scaler-bench: test/scalerbench
+test/scalerbench: $(srcdir)/test/scaler/scalerbench.cpp $(srcdir)/test/scaler/frames.h $(TEST_LIBS)
+	@mkdir -p test
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $(srcdir)/test/scaler/scalerbench.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat
+	-$(RM) test/runner.cpp test/runner test/scalerbench test/engine-data/encoding.dat
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -84,4 +99,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test scaler-bench clean-test copy-dat
@@ -4,7 +4,10 @@
 #include "../backends/platform/null/null.cpp"
 
 void Common::install_null_g_system() {
-	g_system = OSystem_NULL_create();
+	OSystem_NULL *system = new OSystem_NULL();
+	g_system = system;
+	// The mixer needs g_system to be set
+	system->initMixerForTest();
 }
 
 bool BaseBackend::setScaler(const char *name, int factor) {
@@ -0,0 +1,302 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_SCALER_FRAMES_H
+#define TEST_SCALER_FRAMES_H
+
+/*
+ * Test frames and helpers shared by the scaler conformance tests in
+ * test/graphics/scalers.h and the scaler benchmark in test/scaler/scalerbench.cpp.
+ */
+
+#include "common/array.h"
+#include "common/util.h"
+#include "graphics/font.h"
+#include "graphics/fontman.h"
+#include "graphics/scalerplugin.h"
+#include "graphics/surface.h"
+
+#include "base/plugins.h"
+
+#include "../test_helpers.h"
+
+namespace ScalerTest {
+
+enum {
+	kFrameWidth = 320,
+	kFrameHeight = 200,
+	kNumTestFrames = 2,
+	/** Rows and columns around every frame, as the backends provide them */
+	kPadding = 4
+};
+
+inline const char *getTestFrameName(int index) {
+	static const char *const names[kNumTestFrames] = { "adventure", "video" };
+	return names[index];
+}
+
+/**
+ * Draw one of the built-in test frames, as a paletted 320x200 image.
+ *
+ * Game data can not be shipped with the tests, so the frames are generated
+ * to look like typical game content instead:
+ * 0. An adventure game scene with a banded sky, dithered ground, outlined
+ *    tiles, sprites and console font text.
+ * 1. A frame of a dithered, palette reduced video, with smooth gradients
+ *    and noise.
+ *
+ * @param palette  Receives 256 RGB entries.
+ */
+inline void drawTestFrame(int index, Graphics::Surface &dst, byte *palette) {
+	dst.create(kFrameWidth, kFrameHeight, Graphics::PixelFormat::createFormatCLUT8());
+	uint32 seed = 12345 + index;
+
+	if (index == 0) {
+		// VGA style palette: 6 bit components, several ramps
+		for (int i = 0; i < 256; ++i) {
+			const int level = (i & 0x3f) << 2;
+			switch (i >> 6) {
+			case 0: // sky blues
+				palette[i * 3 + 0] = level / 4;
+				palette[i * 3 + 1] = level / 2;
+				palette[i * 3 + 2] = level;
+				break;
+			case 1: // greens and browns
+				palette[i * 3 + 0] = level * 3 / 4;
+				palette[i * 3 + 1] = level;
+				palette[i * 3 + 2] = level / 4;
+				break;
+			case 2: // skin and wood
+				palette[i * 3 + 0] = level;
+				palette[i * 3 + 1] = level * 2 / 3;
+				palette[i * 3 + 2] = level / 3;
+				break;
+			default: // greys
+				palette[i * 3 + 0] = level;
+				palette[i * 3 + 1] = level;
+				palette[i * 3 + 2] = level;
+				break;
+			}
+		}
+
+		// Sky in bands of 8 rows
+		for (int y = 0; y < 100; ++y)
+			memset(dst.getBasePtr(0, y), 20 + y / 8, kFrameWidth);
+
+		// Ground, dithered between two greens
+		for (int y = 100; y < kFrameHeight; ++y) {
+			byte *row = (byte *)dst.getBasePtr(0, y);
+			for (int x = 0; x < kFrameWidth; ++x)
+				row[x] = ((x + y) & 1) ? 64 + 30 + y / 20 : 64 + 26 + y / 25;
+		}
+
+		// A brick wall with dark outlines
+		for (int y = 60; y < 140; ++y) {
+			byte *row = (byte *)dst.getBasePtr(0, y);
+			const int offset = ((y - 60) / 10) & 1 ? 10 : 0;
+			for (int x = 180; x < 300; ++x) {
+				const bool mortar = ((y - 60) % 10 == 0) || ((x + offset) % 20 == 0);
+				row[x] = mortar ? 192 + 12 : 128 + 40 + ((x * 7 + y * 3) % 5);
+			}
+		}
+
+		// Sprites: outlined circles with shading
+		static const int sprites[][3] = { { 60, 130, 25 }, { 120, 150, 18 }, { 240, 170, 12 } };
+		for (int s = 0; s < ARRAYSIZE(sprites); ++s) {
+			const int cx = sprites[s][0], cy = sprites[s][1], r = sprites[s][2];
+			for (int y = cy - r; y <= cy + r; ++y) {
+				byte *row = (byte *)dst.getBasePtr(0, y);
+				for (int x = cx - r; x <= cx + r; ++x) {
+					const int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+					if (d > r * r)
+						continue;
+					if (d > (r - 2) * (r - 2))
+						row[x] = 192;
+					else
+						row[x] = 128 + 63 - ((x - cx + r) * 30 / (2 * r)) - ((y - cy + r) * 20 / (2 * r));
+				}
+			}
+		}
+
+		// A few stars with single pixel details
+		for (int i = 0; i < 60; ++i) {
+			Test::nextSeed(seed);
+			const int x = (seed >> 8) % kFrameWidth;
+			const int y = (seed >> 20) % 60;
+			*(byte *)dst.getBasePtr(x, y) = 255;
+		}
+
+		// Dialog text
+		const Graphics::Font *font = FontMan.getFontByUsage(Graphics::FontManager::kConsoleFont);
+		if (font) {
+			dst.fillRect(Common::Rect(8, 4, 312, 30), 192 + 4);
+			dst.frameRect(Common::Rect(8, 4, 312, 30), 255);
+			font->drawString(&dst, "Look at the strange old brick wall.", 12, 8, 296, 255);
+			font->drawString(&dst, "Pick up  Use  Talk to  Walk to", 12, 18, 296, 192 + 48);
+		}
+	} else {
+		// 6x6x6 color cube plus greys, as used by many video codecs
+		for (int i = 0; i < 216; ++i) {
+			palette[i * 3 + 0] = (i / 36) * 51;
+			palette[i * 3 + 1] = ((i / 6) % 6) * 51;
+			palette[i * 3 + 2] = (i % 6) * 51;
+		}
+		for (int i = 216; i < 256; ++i)
+			memset(palette + i * 3, (i - 216) * 255 / 39, 3);
+
+		// Smooth shapes, dithered with noise into the color cube
+		for (int y = 0; y < kFrameHeight; ++y) {
+			byte *row = (byte *)dst.getBasePtr(0, y);
+			for (int x = 0; x < kFrameWidth; ++x) {
+				const int noise = (int)((Test::nextSeed(seed) >> 16) & 0x1f) - 16;
+				const int dx = x - 200, dy = y - 90;
+				const int r = CLIP(x * 255 / kFrameWidth + noise, 0, 255);
+				const int g = CLIP(255 - (dx * dx + dy * dy) / 80 + noise, 0, 255);
+				const int b = CLIP(y * 255 / kFrameHeight + noise, 0, 255);
+				row[x] = ((r + 25) / 51) * 36 + ((g + 25) / 51) * 6 + (b + 25) / 51;
+			}
+		}
+	}
+}
+
+/**
+ * A frame with kPadding pixels around it, which the scalers read past the
+ * edges of the area they scale.
+ */
+class PaddedFrame {
+public:
+	PaddedFrame(const Graphics::Surface &frame, const Graphics::PixelFormat &format, const byte *palette = nullptr) {
+		Graphics::Surface *converted = frame.convertTo(format, palette);
+
+		_surface.create(frame.w + 2 * kPadding, frame.h + 2 * kPadding, format);
+		_surface.copyRectToSurface(*converted, kPadding, kPadding, Common::Rect(frame.w, frame.h));
+
+		// Repeat the edge pixels into the padding
+		const int bpp = format.bytesPerPixel;
+		for (int y = 0; y < _surface.h; ++y) {
+			const int srcY = CLIP(y - kPadding, 0, frame.h - 1);
+			byte *row = (byte *)_surface.getBasePtr(0, y);
+			const byte *srcRow = (const byte *)converted->getBasePtr(0, srcY);
+			for (int x = 0; x < _surface.w; ++x)
+				memcpy(row + x * bpp, srcRow + CLIP(x - kPadding, 0, frame.w - 1) * bpp, bpp);
+		}
+
+		converted->free();
+		delete converted;
+	}
+
+	~PaddedFrame() { _surface.free(); }
+
+	int width() const { return _surface.w - 2 * kPadding; }
+	int height() const { return _surface.h - 2 * kPadding; }
+	uint32 pitch() const { return _surface.pitch; }
+	const Graphics::PixelFormat &format() const { return _surface.format; }
+
+	/** The first pixel inside the padding */
+	const byte *pixels() const { return (const byte *)_surface.getBasePtr(kPadding, kPadding); }
+
+private:
+	Graphics::Surface _surface;
+};
+
+/**
+ * Checksum of the pixel values, independent of the byte order.
+ * This is the 32 bit FNV-1a hash over the little endian pixel values.
+ */
+inline uint32 checksumPixels(const byte *pixels, uint32 pitch, int width, int height, int bytesPerPixel) {
+	uint32 hash = 2166136261u;
+	for (int y = 0; y < height; ++y) {
+		const byte *row = pixels + y * pitch;
+		for (int x = 0; x < width; ++x) {
+			const uint32 value = bytesPerPixel == 2 ? *(const uint16 *)(row + x * 2) : *(const uint32 *)(row + x * 4);
+			for (int i = 0; i < bytesPerPixel; ++i) {
+				hash ^= (value >> (i * 8)) & 0xff;
+				hash *= 16777619u;
+			}
+		}
+	}
+	return hash;
+}
+
+/** The pixel formats the scalers are tested with */
+inline Graphics::PixelFormat getTestFormat(int bytesPerPixel) {
+	if (bytesPerPixel == 2)
+		return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+}
+
+} // End of namespace ScalerTest
+
+// The scaler plugins built into ScummVM. This mirrors the list in
+// base/plugins.cpp, without going through the plugin manager.
+#define SCALER_TEST_PLUGINS_BASE \
+	SCALER_TEST_PLUGIN(NORMAL)
+
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+#define SCALER_TEST_PLUGINS_HQ SCALER_TEST_PLUGIN(HQ)
+#else
+#define SCALER_TEST_PLUGINS_HQ
+#endif
+
+#if defined(USE_SCALERS) && defined(USE_EDGE_SCALERS)
+#define SCALER_TEST_PLUGINS_EDGE SCALER_TEST_PLUGIN(EDGE)
+#else
+#define SCALER_TEST_PLUGINS_EDGE
+#endif
+
+#ifdef USE_SCALERS
+#define SCALER_TEST_PLUGINS_OTHER \
+	SCALER_TEST_PLUGIN(ADVMAME) \
+	SCALER_TEST_PLUGIN(SAI) \
+	SCALER_TEST_PLUGIN(SUPERSAI) \
+	SCALER_TEST_PLUGIN(SUPEREAGLE) \
+	SCALER_TEST_PLUGIN(PM) \
+	SCALER_TEST_PLUGIN(DOTMATRIX) \
+	SCALER_TEST_PLUGIN(TV)
+#else
+#define SCALER_TEST_PLUGINS_OTHER
+#endif
+
+#define SCALER_TEST_PLUGINS \
+	SCALER_TEST_PLUGINS_BASE \
+	SCALER_TEST_PLUGINS_HQ \
+	SCALER_TEST_PLUGINS_EDGE \
+	SCALER_TEST_PLUGINS_OTHER
+
+#define SCALER_TEST_PLUGIN(ID) extern PluginObject *g_##ID##_getObject();
+SCALER_TEST_PLUGINS
+#undef SCALER_TEST_PLUGIN
+
+namespace ScalerTest {
+
+/**
+ * Create all scaler plugins built into ScummVM. The caller has to delete
+ * them.
+ */
+inline void createScalerPlugins(Common::Array<ScalerPluginObject *> &plugins) {
+#define SCALER_TEST_PLUGIN(ID) plugins.push_back(static_cast<ScalerPluginObject *>(g_##ID##_getObject()));
+	SCALER_TEST_PLUGINS
+#undef SCALER_TEST_PLUGIN
+}
+
+} // End of namespace ScalerTest
+
+#endif
@@ -0,0 +1,202 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Scaler benchmark. Build it with "make scaler-bench".
+ *
+ * Usage: test/scalerbench [--checksums] [--time=<msecs>] [frame.bmp|frame.png ...]
+ *
+ * Every scaler plugin scales every frame at 16bpp and 32bpp, with every
+ * factor it supports. The speed is reported in megapixels of the source
+ * frame per second, together with the checksum of the output. Without any
+ * arguments the built-in test frames are used, otherwise the given
+ * screenshots, which should be recorded from real games at their original
+ * resolution.
+ *
+ * With --checksums, the checksums of the built-in frames are printed in the
+ * form used by test/graphics/scalers.h instead.
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/str.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "image/bmp.h"
+#include "image/png.h"
+
+#include "../null_osystem.h"
+#include "frames.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct BenchFrame {
+	Common::String name;
+	Graphics::Surface surface;
+	byte palette[256 * 3];
+};
+
+static bool loadFrame(const char *path, BenchFrame &frame) {
+	Common::FSNode node(path);
+	Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+	if (!stream) {
+		fprintf(stderr, "Could not open '%s'\n", path);
+		return false;
+	}
+
+	Common::ScopedPtr<Image::ImageDecoder> decoder;
+	const Common::String name = node.getName();
+#ifdef USE_PNG
+	if (name.hasSuffixIgnoreCase(".png"))
+		decoder.reset(new Image::PNGDecoder());
+	else
+#endif
+		decoder.reset(new Image::BitmapDecoder());
+
+	if (!decoder->loadStream(*stream) || !decoder->getSurface()) {
+		fprintf(stderr, "Could not decode '%s'\n", path);
+		return false;
+	}
+
+	frame.name = name;
+	frame.surface.copyFrom(*decoder->getSurface());
+	memset(frame.palette, 0, sizeof(frame.palette));
+	if (decoder->hasPalette())
+		memcpy(frame.palette, decoder->getPalette(), decoder->getPaletteColorCount() * 3);
+	return true;
+}
+
+static void benchScaler(ScalerPluginObject *plugin, int bytesPerPixel, const Common::Array<BenchFrame *> &frames, uint32 minTime) {
+	const Graphics::PixelFormat format = ScalerTest::getTestFormat(bytesPerPixel);
+	Scaler *scaler = plugin->createInstance(format);
+
+	const Common::Array<uint> &factors = plugin->getFactors();
+	for (uint f = 0; f < factors.size(); ++f) {
+		const uint factor = factors[f];
+		scaler->setFactor(factor);
+
+		for (uint i = 0; i < frames.size(); ++i) {
+			ScalerTest::PaddedFrame src(frames[i]->surface, format, frames[i]->palette);
+			const uint32 dstPitch = src.width() * factor * bytesPerPixel;
+			Common::Array<byte> dst(dstPitch * src.height() * factor);
+
+			// Scale until at least minTime has passed, after a warm up run
+			scaler->scale(src.pixels(), src.pitch(), &dst[0], dstPitch, src.width(), src.height(), 0, 0);
+			uint runs = 0;
+			const uint32 start = g_system->getMillis();
+			uint32 elapsed;
+			do {
+				scaler->scale(src.pixels(), src.pitch(), &dst[0], dstPitch, src.width(), src.height(), 0, 0);
+				++runs;
+				elapsed = g_system->getMillis() - start;
+			} while (elapsed < minTime);
+
+			const double mpixels = (double)src.width() * src.height() * runs / 1000000.0;
+			const uint32 checksum = ScalerTest::checksumPixels(&dst[0], dstPitch, src.width() * factor, src.height() * factor, bytesPerPixel);
+			printf("%-12s %ux  %dbpp  %-16s %10.2f MPix/s  %08x\n", plugin->getName(), factor, bytesPerPixel * 8,
+				frames[i]->name.c_str(), mpixels * 1000.0 / MAX<uint32>(elapsed, 1), checksum);
+		}
+	}
+
+	delete scaler;
+}
+
+static void printChecksums(ScalerPluginObject *plugin, int bytesPerPixel, const Common::Array<BenchFrame *> &frames) {
+	const Graphics::PixelFormat format = ScalerTest::getTestFormat(bytesPerPixel);
+	Scaler *scaler = plugin->createInstance(format);
+
+	const Common::Array<uint> &factors = plugin->getFactors();
+	for (uint f = 0; f < factors.size(); ++f) {
+		scaler->setFactor(factors[f]);
+
+		for (uint i = 0; i < frames.size(); ++i) {
+			ScalerTest::PaddedFrame src(frames[i]->surface, format, frames[i]->palette);
+			const uint32 dstPitch = src.width() * factors[f] * bytesPerPixel;
+			Common::Array<byte> dst(dstPitch * src.height() * factors[f]);
+
+			scaler->scale(src.pixels(), src.pitch(), &dst[0], dstPitch, src.width(), src.height(), 0, 0);
+			printf("\t\t\t{ \"%s\", %u, %d, %u, 0x%08x },\n", plugin->getName(), factors[f], bytesPerPixel, i,
+				ScalerTest::checksumPixels(&dst[0], dstPitch, src.width() * factors[f], src.height() * factors[f], bytesPerPixel));
+		}
+	}
+
+	delete scaler;
+}
+
+int main(int argc, char *argv[]) {
+	Common::install_null_g_system();
+
+	bool checksums = false;
+	uint32 minTime = 500;
+	Common::Array<BenchFrame *> frames;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--checksums")) {
+			checksums = true;
+		} else if (!strncmp(argv[i], "--time=", 7)) {
+			minTime = atoi(argv[i] + 7);
+		} else {
+			BenchFrame *frame = new BenchFrame();
+			if (!loadFrame(argv[i], *frame)) {
+				delete frame;
+				return 1;
+			}
+			frames.push_back(frame);
+		}
+	}
+
+	if (checksums && !frames.empty()) {
+		fprintf(stderr, "--checksums only works with the built-in frames\n");
+		return 1;
+	}
+
+	if (frames.empty()) {
+		for (int i = 0; i < ScalerTest::kNumTestFrames; ++i) {
+			BenchFrame *frame = new BenchFrame();
+			frame->name = ScalerTest::getTestFrameName(i);
+			ScalerTest::drawTestFrame(i, frame->surface, frame->palette);
+			frames.push_back(frame);
+		}
+	}
+
+	Common::Array<ScalerPluginObject *> plugins;
+	ScalerTest::createScalerPlugins(plugins);
+
+	for (uint i = 0; i < plugins.size(); ++i) {
+		for (int bytesPerPixel = 2; bytesPerPixel <= 4; bytesPerPixel += 2) {
+			if (checksums)
+				printChecksums(plugins[i], bytesPerPixel, frames);
+			else
+				benchScaler(plugins[i], bytesPerPixel, frames, minTime);
+		}
+		delete plugins[i];
+	}
+
+	for (uint i = 0; i < frames.size(); ++i) {
+		frames[i]->surface.free();
+		delete frames[i];
+	}
+
+	return 0;
+}
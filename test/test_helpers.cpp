@@ -0,0 +1,10 @@
+#define FORBIDDEN_SYMBOL_EXCEPTION_getenv
+
+#include "test_helpers.h"
+
+#include <stdlib.h>
+
+bool Test::benchmarksEnabled() {
+	const char *value = getenv("SCUMMVM_TEST_BENCHMARKS");
+	return value && *value && strcmp(value, "0") != 0;
+}
@@ -0,0 +1,31 @@
+#ifndef TEST_HELPERS
+#define TEST_HELPERS 1
+
+#include "common/scummsys.h"
+
+namespace Test {
+
+/**
+ * Advance a linear congruential generator and return its new state. The
+ * test data built from it is the same on every platform, unlike rand().
+ */
+inline uint32 nextSeed(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return seed;
+}
+
+/** The upper 24 bits of the next state, which are the better mixed ones. */
+inline uint32 nextRandom(uint32 &seed) {
+	return nextSeed(seed) >> 8;
+}
+
+/**
+ * Whether the timing tests should run. They are slow and their results
+ * depend on the host, so they only run if the SCUMMVM_TEST_BENCHMARKS
+ * environment variable is set.
+ */
+bool benchmarksEnabled();
+
+} // End of namespace Test
+
+#endif
@@ -0,0 +1,249 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+#include "../test_helpers.h"
+
+/**
+ * A video of synthetic 8bpp frames. Every frame changes the palette, and
+ * decoding a frame can be made to take some time. Like the AVI decoder,
+ * it can be told to only decode ahead while playing forward.
+ */
+class SyntheticVideoDecoder : public Video::VideoDecoder {
+public:
+	SyntheticVideoDecoder(int frameCount, int frameRate, uint decodeMillis, bool forwardOnly = false) : _forwardOnly(forwardOnly) {
+		_track = new SyntheticVideoTrack(frameCount, frameRate, decodeMillis);
+		addTrack(_track);
+	}
+
+	~SyntheticVideoDecoder() {
+		close();
+	}
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		return false;
+	}
+
+protected:
+	bool supportsDecodeAhead() const override { return !_forwardOnly || !_track->isReversed(); }
+
+private:
+	class SyntheticVideoTrack : public FixedRateVideoTrack {
+	public:
+		SyntheticVideoTrack(int frameCount, int frameRate, uint decodeMillis)
+			: _frameCount(frameCount), _frameRate(frameRate), _decodeMillis(decodeMillis), _curFrame(-1), _reversed(false), _dirtyPalette(false) {
+			_surface.create(64, 48, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~SyntheticVideoTrack() {
+			_surface.free();
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+
+		bool setReverse(bool reverse) override {
+			_reversed = reverse;
+			return true;
+		}
+		bool isReversed() const override { return _reversed; }
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			if (_decodeMillis)
+				g_system->delayMillis(_decodeMillis);
+
+			for (int y = 0; y < _surface.h; y++)
+				for (int x = 0; x < _surface.w; x++)
+					*(byte *)_surface.getBasePtr(x, y) = (_curFrame * 7 + x + y * 3) & 0xFF;
+
+			for (int i = 0; i < 256 * 3; i++)
+				_palette[i] = (_curFrame + i) & 0xFF;
+			_dirtyPalette = true;
+
+			return &_surface;
+		}
+
+		const byte *getPalette() const override {
+			_dirtyPalette = false;
+			return _palette;
+		}
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return _frameRate; }
+
+	private:
+		int _frameCount;
+		int _frameRate;
+		uint _decodeMillis;
+		int _curFrame;
+		bool _reversed;
+		Graphics::Surface _surface;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+
+	SyntheticVideoTrack *_track;
+	bool _forwardOnly;
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	static bool sameFrame(const Graphics::Surface *a, const Graphics::Surface *b) {
+		if (!a || !b)
+			return a == b;
+		if (a->w != b->w || a->h != b->h || a->format != b->format)
+			return false;
+
+		for (int y = 0; y < a->h; y++)
+			if (memcmp(a->getBasePtr(0, y), b->getBasePtr(0, y), a->w * a->format.bytesPerPixel))
+				return false;
+
+		return true;
+	}
+
+	// Decode the given number of frames with both decoders and compare
+	// what they report
+	static void compareFrames(SyntheticVideoDecoder &sync, SyntheticVideoDecoder &ahead, int frames) {
+		for (int i = 0; i < frames; i++) {
+			TS_ASSERT_EQUALS(sync.needsUpdate(), ahead.needsUpdate());
+			TS_ASSERT(sameFrame(sync.decodeNextFrame(), ahead.decodeNextFrame()));
+			TS_ASSERT_EQUALS(sync.getCurFrame(), ahead.getCurFrame());
+			TS_ASSERT_EQUALS(sync.getTimeToNextFrame(), ahead.getTimeToNextFrame());
+			TS_ASSERT_EQUALS(sync.endOfVideo(), ahead.endOfVideo());
+			TS_ASSERT_EQUALS(sync.hasDirtyPalette(), ahead.hasDirtyPalette());
+			if (sync.hasDirtyPalette() && ahead.hasDirtyPalette())
+				TS_ASSERT(memcmp(sync.getPalette(), ahead.getPalette(), 256 * 3) == 0);
+		}
+	}
+
+public:
+	void test_decode_ahead_matches_sync() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		SyntheticVideoDecoder sync(40, 30, 0), ahead(40, 30, 0);
+		ahead.setDecodeAhead(4);
+		TS_ASSERT(!ahead.isDecodingAhead());
+
+		compareFrames(sync, ahead, 15);
+		TS_ASSERT(ahead.isDecodingAhead());
+
+		// Seeking discards the frames decoded ahead
+		TS_ASSERT(sync.seekToFrame(30));
+		TS_ASSERT(ahead.seekToFrame(30));
+		TS_ASSERT_EQUALS(sync.getCurFrame(), ahead.getCurFrame());
+		compareFrames(sync, ahead, 10);
+
+		TS_ASSERT(ahead.endOfVideo());
+		TS_ASSERT(!ahead.decodeNextFrame());
+
+		TS_ASSERT(sync.rewind());
+		TS_ASSERT(ahead.rewind());
+		TS_ASSERT(!ahead.endOfVideo());
+		compareFrames(sync, ahead, 5);
+
+		const Video::VideoDecoder::DecodeAheadStats stats = ahead.getDecodeAheadStats();
+		TS_ASSERT_EQUALS(stats.capacity, 4u);
+		TS_ASSERT_EQUALS(stats.presentedFrames, 30u);
+		TS_ASSERT_EQUALS(stats.droppedFrames, 0u);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.queuedFrames, 4u);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.presentedFrames, stats.decodedFrames);
+
+		ahead.close();
+		TS_ASSERT(!ahead.isDecodingAhead());
+		TS_ASSERT_EQUALS(ahead.getDecodeAheadStats().presentedFrames, 0u);
+#endif
+	}
+
+	void test_decode_ahead_forward_only() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		SyntheticVideoDecoder video(40, 30, 0, true);
+		video.setDecodeAhead(4);
+		TS_ASSERT(video.decodeNextFrame());
+		if (!video.isDecodingAhead()) {
+			TS_TRACE("Threads are not supported, skipping");
+			return;
+		}
+
+		// The worker is stopped while playing in reverse, and started
+		// again once playing forward
+		TS_ASSERT(video.setReverse(true));
+		TS_ASSERT(!video.isDecodingAhead());
+		TS_ASSERT(video.setReverse(false));
+		TS_ASSERT(video.decodeNextFrame());
+		TS_ASSERT(video.isDecodingAhead());
+#endif
+	}
+
+	void test_drop_late_frames() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Ten milliseconds per frame
+		SyntheticVideoDecoder video(50, 100, 0);
+		video.setDecodeAhead(4, true);
+		video.start();
+		TS_ASSERT(video.decodeNextFrame());
+		TS_ASSERT_EQUALS(video.getCurFrame(), 0);
+
+		// Let the queue fill up and the queued frames run late
+		while (video.getDecodeAheadStats().queuedFrames < 4)
+			g_system->delayMillis(1);
+		g_system->delayMillis(100);
+
+		// Only the newest queued frame is shown, with the palette of the
+		// skipped ones applied before its own
+		TS_ASSERT(video.decodeNextFrame());
+		TS_ASSERT_EQUALS(video.getCurFrame(), 4);
+		TS_ASSERT(video.hasDirtyPalette());
+		TS_ASSERT_EQUALS(video.getPalette()[0], 4);
+
+		const Video::VideoDecoder::DecodeAheadStats stats = video.getDecodeAheadStats();
+		TS_ASSERT_EQUALS(stats.presentedFrames, 2u);
+		TS_ASSERT_EQUALS(stats.droppedFrames, 3u);
+#endif
+	}
+
+	void test_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!Test::benchmarksEnabled())
+			return;
+		Common::install_null_g_system();
+
+		// Decoding and showing a frame both take two milliseconds, which
+		// overlap when decoding ahead
+		const int frames = 50;
+		uint32 times[2];
+		for (int ahead = 0; ahead < 2; ahead++) {
+			SyntheticVideoDecoder video(frames, 30, 2);
+			video.setDecodeAhead(ahead ? 4 : 0);
+
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < frames; i++) {
+				video.decodeNextFrame();
+				g_system->delayMillis(2);
+			}
+			times[ahead] = g_system->getMillis() - start;
+		}
+		TS_ASSERT_LESS_THAN(times[1], times[0]);
+
+		TS_TRACE(Common::String::format("%d frames taking 2 ms to decode and 2 ms to show: synchronous %u ms, decoded ahead %u ms", frames, times[0], times[1]).c_str());
+#endif
+	}
+};
@@ -136,6 +136,16 @@ bool AVIDecoder::isSeekable() const {
 	return isVideoLoaded() && !_indexEntries.empty();
 }
 
+bool AVIDecoder::supportsDecodeAhead() const {
+	// decodeNextFrame() seeks the tracks when playing in reverse
+	for (uint idx = 0; idx < _videoTracks.size(); ++idx) {
+		if (static_cast<const AVIVideoTrack *>(_videoTracks[idx].track)->isReversed())
+			return false;
+	}
+
+	return true;
+}
+
 const Graphics::Surface *AVIDecoder::decodeNextFrame() {
 	AVIVideoTrack *track = nullptr;
 	bool isReversed = false;
@@ -102,6 +102,7 @@ protected:
 	bool seekIntern(const Audio::Timestamp &time);
 	bool supportsAudioTrackSwitching() const { return true; }
 	AudioTrack *getAudioTrack(int index);
+	bool supportsDecodeAhead() const;
 
 	/**
 	 * Define a track to be used by this class.
@@ -582,6 +582,10 @@ public:
 
 	void setSurfaceMemory(void *mem, uint16 width, uint16 height, uint8 bpp);
 
+protected:
+	// setSurfaceMemory() replaces the surface the track decodes into
+	bool supportsDecodeAhead() const { return false; }
+
 private:
 	class VMDVideoTrack : public FixedRateVideoTrack {
 	public:
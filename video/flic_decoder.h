@@ -58,6 +58,9 @@ public:
 	void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
 protected:
+	// The dirty rects describe the frame last decoded by the track
+	bool supportsDecodeAhead() const { return false; }
+
 	class FlicVideoTrack : public VideoTrack {
 	public:
 		FlicVideoTrack(Common::SeekableReadStream *stream, uint16 frameCount, uint16 width, uint16 height, bool skipHeader = false);
@@ -61,6 +61,8 @@ public:
 protected:
 	void readNextPacket();
 	bool useAudioSync() const { return false; }
+	// readNextPacket() adds the tracks as they are found
+	bool supportsDecodeAhead() const { return false; }
 
 private:
 	class MPEGPSDemuxer {
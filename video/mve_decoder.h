@@ -164,6 +164,11 @@ public:
 
 	Common::Rational getFrameRate() { return _frameRate; }
 	void readNextPacket();
+
+protected:
+	// applyPalette() uses the palette of the packet read last, and
+	// setAudioTrack() changes what readNextPacket() does
+	bool supportsDecodeAhead() const { return false; }
 };
 
 } // End of namespace Video
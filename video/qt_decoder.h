@@ -73,6 +73,9 @@ public:
 	void enableEditListBoundsCheckQuirk(bool enable) { _enableEditListBoundsCheckQuirk = enable; }
 
 protected:
+	// decodeNextFrame() also fills the audio buffers from the file
+	bool supportsDecodeAhead() const { return false; }
+
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
 
 private:
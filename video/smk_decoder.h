@@ -78,6 +78,9 @@ protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
 	AudioTrack *getAudioTrack(int index);
+	// forceSeekToFrame() uses the track and the stream directly, and
+	// getNextDirtyRect() describes the frame last decoded by the track
+	bool supportsDecodeAhead() const { return false; }
 
 	virtual void handleAudioTrack(byte track, uint32 chunkSize, uint32 unpackedSize);
 
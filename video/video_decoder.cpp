@@ -26,12 +26,356 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
+
+#include <atomic>
 
 namespace Video {
 
+enum {
+	/** How long the decode-ahead worker sleeps when the queue is full, in milliseconds. */
+	kDecodeAheadIdleTimeout = 10,
+	/** How long decodeNextFrame() waits for the worker at a time, in milliseconds. */
+	kDecodeAheadWaitTimeout = 10
+};
+
+/**
+ * Decodes the frames of a VideoDecoder on a worker thread into a ring of
+ * surfaces.
+ *
+ * The ring has one slot more than the number of frames decoded ahead, so
+ * the frame last returned by nextFrame() is not overwritten until the next
+ * call. The worker only touches the tracks with the decoder's _trackMutex
+ * held, and records the state of the video tracks after each frame, which
+ * the decoder then reports instead of the state of the tracks themselves.
+ */
+class VideoDecoder::DecodeAhead {
+public:
+	/** The state of a video track after decoding a frame. */
+	struct TrackState {
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+		bool reversed;
+	};
+
+	/** The state of all video tracks, in the order of the decoder's tracks. */
+	struct State {
+		Common::Array<TrackState> tracks;
+		/** The index of the track with the next frame, or -1 if there is none. */
+		int nextTrack;
+	};
+
+	DecodeAhead(VideoDecoder *decoder, uint frames);
+	/** Stops the worker thread. Must not be called with _trackMutex held. */
+	~DecodeAhead();
+
+	/**
+	 * Start the worker thread.
+	 *
+	 * @return true on success, false if the backend does not support threads.
+	 */
+	bool start();
+
+	/**
+	 * Return the next decoded frame, waiting for the worker if necessary.
+	 *
+	 * @param dropLateFrames  Whether to skip frames whose successor is due.
+	 * @return the frame, or 0 if there is no frame or the track did not
+	 *         return one
+	 */
+	const Graphics::Surface *nextFrame(bool dropLateFrames);
+
+	/**
+	 * Discard the queued frames after the tracks were changed, e.g. by
+	 * seeking. Must be called with _trackMutex held.
+	 */
+	void reset();
+
+	/** The state of the tracks after the frame last returned by nextFrame(). */
+	const State &getPresentedState() const { return _presented; }
+
+	/** Whether any video track has a frame left, taking the end time into account. */
+	bool hasFramesLeft() const;
+
+	DecodeAheadStats getStats() const;
+
+private:
+	struct Frame {
+		Frame() : hasSurface(false), dirtyPalette(false) {}
+
+		Graphics::Surface surface;
+		bool hasSurface;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		State state;
+	};
+
+	static void workerProc(void *data);
+	void run();
+
+	/**
+	 * Decode one frame into the next free slot, like
+	 * VideoDecoder::decodeNextFrame() does.
+	 *
+	 * @return false if the queue is full or there is nothing to decode
+	 */
+	bool decodeFrame();
+
+	void captureState(State &state) const;
+	bool isLate(const State &state, uint32 time) const;
+	void applyPalette(const Frame &frame);
+
+	VideoDecoder *_decoder;
+	const uint _capacity;
+	Common::Array<Frame> _frames;
+
+	/** Guards _read, _ready and _stats. */
+	Common::Mutex _queueMutex;
+	/** The slot of the oldest queued frame. */
+	uint _read;
+	/** The number of queued frames. */
+	uint _ready;
+	DecodeAheadStats _stats;
+
+	/** Only used by the consumer thread. */
+	State _presented;
+
+	Common::Thread _thread;
+	Common::Semaphore _frameReady;
+	Common::Semaphore _wakeUp;
+	std::atomic<bool> _quit;
+};
+
+VideoDecoder::DecodeAhead::DecodeAhead(VideoDecoder *decoder, uint frames)
+	: _decoder(decoder),
+	  _capacity(frames),
+	  _read(0),
+	  _ready(0),
+	  _quit(false) {
+
+	_frames.resize(frames + 1);
+	memset(&_stats, 0, sizeof(_stats));
+	_presented.nextTrack = -1;
+}
+
+VideoDecoder::DecodeAhead::~DecodeAhead() {
+	if (_thread.isRunning()) {
+		_quit.store(true);
+		_wakeUp.post();
+		_thread.join();
+	}
+
+	for (uint i = 0; i < _frames.size(); ++i)
+		_frames[i].surface.free();
+}
+
+bool VideoDecoder::DecodeAhead::start() {
+	{
+		Common::StackLock lock(_decoder->_trackMutex);
+		captureState(_presented);
+	}
+
+	return _thread.start(workerProc, this, "Video decode-ahead");
+}
+
+const Graphics::Surface *VideoDecoder::DecodeAhead::nextFrame(bool dropLateFrames) {
+	// Before locking, as it asks the mixer for the time of the audio tracks
+	const uint32 time = dropLateFrames ? _decoder->getTime() : 0;
+	bool waited = false;
+
+	for (;;) {
+		{
+			Common::StackLock lock(_queueMutex);
+			if (_ready)
+				break;
+		}
+
+		// Without queued frames, the presented state is the one the
+		// worker continues from
+		if (_presented.nextTrack < 0)
+			return 0;
+
+		waited = true;
+		_frameReady.wait(kDecodeAheadWaitTimeout);
+	}
+
+	Frame *frame;
+
+	{
+		Common::StackLock lock(_queueMutex);
+
+		if (waited)
+			_stats.lateFrames++;
+
+		while (dropLateFrames && _ready > 1 && isLate(_frames[_read].state, time)) {
+			// The palette of a skipped frame still applies to the next ones
+			applyPalette(_frames[_read]);
+			_read = (_read + 1) % _frames.size();
+			_ready--;
+			_stats.droppedFrames++;
+		}
+
+		frame = &_frames[_read];
+		_read = (_read + 1) % _frames.size();
+		_ready--;
+		_stats.presentedFrames++;
+	}
+
+	// The slot stays with the consumer until the next call
+	applyPalette(*frame);
+	_presented = frame->state;
+	_wakeUp.post();
+
+	return frame->hasSurface ? &frame->surface : 0;
+}
+
+void VideoDecoder::DecodeAhead::reset() {
+	{
+		Common::StackLock lock(_queueMutex);
+		_ready = 0;
+	}
+
+	captureState(_presented);
+	_wakeUp.post();
+}
+
+bool VideoDecoder::DecodeAhead::hasFramesLeft() const {
+	for (uint i = 0; i < _presented.tracks.size(); ++i) {
+		const TrackState &track = _presented.tracks[i];
+
+		bool videoEndTimeReached = _decoder->_endTimeSet && track.nextFrameStartTime >= (uint)_decoder->_endTime.msecs();
+		bool endReached = track.endOfTrack || (_decoder->isPlaying() && videoEndTimeReached);
+		if (!endReached)
+			return true;
+	}
+
+	return false;
+}
+
+VideoDecoder::DecodeAheadStats VideoDecoder::DecodeAhead::getStats() const {
+	Common::StackLock lock(_queueMutex);
+
+	DecodeAheadStats stats = _stats;
+	stats.capacity = _capacity;
+	stats.queuedFrames = _ready;
+	return stats;
+}
+
+void VideoDecoder::DecodeAhead::workerProc(void *data) {
+	((DecodeAhead *)data)->run();
+}
+
+void VideoDecoder::DecodeAhead::run() {
+	while (!_quit.load()) {
+		if (!decodeFrame())
+			_wakeUp.wait(kDecodeAheadIdleTimeout);
+	}
+}
+
+bool VideoDecoder::DecodeAhead::decodeFrame() {
+	// Held until the frame is queued, so reset() can not come in between
+	Common::StackLock trackLock(_decoder->_trackMutex);
+
+	if (_quit.load() || !_decoder->_nextVideoTrack)
+		return false;
+
+	uint slot;
+
+	{
+		Common::StackLock lock(_queueMutex);
+		if (_ready >= _capacity)
+			return false;
+
+		// Not changed by the consumer while it pops frames
+		slot = (_read + _ready) % _frames.size();
+	}
+
+	Frame &frame = _frames[slot];
+	frame.hasSurface = false;
+	frame.dirtyPalette = false;
+
+	_decoder->readNextPacket();
+
+	VideoTrack *track = _decoder->_nextVideoTrack;
+	if (track) {
+		const Graphics::Surface *surface = track->decodeNextFrame();
+
+		if (surface) {
+			// The track keeps decoding into its own surface
+			if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+				frame.surface.free();
+				frame.surface.create(surface->w, surface->h, surface->format);
+			}
+
+			frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+			frame.hasSurface = true;
+		}
+
+		if (track->hasDirtyPalette() && track->getPalette()) {
+			memcpy(frame.palette, track->getPalette(), sizeof(frame.palette));
+			frame.dirtyPalette = true;
+		}
+
+		_decoder->findNextVideoTrack();
+	}
+
+	captureState(frame.state);
+
+	{
+		Common::StackLock lock(_queueMutex);
+		_ready++;
+		_stats.decodedFrames++;
+	}
+
+	_frameReady.post();
+	return true;
+}
+
+void VideoDecoder::DecodeAhead::captureState(State &state) const {
+	state.tracks.clear();
+	state.nextTrack = -1;
+
+	for (TrackList::const_iterator it = _decoder->_tracks.begin(); it != _decoder->_tracks.end(); it++) {
+		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
+			continue;
+
+		const VideoTrack *track = (const VideoTrack *)*it;
+		if (track == _decoder->_nextVideoTrack)
+			state.nextTrack = state.tracks.size();
+
+		TrackState trackState;
+		trackState.curFrame = track->getCurFrame();
+		trackState.nextFrameStartTime = track->getNextFrameStartTime();
+		trackState.endOfTrack = track->endOfTrack();
+		trackState.reversed = track->isReversed();
+		state.tracks.push_back(trackState);
+	}
+}
+
+bool VideoDecoder::DecodeAhead::isLate(const State &state, uint32 time) const {
+	if (state.nextTrack < 0)
+		return false;
+
+	// The frame is late if the one after it is already due
+	const TrackState &track = state.tracks[state.nextTrack];
+	return track.reversed ? track.nextFrameStartTime >= time : track.nextFrameStartTime <= time;
+}
+
+void VideoDecoder::DecodeAhead::applyPalette(const Frame &frame) {
+	if (!frame.dirtyPalette)
+		return;
+
+	memcpy(_decoder->_decodeAheadPalette, frame.palette, sizeof(frame.palette));
+	_decoder->_palette = _decoder->_decodeAheadPalette;
+	_decoder->_dirtyPalette = true;
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,6 +392,9 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodeAhead = nullptr;
+	_decodeAheadFrames = 0;
+	_dropLateFrames = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -56,7 +403,14 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	stopDecodeAhead();
+}
+
 void VideoDecoder::close() {
+	// Before anything else, as the worker uses the tracks
+	stopDecodeAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -109,6 +463,8 @@ void VideoDecoder::pauseVideo(bool pause) {
 		return;
 	}
 
+	Common::StackLock lock(_trackMutex);
+
 	if (_pauseLevel == 1 && pause) {
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
@@ -130,6 +486,7 @@ void VideoDecoder::resetPauseStartTime() {
 void VideoDecoder::setVolume(byte volume) {
 	_audioVolume = volume;
 
+	Common::StackLock lock(_trackMutex);
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->setVolume(_audioVolume);
@@ -138,6 +495,7 @@ void VideoDecoder::setVolume(byte volume) {
 void VideoDecoder::setBalance(int8 balance) {
 	_audioBalance = balance;
 
+	Common::StackLock lock(_trackMutex);
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->setBalance(_audioBalance);
@@ -150,6 +508,7 @@ Audio::Mixer::SoundType VideoDecoder::getSoundType() const {
 void VideoDecoder::setSoundType(Audio::Mixer::SoundType soundType) {
 	_soundType = soundType;
 
+	Common::StackLock lock(_trackMutex);
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->setSoundType(_soundType);
@@ -187,6 +546,12 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (_decodeAheadFrames && !_decodeAhead && isVideoLoaded() && supportsDecodeAhead())
+		startDecodeAhead();
+
+	if (_decodeAhead)
+		return _decodeAhead->nextFrame(_dropLateFrames);
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -212,18 +577,34 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
-	// Attempt to make sure all the tracks are in the requested direction
-	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
-			if (!((VideoTrack *)*it)->setReverse(reverse))
-				return false;
+	bool result = true;
+
+	{
+		Common::StackLock lock(_trackMutex);
+
+		// Attempt to make sure all the tracks are in the requested direction
+		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+			if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
+				if (!((VideoTrack *)*it)->setReverse(reverse)) {
+					result = false;
+					break;
+				}
 
-			_needsUpdate = true; // force an update
+				_needsUpdate = true; // force an update
+			}
 		}
+
+		if (result)
+			findNextVideoTrack();
+		resetDecodeAhead();
 	}
 
-	findNextVideoTrack();
-	return true;
+	// Some decoders can only decode ahead while playing forward. The worker
+	// takes the track mutex, so it must be stopped without holding it.
+	if (_decodeAhead && !supportsDecodeAhead())
+		stopDecodeAhead();
+
+	return result;
 }
 
 const byte *VideoDecoder::getPalette() {
@@ -234,6 +615,14 @@ const byte *VideoDecoder::getPalette() {
 int VideoDecoder::getCurFrame() const {
 	int32 frame = -1;
 
+	if (_decodeAhead) {
+		const DecodeAhead::State &state = _decodeAhead->getPresentedState();
+		for (uint i = 0; i < state.tracks.size(); i++)
+			frame += state.tracks[i].curFrame + 1;
+
+		return frame;
+	}
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
 			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
@@ -242,6 +631,7 @@ int VideoDecoder::getCurFrame() const {
 }
 
 uint32 VideoDecoder::getFrameCount() const {
+	Common::StackLock lock(_trackMutex);
 	int count = 0;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -273,13 +663,31 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool reversed;
+
+	if (_decodeAhead) {
+		// The tracks are already ahead of the frames shown
+		const DecodeAhead::State &state = _decodeAhead->getPresentedState();
+		if (state.nextTrack < 0)
+			return 0;
+
+		nextFrameStartTime = state.tracks[state.nextTrack].nextFrameStartTime;
+		reversed = state.tracks[state.nextTrack].reversed;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		reversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (reversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -298,13 +706,17 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
+		// The video tracks are ahead of the frames shown, see below
+		if (_decodeAhead && track->getTrackType() == Track::kTrackTypeVideo)
+			continue;
+
 		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
 		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
 
-	return true;
+	return !_decodeAhead || !_decodeAhead->hasFramesLeft();
 }
 
 bool VideoDecoder::isRewindable() const {
@@ -322,13 +734,18 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	Common::StackLock lock(_trackMutex);
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
 
-	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if (!(*it)->rewind())
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if (!(*it)->rewind()) {
+			resetDecodeAhead();
 			return false;
+		}
+	}
 
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
@@ -338,6 +755,7 @@ bool VideoDecoder::rewind() {
 	_startTime = g_system->getMillis();
 	resetPauseStartTime();
 	findNextVideoTrack();
+	resetDecodeAhead();
 	return true;
 }
 
@@ -356,18 +774,25 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	Common::StackLock lock(_trackMutex);
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
 
 	// Do the actual seeking
-	if (!seekIntern(time))
+	if (!seekIntern(time)) {
+		resetDecodeAhead();
 		return false;
+	}
 
 	// Seek any external track too
-	for (TrackListIterator it = _externalTracks.begin(); it != _externalTracks.end(); it++)
-		if (!(*it)->seek(time))
+	for (TrackListIterator it = _externalTracks.begin(); it != _externalTracks.end(); it++) {
+		if (!(*it)->seek(time)) {
+			resetDecodeAhead();
 			return false;
+		}
+	}
 
 	_lastTimeChange = time;
 
@@ -380,6 +805,7 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 
 	resetPauseStartTime();
 	findNextVideoTrack();
+	resetDecodeAhead();
 	_needsUpdate = true;
 	return true;
 }
@@ -441,6 +867,7 @@ void VideoDecoder::stop() {
 	_pauseLevel = 0;
 
 	// Reset the pause state of the tracks too
+	Common::StackLock lock(_trackMutex);
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		(*it)->pause(false);
 }
@@ -525,6 +952,45 @@ bool VideoDecoder::setDitheringPalette(const byte *palette) {
 	return result;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames, bool dropLateFrames) {
+	if (frames != _decodeAheadFrames)
+		stopDecodeAhead();
+
+	_decodeAheadFrames = frames;
+	_dropLateFrames = dropLateFrames;
+}
+
+VideoDecoder::DecodeAheadStats VideoDecoder::getDecodeAheadStats() const {
+	if (!_decodeAhead) {
+		DecodeAheadStats stats;
+		memset(&stats, 0, sizeof(stats));
+		return stats;
+	}
+
+	return _decodeAhead->getStats();
+}
+
+void VideoDecoder::startDecodeAhead() {
+	_decodeAhead = new DecodeAhead(this, _decodeAheadFrames);
+
+	if (!_decodeAhead->start()) {
+		// Threads are not available, so keep decoding in decodeNextFrame()
+		delete _decodeAhead;
+		_decodeAhead = nullptr;
+		_decodeAheadFrames = 0;
+	}
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+}
+
+void VideoDecoder::resetDecodeAhead() {
+	if (_decodeAhead)
+		_decodeAhead->reset();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -717,6 +1183,8 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::String &base
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	Common::StackLock lock(_trackMutex);
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -783,6 +1251,7 @@ bool VideoDecoder::setAudioTrack(int index) {
 	if (_mainAudioTrack == audioTrack)
 		return true;
 
+	Common::StackLock lock(_trackMutex);
 	_mainAudioTrack->setMute(true);
 	audioTrack->setMute(false);
 	_mainAudioTrack = audioTrack;
@@ -889,6 +1358,8 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 }
 
 void VideoDecoder::startAudio() {
+	Common::StackLock lock(_trackMutex);
+
 	if (_endTimeSet) {
 		// HACK: Timestamp's subtraction asserts out when subtracting two times
 		// with different rates.
@@ -902,12 +1373,16 @@ void VideoDecoder::startAudio() {
 }
 
 void VideoDecoder::stopAudio() {
+	Common::StackLock lock(_trackMutex);
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->stop();
 }
 
 void VideoDecoder::startAudioLimit(const Audio::Timestamp &limit) {
+	Common::StackLock lock(_trackMutex);
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->start(limit);
@@ -917,6 +1392,9 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	if (_decodeAhead)
+		return _decodeAhead->hasFramesLeft();
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
@@ -941,6 +1419,8 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	Common::StackLock lock(_trackMutex);
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
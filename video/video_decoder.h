@@ -25,6 +25,7 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/path.h"
 #include "common/rational.h"
 #include "common/str.h"
@@ -52,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +397,59 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Statistics of the decode-ahead mode.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	struct DecodeAheadStats {
+		/** Number of frames decoded ahead at most. */
+		uint32 capacity;
+		/** Number of frames currently decoded and waiting to be shown. */
+		uint32 queuedFrames;
+		/** Number of frames decoded by the worker thread so far. */
+		uint32 decodedFrames;
+		/** Number of frames returned by decodeNextFrame() so far. */
+		uint32 presentedFrames;
+		/** Number of late frames skipped by decodeNextFrame(). */
+		uint32 droppedFrames;
+		/** Number of decodeNextFrame() calls which had to wait for the worker thread. */
+		uint32 lateFrames;
+	};
+
+	/**
+	 * Decode frames ahead on a worker thread.
+	 *
+	 * Up to the given number of frames are decoded ahead into a ring of
+	 * surfaces, and decodeNextFrame() returns the oldest of them. The tracks
+	 * are left untouched: the worker calls readNextPacket() and the next
+	 * video track's decodeNextFrame() just like decodeNextFrame() does.
+	 *
+	 * The worker is started by the first decodeNextFrame() call and stopped
+	 * by close(). Frames queued when the setting is changed are discarded.
+	 * The setting itself is kept across close(), like
+	 * setDefaultHighColorFormat(). If the backend does not support threads,
+	 * or the decoder does not support decoding ahead, frames are decoded by
+	 * decodeNextFrame() as usual.
+	 *
+	 * @param frames          The number of frames to decode ahead, or 0 to
+	 *                        decode each frame in decodeNextFrame().
+	 * @param dropLateFrames  Whether decodeNextFrame() should skip queued
+	 *                        frames whose successor is already due.
+	 */
+	void setDecodeAhead(uint frames, bool dropLateFrames = false);
+
+	/**
+	 * Returns if frames are currently decoded by a worker thread.
+	 */
+	bool isDecodingAhead() const { return _decodeAhead != nullptr; }
+
+	/**
+	 * Return the statistics of the decode-ahead mode. All values are zero
+	 * if no frames are decoded ahead.
+	 */
+	DecodeAheadStats getDecodeAheadStats() const;
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -936,6 +990,17 @@ protected:
 	 */
 	virtual AudioTrack *getAudioTrack(int index) { return 0; }
 
+	/**
+	 * Can frames of this video be decoded ahead on a worker thread?
+	 *
+	 * The worker only calls readNextPacket() and the tracks' functions.
+	 * A subclass which uses its tracks or its stream anywhere else while
+	 * playing, e.g. in its own decodeNextFrame(), must return false.
+	 *
+	 * @see setDecodeAhead()
+	 */
+	virtual bool supportsDecodeAhead() const { return true; }
+
 private:
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
@@ -959,6 +1024,21 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Decode-ahead mode, see setDecodeAhead()
+	class DecodeAhead;
+	DecodeAhead *_decodeAhead;
+	uint _decodeAheadFrames;
+	bool _dropLateFrames;
+	byte _decodeAheadPalette[256 * 3];
+
+	// Held while the tracks are used, so the decode-ahead worker and the
+	// playback control functions do not use them at the same time
+	Common::Mutex _trackMutex;
+
+	void startDecodeAhead();
+	void stopDecodeAhead();
+	void resetDecodeAhead();
+
 protected:
 	// Internal helper functions
 	void stopAudio();